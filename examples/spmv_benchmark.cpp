@@ -0,0 +1,128 @@
+/*
+ * Benchmark of sparse matrix-vector products: CHOLMOD (cholmod_sdmult)
+ * versus Matrix::mult/Matrix::multTranspose with compressed-column storage
+ * and with dual (compressed-column and compressed-row) storage.
+ *
+ * Usage: spmv_benchmark <matrix-market file> [repetitions] [threads]
+ *
+ * Compile the library with `make DO_OPENMP=1` to use multiple threads.
+ */
+#include "ForBES.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <iomanip>
+#include <sys/time.h>
+
+static double wall_time() {
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return static_cast<double> (tv.tv_sec) + 1e-6 * static_cast<double> (tv.tv_usec);
+}
+
+static void report(const char * name, double seconds, int repetitions) {
+    std::cout << std::setw(28) << std::left << name
+            << std::setw(12) << std::right << std::setprecision(4)
+            << 1e3 * seconds / repetitions << " ms/product" << std::endl;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <matrix-market file> [repetitions] [threads]" << std::endl;
+        return 1;
+    }
+    int repetitions = argc > 2 ? std::atoi(argv[2]) : 100;
+    int threads = argc > 3 ? std::atoi(argv[3]) : 0;
+    Matrix::set_num_threads(threads);
+
+    FILE * fp = std::fopen(argv[1], "r");
+    if (fp == NULL) {
+        std::cerr << "Cannot open " << argv[1] << std::endl;
+        return 1;
+    }
+    Matrix A = MatrixFactory::ReadSparse(fp);
+    std::rewind(fp);
+    cholmod_sparse * A_cholmod = cholmod_read_sparse(fp, Matrix::cholmod_handle());
+    std::fclose(fp);
+
+    const size_t n = A.getNrows();
+    const size_t m = A.getNcols();
+    std::cout << "A: " << n << "x" << m << ", threads: " << Matrix::get_num_threads() << std::endl;
+
+    Matrix x = MatrixFactory::MakeRandomMatrix(m, 1, -1.0, 2.0);
+    Matrix y = MatrixFactory::MakeRandomMatrix(n, 1, -1.0, 2.0);
+    Matrix Ax(n, 1);
+    Matrix Aty(m, 1);
+
+    /* CHOLMOD */
+    cholmod_dense * x_cholmod = cholmod_allocate_dense(m, 1, m, CHOLMOD_REAL, Matrix::cholmod_handle());
+    cholmod_dense * y_cholmod = cholmod_allocate_dense(n, 1, n, CHOLMOD_REAL, Matrix::cholmod_handle());
+    cholmod_dense * Ax_cholmod = cholmod_allocate_dense(n, 1, n, CHOLMOD_REAL, Matrix::cholmod_handle());
+    cholmod_dense * Aty_cholmod = cholmod_allocate_dense(m, 1, m, CHOLMOD_REAL, Matrix::cholmod_handle());
+    for (size_t i = 0; i < m; i++) static_cast<double*> (x_cholmod->x)[i] = x[i];
+    for (size_t i = 0; i < n; i++) static_cast<double*> (y_cholmod->x)[i] = y[i];
+    double one[2] = {1.0, 0.0};
+    double zero[2] = {0.0, 0.0};
+
+    double t0 = wall_time();
+    for (int k = 0; k < repetitions; k++) {
+        cholmod_sdmult(A_cholmod, 0, one, zero, x_cholmod, Ax_cholmod, Matrix::cholmod_handle());
+    }
+    report("cholmod_sdmult (A*x)", wall_time() - t0, repetitions);
+
+    t0 = wall_time();
+    for (int k = 0; k < repetitions; k++) {
+        cholmod_sdmult(A_cholmod, 1, one, zero, y_cholmod, Aty_cholmod, Matrix::cholmod_handle());
+    }
+    report("cholmod_sdmult (A'*y)", wall_time() - t0, repetitions);
+
+    /* Matrix (compressed-column storage) */
+    A.setDualStorage(false);
+    Matrix::mult(Ax, 1.0, A, x, 0.0); /* warm-up: builds the cached storage */
+    t0 = wall_time();
+    for (int k = 0; k < repetitions; k++) {
+        Matrix::mult(Ax, 1.0, A, x, 0.0);
+    }
+    report("Matrix::mult (CSC)", wall_time() - t0, repetitions);
+
+    t0 = wall_time();
+    for (int k = 0; k < repetitions; k++) {
+        Matrix::multTranspose(Aty, 1.0, A, y, 0.0);
+    }
+    report("Matrix::multTranspose (CSC)", wall_time() - t0, repetitions);
+
+    /* Matrix (dual storage) */
+    A.setDualStorage(true);
+    Matrix::mult(Ax, 1.0, A, x, 0.0);
+    t0 = wall_time();
+    for (int k = 0; k < repetitions; k++) {
+        Matrix::mult(Ax, 1.0, A, x, 0.0);
+    }
+    report("Matrix::mult (dual)", wall_time() - t0, repetitions);
+
+    t0 = wall_time();
+    for (int k = 0; k < repetitions; k++) {
+        Matrix::multTranspose(Aty, 1.0, A, y, 0.0);
+    }
+    report("Matrix::multTranspose (dual)", wall_time() - t0, repetitions);
+
+    /* check */
+    double err = 0.0;
+    for (size_t i = 0; i < n; i++) {
+        double d = Ax[i] - static_cast<double*> (Ax_cholmod->x)[i];
+        err += d * d;
+    }
+    for (size_t i = 0; i < m; i++) {
+        double d = Aty[i] - static_cast<double*> (Aty_cholmod->x)[i];
+        err += d * d;
+    }
+    std::cout << "Squared difference from CHOLMOD: " << err << std::endl;
+
+    cholmod_free_dense(&x_cholmod, Matrix::cholmod_handle());
+    cholmod_free_dense(&y_cholmod, Matrix::cholmod_handle());
+    cholmod_free_dense(&Ax_cholmod, Matrix::cholmod_handle());
+    cholmod_free_dense(&Aty_cholmod, Matrix::cholmod_handle());
+    cholmod_free_sparse(&A_cholmod, Matrix::cholmod_handle());
+    return 0;
+}
@@ -0,0 +1,220 @@
+/*
+ * File:   BlockCGSolver.cpp
+ *
+ * ForBES is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ForBES is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with ForBES. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BlockCGSolver.h"
+#include <cblas.h>
+#include <lapacke.h>
+#include <math.h>
+#include <cstring>
+
+/* solves S * Y = C in place (C := Y) for a symmetric positive definite S, 
+ * which is overwritten by its Cholesky factor */
+static int block_cg_spd_solve(Matrix& S, Matrix& C) {
+    const size_t k = S.getNrows();
+    int info = LAPACKE_dpotrf(LAPACK_COL_MAJOR, 'L', k, S.getData(), k);
+    if (info != 0) {
+        return ForBESUtils::STATUS_NUMERICAL_PROBLEMS;
+    }
+    LAPACKE_dpotrs(LAPACK_COL_MAJOR, 'L', k, C.getNcols(), S.getData(), k, C.getData(), k);
+    return ForBESUtils::STATUS_OK;
+}
+
+/* makes W a dense nrows-by-ncols matrix; no allocation if it is large enough */
+static void block_cg_workspace(Matrix& W, size_t nrows, size_t ncols) {
+    if (W.getType() != Matrix::MATRIX_DENSE || W.length() < nrows * ncols) {
+        W = Matrix(nrows, ncols);
+    } else if (W.getNrows() != nrows || W.getNcols() != ncols) {
+        W.reshape(nrows, ncols);
+    }
+}
+
+/* C = A'B for dense n-by-k matrices A and B (which may be the same object) */
+static void block_cg_inner(Matrix& C, Matrix& A, Matrix& B) {
+    const size_t n = A.getNrows();
+    cblas_dgemm(CblasColMajor, CblasTrans, CblasNoTrans, A.getNcols(), B.getNcols(), n,
+            1.0, A.getData(), n, B.getData(), n, 0.0, C.getData(), C.getNrows());
+}
+
+/* infinity norm of the j-th column of an n-by-k matrix */
+static double block_cg_column_norm(Matrix& R, size_t j) {
+    const size_t n = R.getNrows();
+    const double * r = R.getData() + j * n;
+    double mx = 0.0;
+    for (size_t i = 0; i < n; i++) {
+        if (fabs(r[i]) > mx) mx = fabs(r[i]);
+    }
+    return mx;
+}
+
+BlockCGSolver::BlockCGSolver(LinearOperator& linop) : LinOpSolver(linop) {
+    m_precond = NULL;
+    m_tolerance = 1e-4;
+    m_max_iterations = 500;
+    m_iterations_count = 0;
+}
+
+BlockCGSolver::BlockCGSolver(LinearOperator& linop, LinearOperator& preconditioner,
+        double tolerance, size_t max_iterations) :
+LinOpSolver(linop), m_precond(&preconditioner), m_tolerance(tolerance),
+m_max_iterations(max_iterations) {
+    m_iterations_count = 0;
+}
+
+BlockCGSolver::~BlockCGSolver() {
+}
+
+double BlockCGSolver::last_error() const {
+    double err = 0.0;
+    for (size_t j = 0; j < m_errors.size(); j++) {
+        if (!(m_errors[j] <= err)) err = m_errors[j]; /* propagates NaN */
+    }
+    return err;
+}
+
+double BlockCGSolver::last_error(size_t j) const {
+    return m_errors.at(j);
+}
+
+size_t BlockCGSolver::last_num_iter() const {
+    return m_iterations_count;
+}
+
+size_t BlockCGSolver::last_num_iter(size_t j) const {
+    return m_iterations.at(j);
+}
+
+int BlockCGSolver::solve(Matrix& B, Matrix& X) {
+    const size_t n = B.getNrows();
+    const size_t s = B.getNcols();
+    m_iterations_count = 0;
+    m_errors.assign(s, NAN);
+    m_iterations.assign(s, 0);
+
+    bool x_zero = false;
+    if (X.getNrows() != n || X.getNcols() != s || X.getType() != Matrix::MATRIX_DENSE) {
+        X = Matrix(n, s);
+        x_zero = true;
+    }
+    block_cg_workspace(m_R_full, n, s);
+    if (B.getType() == Matrix::MATRIX_DENSE) {
+        memcpy(m_R_full.getData(), B.getData(), n * s * sizeof (double));
+    } else {
+        for (size_t j = 0; j < s; j++) {
+            for (size_t i = 0; i < n; i++) m_R_full.set(i, j, B.get(i, j));
+        }
+    }
+    if (!x_zero) {
+        m_linop->call(m_R_full, -1.0, X, 1.0); // R = B - T(X)
+    }
+
+    for (size_t j = 0; j < s; j++) {
+        m_errors[j] = block_cg_column_norm(m_R_full, j);
+    }
+    while (m_iterations_count < m_max_iterations) {
+        m_active.clear();
+        for (size_t j = 0; j < s; j++) {
+            if (m_errors[j] >= m_tolerance) {
+                m_active.push_back(j);
+            }
+        }
+        if (m_active.empty()) {
+            return ForBESUtils::STATUS_OK;
+        }
+        int status = blockIterations(X);
+        if (ForBESUtils::STATUS_OK != status) {
+            return status;
+        }
+    }
+    for (size_t j = 0; j < s; j++) {
+        if (m_errors[j] >= m_tolerance) {
+            return ForBESUtils::STATUS_MAX_ITERATIONS_REACHED;
+        }
+    }
+    return ForBESUtils::STATUS_OK;
+}
+
+int BlockCGSolver::blockIterations(Matrix& X_full) {
+    const size_t n = X_full.getNrows();
+    const size_t k = m_active.size();
+    const size_t col_bytes = n * sizeof (double);
+    const size_t block_bytes = n * k * sizeof (double);
+    const size_t small_bytes = k * k * sizeof (double);
+
+    block_cg_workspace(m_X, n, k);
+    block_cg_workspace(m_R, n, k);
+    block_cg_workspace(m_D, n, k);
+    block_cg_workspace(m_TD, n, k);
+    block_cg_workspace(m_ZR, k, k);
+    block_cg_workspace(m_ZR_new, k, k);
+    block_cg_workspace(m_S, k, k);
+    block_cg_workspace(m_coef, k, k);
+    if (m_precond != NULL) block_cg_workspace(m_Z, n, k);
+
+    /* restrict to the active columns */
+    for (size_t j = 0; j < k; j++) {
+        memcpy(m_X.getData() + j * n, X_full.getData() + m_active[j] * n, col_bytes);
+        memcpy(m_R.getData() + j * n, m_R_full.getData() + m_active[j] * n, col_bytes);
+    }
+    Matrix& Z = (m_precond != NULL) ? m_Z : m_R; /* P(R); R itself without a preconditioner */
+
+    if (m_precond != NULL) m_precond->call(Z, 1.0, m_R, 0.0); // Z = P(R)
+    memcpy(m_D.getData(), Z.getData(), block_bytes); // D = Z
+    block_cg_inner(m_ZR, Z, m_R); // ZR = Z'R
+
+    int status = ForBESUtils::STATUS_OK;
+    size_t round_iterations = 0;
+    bool restart = false;
+    while (!restart && m_iterations_count < m_max_iterations) {
+        m_linop->call(m_TD, 1.0, m_D, 0.0); // TD = T(D)
+        block_cg_inner(m_S, m_D, m_TD); // S = D'T(D)
+        memcpy(m_coef.getData(), m_ZR.getData(), small_bytes);
+        if (ForBESUtils::STATUS_OK != block_cg_spd_solve(m_S, m_coef)) { // alpha = S \ Z'R
+            /* rank deficient block; restart unless nothing was gained */
+            if (round_iterations == 0) status = ForBESUtils::STATUS_NUMERICAL_PROBLEMS;
+            break;
+        }
+        Matrix::mult(m_X, 1.0, m_D, m_coef, 1.0); // X += D alpha
+        Matrix::mult(m_R, -1.0, m_TD, m_coef, 1.0); // R -= T(D) alpha
+        m_iterations_count++;
+        round_iterations++;
+        for (size_t j = 0; j < k; j++) {
+            size_t c = m_active[j];
+            m_errors[c] = block_cg_column_norm(m_R, j);
+            m_iterations[c] = m_iterations_count;
+            if (m_errors[c] < m_tolerance) restart = true; /* deflate */
+        }
+        if (restart) break;
+        if (m_precond != NULL) m_precond->call(Z, 1.0, m_R, 0.0); // Z = P(R)
+        block_cg_inner(m_ZR_new, Z, m_R);
+        memcpy(m_S.getData(), m_ZR.getData(), small_bytes);
+        memcpy(m_coef.getData(), m_ZR_new.getData(), small_bytes);
+        if (ForBESUtils::STATUS_OK != block_cg_spd_solve(m_S, m_coef)) { // beta = (Z'R) \ (Z'R)_new
+            break;
+        }
+        memcpy(m_ZR.getData(), m_ZR_new.getData(), small_bytes);
+        /* D = Z + D beta; T(D) is recomputed, so it is used as workspace */
+        memcpy(m_TD.getData(), Z.getData(), block_bytes);
+        Matrix::mult(m_TD, 1.0, m_D, m_coef, 1.0);
+        memcpy(m_D.getData(), m_TD.getData(), block_bytes);
+    }
+
+    for (size_t j = 0; j < k; j++) {
+        memcpy(X_full.getData() + m_active[j] * n, m_X.getData() + j * n, col_bytes);
+        memcpy(m_R_full.getData() + m_active[j] * n, m_R.getData() + j * n, col_bytes);
+    }
+    return status;
+}
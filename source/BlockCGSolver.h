@@ -0,0 +1,164 @@
+/*
+ * File:   BlockCGSolver.h
+ *
+ * ForBES is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ForBES is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with ForBES. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BLOCKCGSOLVER_H
+#define BLOCKCGSOLVER_H
+
+#include "LinOpSolver.h"
+#include <vector>
+
+/**
+ * \class BlockCGSolver
+ * \brief Block conjugate gradient solver for multiple right-hand sides
+ * \version 0.1
+ * \ingroup LinSysSolver-group
+ *
+ * Solves \f$T(X) = B\f$, where \f$B\f$ has \f$s\f$ columns and \f$T\f$ is a 
+ * self-adjoint positive definite linear operator, using the (preconditioned) 
+ * block conjugate gradient method [D. P. O'Leary, The block conjugate gradient
+ * algorithm and related methods, Linear Algebra Appl. 29, 1980]:
+ *
+ * 1. \f$R\leftarrow B-T(X)\f$, \f$Z\leftarrow P(R)\f$, \f$D\leftarrow Z\f$
+ * 2. Do:
+ *      1. \f$\alpha \leftarrow (D^{\top}T(D))^{-1}Z^{\top}R\f$
+ *      2. \f$X\leftarrow X + D\alpha\f$, \f$R\leftarrow R - T(D)\alpha\f$
+ *      3. \f$Z_{+}\leftarrow P(R)\f$
+ *      4. \f$\beta \leftarrow (Z^{\top}R)^{-1}Z_{+}^{\top}R_{+}\f$
+ *      5. \f$D\leftarrow Z_{+} + D\beta\f$
+ *
+ * All columns share one block Krylov subspace, so every iteration costs one
+ * block application of \f$T\f$ (see LinearOperator::call), which is 
+ * typically much cheaper than \f$s\f$ separate applications, and the number 
+ * of iterations is at most that of CG on each column. The small 
+ * \f$s\times s\f$ systems are solved by Cholesky factorizations.
+ *
+ * A column is considered converged once the infinity-norm of its residual 
+ * drops below the tolerance; the block is then deflated, i.e., the method is 
+ * restarted with the remaining columns from the current iterate (this also 
+ * avoids the rank deficiency of \f$D^{\top}T(D)\f$ caused by converged 
+ * columns). The convergence of each column is reported by 
+ * #last_error(size_t) const and #last_num_iter(size_t) const.
+ *
+ * The linear operator and the preconditioner must support block 
+ * (multi-column) arguments.
+ */
+class BlockCGSolver : public LinOpSolver {
+public:
+
+    /**
+     * Constructs a new block CG solver without preconditioner, with tolerance
+     * \f$10^{-4}\f$ and at most <code>500</code> iterations.
+     *
+     * @param linop self-adjoint positive definite linear operator
+     */
+    explicit BlockCGSolver(LinearOperator& linop);
+
+    /**
+     * Constructs a new block CG solver.
+     *
+     * @param linop self-adjoint positive definite linear operator
+     * @param preconditioner preconditioner as a linear operator
+     * @param tolerance tolerance
+     * @param max_iterations maximum number of iterations
+     */
+    BlockCGSolver(LinearOperator& linop, LinearOperator& preconditioner,
+            double tolerance, size_t max_iterations);
+
+    virtual ~BlockCGSolver();
+
+    /**
+     * Solves \f$T(X) = B\f$. The initial guess is the value of 
+     * <code>solution</code> if it has the dimensions of <code>rhs</code> and 
+     * zero otherwise.
+     *
+     * @param rhs the right-hand side \f$B\f$
+     * @param solution the solution \f$X\f$
+     * @return status code; \link ForBESUtils::STATUS_MAX_ITERATIONS_REACHED 
+     * STATUS_MAX_ITERATIONS_REACHED\endlink if some column has not converged
+     * and \link ForBESUtils::STATUS_NUMERICAL_PROBLEMS STATUS_NUMERICAL_PROBLEMS\endlink
+     * upon breakdown
+     */
+    virtual int solve(Matrix& rhs, Matrix& solution);
+
+    /**
+     * Largest infinity-norm of the residuals of all columns on the last run.
+     *
+     * @return last error
+     */
+    double last_error() const;
+
+    /**
+     * Infinity-norm of the residual of the j-th column on the last run.
+     *
+     * @param j column index
+     * @return last error of the j-th column
+     */
+    double last_error(size_t j) const;
+
+    /**
+     * Number of (block) iterations on the last run.
+     *
+     * @return number of iterations
+     */
+    size_t last_num_iter() const;
+
+    /**
+     * Number of iterations after which the j-th column converged on the last
+     * run (equal to #last_num_iter() if it did not converge).
+     *
+     * @param j column index
+     * @return number of iterations of the j-th column
+     */
+    size_t last_num_iter(size_t j) const;
+
+private:
+
+    LinearOperator * m_precond; /**< preconditioner (may be NULL) */
+    double m_tolerance; /**< tolerance */
+    size_t m_max_iterations; /**< maximum number of iterations */
+    size_t m_iterations_count; /**< iterations on the last run */
+    std::vector<double> m_errors; /**< residual norm of every column */
+    std::vector<size_t> m_iterations; /**< iterations of every column */
+    std::vector<size_t> m_active; /**< columns which have not converged */
+
+    /*
+     * Work matrices; they are allocated on the first call of #solve (for 
+     * n-by-s right-hand sides) and reshaped, without reallocation, when 
+     * columns are deflated or when smaller systems are solved.
+     */
+    Matrix m_R_full; /**< residual of all columns (n-by-s) */
+    Matrix m_X; /**< active columns of the solution (n-by-k) */
+    Matrix m_R; /**< active columns of the residual (n-by-k) */
+    Matrix m_Z; /**< preconditioned residual (n-by-k) */
+    Matrix m_D; /**< search directions (n-by-k) */
+    Matrix m_TD; /**< T(D) (n-by-k) */
+    Matrix m_ZR; /**< Z'R (k-by-k) */
+    Matrix m_ZR_new; /**< Z'R of the next iteration (k-by-k) */
+    Matrix m_S; /**< D'T(D) and its Cholesky factor (k-by-k) */
+    Matrix m_coef; /**< alpha or beta (k-by-k) */
+
+    /**
+     * Block CG on the columns #m_active of X and #m_R_full until one of them
+     * converges, the maximum number of iterations is reached, or breakdown.
+     *
+     * @return status code
+     */
+    int blockIterations(Matrix& X);
+
+};
+
+#endif /* BLOCKCGSOLVER_H */
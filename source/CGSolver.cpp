@@ -19,9 +19,82 @@
  */
 
 #include "CGSolver.h"
-#include <lapacke.h>
+#include "MatrixParallel.h"
 #include <math.h>
-#include <iostream>
+#include <cstring>
+#include <stdexcept>
+
+/*
+ * Parallel loops with fused reductions (sums and a maximum); max-reductions
+ * require OpenMP 3.1, otherwise these loops run serially.
+ */
+#if defined(_OPENMP) && _OPENMP >= 201107
+#define CG_PARALLEL_FOR_SUM_MAX(n, sum, mx) MATRIX_OMP_PRAGMA(omp parallel for \
+        if ((n) >= MATRIX_PARALLEL_THRESHOLD) num_threads(Matrix::get_num_threads()) \
+        reduction(+:sum) reduction(max:mx))
+#define CG_PARALLEL_FOR_SUM2_MAX(n, sum1, sum2, mx) MATRIX_OMP_PRAGMA(omp parallel for \
+        if ((n) >= MATRIX_PARALLEL_THRESHOLD) num_threads(Matrix::get_num_threads()) \
+        reduction(+:sum1, sum2) reduction(max:mx))
+#else
+#define CG_PARALLEL_FOR_SUM_MAX(n, sum, mx)
+#define CG_PARALLEL_FOR_SUM2_MAX(n, sum1, sum2, mx)
+#endif
+
+/* makes v a dense n-by-1 vector; no allocation if it already is one */
+static void cg_workspace(Matrix& v, size_t n) {
+    if (v.getNrows() != n || v.getNcols() != 1 || v.getType() != Matrix::MATRIX_DENSE) {
+        v = Matrix(n, 1);
+    }
+}
+
+/* returns <a, b> */
+static double cg_dot(const double * a, const double * b, size_t n) {
+    double sum = 0.0;
+    MATRIX_PARALLEL_FOR_SIMD_SUM(n, sum)
+    for (size_t i = 0; i < n; i++) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+
+/* returns <r, z> and stores ||r||_inf in err */
+static double cg_dot_norm(const double * r, const double * z, size_t n, double& err) {
+    double sum = 0.0;
+    double mx = 0.0;
+    CG_PARALLEL_FOR_SUM_MAX(n, sum, mx)
+    for (size_t i = 0; i < n; i++) {
+        sum += r[i] * z[i];
+        double a = fabs(r[i]);
+        if (a > mx) mx = a;
+    }
+    err = mx;
+    return sum;
+}
+
+/* x += alpha p, r -= alpha Ap; returns <r, r> and stores ||r||_inf in err */
+static double cg_update(double * x, double * r, const double * p, const double * Ap,
+        double alpha, size_t n, double& err) {
+    double sum = 0.0;
+    double mx = 0.0;
+    CG_PARALLEL_FOR_SUM_MAX(n, sum, mx)
+    for (size_t i = 0; i < n; i++) {
+        x[i] += alpha * p[i];
+        r[i] -= alpha * Ap[i];
+        sum += r[i] * r[i];
+        double a = fabs(r[i]);
+        if (a > mx) mx = a;
+    }
+    err = mx;
+    return sum;
+}
+
+/* p = z + beta p */
+static void cg_direction(double * p, const double * z, double beta, size_t n) {
+    MATRIX_PARALLEL_FOR_SIMD(n)
+    for (size_t i = 0; i < n; i++) {
+        p[i] = z[i] + beta * p[i];
+    }
+}
 
 CGSolver::CGSolver(LinearOperator& linop) : LinOpSolver(linop) {
     init();
@@ -36,6 +109,8 @@ CGSolver::CGSolver(LinearOperator& linop, LinearOperator& preconditioner, double
 : LinOpSolver(linop), m_precond(&preconditioner), m_tolerance(tolerance), m_max_iterations(max_iterations) {
     m_err = NAN;
     m_iterations_count = 0;
+    m_pipelined = false;
+    m_warm_start = false;
 }
 
 CGSolver::~CGSolver() {
@@ -46,51 +121,213 @@ void CGSolver::init() {
     m_max_iterations = 500;
     m_err = NAN;
     m_iterations_count = 0;
+    m_pipelined = false;
+    m_warm_start = false;
+}
+
+void CGSolver::setWarmStart(bool warm_start) {
+    m_warm_start = warm_start;
+}
+
+bool CGSolver::isWarmStart() const {
+    return m_warm_start;
+}
+
+void CGSolver::setPipelined(bool pipelined) {
+    m_pipelined = pipelined;
+}
+
+bool CGSolver::isPipelined() const {
+    return m_pipelined;
+}
+
+void CGSolver::prepare(Matrix& b, Matrix& x, bool warm_start) {
+    if (!b.isColumnVector()) {
+        throw std::invalid_argument("CGSolver: the right-hand side must be a column vector");
+    }
+    const size_t n = b.getNrows();
+    cg_workspace(m_r, n);
+    cg_workspace(m_p, n);
+    cg_workspace(m_Ap, n);
+    if (m_precond != NULL) cg_workspace(m_z, n);
+    if (m_pipelined) {
+        cg_workspace(m_w, n);
+        cg_workspace(m_APw, n);
+        cg_workspace(m_Aq, n);
+        if (m_precond != NULL) {
+            cg_workspace(m_Pw, n);
+            cg_workspace(m_q, n);
+        }
+    }
+
+    bool x_zero = true;
+    if (x.getNrows() != n || x.getNcols() != 1 || x.getType() != Matrix::MATRIX_DENSE) {
+        x = Matrix(n, 1);
+    } else if (!warm_start) {
+        memset(x.getData(), 0, n * sizeof (double));
+    } else {
+        const double * xd = x.getData();
+        for (size_t i = 0; i < n && x_zero; i++) {
+            x_zero = (xd[i] == 0.0);
+        }
+    }
+
+    /* r = b - T(x) */
+    if (b.getType() == Matrix::MATRIX_DENSE) {
+        memcpy(m_r.getData(), b.getData(), n * sizeof (double));
+    } else {
+        for (size_t i = 0; i < n; i++) m_r[i] = b.get(i, 0);
+    }
+    if (!x_zero) {
+        m_linop->call(m_r, -1.0, x, 1.0);
+    }
 }
 
 int CGSolver::solve(Matrix& b, Matrix& solution) {
+    return run(b, solution, m_warm_start);
+}
+
+int CGSolver::run(Matrix& b, Matrix& solution, bool warm_start) {
     m_iterations_count = 0;
     m_err = NAN;
-    Matrix r(b);
-    Matrix z = m_precond != NULL ? m_precond->call(r) : MatrixFactory::ShallowMatrix(r);
-    Matrix p = MatrixFactory::ShallowVector(z, 0);
-    bool keepgoing = true;
-    Matrix Ap;
-    while (keepgoing) {
-        Ap = m_linop->call(p);                      // Ap = A * p
-        double a_denom = (p * Ap).get(0, 0);        //
-        double a_numer = (r * z).get(0, 0);         //
-        double alpha = a_numer / a_denom;           // alpha = (r,z)/(p, Ap);
-        Matrix::add(solution, alpha, p, 1.0);       // x = x + alpha * p
-        Matrix r_new = r;                           // r_new = r
-
-        m_err = LAPACKE_dlange(
-                LAPACK_COL_MAJOR,
-                'I',
-                r_new.getNrows(),
-                1,
-                r_new.getData(),
-                r_new.getNrows());                  // compute ||r||_{inf}
+    prepare(b, solution, warm_start);
+    return m_pipelined ? solvePipelined(solution) : solveStandard(solution);
+}
+
+int CGSolver::solve(Matrix& rhs, Matrix& solution, double tolerance, Matrix guess) {
+    double tolerance_default = m_tolerance;
+    m_tolerance = tolerance;
+    solution = guess;
+    int status = run(rhs, solution, true);
+    m_tolerance = tolerance_default;
+    return status;
+}
 
+int CGSolver::solveStandard(Matrix& solution) {
+    const size_t n = m_r.getNrows();
+    double * x = solution.getData();
+    double * r = m_r.getData();
+    double * p = m_p.getData();
+    double * Ap = m_Ap.getData();
+    double * z = r; /* z = r without a preconditioner */
+    if (m_precond != NULL) {
+        m_precond->call(m_z, 1.0, m_r, 0.0);    // z = P(r)
+        z = m_z.getData();
+    }
+    double rz = cg_dot_norm(r, z, n, m_err);    // (r, z) and ||r||_{inf}
+    memcpy(p, z, n * sizeof (double));          // p = z
+    while (m_err >= m_tolerance && m_iterations_count < m_max_iterations) {
+        m_linop->call(m_Ap, 1.0, m_p, 0.0);     // Ap = A * p
+        double pAp = cg_dot(p, Ap, n);
+        if (pAp == 0.0) {
+            return ForBESUtils::STATUS_NUMERICAL_PROBLEMS;
+        }
+        double alpha = rz / pAp;                // alpha = (r,z)/(p, Ap)
+        double rr = cg_update(x, r, p, Ap, alpha, n, m_err); // x += alpha p, r -= alpha Ap
+        m_iterations_count++;                   // k = k + 1
         if (m_err < m_tolerance) {
-            break;                                  // stop if tolerance reached
+            break;                              // stop if tolerance reached
+        }
+        double rz_new = rr;                     // (r_new, z_new)
+        if (m_precond != NULL) {
+            m_precond->call(m_z, 1.0, m_r, 0.0); // z_new = P(r_new)
+            rz_new = cg_dot(r, z, n);
         }
+        double beta = rz_new / rz;              // beta = (r_new, z_new)/(r, z)
+        cg_direction(p, z, beta, n);            // p = z_new + beta p
+        rz = rz_new;
+    }
+    if (m_err >= m_tolerance) {
+        return ForBESUtils::STATUS_MAX_ITERATIONS_REACHED;
+    }
+    return ForBESUtils::STATUS_OK;
+}
+
+int CGSolver::solvePipelined(Matrix& solution) {
+    /*
+     * Pipelined (preconditioned) CG [P. Ghysels and W. Vanroose, Hiding global
+     * synchronization latency in the preconditioned Conjugate Gradient
+     * algorithm, Parallel Computing 40(7), 2014]. Without a preconditioner,
+     * z = r, Pw = w and q = Ap.
+     */
+    const size_t n = m_r.getNrows();
+    const bool precond = m_precond != NULL;
+    Matrix& z_mat = precond ? m_z : m_r;
+    Matrix& Pw_mat = precond ? m_Pw : m_w;
+    double * x = solution.getData();
+    double * r = m_r.getData();
+    double * z = z_mat.getData();
+    double * w = m_w.getData();
+    double * Pw = Pw_mat.getData();
+    double * APw = m_APw.getData();
+    double * p = m_p.getData();
+    double * s = m_Ap.getData();
+    double * q = precond ? m_q.getData() : s;
+    double * Aq = m_Aq.getData();
+
+    if (precond) m_precond->call(m_z, 1.0, m_r, 0.0); // z = P(r)
+    m_linop->call(m_w, 1.0, z_mat, 0.0);        // w = A z
+
+    double rz_prev = 0.0;
+    double alpha_prev = 0.0;
+    while (true) {
+        /* (r, z), (w, z) and ||r||_{inf} in a single reduction */
+        double rz = 0.0;
+        double wz = 0.0;
+        double mx = 0.0;
+        CG_PARALLEL_FOR_SUM2_MAX(n, rz, wz, mx)
+        for (size_t i = 0; i < n; i++) {
+            rz += r[i] * z[i];
+            wz += w[i] * z[i];
+            double a = fabs(r[i]);
+            if (a > mx) mx = a;
+        }
+        m_err = mx;
+        if (m_err < m_tolerance || m_iterations_count >= m_max_iterations) {
+            break;
+        }
+        if (precond) m_precond->call(m_Pw, 1.0, m_w, 0.0); // Pw = P(w)
+        m_linop->call(m_APw, 1.0, Pw_mat, 0.0); // APw = A P(w)
 
-        Matrix::add(r_new, -alpha, Ap, 1.0);        // r_new = r - alpha A p;
-        Matrix z_new = m_precond != NULL 
-             ? m_precond->call(r_new)
-             : MatrixFactory::ShallowMatrix(r_new); // z_new = P(r_new)
-        double zr = (r_new * z_new).get(0, 0);
-        double beta = zr / a_numer;                 // beta = (r_new, z_nwq)/(r, z)
-        Matrix::add(p, 1.0, z_new, beta);           // p = beta p + z_new
-        z = z_new;                                  // z = z_new
-        r = r_new;                                  // r = r_new
-        m_iterations_count++;                       // k = k + 1
-        if (m_iterations_count == m_max_iterations) {
-            keepgoing = false;
+        double beta = 0.0;
+        double alpha;
+        if (m_iterations_count > 0) {
+            beta = rz / rz_prev;
+            alpha = rz / (wz - beta * rz / alpha_prev);
+        } else {
+            alpha = rz / wz;
+        }
+        if (alpha == 0.0 || !(fabs(alpha) < INFINITY)) {
+            return ForBESUtils::STATUS_NUMERICAL_PROBLEMS;
+        }
+        if (precond) {
+            MATRIX_PARALLEL_FOR_SIMD(n)
+            for (size_t i = 0; i < n; i++) {
+                Aq[i] = APw[i] + beta * Aq[i];
+                q[i] = Pw[i] + beta * q[i];
+                s[i] = w[i] + beta * s[i];
+                p[i] = z[i] + beta * p[i];
+                x[i] += alpha * p[i];
+                r[i] -= alpha * s[i];
+                z[i] -= alpha * q[i];
+                w[i] -= alpha * Aq[i];
+            }
+        } else {
+            MATRIX_PARALLEL_FOR_SIMD(n)
+            for (size_t i = 0; i < n; i++) {
+                Aq[i] = APw[i] + beta * Aq[i];
+                s[i] = w[i] + beta * s[i];
+                p[i] = r[i] + beta * p[i];
+                x[i] += alpha * p[i];
+                r[i] -= alpha * s[i];
+                w[i] -= alpha * Aq[i];
+            }
         }
+        rz_prev = rz;
+        alpha_prev = alpha;
+        m_iterations_count++;
     }
-    if (m_iterations_count>=m_max_iterations){
+    if (m_err >= m_tolerance) {
         return ForBESUtils::STATUS_MAX_ITERATIONS_REACHED;
     }
     return ForBESUtils::STATUS_OK;
@@ -103,6 +340,3 @@ double CGSolver::last_error() const {
 size_t CGSolver::last_num_iter() const {
     return m_iterations_count;
 }
-
-
-
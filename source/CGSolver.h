@@ -59,6 +59,23 @@
  * Providing a preconditioner is optional. If no preconditioner is provided, it is 
  * assumed that \f$P\f$ is the identity operator, \f$P(x)=x\f$.
  * 
+ * The initial guess \f$x_0\f$ is zero, unless it is given explicitly using 
+ * #solve(Matrix&, Matrix&, double, Matrix) or warm starting is enabled 
+ * (see #setWarmStart), in which case it is the value of <code>solution</code>
+ * when #solve is invoked (a zero vector if it is empty). The work vectors 
+ * \f$r\f$, \f$z\f$, \f$p\f$ and \f$T(p)\f$ are allocated once and reused by
+ * subsequent invocations of #solve on systems of the same dimension; the 
+ * operators are applied in place using 
+ * \link LinearOperator::call(Matrix&, double, Matrix&, double) LinearOperator::call(y, alpha, x, gamma)\endlink,
+ * and the vector updates and inner products of every step are fused so that 
+ * each vector is traversed once.
+ * 
+ * Optionally (see #setPipelined), the pipelined variant of CG by Ghysels and
+ * Vanroose is used; it is mathematically equivalent to the above, but computes
+ * all inner products of an iteration in a single pass (one global reduction
+ * instead of two), at the cost of more work vectors and slightly
+ * different rounding errors.
+ * 
  * 
  * Systems of the form \f$Ax=b\f$, i.e., where \f$T(x)=Ax\f$ where \f$A\f$ is a 
  * Matrix can be solved using the linear operator MatrixOperator which wraps 
@@ -126,8 +143,50 @@ public:
      */
     virtual int solve(Matrix& rhs, Matrix& solution);
 
+    /**
+     * Solves the operator equation \f$T(x) = b\f$ starting from a given initial
+     * guess and with a given tolerance.
+     * 
+     * @param rhs the right-hand side of the equation
+     * @param solution the solution to be computed
+     * @param tolerance tolerance (used only for this invocation)
+     * @param guess initial guess
+     * @return status code
+     */
     int solve(Matrix& rhs, Matrix& solution, double tolerance, Matrix guess);
 
+    /**
+     * Enables or disables warm starting: if enabled, #solve(Matrix&, Matrix&)
+     * uses the incoming value of <code>solution</code> as initial guess; 
+     * otherwise it starts from zero.
+     * 
+     * @param warm_start whether the solver should be warm-started (default: 
+     * <code>false</code>)
+     */
+    void setWarmStart(bool warm_start);
+
+    /**
+     * Whether the solver is warm-started (see #setWarmStart).
+     * 
+     * @return <code>true</code> if warm starting is enabled
+     */
+    bool isWarmStart() const;
+
+    /**
+     * Enables or disables the pipelined variant of CG.
+     * 
+     * @param pipelined whether the pipelined variant should be used (default: 
+     * <code>false</code>)
+     */
+    void setPipelined(bool pipelined);
+
+    /**
+     * Whether the pipelined variant of CG is used.
+     * 
+     * @return <code>true</code> if the pipelined variant is used
+     */
+    bool isPipelined() const;
+
     /**
      * Default destructor.
      */
@@ -159,9 +218,38 @@ private:
     double m_err;
     size_t m_max_iterations;
     size_t m_iterations_count;
-    
-    
-    void init();   
+    bool m_pipelined;
+    bool m_warm_start; /**< whether solve(Matrix&, Matrix&) is warm-started */
+
+    /* work vectors (see #solve) */
+    Matrix m_r; /**< residual */
+    Matrix m_z; /**< preconditioned residual (unused without a preconditioner) */
+    Matrix m_p; /**< search direction */
+    Matrix m_Ap; /**< T(p) */
+    /* additional work vectors of pipelined CG */
+    Matrix m_w; /**< T(z) */
+    Matrix m_Pw; /**< P(w) (unused without a preconditioner) */
+    Matrix m_APw; /**< T(P(w)) */
+    Matrix m_q; /**< P(T(p)) (unused without a preconditioner) */
+    Matrix m_Aq; /**< T(P(T(p))) */
+
+    void init();
+
+    /**
+     * Allocates the work vectors, unless they already have the right size,
+     * and computes the initial residual \f$r = b - T(x)\f$ into #m_r; 
+     * unless <code>warm_start</code> is set, x is first set to zero.
+     */
+    void prepare(Matrix& b, Matrix& x, bool warm_start);
+
+    /**
+     * Runs CG from the initial guess given by <code>warm_start</code>.
+     */
+    int run(Matrix& b, Matrix& solution, bool warm_start);
+
+    int solveStandard(Matrix& x);
+
+    int solvePipelined(Matrix& x);
 
 
 protected:
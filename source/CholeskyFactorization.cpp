@@ -24,6 +24,8 @@ CholeskyFactorization::CholeskyFactorization(Matrix& matrix) :
 FactoredSolver(matrix) {
     m_L = NULL;
     m_factor = NULL;
+    m_shift = 0.0;
+    m_analyzed_nnz = 0;
     if (matrix.getNrows() != matrix.getNcols()){
         throw std::invalid_argument("CholeskyFactorization factorization can only be applied to square matrices");
     }
@@ -43,22 +45,69 @@ CholeskyFactorization::~CholeskyFactorization() {
     }
 }
 
+/* number of stored entries of a packed cholmod_sparse */
+static size_t sparse_nnz(const cholmod_sparse * A) {
+    return static_cast<size_t> (static_cast<const int*> (A->p)[A->ncol]);
+}
+
+void CholeskyFactorization::analyze() {
+    if (m_factor != NULL) {
+        cholmod_free_factor(&m_factor, Matrix::cholmod_handle());
+    }
+    m_factor = cholmod_analyze(m_matrix->m_sparse, Matrix::cholmod_handle());
+    m_analyzed_nnz = sparse_nnz(m_matrix->m_sparse);
+}
+
 int CholeskyFactorization::factorize() {
+    m_shift = 0.0;
     if (m_matrix_type == Matrix::MATRIX_SPARSE) {
         /* Cholesky decomposition of a SPARSE matrix: */
         if (m_matrix->m_sparse == NULL) {
             m_matrix->_createSparse();
         }
-        /* analyze */
-        m_factor = cholmod_analyze(m_matrix->m_sparse, Matrix::cholmod_handle());
-        /* factorize */
-        cholmod_factorize(m_matrix->m_sparse, m_factor, Matrix::cholmod_handle());
+        analyze();
+    }
+    return factorize_numeric();
+}
+
+int CholeskyFactorization::refactorize() {
+    if (m_matrix_type == Matrix::MATRIX_SPARSE) {
+        if (m_matrix->m_sparse == NULL) {
+            m_matrix->_createSparse();
+        }
+        if (m_factor == NULL || sparse_nnz(m_matrix->m_sparse) != m_analyzed_nnz) {
+            /* no analysis, or the pattern has changed */
+            analyze();
+        }
+    }
+    return factorize_numeric();
+}
+
+int CholeskyFactorization::refactorize(double beta) {
+    m_shift = beta;
+    return refactorize();
+}
+
+double CholeskyFactorization::getShift() const {
+    return m_shift;
+}
+
+int CholeskyFactorization::factorize_numeric() {
+    if (m_matrix_type == Matrix::MATRIX_SPARSE) {
+        /* numeric factorization of A + shift * I; the symbolic factor is reused */
+        double beta[2] = {m_shift, 0.0};
+        cholmod_factorize_p(m_matrix->m_sparse, beta, NULL, 0, m_factor, Matrix::cholmod_handle());
         /* Success: status = 0, else 1*/
         return (m_factor->minor == m_matrix->m_nrows) ? ForBESUtils::STATUS_OK : ForBESUtils::STATUS_NUMERICAL_PROBLEMS;
     } else { /* If this is any non-sparse matrix: */
         memcpy(m_L, m_matrix->getData(), m_matrix->length() * sizeof (double)); /* m_L := m_matrix.m_data */
         int info = ForBESUtils::STATUS_OK;
         if (m_matrix_type == Matrix::MATRIX_DENSE) { /* This is a dense matrix */
+            if (m_shift != 0.0) {
+                for (size_t j = 0; j < m_matrix_nrows; j++) {
+                    m_L[j + j * m_matrix_nrows] += m_shift;
+                }
+            }
             info = LAPACKE_dpotrf(LAPACK_COL_MAJOR, 'L', m_matrix_nrows, m_L, m_matrix_nrows);
 #ifdef SET_L_OFFDIAG_TO_ZERO
             for (size_t i = 0; i < m_matrix_nrows; i++) {
@@ -68,6 +117,12 @@ int CholeskyFactorization::factorize() {
             }
 #endif
         } else if (m_matrix_type == Matrix::MATRIX_SYMMETRIC) { /* This is a symmetric matrix */
+            if (m_shift != 0.0) {
+                /* packed lower triangular storage */
+                for (size_t j = 0; j < m_matrix_nrows; j++) {
+                    m_L[j + m_matrix_nrows * j - j * (j + 1) / 2] += m_shift;
+                }
+            }
             info = LAPACKE_dpptrf(LAPACK_COL_MAJOR, 'L', m_matrix_nrows, m_L);
         }
         return info;
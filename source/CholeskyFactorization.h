@@ -117,11 +117,66 @@ public:
      */
     virtual int solve(Matrix& rhs, Matrix& solution);
 
+    /**
+     * Recomputes the factorization of \f$A + \beta I\f$, where \f$\beta\f$ is
+     * the current shift (see #getShift), after the values of \f$A\f$ have 
+     * changed. 
+     * 
+     * For sparse matrices, the symbolic analysis (fill-reducing ordering and
+     * elimination tree) of the last call to #factorize is reused, so the 
+     * sparsity pattern of the matrix must not have changed; if the number of
+     * nonzeros has changed, or #factorize has not been called, the matrix is
+     * analyzed anew.
+     * 
+     * @return status code (see #factorize)
+     */
+    virtual int refactorize();
 
+    /**
+     * Computes the factorization of \f$A + \beta I\f$ for a new shift 
+     * \f$\beta\f$ reusing, for sparse matrices, the symbolic analysis of the
+     * last call to #factorize (see #refactorize()). Subsequent calls to 
+     * #solve solve the system \f$(A + \beta I)x = b\f$.
+     * 
+     * This is useful when systems with matrices \f$A + \beta I\f$ need to be
+     * solved for different values of \f$\beta\f$ (e.g., to compute proximal
+     * operators of quadratic functions for different values of 
+     * \f$\gamma\f$).
+     * 
+     * @param beta shift \f$\beta\f$
+     * @return status code (see #factorize)
+     */
+    int refactorize(double beta);
+
+    /**
+     * The shift \f$\beta\f$ of the factorized matrix \f$A + \beta I\f$; it is
+     * zero after #factorize.
+     * 
+     * @return shift
+     */
+    double getShift() const;
 
 private:
     double * m_L;
     cholmod_factor * m_factor;
+    /**
+     * Shift beta; the factorized matrix is A + beta * I
+     */
+    double m_shift;
+    /**
+     * Number of nonzeros of the sparse matrix when it was analyzed
+     */
+    size_t m_analyzed_nnz;
+
+    /**
+     * Symbolic analysis of the sparse matrix (replaces m_factor).
+     */
+    void analyze();
+
+    /**
+     * Numeric factorization of A + m_shift * I.
+     */
+    int factorize_numeric();
 
 };
 
@@ -0,0 +1,241 @@
+/*
+ * File:   DCTHelper.cpp
+ *
+ * ForBES is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ForBES is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with ForBES. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define _USE_MATH_DEFINES
+
+#include "DCTHelper.h"
+#include <cmath>
+#include <stdexcept>
+
+DCTHelper::DCTHelper(size_t n) : m_n(n) {
+    if (n == 0) {
+        //LCOV_EXCL_START
+        throw std::invalid_argument("DCTHelper: the length must be positive");
+        //LCOV_EXCL_STOP
+    }
+
+    /* Makhoul's post-/pre-twiddle factors exp(-i*pi*k/(2n)) */
+    m_dct_cos.resize(n);
+    m_dct_sin.resize(n);
+    for (size_t k = 0; k < n; k++) {
+        double theta = M_PI * static_cast<double> (k) / (2.0 * static_cast<double> (n));
+        m_dct_cos[k] = std::cos(theta);
+        m_dct_sin[k] = std::sin(theta);
+    }
+
+    m_bluestein = (n & (n - 1)) != 0;
+    m_fft_len = 1;
+    size_t min_len = m_bluestein ? 2 * n - 1 : n;
+    while (m_fft_len < min_len) {
+        m_fft_len <<= 1;
+    }
+
+    /* radix-2 twiddle factors and bit-reversal permutation */
+    size_t m = m_fft_len;
+    m_tw_re.resize(m / 2 + 1);
+    m_tw_im.resize(m / 2 + 1);
+    for (size_t k = 0; k < m / 2; k++) {
+        double theta = 2.0 * M_PI * static_cast<double> (k) / static_cast<double> (m);
+        m_tw_re[k] = std::cos(theta);
+        m_tw_im[k] = -std::sin(theta);
+    }
+    m_bitrev.resize(m);
+    size_t log2m = 0;
+    while ((static_cast<size_t> (1) << log2m) < m) {
+        log2m++;
+    }
+    for (size_t k = 0; k < m; k++) {
+        size_t r = 0;
+        for (size_t b = 0; b < log2m; b++) {
+            r |= ((k >> b) & 1) << (log2m - 1 - b);
+        }
+        m_bitrev[k] = r;
+    }
+
+    m_vr.resize(n);
+    m_vi.resize(n);
+
+    if (!m_bluestein) {
+        return;
+    }
+
+    /* Bluestein chirp w_k = exp(-i*pi*k^2/n); k^2 is reduced modulo 2n */
+    m_chirp_re.resize(n);
+    m_chirp_im.resize(n);
+    size_t k2 = 0;
+    for (size_t k = 0; k < n; k++) {
+        double theta = M_PI * static_cast<double> (k2) / static_cast<double> (n);
+        m_chirp_re[k] = std::cos(theta);
+        m_chirp_im[k] = -std::sin(theta);
+        k2 = (k2 + 2 * k + 1) % (2 * n);
+    }
+
+    /* FFT of the filter b_k = conj(w_k), b_{m-k} = b_k */
+    m_filter_re.assign(m, 0.0);
+    m_filter_im.assign(m, 0.0);
+    m_filter_re[0] = m_chirp_re[0];
+    m_filter_im[0] = -m_chirp_im[0];
+    for (size_t k = 1; k < n; k++) {
+        m_filter_re[k] = m_filter_re[m - k] = m_chirp_re[k];
+        m_filter_im[k] = m_filter_im[m - k] = -m_chirp_im[k];
+    }
+    fft_radix2(&m_filter_re[0], &m_filter_im[0], false);
+
+    m_wr.resize(m);
+    m_wi.resize(m);
+}
+
+DCTHelper::~DCTHelper() {
+}
+
+size_t DCTHelper::length() const {
+    return m_n;
+}
+
+void DCTHelper::fft_radix2(double* re, double* im, bool inverse) {
+    const size_t m = m_fft_len;
+    for (size_t k = 0; k < m; k++) {
+        size_t r = m_bitrev[k];
+        if (r > k) {
+            double t = re[k];
+            re[k] = re[r];
+            re[r] = t;
+            t = im[k];
+            im[k] = im[r];
+            im[r] = t;
+        }
+    }
+    const double sgn = inverse ? -1.0 : 1.0;
+    for (size_t len = 2; len <= m; len <<= 1) {
+        size_t half = len / 2;
+        size_t stride = m / len;
+        for (size_t start = 0; start < m; start += len) {
+            for (size_t j = 0; j < half; j++) {
+                double wr = m_tw_re[j * stride];
+                double wi = sgn * m_tw_im[j * stride];
+                size_t p = start + j;
+                size_t q = p + half;
+                double tr = wr * re[q] - wi * im[q];
+                double ti = wr * im[q] + wi * re[q];
+                re[q] = re[p] - tr;
+                im[q] = im[p] - ti;
+                re[p] += tr;
+                im[p] += ti;
+            }
+        }
+    }
+}
+
+void DCTHelper::fft_n(bool inverse) {
+    double * vr = &m_vr[0];
+    double * vi = &m_vi[0];
+    if (!m_bluestein) {
+        fft_radix2(vr, vi, inverse);
+        return;
+    }
+    /*
+     * Bluestein: the inverse transform is computed as the conjugate of the
+     * forward transform of the conjugate input.
+     */
+    const size_t n = m_n;
+    const size_t m = m_fft_len;
+    const double sgn = inverse ? -1.0 : 1.0;
+    for (size_t k = 0; k < n; k++) {
+        double ar = vr[k];
+        double ai = sgn * vi[k];
+        m_wr[k] = ar * m_chirp_re[k] - ai * m_chirp_im[k];
+        m_wi[k] = ar * m_chirp_im[k] + ai * m_chirp_re[k];
+    }
+    for (size_t k = n; k < m; k++) {
+        m_wr[k] = 0.0;
+        m_wi[k] = 0.0;
+    }
+    fft_radix2(&m_wr[0], &m_wi[0], false);
+    for (size_t k = 0; k < m; k++) {
+        double ar = m_wr[k];
+        double ai = m_wi[k];
+        m_wr[k] = ar * m_filter_re[k] - ai * m_filter_im[k];
+        m_wi[k] = ar * m_filter_im[k] + ai * m_filter_re[k];
+    }
+    fft_radix2(&m_wr[0], &m_wi[0], true);
+    const double scale = 1.0 / static_cast<double> (m);
+    for (size_t k = 0; k < n; k++) {
+        double ar = m_wr[k] * scale;
+        double ai = m_wi[k] * scale;
+        vr[k] = ar * m_chirp_re[k] - ai * m_chirp_im[k];
+        vi[k] = sgn * (ar * m_chirp_im[k] + ai * m_chirp_re[k]);
+    }
+}
+
+void DCTHelper::dct2(double* y, double alpha, const double* x, double gamma) {
+    const size_t n = m_n;
+    /* v = [x_0, x_2, x_4, ..., x_5, x_3, x_1] */
+    for (size_t k = 0; 2 * k < n; k++) {
+        m_vr[k] = x[2 * k];
+        m_vi[k] = 0.0;
+    }
+    for (size_t k = 0; 2 * k + 1 < n; k++) {
+        m_vr[n - 1 - k] = x[2 * k + 1];
+        m_vi[n - 1 - k] = 0.0;
+    }
+    fft_n(false);
+    /* y_k = Re(exp(-i*pi*k/(2n)) * V_k) */
+    for (size_t k = 0; k < n; k++) {
+        double yk = m_vr[k] * m_dct_cos[k] + m_vi[k] * m_dct_sin[k];
+        y[k] = gamma * y[k] + alpha * yk;
+    }
+}
+
+void DCTHelper::dct3(double* y, double alpha, const double* x, double gamma) {
+    const size_t n = m_n;
+    /* V_k = exp(i*pi*k/(2n)) * (x_k - i x_{n-k}), with x_n = 0 */
+    m_vr[0] = x[0];
+    m_vi[0] = 0.0;
+    for (size_t k = 1; k < n; k++) {
+        double a = x[k];
+        double b = x[n - k];
+        m_vr[k] = a * m_dct_cos[k] + b * m_dct_sin[k];
+        m_vi[k] = a * m_dct_sin[k] - b * m_dct_cos[k];
+    }
+    fft_n(true);
+    /* undo the even/odd permutation (the factor 1/2 accounts for x_0/2) */
+    const double a2 = 0.5 * alpha;
+    for (size_t k = 0; 2 * k < n; k++) {
+        y[2 * k] = gamma * y[2 * k] + a2 * m_vr[k];
+    }
+    for (size_t k = 0; 2 * k + 1 < n; k++) {
+        y[2 * k + 1] = gamma * y[2 * k + 1] + a2 * m_vr[n - 1 - k];
+    }
+}
+
+void DCTHelper::cosineBasis(size_t n, double* C) {
+    /* cos(pi*(2i+1)*k/(2n)) = table[(2i+1)*k mod 4n] */
+    const size_t period = 4 * n;
+    std::vector<double> table(period);
+    for (size_t j = 0; j < period; j++) {
+        table[j] = std::cos(M_PI * static_cast<double> (j) / (2.0 * static_cast<double> (n)));
+    }
+    for (size_t i = 0; i < n; i++) {
+        const size_t step = 2 * i + 1;
+        size_t idx = 0;
+        double * Ci = C + i * n;
+        for (size_t k = 0; k < n; k++) {
+            Ci[k] = table[idx];
+            idx = (idx + step) % period;
+        }
+    }
+}
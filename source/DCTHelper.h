@@ -0,0 +1,185 @@
+/*
+ * File:   DCTHelper.h
+ *
+ * ForBES is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ForBES is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with ForBES. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef DCTHELPER_H
+#define DCTHELPER_H
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * Dimension above which the DCT operators (OpDCT2 and OpDCT3) switch from the
+ * direct O(n^2) evaluation to the FFT-based one when used with
+ * DCTHelper::DCT_AUTO.
+ */
+#ifndef DCT_FFT_THRESHOLD
+#define DCT_FFT_THRESHOLD 64
+#endif
+
+/**
+ * \class DCTHelper
+ * \brief FFT-based DCT-II and DCT-III transforms of a given length
+ * \version 0.1
+ *
+ * An instance of this class is a plan for the computation of the (unnormalized)
+ * DCT-II
+ *
+ * \f[
+ * y_k = \sum_{i=0}^{n-1} x_i \cos \left[ \frac{\pi}{n}\left(i+\frac{1}{2}\right)k \right],
+ * \f]
+ *
+ * and of the DCT-III
+ *
+ * \f[
+ * y_k = \frac{x_0}{2} + \sum_{i=1}^{n-1} x_i \cos \left[ \frac{\pi}{n}i\left(k+\frac{1}{2}\right) \right],
+ * \f]
+ *
+ * of vectors of length \f$n\f$ in \f$O(n\log n)\f$ operations.
+ *
+ * Both transforms are reduced to a complex FFT of length \f$n\f$ (Makhoul's
+ * algorithm). When \f$n\f$ is a power of 2, a radix-2 FFT is used; otherwise,
+ * the FFT is computed by means of Bluestein's algorithm using a radix-2 FFT
+ * of length \f$m\geq 2n-1\f$. All twiddle factors and chirp sequences are
+ * computed once, upon construction, and are reused in every call.
+ *
+ * Instances of this class own a workspace, therefore, the same instance should
+ * not be used concurrently from different threads.
+ */
+class DCTHelper {
+public:
+
+    /**
+     * Method used to evaluate a DCT operator.
+     */
+    enum DCTMethod {
+        /**
+         * Use the FFT if the dimension is at least \c DCT_FFT_THRESHOLD,
+         * otherwise, use the direct method.
+         */
+        DCT_AUTO,
+        /**
+         * Direct O(n^2) evaluation of the cosine sums.
+         */
+        DCT_DIRECT,
+        /**
+         * FFT-based O(n log n) evaluation.
+         */
+        DCT_FFT,
+        /**
+         * Dense matrix-vector multiplication (through BLAS) with an n-by-n
+         * basis matrix which is computed once, upon construction of the
+         * operator. This requires O(n^2) memory, but involves no evaluations
+         * of trigonometric functions; it is suitable for many small transforms.
+         */
+        DCT_TABLE
+    };
+
+    /**
+     * Creates a new plan for the computation of DCTs of length \c n.
+     *
+     * @param n length of the transformed vectors
+     * @throws std::invalid_argument if n is zero
+     */
+    explicit DCTHelper(size_t n);
+
+    virtual ~DCTHelper();
+
+    /**
+     * Length of the vectors this plan applies to.
+     *
+     * @return length
+     */
+    size_t length() const;
+
+    /**
+     * Computes \f$y \leftarrow \gamma y + \alpha \mathrm{DCT2}(x)\f$, where
+     * both \c x and \c y are arrays of length #length(). Arrays \c x and \c y
+     * may not overlap.
+     *
+     * @param y output array (updated in place)
+     * @param alpha scalar \f$\alpha\f$
+     * @param x input array
+     * @param gamma scalar \f$\gamma\f$
+     */
+    void dct2(double * y, double alpha, const double * x, double gamma);
+
+    /**
+     * Computes \f$y \leftarrow \gamma y + \alpha \mathrm{DCT3}(x)\f$, where
+     * both \c x and \c y are arrays of length #length(). Arrays \c x and \c y
+     * may not overlap.
+     *
+     * @param y output array (updated in place)
+     * @param alpha scalar \f$\alpha\f$
+     * @param x input array
+     * @param gamma scalar \f$\gamma\f$
+     */
+    void dct3(double * y, double alpha, const double * x, double gamma);
+
+    /**
+     * Computes the DCT-II basis matrix \f$C\in\mathbb{R}^{n\times n}\f$ with
+     * 
+     * \f[
+     * C_{ki} = \cos \left[ \frac{\pi}{n}\left(i+\frac{1}{2}\right)k \right],
+     * \f]
+     * 
+     * so that \f$\mathrm{DCT2}(x) = Cx\f$. Only \f$4n\f$ cosines are
+     * computed; all entries of \f$C\f$ are read from this compact table.
+     * 
+     * @param n dimension
+     * @param C array of length \f$n^2\f$ where \f$C\f$ is stored in
+     * column-major order
+     */
+    static void cosineBasis(size_t n, double * C);
+
+private:
+
+    DCTHelper(const DCTHelper& orig);
+    DCTHelper& operator=(const DCTHelper& right);
+
+    /**
+     * In-place radix-2 FFT of length #m_fft_len on (re, im).
+     */
+    void fft_radix2(double * re, double * im, bool inverse);
+
+    /**
+     * In-place (unnormalized) FFT of length #m_n on (m_vr, m_vi).
+     */
+    void fft_n(bool inverse);
+
+    size_t m_n;             /**< length of the transforms */
+    size_t m_fft_len;       /**< length of the radix-2 FFT */
+    bool m_bluestein;       /**< whether the Bluestein algorithm is used */
+
+    std::vector<double> m_tw_re;        /**< radix-2 twiddle factors (real part) */
+    std::vector<double> m_tw_im;        /**< radix-2 twiddle factors (imaginary part) */
+    std::vector<size_t> m_bitrev;       /**< bit-reversal permutation */
+    std::vector<double> m_dct_cos;      /**< cos(pi*k/(2n)) */
+    std::vector<double> m_dct_sin;      /**< sin(pi*k/(2n)) */
+    std::vector<double> m_chirp_re;     /**< Bluestein chirp (real part) */
+    std::vector<double> m_chirp_im;     /**< Bluestein chirp (imaginary part) */
+    std::vector<double> m_filter_re;    /**< FFT of the Bluestein filter (real part) */
+    std::vector<double> m_filter_im;    /**< FFT of the Bluestein filter (imaginary part) */
+
+    std::vector<double> m_vr;           /**< workspace of length n (real part) */
+    std::vector<double> m_vi;           /**< workspace of length n (imaginary part) */
+    std::vector<double> m_wr;           /**< workspace of length m (real part) */
+    std::vector<double> m_wi;           /**< workspace of length m (imaginary part) */
+
+};
+
+#endif /* DCTHELPER_H */
+
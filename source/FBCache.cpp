@@ -49,11 +49,39 @@ const int FBCache::STATUS_GRAD_FBE = 5;
  * @return \c true iff \c a is approximately equal to \c b.
  */
 inline bool is_close(const double a, const double b) {
-    return abs(a - b) <= std::max(
+    return std::abs(a - b) <= std::max(
             FB_CACHE_RELATIVE_TOL * std::max(std::abs(a), std::abs(b)),
             FB_CACHE_ABSOLUTE_TOL);
 }
 
+/**
+ * Inner product of two vectors (or matrices) of the same dimensions, computed
+ * without creating any temporary matrices.
+ * 
+ * @param a first vector
+ * @param b second vector
+ * @return inner product \f$\langle a, b \rangle\f$
+ */
+inline double inner_product(Matrix& a, Matrix& b) {
+    double t = 0.0;
+    const size_t n = a.length();
+    for (size_t i = 0; i < n; i++) {
+        t += a[i] * b[i];
+    }
+    return t;
+}
+
+/**
+ * Dimensions of the residual \f$r(x) = Lx + d\f$; these are given by the 
+ * dimensions of \f$d\f$, if it is provided, or the output dimensions of 
+ * \f$L\f$, if it is provided, or the dimensions of \f$x\f$ otherwise.
+ */
+inline std::pair<size_t, size_t> residual_dimensions(LinearOperator * L, Matrix * d, Matrix& x) {
+    if (d != NULL) return std::make_pair(d->getNrows(), d->getNcols());
+    if (L != NULL) return L->blockDimensionOut(x);
+    return std::make_pair(x.getNrows(), x.getNcols());
+}
+
 void FBCache::reset(int status) {
     if (status < m_status) m_status = status;
 }
@@ -67,6 +95,41 @@ void FBCache::reset() {
     m_cached_grad_f2 = false;
 }
 
+void FBCache::set_curvature_cache(bool enabled) {
+    if (m_prob.f1() != NULL) {
+        m_prob.f1()->setCurvatureCache(enabled);
+    }
+    if (m_prob.f2() != NULL) {
+        m_prob.f2()->setCurvatureCache(enabled);
+    }
+}
+
+void FBCache::set_instrumentation(FBInstrumentation* instrumentation) {
+    m_instrumentation = instrumentation;
+}
+
+FBInstrumentation * FBCache::get_instrumentation() const {
+    return m_instrumentation;
+}
+
+int FBCache::apply_operator(LinearOperator* L, bool adjoint, Matrix& y, double alpha, Matrix& x, double gamma) {
+    if (m_instrumentation == NULL) {
+        return adjoint ? L->callAdjoint(y, alpha, x, gamma) : L->call(y, alpha, x, gamma);
+    }
+    FBInstrumentation::Scope scope(m_instrumentation, FBInstrumentation::PHASE_OPERATOR);
+    m_instrumentation->count(adjoint
+            ? FBInstrumentation::COUNT_OPERATOR_ADJOINT
+            : FBInstrumentation::COUNT_OPERATOR_CALL);
+    return adjoint ? L->callAdjoint(y, alpha, x, gamma) : L->call(y, alpha, x, gamma);
+}
+
+int FBCache::cache_hit() {
+    if (m_instrumentation != NULL) {
+        m_instrumentation->count(FBInstrumentation::COUNT_CACHE_HIT);
+    }
+    return ForBESUtils::STATUS_CACHED_ALREADY;
+}
+
 FBCache::FBCache(FBProblem & p, Matrix & x, double gamma) :
 m_prob(p),
 m_x(&x),
@@ -79,6 +142,8 @@ m_gamma(gamma) {
     m_L2d_fresh = false;
     m_fxtd_fresh = false;
     m_cached_grad_f2 = false;
+    m_has_direction = false;
+    m_instrumentation = NULL;
 
     /* set pointers to NULL */
     m_res1x = NULL;
@@ -93,6 +158,15 @@ m_gamma(gamma) {
     m_dir = NULL;
     m_L2d = NULL;
     m_Qu = NULL;
+    m_L1d = NULL;
+    m_xtd = NULL;
+    m_gradf_xtd = NULL;
+    m_ytd = NULL;
+    m_ztd = NULL;
+    m_work1a = NULL;
+    m_work1b = NULL;
+    m_work2a = NULL;
+    m_work2b = NULL;
 
     /* initialize double variables */
     m_FBEx = std::numeric_limits<double>::infinity();
@@ -103,9 +177,49 @@ m_gamma(gamma) {
     m_linx = 0.0;
     m_fx = 0.0;
     m_gz = 0.0;
+
+    allocate_workspace();
+}
+
+void FBCache::allocate_workspace() {
+    const size_t nx = m_x->getNrows();
+    const size_t mx = m_x->getNcols();
+
+    m_y = new Matrix(nx, mx);
+    m_z = new Matrix(nx, mx);
+    m_FPRx = new Matrix(nx, mx);
+    m_gradfx = new Matrix(nx, mx);
+    m_gradFBEx = new Matrix(nx, mx);
+    m_dir = new Matrix(nx, mx);
+    m_xtd = new Matrix(nx, mx);
+    m_gradf_xtd = new Matrix(nx, mx);
+    m_ytd = new Matrix(nx, mx);
+    m_ztd = new Matrix(nx, mx);
+
+    if (m_prob.f1() != NULL) {
+        std::pair<size_t, size_t> dim1 = residual_dimensions(m_prob.L1(), m_prob.d1(), *m_x);
+        /* if there are no L1, d1, allocate no memory for m_res1x */
+        m_res1x = (m_prob.L1() == NULL && m_prob.d1() == NULL) ? m_x : new Matrix(dim1);
+        m_gradf1x = new Matrix(dim1);
+        m_Qu = new Matrix(dim1);
+        m_work1a = new Matrix(dim1);
+        m_work1b = new Matrix(dim1);
+        if (m_prob.L1() != NULL) m_L1d = new Matrix(dim1);
+    }
+
+    if (m_prob.f2() != NULL) {
+        std::pair<size_t, size_t> dim2 = residual_dimensions(m_prob.L2(), m_prob.d2(), *m_x);
+        m_res2x = (m_prob.L2() == NULL && m_prob.d2() == NULL) ? m_x : new Matrix(dim2);
+        m_gradf2x = new Matrix(dim2);
+        m_work2a = new Matrix(dim2);
+        m_work2b = new Matrix(dim2);
+        /* if there is no L2, then L2*d is d itself */
+        m_L2d = (m_prob.L2() != NULL) ? new Matrix(dim2) : m_dir;
+    }
 }
 
 int FBCache::update_eval_f(bool order_grad_f2) {
+    FBInstrumentation::Scope scope(m_instrumentation, FBInstrumentation::PHASE_FUNCTION);
 
     if (!m_cached_grad_f2 && order_grad_f2) {
         // If gradf2x has not been computed previously, but now should be
@@ -114,50 +228,43 @@ int FBCache::update_eval_f(bool order_grad_f2) {
         m_status = STATUS_NONE;
     }
 
-    if (m_status >= STATUS_EVALF) return ForBESUtils::STATUS_CACHED_ALREADY;
+    if (m_status >= STATUS_EVALF) return cache_hit();
+
+    int status;
 
     if (m_prob.f1() != NULL) {
         // quadratic
 
-        /* Compute the residual m_res1x (allocate mem if necessary) */
-        if (m_prob.L1() == NULL && m_prob.d1() == NULL) {
-            /* if there are no L1, d1, allocate no memory for m_res1x */
-            m_res1x = m_x;
-        } else {
-            /* if at least one of L1, d1 is defined, allocate memory for m_resx1 */
-            if (m_prob.d1() != NULL) {
-                /* if there is a d1, use it to get the dimensions */
-                m_res1x = new Matrix(m_prob.d1()->getNrows(), m_prob.d1()->getNcols());
-            }
+        /* Compute the residual m_res1x = L1*x + d1 (unless it is x itself) */
+        if (m_res1x != m_x) {
             if (m_prob.L1() != NULL) {
-                /* if there is an L1, and there has been no d1, use L1 to get the dimensions */
-                if (m_res1x == NULL) m_res1x = new Matrix(m_prob.L1()->dimensionOut());
-                /* If L1 is defined, compute L1[x] */
-                *m_res1x = m_prob.L1()->call(*m_x);
+                status = apply_operator(m_prob.L1(), false, *m_res1x, 1.0, *m_x, 0.0);
+                if (ForBESUtils::is_status_error(status)) return status;
+            } else {
+                *m_res1x = *m_x;
             }
-            if (m_prob.d1() != NULL) *m_res1x += *m_prob.d1();
+            if (m_prob.d1() != NULL) Matrix::add(*m_res1x, 1.0, *m_prob.d1(), 1.0);
         }
-        if (m_gradf1x == NULL) m_gradf1x = new Matrix(m_res1x->getNrows(), m_res1x->getNcols());
-        int call_status = m_prob.f1()->call(*m_res1x, m_f1x, *m_gradf1x);
-        if (ForBESUtils::is_status_error(call_status)) return call_status;
+        count_call(FBInstrumentation::COUNT_FUNCTION_CALL);
+        status = m_prob.f1()->call(*m_res1x, m_f1x, *m_gradf1x);
+        if (ForBESUtils::is_status_error(status)) return status;
 
     }
 
     if (m_prob.f2() != NULL) {
 
-        if (m_prob.L2() == NULL && m_prob.d2() == NULL) {
-            m_res2x = m_x;
-        } else {
-            if (m_prob.d2() != NULL) m_res1x = new Matrix(m_prob.d2()->getNrows(), m_prob.d2()->getNcols());
+        if (m_res2x != m_x) {
             if (m_prob.L2() != NULL) {
-                if (m_res2x == NULL) m_res2x = new Matrix(m_prob.L2()->dimensionOut());
-                *m_res2x = m_prob.L2()->call(*m_x);
+                status = apply_operator(m_prob.L2(), false, *m_res2x, 1.0, *m_x, 0.0);
+                if (ForBESUtils::is_status_error(status)) return status;
+            } else {
+                *m_res2x = *m_x;
             }
-            if (m_prob.d2() != NULL) *m_res2x += *m_prob.d2();
+            if (m_prob.d2() != NULL) Matrix::add(*m_res2x, 1.0, *m_prob.d2(), 1.0);
         }
-        if (m_gradf2x == NULL) m_gradf2x = new Matrix(m_res2x->getNrows(), m_res2x->getNcols());
 
-        int status =
+        count_call(FBInstrumentation::COUNT_FUNCTION_CALL);
+        status =
                 order_grad_f2
                 ? m_prob.f2()->call(*m_res2x, m_f2x, *m_gradf2x)
                 : m_prob.f2()->call(*m_res2x, m_f2x);
@@ -167,7 +274,7 @@ int FBCache::update_eval_f(bool order_grad_f2) {
     }
 
     if (m_prob.lin() != NULL) {
-        m_linx = ((*m_prob.lin()) * (*m_x))[0];
+        m_linx = inner_product(*m_prob.lin(), *m_x);
     }
 
     m_fx = m_f1x + m_f2x + m_linx;
@@ -177,9 +284,7 @@ int FBCache::update_eval_f(bool order_grad_f2) {
 }
 
 int FBCache::update_forward_step(double gamma) {
-
-    if (m_y == NULL) m_y = new Matrix();
-    if (m_gradfx == NULL) m_gradfx = new Matrix(m_x->getNrows(), m_x->getNcols());
+    FBInstrumentation::Scope scope(m_instrumentation, FBInstrumentation::PHASE_FUNCTION);
 
     bool is_gamma_the_same = is_close(gamma, m_gamma);
 
@@ -199,7 +304,7 @@ int FBCache::update_forward_step(double gamma) {
          * If we are at STATUS_FORWARD or higher, and gamma has not changed,
          * the forward step is cached and fresh.
          */
-        if (is_gamma_the_same) return ForBESUtils::STATUS_CACHED_ALREADY;
+        if (is_gamma_the_same) return cache_hit();
         /*
          * If gamma has changed, but the gradient of f at x is stored, do
          * the following:
@@ -218,34 +323,42 @@ int FBCache::update_forward_step(double gamma) {
         if (ForBESUtils::is_status_error(status)) return status;
     }
 
+    /* 
+     * gradfx = L1'*gradf1x + L2'*gradf2x + lin; the first term which is 
+     * present overwrites gradfx and the rest are accumulated
+     */
+    bool is_gradfx_set = false;
+
     if (m_prob.f1() != NULL) {
         if (m_prob.L1()) {
-            Matrix d_gradfx = m_prob.L1()->callAdjoint(*m_gradf1x);
-            *m_gradfx = d_gradfx;
+            status = apply_operator(m_prob.L1(), true, *m_gradfx, 1.0, *m_gradf1x, 0.0);
+            if (ForBESUtils::is_status_error(status)) return status;
         } else {
             *m_gradfx = *m_gradf1x;
         }
+        is_gradfx_set = true;
     }
 
     if (m_prob.f2() != NULL) {
         if (!m_cached_grad_f2) {
+            count_call(FBInstrumentation::COUNT_FUNCTION_CALL);
             status = m_prob.f2()->call(*m_res2x, m_f2x, *m_gradf2x);
             if (ForBESUtils::is_status_error(status)) return status;
             // now gradf2x has been computed:
             m_cached_grad_f2 = true;
         }
         if (m_prob.L2() != NULL) {
-            Matrix d_gradfx = m_prob.L2()->callAdjoint(*m_gradf2x);
-            if (m_prob.f1() != NULL) *m_gradfx += d_gradfx;
-            else *m_gradfx = d_gradfx;
+            status = apply_operator(m_prob.L2(), true, *m_gradfx, 1.0, *m_gradf2x, is_gradfx_set ? 1.0 : 0.0);
+            if (ForBESUtils::is_status_error(status)) return status;
         } else {
-            if (m_prob.f1() != NULL) *m_gradfx += *m_gradf2x;
+            if (is_gradfx_set) *m_gradfx += *m_gradf2x;
             else *m_gradfx = *m_gradf2x;
         }
+        is_gradfx_set = true;
     }
 
     if (m_prob.lin()) {
-        if (m_prob.f1() != NULL || m_prob.f2() != NULL) {
+        if (is_gradfx_set) {
             *m_gradfx += (*m_prob.lin());
         } else {
             *m_gradfx = *m_prob.lin();
@@ -262,16 +375,13 @@ int FBCache::update_forward_step(double gamma) {
 }
 
 int FBCache::update_forward_backward_step(double gamma) {
+    FBInstrumentation::Scope scope(m_instrumentation, FBInstrumentation::PHASE_PROX);
     int status;
 
-    /* Allocate memory if necessary */
-    if (m_z == NULL) m_z = new Matrix(m_x->getNrows(), m_x->getNcols());
-    if (m_FPRx == NULL) m_FPRx = new Matrix();
-
     if (!is_close(gamma, m_gamma)) {
         reset(STATUS_EVALF);
     }
-    if (m_status >= STATUS_FORWARDBACKWARD) return ForBESUtils::STATUS_CACHED_ALREADY;
+    if (m_status >= STATUS_FORWARDBACKWARD) return cache_hit();
     if (m_status < STATUS_FORWARD) {
         status = update_forward_step(gamma);
         if (ForBESUtils::is_status_error(status)) {
@@ -279,10 +389,13 @@ int FBCache::update_forward_backward_step(double gamma) {
         }
     }
 
+    count_call(FBInstrumentation::COUNT_PROX_CALL);
     status = m_prob.g()->callProx(*m_y, gamma, *m_z, m_gz);
     if (ForBESUtils::is_status_error(status)) return status;
 
-    *m_FPRx = (*m_x - *m_z);
+    /* FPR = x - z */
+    *m_FPRx = *m_x;
+    Matrix::add(*m_FPRx, -1.0, *m_z, 1.0);
     m_sqnormFPRx = std::pow(m_FPRx->norm_fro(), 2);
     m_gamma = gamma;
     m_status = STATUS_FORWARDBACKWARD;
@@ -291,11 +404,12 @@ int FBCache::update_forward_backward_step(double gamma) {
 }
 
 int FBCache::update_eval_FBE(double gamma) {
+    FBInstrumentation::Scope scope(m_instrumentation, FBInstrumentation::PHASE_FUNCTION);
     if (!is_close(gamma, m_gamma)) {
         reset(STATUS_EVALF);
     }
 
-    if (m_status >= STATUS_FBE) return ForBESUtils::STATUS_CACHED_ALREADY;
+    if (m_status >= STATUS_FBE) return cache_hit();
 
     if (m_status < STATUS_FORWARDBACKWARD) {
         int status = update_forward_backward_step(gamma);
@@ -304,8 +418,7 @@ int FBCache::update_eval_FBE(double gamma) {
         }
     }
 
-    Matrix innprox_mat = (*m_FPRx) * (*m_gradfx);
-    double innprod = innprox_mat[0];
+    double innprod = inner_product(*m_FPRx, *m_gradfx);
 
     m_FBEx = m_fx + m_gz - innprod + 0.5 / m_gamma*m_sqnormFPRx;
     m_gamma = gamma;
@@ -315,11 +428,10 @@ int FBCache::update_eval_FBE(double gamma) {
 }
 
 int FBCache::update_grad_FBE(double gamma) {
+    FBInstrumentation::Scope scope(m_instrumentation, FBInstrumentation::PHASE_FUNCTION);
     if (!is_close(gamma, m_gamma)) reset(STATUS_EVALF);
 
-    if (m_gradFBEx == NULL) m_gradFBEx = new Matrix();
-
-    if (m_status >= STATUS_GRAD_FBE) return ForBESUtils::STATUS_CACHED_ALREADY;
+    if (m_status >= STATUS_GRAD_FBE) return cache_hit();
 
     if (m_status < STATUS_FORWARDBACKWARD) {
         int status = update_forward_backward_step(gamma);
@@ -328,35 +440,30 @@ int FBCache::update_grad_FBE(double gamma) {
 
     *m_gradFBEx = *m_FPRx;
 
+    /*
+     * gradFBE = FPR/gamma - L1'*H1*L1*FPR - L2'*H2*L2*FPR, where the first
+     * Hessian product which is present also scales gradFBE by 1/gamma
+     */
     if (m_prob.f1() != NULL) {
         if (m_prob.L1() != NULL) {
-            Matrix v1(m_prob.L1()->dimensionOut());
-            v1 = m_prob.L1()->call(*m_FPRx);
-            Matrix v2(m_prob.L1()->dimensionOut());
-            m_prob.f1()->hessianProduct(*m_res1x, v1, v2);
-            v1 = m_prob.L1()->callAdjoint(v2);
-            Matrix::add(*m_gradFBEx, -1.0, v1, 1.0 / gamma);
+            apply_operator(m_prob.L1(), false, *m_work1a, 1.0, *m_FPRx, 0.0);
+            m_prob.f1()->hessianProduct(*m_res1x, *m_work1a, *m_work1b);
+            apply_operator(m_prob.L1(), true, *m_gradFBEx, -1.0, *m_work1b, 1.0 / gamma);
         } else {
-            Matrix v1(m_x->getNrows(), m_x->getNcols());
-            m_prob.f1()->hessianProduct(*m_x, *m_FPRx, v1);
-            Matrix::add(*m_gradFBEx, -1.0, v1, 1.0 / gamma);
+            m_prob.f1()->hessianProduct(*m_res1x, *m_FPRx, *m_work1b);
+            Matrix::add(*m_gradFBEx, -1.0, *m_work1b, 1.0 / gamma);
         }
     }
 
     if (m_prob.f2() != NULL) {
+        double scale = (m_prob.f1() != NULL) ? 1.0 : 1.0 / gamma;
         if (m_prob.L2() != NULL) {
-            Matrix v1(m_prob.L2()->dimensionOut());
-            v1 = m_prob.L2()->call(*m_FPRx);
-            Matrix v2(m_prob.L2()->dimensionOut());
-            m_prob.f2()->hessianProduct(*m_res2x, v1, v2);
-            v1 = m_prob.L2()->callAdjoint(v2);
-            if (m_prob.f1() != NULL) Matrix::add(*m_gradFBEx, -1.0, v1, 1.0);
-            else Matrix::add(*m_gradFBEx, -1.0, v1, 1.0 / gamma);
+            apply_operator(m_prob.L2(), false, *m_work2a, 1.0, *m_FPRx, 0.0);
+            m_prob.f2()->hessianProduct(*m_res2x, *m_work2a, *m_work2b);
+            apply_operator(m_prob.L2(), true, *m_gradFBEx, -1.0, *m_work2b, scale);
         } else {
-            Matrix v1(m_x->getNrows(), m_x->getNcols());
-            m_prob.f2()->hessianProduct(*m_x, *m_FPRx, v1);
-            if (m_prob.f1() != NULL) Matrix::add(*m_gradFBEx, -1.0, v1, 1.0);
-            else Matrix::add(*m_gradFBEx, -1.0, v1, 1.0 / gamma);
+            m_prob.f2()->hessianProduct(*m_res2x, *m_FPRx, *m_work2b);
+            Matrix::add(*m_gradFBEx, -1.0, *m_work2b, scale);
         }
     }
 
@@ -380,11 +487,9 @@ Matrix * FBCache::get_point() {
 }
 
 void FBCache::set_direction(Matrix& d) {
-    /* the first time this method is called, allocate memory */
-    if (m_dir == NULL) {
-        m_dir = new Matrix();
-    }
+    /* copy d into the preallocated direction */
     *m_dir = d;
+    m_has_direction = true;
     m_betas_fresh = false;
     m_lind_fresh = false;
     m_L2d_fresh = false;
@@ -393,7 +498,7 @@ void FBCache::set_direction(Matrix& d) {
 }
 
 Matrix* FBCache::get_direction() {
-    return m_dir;
+    return m_has_direction ? m_dir : NULL;
 }
 
 double FBCache::get_eval_FBE(double gamma) {
@@ -440,6 +545,7 @@ double FBCache::get_norm_fpr() {
 }
 
 int FBCache::extrapolate_fbe(double tau, double gamma, double& fbe) {
+    FBInstrumentation::Scope scope(m_instrumentation, FBInstrumentation::PHASE_LINE_SEARCH);
     fbe = 0.0;
 
     /* if tau has changed, set m_fxtd_fresh to false */
@@ -447,47 +553,48 @@ int FBCache::extrapolate_fbe(double tau, double gamma, double& fbe) {
     m_tau = tau;
     
     /* compute x_tau_d = x + tau*d */
-    Matrix x_tau_d(m_x->getNrows(), m_x->getNcols());
-    int status = xtd(tau, x_tau_d);
+    int status = xtd(tau, *m_xtd);
     if (ForBESUtils::is_status_error(status)) return status;
 
     /* compute the gradient of f at x + tau*d (and f(x+tau*d)*/
-    Matrix grad_xtd;
-    status = extrapolate_gradf(tau, grad_xtd);
+    status = extrapolate_gradf(tau, *m_gradf_xtd);
     if (ForBESUtils::is_status_error(status)) return status;
 
     /* Update FBE (1) */
     fbe = m_fxtd;
 
     /* Compute y(x+tau*d) = x_tau_d - gamma*gradf_xtd */
-    Matrix y_xtd = x_tau_d;
-    Matrix::add(y_xtd, -gamma, grad_xtd, 1.0);
+    *m_ytd = *m_xtd;
+    Matrix::add(*m_ytd, -gamma, *m_gradf_xtd, 1.0);
 
     /* Compute z(x+tau*d) = prox_(gamma*g)(y_xtd)*/
     double g_z_xtd; // g(z(x+tau*d))
-    Matrix z_xtd(y_xtd.getNrows(), y_xtd.getNcols()); // z(x+tau*d)
-    status = m_prob.g()->callProx(y_xtd, gamma, z_xtd, g_z_xtd);
+    {
+        FBInstrumentation::Scope prox_scope(m_instrumentation, FBInstrumentation::PHASE_PROX);
+        count_call(FBInstrumentation::COUNT_PROX_CALL);
+        status = m_prob.g()->callProx(*m_ytd, gamma, *m_ztd, g_z_xtd);
+    }
     if (ForBESUtils::is_status_error(status)) return status;
 
     /* Update FBE (2) */
     fbe += g_z_xtd;
 
-    /* Compute the FPR(x+tau*d) = x + tau*d - z(x+tau*d) */
-    Matrix * fpr;
-    fpr = &z_xtd;
-    Matrix::add(*fpr, 1.0, x_tau_d, -1.0);
+    /* Compute the FPR(x+tau*d) = x + tau*d - z(x+tau*d) (stored in m_ztd) */
+    Matrix * fpr = m_ztd;
+    Matrix::add(*fpr, 1.0, *m_xtd, -1.0);
 
     /* Update FBE (3) */
     fbe += std::pow(fpr->norm_fro(), 2) * 0.5 / gamma;
 
     /* Update FBE (4) */
-    fbe -= (grad_xtd * (*fpr))[0];
+    fbe -= inner_product(*m_gradf_xtd, *fpr);
 
     return ForBESUtils::STATUS_OK;
 }
 
 int FBCache::extrapolate_f1(double tau, double& fxtd) {
-    if (m_dir == NULL) return ForBESUtils::STATUS_CACHE_NO_DIRECTION;
+    FBInstrumentation::Scope scope(m_instrumentation, FBInstrumentation::PHASE_LINE_SEARCH);
+    if (!m_has_direction) return ForBESUtils::STATUS_CACHE_NO_DIRECTION;
     if (m_prob.f1() == NULL) {
         fxtd = 0.0;
         return ForBESUtils::STATUS_CACHE_NO_QUADRATIC;
@@ -495,17 +602,17 @@ int FBCache::extrapolate_f1(double tau, double& fxtd) {
     if (m_status < STATUS_EVALF) update_eval_f(false);
 
     if (!m_betas_fresh) {
-        Matrix * u; /* should we cache this? */
+        Matrix * u;
         if (m_prob.L1() != NULL) {
-            u = new Matrix();
-            *u = m_prob.L1()->call(*m_dir);
+            u = m_L1d;
+            int status = apply_operator(m_prob.L1(), false, *u, 1.0, *m_dir, 0.0);
+            if (ForBESUtils::is_status_error(status)) return status;
         } else {
             u = m_dir;
         }
-        m_beta1 = static_cast<Matrix> ((*u)*(*m_gradf1x))[0];
-        if (m_Qu == NULL) m_Qu = new Matrix();
+        m_beta1 = inner_product(*u, *m_gradf1x);
         m_prob.f1()->hessianProduct(*m_x, *u, *m_Qu);
-        m_beta2 = static_cast<Matrix> ((*u) * (*m_Qu))[0] / 2;
+        m_beta2 = inner_product(*u, *m_Qu) / 2;
         m_betas_fresh = true; /* beta1 and beta2 are now cached */
     }
 
@@ -516,11 +623,12 @@ int FBCache::extrapolate_f1(double tau, double& fxtd) {
 }
 
 int FBCache::extrapolate_f(double tau, double& fxtd) {
-    if (m_dir == NULL) return ForBESUtils::STATUS_CACHE_NO_DIRECTION;
+    FBInstrumentation::Scope scope(m_instrumentation, FBInstrumentation::PHASE_LINE_SEARCH);
+    if (!m_has_direction) return ForBESUtils::STATUS_CACHE_NO_DIRECTION;
     if (m_status < STATUS_EVALF) update_eval_f(false);
     if (m_fxtd_fresh && !isinf(m_tau) && is_close(tau, m_tau)) {
         fxtd = m_fxtd;
-        return ForBESUtils::STATUS_CACHED_ALREADY;
+        return cache_hit();
     }
     int status;
     fxtd = 0.0;
@@ -535,7 +643,7 @@ int FBCache::extrapolate_f(double tau, double& fxtd) {
         fxtd += m_linx;
         if (!m_lind_fresh) {
             /* compute and cache the inner product (lin,d) */
-            m_lind = ((*m_prob.lin())*(*m_dir))[0];
+            m_lind = inner_product(*m_prob.lin(), *m_dir);
             m_lind_fresh = true;
         }
         fxtd += (tau * m_lind);
@@ -544,19 +652,18 @@ int FBCache::extrapolate_f(double tau, double& fxtd) {
     /* += f2(r2(x) + tau * L2[d]) */
     if (m_prob.f2() != NULL) {
         if (!m_L2d_fresh) {
+            /* if L2 is not defined, m_L2d points to m_dir */
             if (m_prob.L2() != NULL) {
-                m_L2d = new Matrix();
-                *m_L2d = m_prob.L2()->call(*m_dir);
-            } else {
-                /* careful how you delete this later... */
-                m_L2d = m_dir;
+                status = apply_operator(m_prob.L2(), false, *m_L2d, 1.0, *m_dir, 0.0);
+                if (ForBESUtils::is_status_error(status)) return status;
             }
             m_L2d_fresh = true;
         }
-        Matrix r2xtd(*m_res2x);
-        Matrix::add(r2xtd, tau, *m_L2d, 1.0);
+        *m_work2a = *m_res2x;
+        Matrix::add(*m_work2a, tau, *m_L2d, 1.0);
         double f2val = 0.0;
-        status = m_prob.f2()->call(r2xtd, f2val);
+        count_call(FBInstrumentation::COUNT_FUNCTION_CALL);
+        status = m_prob.f2()->call(*m_work2a, f2val);
         if (ForBESUtils::is_status_error(status)) return status;
         fxtd += f2val;
     }
@@ -567,8 +674,9 @@ int FBCache::extrapolate_f(double tau, double& fxtd) {
 }
 
 int FBCache::extrapolate_gradf(double tau, Matrix& grad_xtd) {
+    FBInstrumentation::Scope scope(m_instrumentation, FBInstrumentation::PHASE_LINE_SEARCH);
     int status;
-    if (m_dir == NULL) return ForBESUtils::STATUS_CACHE_NO_DIRECTION;
+    if (!m_has_direction) return ForBESUtils::STATUS_CACHE_NO_DIRECTION;
 
     /* 
      * this ensures that extrapolate_f has been previously invoked and that 
@@ -580,37 +688,48 @@ int FBCache::extrapolate_gradf(double tau, Matrix& grad_xtd) {
         if (ForBESUtils::is_status_error(status)) return status;
     }
 
+    if (grad_xtd.getNrows() != m_x->getNrows() || grad_xtd.getNcols() != m_x->getNcols()) {
+        grad_xtd = Matrix(m_x->getNrows(), m_x->getNcols());
+    }
+
+    bool is_grad_set = false;
+
     /* Gradient of f1(r1(x+tau*d)) */
-    /* __gradf1_xtd : grad_f1(r1(x)) + tau * (Q*u) */
+    /* m_work1a : grad_f1(r1(x)) + tau * (Q*u) */
     if (m_prob.f1() != NULL) {
         // gradient of quadratic
-        Matrix __gradf1_xtd = *m_gradf1x;
-        Matrix::add(__gradf1_xtd, tau, *m_Qu, 1.0);
+        *m_work1a = *m_gradf1x;
+        Matrix::add(*m_work1a, tau, *m_Qu, 1.0);
         if (m_prob.L1() == NULL) {
-            grad_xtd = __gradf1_xtd;
+            grad_xtd = *m_work1a;
         } else {
-            grad_xtd = m_prob.L1()->callAdjoint(__gradf1_xtd);
+            status = apply_operator(m_prob.L1(), true, grad_xtd, 1.0, *m_work1a, 0.0);
+            if (ForBESUtils::is_status_error(status)) return status;
         }
+        is_grad_set = true;
     }
     /* Add the constant term (m_lin) */
     if (m_prob.lin() != NULL) {
-        grad_xtd += *m_prob.lin();
+        if (is_grad_set) grad_xtd += *m_prob.lin();
+        else grad_xtd = *m_prob.lin();
+        is_grad_set = true;
     }
 
     /* Non-quadratic */
     if (m_prob.f2() != NULL) {
-        /* __res2_xtd = m_res2x + tau * L2*d   */
-        Matrix __res2_xtd = *m_res2x;
-        Matrix::add(__res2_xtd, tau, *m_L2d, 1.0);
+        /* m_work2a = m_res2x + tau * L2*d   */
+        *m_work2a = *m_res2x;
+        Matrix::add(*m_work2a, tau, *m_L2d, 1.0);
         double f2_xtd_temp;
-        Matrix gradf2_xtd(2, 1);
-        status = m_prob.f2()->call(__res2_xtd, f2_xtd_temp, gradf2_xtd);
+        count_call(FBInstrumentation::COUNT_FUNCTION_CALL);
+        status = m_prob.f2()->call(*m_work2a, f2_xtd_temp, *m_work2b);
         if (ForBESUtils::is_status_error(status)) return status;
         if (m_prob.L2() != NULL) {
-            Matrix f = m_prob.L2()->callAdjoint(gradf2_xtd);
-            grad_xtd += f;
+            status = apply_operator(m_prob.L2(), true, grad_xtd, 1.0, *m_work2b, is_grad_set ? 1.0 : 0.0);
+            if (ForBESUtils::is_status_error(status)) return status;
         } else {
-            grad_xtd += gradf2_xtd;
+            if (is_grad_set) grad_xtd += *m_work2b;
+            else grad_xtd = *m_work2b;
         }
 
     }
@@ -620,60 +739,32 @@ int FBCache::extrapolate_gradf(double tau, Matrix& grad_xtd) {
 }
 
 int FBCache::xtd(double tau, Matrix& xtd_matrix) {
-    if (m_dir == NULL) return ForBESUtils::STATUS_CACHE_NO_DIRECTION;
+    if (!m_has_direction) return ForBESUtils::STATUS_CACHE_NO_DIRECTION;
     xtd_matrix = *m_x;
     Matrix::add(xtd_matrix, tau, *m_dir, 1.0);
     return ForBESUtils::STATUS_OK;
 }
 
 FBCache::~FBCache() {
-    if (m_z != NULL) {
-        delete m_z;
-        m_z = NULL;
-    }
-    if (m_y != NULL) {
-        delete m_y;
-        m_y = NULL;
-    }
-    if (m_res2x != NULL && m_res2x != m_x) {
-        delete m_res2x;
-        m_res2x = NULL;
-    }
-    if (m_gradf2x != NULL) {
-        delete m_gradf2x;
-        m_gradf2x = NULL;
-    }
-    /* if both L1 and d1 are NULL, there has been no mem alloc for m_res1x*/
-    if (m_res1x != NULL && (m_prob.L1() != NULL || m_prob.d1() != NULL)) {
-        delete m_res1x;
-        m_res1x = NULL;
-    }
-    if (m_gradf1x != NULL) {
-        delete m_gradf1x;
-        m_gradf1x = NULL;
-    }
-    if (m_gradfx != NULL) {
-        delete m_gradfx;
-        m_gradfx = NULL;
-    }
-    if (m_FPRx != NULL) {
-        delete m_FPRx;
-        m_FPRx = NULL;
-    }
-    if (m_gradFBEx != NULL) {
-        delete m_gradFBEx;
-        m_gradFBEx = NULL;
-    }
-    if (m_dir != NULL) {
-        delete m_dir;
-        m_dir = NULL;
-    }
-    if (m_L2d != NULL && m_L2d != m_dir) {
-        delete m_L2d;
-        m_L2d = NULL;
-    }
-    if (m_Qu != NULL) {
-        delete m_Qu;
-        m_Qu = NULL;
+    /* m_res1x, m_res2x may point to m_x and m_L2d may point to m_dir */
+    if (m_res1x != NULL && m_res1x != m_x) delete m_res1x;
+    if (m_res2x != NULL && m_res2x != m_x) delete m_res2x;
+    if (m_L2d != NULL && m_L2d != m_dir) delete m_L2d;
+    m_res1x = NULL;
+    m_res2x = NULL;
+    m_L2d = NULL;
+
+    Matrix ** workspace[] = {
+        &m_y, &m_z, &m_FPRx, &m_gradfx, &m_gradFBEx, &m_dir,
+        &m_xtd, &m_gradf_xtd, &m_ytd, &m_ztd,
+        &m_gradf1x, &m_Qu, &m_L1d, &m_work1a, &m_work1b,
+        &m_gradf2x, &m_work2a, &m_work2b
+    };
+    const size_t n_workspace = sizeof (workspace) / sizeof (workspace[0]);
+    for (size_t i = 0; i < n_workspace; i++) {
+        if (*workspace[i] != NULL) {
+            delete *workspace[i];
+            *workspace[i] = NULL;
+        }
     }
 }
@@ -23,6 +23,7 @@
 
 #include "Matrix.h"
 #include "FBProblem.h"
+#include "FBInstrumentation.h"
 
 /**
  * \class FBCache
@@ -36,6 +37,13 @@
  * It allows to evaluate the proximal-gradient operation starting from x,
  * and the value of the forward-backward envelope function (FBE) associated
  * with p.
+ * 
+ * All internal matrices are allocated once, upon construction, and their
+ * dimensions are determined by the dimensions of \f$x\f$ and those of the
+ * linear operators \f$L_1\f$, \f$L_2\f$ (or the vectors \f$d_1\f$, \f$d_2\f$)
+ * of the problem. Subsequent calls to #set_point and #set_direction and all 
+ * computations performed by the cache reuse this workspace and do not 
+ * allocate memory (provided that the operators of the problem do not).
  */
 class FBCache {
 private:
@@ -68,6 +76,16 @@ private:
     Matrix * m_dir; /**< direction (d). */
     Matrix * m_L2d; /**< Matrix v = L2[d] cached to facilitate the extrapolation on f2 */
     Matrix * m_Qu; /**< Q*L1[d] */
+    Matrix * m_L1d; /**< u = L1[d] (workspace, only if L1 is defined) */
+    Matrix * m_xtd; /**< x + tau*d (workspace) */
+    Matrix * m_gradf_xtd; /**< nabla f(x + tau*d) (workspace) */
+    Matrix * m_ytd; /**< forward step at x + tau*d (workspace) */
+    Matrix * m_ztd; /**< forward-backward step at x + tau*d (workspace) */
+    Matrix * m_work1a; /**< workspace of the dimension of res1x */
+    Matrix * m_work1b; /**< workspace of the dimension of res1x */
+    Matrix * m_work2a; /**< workspace of the dimension of res2x */
+    Matrix * m_work2b; /**< workspace of the dimension of res2x */
+    bool m_has_direction; /**< whether a direction has been provided */
     double m_f1x; /**< f1(res1x) */
     double m_f2x; /**< f2(res2x) */
     double m_linx; /**< l'*x */
@@ -81,6 +99,40 @@ private:
     double m_beta2; /**< Parameter used to determin f1(x+tau*d) - see #f1_extrapolate */
     double m_tau; /**< tau */
     double m_fxtd; /**< cached value of f(x+tau*d) which is fresh if <code>m_fxtd_fresh == true</code> */
+    FBInstrumentation * m_instrumentation; /**< observer of the cache (or NULL) */
+
+    /**
+     * Allocates all internal matrices (the workspace of the cache). Their
+     * dimensions are determined by the underlying FBProblem and the point x.
+     */
+    void allocate_workspace();
+
+    /**
+     * Computes \f$y \leftarrow \gamma y + \alpha L x\f$ or, if 
+     * <code>adjoint</code> is \c true, \f$y \leftarrow \gamma y + \alpha L^* x\f$;
+     * the call is recorded by the instrumentation (if any).
+     */
+    int apply_operator(LinearOperator * L, bool adjoint, Matrix& y, double alpha, Matrix& x, double gamma);
+
+    /**
+     * Records a cache hit and returns \link ForBESUtils::STATUS_CACHED_ALREADY
+     * STATUS_CACHED_ALREADY\endlink.
+     */
+    int cache_hit();
+
+    /**
+     * Records an invocation of a Function method (if instrumentation is 
+     * enabled).
+     */
+    void count_call(FBInstrumentation::Counter counter) {
+        if (m_instrumentation != NULL) m_instrumentation->count(counter);
+    }
+
+    /*
+     * FBCache objects own their workspace and cannot be copied.
+     */
+    FBCache(const FBCache& orig);
+    FBCache& operator=(const FBCache& right);
 
 protected:
     
@@ -115,34 +167,6 @@ protected:
      */
     int extrapolate_f1(double tau, double& fxtd);
 
-    /**
-     * Computes \f$f(x+\tau d)\f$ for the stored values of \f$x\f$ and \f$d\f$.
-     * 
-     * It uses the formula
-     * 
-     * \f[
-     *  f(x+\tau d) = f_1(r_1(x+\tau d)) + \langle l, x\rangle + 
-     *    \tau \langle l, d\rangle + f_2(r_2(x) + \tau v),
-     * \f]
-     * 
-     * where \f$v=L_2 d\f$ and \f$f_1(r_1(x+\tau d))\f$ is computed using 
-     * #extrapolate_f1.
-     * 
-     * \post After successful completion, the \link #cache_status status \endlink 
-     * of the cache will be at least #STATUS_EVALF.
-     * 
-     * @param tau scalar parameter \f$\tau\f$
-     * @param fxtd result \f$f(x+\tau d)\f$ for the given \f$\tau\f$
-     * @return status code: returns \link ForBESUtils::STATUS_OK STATUS_OK\endlink 
-     * if the method has succeeded, \link ForBESUtils::STATUS_CACHE_NO_DIRECTION 
-     * STATUS_CACHE_NO_DIRECTION\endlink if no direction \f$d\f$ is provided.
-     * 
-     * \sa extrapolate_f1
-     * \sa extrapolate_gradf
-     * \sa extrapolate_fbe
-     */
-    int extrapolate_f(double tau, double& fxtd);
-
     /**
      * Computes the gradient of \f$f\f$ at \f$x+\tau d\f$ that is \f$\nabla f(x+\tau d)\f$
      * for the stored values of \f$x\f$ and \f$d\f$.
@@ -362,8 +386,8 @@ public:
      * Passes a new direction to the current modifiable cache which is cached 
      * internally.
      * 
-     * \note Before this method is invoked for the first time, no memory is allocated
-     * for the direction.
+     * \note The direction is copied into the internal workspace of the cache,
+     * so \c d must have the same dimensions as \f$x\f$.
      * 
      * @param d direction
      * 
@@ -373,7 +397,8 @@ public:
 
     /**
      * Returns a pointer to the currently stored direction
-     * @return internally stored direction
+     * @return internally stored direction, or \c NULL if no direction has
+     * been provided
      * 
      * \sa set_direction
      */
@@ -503,6 +528,34 @@ public:
      */
     void reset();
 
+    /**
+     * Enables or disables the \link Function::setCurvatureCache curvature 
+     * cache\endlink of the smooth functions \f$f_1\f$ and \f$f_2\f$ of the
+     * problem. When enabled, the Hessian-vector products which are needed by
+     * #get_grad_FBE reuse the curvature information that was stored when the 
+     * gradient of \f$f\f$ was computed at the current point.
+     * 
+     * @param enabled whether the curvature cache should be enabled
+     */
+    void set_curvature_cache(bool enabled);
+
+    /**
+     * Attaches an instrumentation observer to the cache, which records the
+     * time spent in the various phases of the computations, the invocations
+     * of the linear operators and functions of the problem and the cache hits.
+     * 
+     * @param instrumentation observer, or NULL to disable instrumentation; 
+     * the cache does not take ownership of it
+     */
+    void set_instrumentation(FBInstrumentation * instrumentation);
+
+    /**
+     * The instrumentation observer attached to this cache.
+     * 
+     * @return pointer to the observer or NULL if none is attached
+     */
+    FBInstrumentation * get_instrumentation() const;
+
     /**
      * 
      * Computes the value of \f$\varphi_\gamma(x+\tau d)\f$ for the cached values 
@@ -540,6 +593,34 @@ public:
      */
     int extrapolate_fbe(double tau, double gamma, double& fbe);
 
+    /**
+     * Computes \f$f(x+\tau d)\f$ for the stored values of \f$x\f$ and \f$d\f$.
+     * 
+     * It uses the formula
+     * 
+     * \f[
+     *  f(x+\tau d) = f_1(r_1(x+\tau d)) + \langle l, x\rangle + 
+     *    \tau \langle l, d\rangle + f_2(r_2(x) + \tau v),
+     * \f]
+     * 
+     * where \f$v=L_2 d\f$ and \f$f_1(r_1(x+\tau d))\f$ is computed using 
+     * #extrapolate_f1.
+     * 
+     * \post After successful completion, the \link #cache_status status \endlink 
+     * of the cache will be at least #STATUS_EVALF.
+     * 
+     * @param tau scalar parameter \f$\tau\f$
+     * @param fxtd result \f$f(x+\tau d)\f$ for the given \f$\tau\f$
+     * @return status code: returns \link ForBESUtils::STATUS_OK STATUS_OK\endlink 
+     * if the method has succeeded, \link ForBESUtils::STATUS_CACHE_NO_DIRECTION 
+     * STATUS_CACHE_NO_DIRECTION\endlink if no direction \f$d\f$ is provided.
+     * 
+     * \sa extrapolate_f1
+     * \sa extrapolate_gradf
+     * \sa extrapolate_fbe
+     */
+    int extrapolate_f(double tau, double& fxtd);
+
 };
 
 #endif /* FBCACHE_H */
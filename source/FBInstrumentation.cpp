@@ -0,0 +1,194 @@
+/*
+ * File:   FBInstrumentation.cpp
+ *
+ * ForBES is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ForBES is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with ForBES. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "FBInstrumentation.h"
+#include "ForBESUtils.h"
+
+#include <time.h>
+
+static const char * const PHASE_NAMES[FBInstrumentation::NUM_PHASES] = {
+    "function",
+    "operator",
+    "prox",
+    "line_search",
+    "stopping",
+    "solver"
+};
+
+static const char * const COUNTER_NAMES[FBInstrumentation::NUM_COUNTERS] = {
+    "operator_calls",
+    "operator_adjoint_calls",
+    "function_calls",
+    "prox_calls",
+    "cache_hits"
+};
+
+FBInstrumentation::FBInstrumentation() {
+    m_trace = false;
+    reset();
+}
+
+FBInstrumentation::~FBInstrumentation() {
+}
+
+void FBInstrumentation::setTrace(bool trace) {
+    m_trace = trace;
+}
+
+bool FBInstrumentation::isTrace() const {
+    return m_trace;
+}
+
+void FBInstrumentation::reset() {
+    m_iterations = 0;
+    m_depth = 0;
+    m_resumed = 0.0;
+    for (size_t c = 0; c < NUM_COUNTERS; c++) {
+        m_counts[c] = 0;
+    }
+    for (size_t p = 0; p < NUM_PHASES; p++) {
+        m_times[p] = 0.0;
+    }
+    m_trace_times.clear();
+    m_trace_counts.clear();
+}
+
+double FBInstrumentation::now() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<double> (ts.tv_sec) + 1e-9 * static_cast<double> (ts.tv_nsec);
+}
+
+void FBInstrumentation::beginPhase(Phase phase) {
+    if (m_depth >= FB_INSTRUMENTATION_MAX_DEPTH) {
+        m_depth++;
+        return;
+    }
+    double t = now();
+    if (m_depth > 0) {
+        /* pause the enclosing phase */
+        m_times[m_stack[m_depth - 1]] += t - m_resumed;
+    }
+    m_stack[m_depth] = phase;
+    m_depth++;
+    m_resumed = t;
+}
+
+void FBInstrumentation::endPhase() {
+    if (m_depth == 0) {
+        return;
+    }
+    m_depth--;
+    if (m_depth >= FB_INSTRUMENTATION_MAX_DEPTH) {
+        return;
+    }
+    double t = now();
+    m_times[m_stack[m_depth]] += t - m_resumed;
+    /* resume the enclosing phase */
+    m_resumed = t;
+}
+
+void FBInstrumentation::endIteration() {
+    m_iterations++;
+    if (m_trace) {
+        m_trace_times.insert(m_trace_times.end(), m_times, m_times + NUM_PHASES);
+        m_trace_counts.insert(m_trace_counts.end(), m_counts, m_counts + NUM_COUNTERS);
+    }
+}
+
+size_t FBInstrumentation::getCount(Counter counter) const {
+    return m_counts[counter];
+}
+
+double FBInstrumentation::getTime(Phase phase) const {
+    return m_times[phase];
+}
+
+double FBInstrumentation::getTotalTime() const {
+    double total = 0.0;
+    for (size_t p = 0; p < NUM_PHASES; p++) {
+        total += m_times[p];
+    }
+    return total;
+}
+
+size_t FBInstrumentation::getIterations() const {
+    return m_iterations;
+}
+
+const char * FBInstrumentation::phaseName(Phase phase) {
+    return PHASE_NAMES[phase];
+}
+
+const char * FBInstrumentation::counterName(Counter counter) {
+    return COUNTER_NAMES[counter];
+}
+
+void FBInstrumentation::printSummary(FILE* fp) const {
+    double total = getTotalTime();
+    fprintf(fp, "iterations: " FMT_SIZE_T "\n", m_iterations);
+    fprintf(fp, "%-24s %12s %8s\n", "phase", "time [s]", "share");
+    for (size_t p = 0; p < NUM_PHASES; p++) {
+        fprintf(fp, "%-24s %12.6f %7.1f%%\n", PHASE_NAMES[p], m_times[p],
+                total > 0.0 ? 100.0 * m_times[p] / total : 0.0);
+    }
+    fprintf(fp, "%-24s %12.6f\n", "total", total);
+    fprintf(fp, "%-24s %12s\n", "counter", "count");
+    for (size_t c = 0; c < NUM_COUNTERS; c++) {
+        char count[32];
+        sprintf(count, FMT_SIZE_T, m_counts[c]);
+        fprintf(fp, "%-24s %12s\n", COUNTER_NAMES[c], count);
+    }
+}
+
+void FBInstrumentation::printJSON(FILE* fp) const {
+    fprintf(fp, "{\n  \"iterations\":" FMT_SIZE_T ",\n", m_iterations);
+    fprintf(fp, "  \"total_time\":%.9g,\n", getTotalTime());
+    fprintf(fp, "  \"phases\":{");
+    for (size_t p = 0; p < NUM_PHASES; p++) {
+        fprintf(fp, "%s\"%s\":%.9g", p > 0 ? ", " : "", PHASE_NAMES[p], m_times[p]);
+    }
+    fprintf(fp, "},\n  \"counters\":{");
+    for (size_t c = 0; c < NUM_COUNTERS; c++) {
+        fprintf(fp, "%s\"%s\":" FMT_SIZE_T, c > 0 ? ", " : "", COUNTER_NAMES[c], m_counts[c]);
+    }
+    fprintf(fp, "}");
+    if (m_trace) {
+        /* per-iteration differences of the cumulative snapshots */
+        size_t n = m_trace_times.size() / NUM_PHASES;
+        fprintf(fp, ",\n  \"trace\":[");
+        for (size_t k = 0; k < n; k++) {
+            const double * t = &m_trace_times[k * NUM_PHASES];
+            const size_t * c = &m_trace_counts[k * NUM_COUNTERS];
+            const double * t_prev = k > 0 ? t - NUM_PHASES : NULL;
+            const size_t * c_prev = k > 0 ? c - NUM_COUNTERS : NULL;
+            fprintf(fp, "%s\n    {\"iteration\":" FMT_SIZE_T ", \"phases\":{", k > 0 ? "," : "", k + 1);
+            for (size_t p = 0; p < NUM_PHASES; p++) {
+                double dt = t_prev != NULL ? t[p] - t_prev[p] : t[p];
+                fprintf(fp, "%s\"%s\":%.9g", p > 0 ? ", " : "", PHASE_NAMES[p], dt);
+            }
+            fprintf(fp, "}, \"counters\":{");
+            for (size_t j = 0; j < NUM_COUNTERS; j++) {
+                size_t dc = c_prev != NULL ? c[j] - c_prev[j] : c[j];
+                fprintf(fp, "%s\"%s\":" FMT_SIZE_T, j > 0 ? ", " : "", COUNTER_NAMES[j], dc);
+            }
+            fprintf(fp, "}}");
+        }
+        fprintf(fp, "\n  ]");
+    }
+    fprintf(fp, "\n}\n");
+}
@@ -0,0 +1,279 @@
+/*
+ * File:   FBInstrumentation.h
+ *
+ * ForBES is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ForBES is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with ForBES. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef FBINSTRUMENTATION_H
+#define FBINSTRUMENTATION_H
+
+#include <cstddef>
+#include <cstdio>
+#include <vector>
+
+/**
+ * Maximum nesting depth of the phases recorded by FBInstrumentation; deeper
+ * phases are not timed.
+ */
+#define FB_INSTRUMENTATION_MAX_DEPTH 16
+
+/**
+ * \class FBInstrumentation
+ * \brief Per-phase timing and call counters of forward-backward solvers
+ * \version 0.1
+ * \ingroup FBSolver-group
+ *
+ * An FBInstrumentation object is an observer which may be attached to an
+ * FBSplitting solver (or any of its subclasses) using
+ * FBSplitting::setInstrumentation, or directly to an FBCache using
+ * FBCache::set_instrumentation. It then records
+ *
+ * - the wall time spent in every #Phase of the algorithm,
+ * - the number of invocations of LinearOperator::call,
+ *   LinearOperator::callAdjoint, Function::call and Function::callProx,
+ * - the number of cache hits, that is, the number of times a requested
+ *   quantity was found in the cache
+ *   (\link ForBESUtils::STATUS_CACHED_ALREADY STATUS_CACHED_ALREADY\endlink),
+ *
+ * and, optionally (see #setTrace), the same information for every iteration.
+ * These can be printed as a human-readable summary (#printSummary) or as
+ * JSON (#printJSON).
+ *
+ * Phases may be nested (e.g., operator applications take place while
+ * evaluating the function); the time of each phase is <em>exclusive</em>,
+ * i.e., it does not include the time spent in nested phases, so the times
+ * of all phases add up to the total instrumented time.
+ *
+ * When no instrumentation is attached, solvers only perform a null-pointer
+ * check per instrumentation point.
+ *
+ * Example:
+ *
+ * \code{.cpp}
+ * FBInstrumentation instr;
+ * FBSplitting solver(prob, x0, gamma);
+ * solver.setInstrumentation(&instr);
+ * solver.run();
+ * instr.printSummary(stdout);
+ * \endcode
+ */
+class FBInstrumentation {
+public:
+
+    /**
+     * Phases of forward-backward algorithms.
+     */
+    enum Phase {
+        /**
+         * Evaluation of \f$f\f$, its gradient, the forward step, the FBE and
+         * its gradient (excluding operator applications).
+         */
+        PHASE_FUNCTION = 0,
+        /**
+         * Applications of the linear operators \f$L_1\f$, \f$L_2\f$ and their
+         * adjoints.
+         */
+        PHASE_OPERATOR,
+        /**
+         * Proximal steps on \f$g\f$ (and the computation of the fixed-point
+         * residual).
+         */
+        PHASE_PROX,
+        /**
+         * Extrapolations along a direction (line searches).
+         */
+        PHASE_LINE_SEARCH,
+        /**
+         * Stopping test.
+         */
+        PHASE_STOPPING,
+        /**
+         * Remaining work of the solver in its iterations (e.g., computation
+         * of directions and step-sizes).
+         */
+        PHASE_SOLVER,
+        NUM_PHASES /**< number of phases */
+    };
+
+    /**
+     * Counted events.
+     */
+    enum Counter {
+        COUNT_OPERATOR_CALL = 0, /**< invocations of LinearOperator::call */
+        COUNT_OPERATOR_ADJOINT, /**< invocations of LinearOperator::callAdjoint */
+        COUNT_FUNCTION_CALL, /**< invocations of Function::call */
+        COUNT_PROX_CALL, /**< invocations of Function::callProx */
+        COUNT_CACHE_HIT, /**< quantities found in the cache */
+        NUM_COUNTERS /**< number of counters */
+    };
+
+    /**
+     * Scoped phase: the phase begins upon construction and ends upon
+     * destruction (also when an exception is thrown). Nothing happens if
+     * the instrumentation is NULL.
+     */
+    class Scope {
+    public:
+
+        Scope(FBInstrumentation * instrumentation, Phase phase) : m_instrumentation(instrumentation) {
+            if (m_instrumentation != NULL) m_instrumentation->beginPhase(phase);
+        }
+
+        ~Scope() {
+            if (m_instrumentation != NULL) m_instrumentation->endPhase();
+        }
+
+    private:
+        Scope(const Scope& orig);
+        Scope& operator=(const Scope& right);
+
+        FBInstrumentation * m_instrumentation;
+    };
+
+    FBInstrumentation();
+
+    virtual ~FBInstrumentation();
+
+    /**
+     * Enables or disables the recording of per-iteration data. Per-iteration
+     * data are printed by #printJSON.
+     *
+     * @param trace whether per-iteration data should be recorded
+     */
+    void setTrace(bool trace);
+
+    /**
+     * Whether per-iteration data are recorded.
+     *
+     * @return \c true if per-iteration data are recorded
+     */
+    bool isTrace() const;
+
+    /**
+     * Clears all recorded data.
+     */
+    void reset();
+
+    /**
+     * Increments a counter by one.
+     *
+     * @param counter counter to increment
+     */
+    void count(Counter counter) {
+        m_counts[counter]++;
+    }
+
+    /**
+     * Begins a (possibly nested) phase; the current phase (if any) is paused
+     * until #endPhase is called.
+     *
+     * @param phase the phase which begins
+     */
+    void beginPhase(Phase phase);
+
+    /**
+     * Ends the current phase and resumes the phase in which it was nested.
+     */
+    void endPhase();
+
+    /**
+     * Marks the end of an iteration of the solver.
+     */
+    void endIteration();
+
+    /**
+     * The value of a counter.
+     *
+     * @param counter counter
+     * @return number of recorded events
+     */
+    size_t getCount(Counter counter) const;
+
+    /**
+     * The (exclusive) wall time spent in a phase.
+     *
+     * @param phase phase
+     * @return time in seconds
+     */
+    double getTime(Phase phase) const;
+
+    /**
+     * The total instrumented wall time.
+     *
+     * @return time in seconds
+     */
+    double getTotalTime() const;
+
+    /**
+     * Number of iterations (calls to #endIteration).
+     *
+     * @return number of iterations
+     */
+    size_t getIterations() const;
+
+    /**
+     * Prints a human-readable summary of the recorded data.
+     *
+     * @param fp file to print to (e.g., stdout)
+     */
+    void printSummary(FILE * fp) const;
+
+    /**
+     * Prints the recorded data as a JSON object with the totals of all
+     * phases and counters and, if #setTrace is enabled, an array
+     * <code>trace</code> with the times and counts of every iteration.
+     *
+     * @param fp file to print to
+     */
+    void printJSON(FILE * fp) const;
+
+    /**
+     * Name of a phase.
+     *
+     * @param phase phase
+     * @return name (e.g., "prox")
+     */
+    static const char * phaseName(Phase phase);
+
+    /**
+     * Name of a counter.
+     *
+     * @param counter counter
+     * @return name (e.g., "prox_calls")
+     */
+    static const char * counterName(Counter counter);
+
+private:
+
+    FBInstrumentation(const FBInstrumentation& orig);
+    FBInstrumentation& operator=(const FBInstrumentation& right);
+
+    /**
+     * Current (monotonic) wall-clock time in seconds.
+     */
+    static double now();
+
+    bool m_trace; /**< whether per-iteration data are recorded */
+    size_t m_iterations; /**< number of iterations */
+    size_t m_counts[NUM_COUNTERS]; /**< counters */
+    double m_times[NUM_PHASES]; /**< exclusive time of each phase */
+    Phase m_stack[FB_INSTRUMENTATION_MAX_DEPTH]; /**< stack of active phases */
+    size_t m_depth; /**< number of active phases */
+    double m_resumed; /**< time at which the current phase began or was resumed */
+    std::vector<double> m_trace_times; /**< cumulative times at the end of every iteration */
+    std::vector<size_t> m_trace_counts; /**< cumulative counts at the end of every iteration */
+
+};
+
+#endif /* FBINSTRUMENTATION_H */
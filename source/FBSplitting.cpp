@@ -3,52 +3,124 @@
 #include "FBStopping.h"
 
 #include <iostream>
+#include <cmath>
+#include <stdexcept>
+#include <sstream>
+#include <string>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 #define DEFAULT_MAXIT 1000
 #define DEFAULT_TOL 1e-6
+#define BACKTRACK_FACTOR 0.5
+#define BACKTRACK_MAXIT 50
 
 FBSplitting::FBSplitting(FBProblem & prob, Matrix & x0, double gamma) :
-m_cache(FBCache(prob, x0, gamma)), m_maxit(DEFAULT_MAXIT) {    
+m_cache(prob, x0, gamma), m_maxit(DEFAULT_MAXIT) {    
     m_it = 0;
     m_prob = &prob;
     m_gamma = gamma;
+    m_adaptive = false;
+    m_instrumentation = NULL;
     m_sc = new FBStopping(DEFAULT_TOL);
     delete_sc = true;
 }
 
 FBSplitting::FBSplitting(FBProblem & prob, Matrix & x0, double gamma, FBStopping & sc) :
-m_cache(FBCache(prob, x0, gamma)), m_maxit(DEFAULT_MAXIT) {
+m_cache(prob, x0, gamma), m_maxit(DEFAULT_MAXIT) {
     m_it = 0;
     m_prob = &prob;
     m_gamma = gamma;
+    m_adaptive = false;
+    m_instrumentation = NULL;
     m_sc = &sc;
     delete_sc = false;
 }
 
 FBSplitting::FBSplitting(FBProblem & prob, Matrix & x0, double gamma, int maxit) :
-m_cache(FBCache(prob, x0, gamma)), m_maxit(maxit) {
+m_cache(prob, x0, gamma), m_maxit(maxit) {
     m_it = 0;
     m_prob = &prob;
     m_gamma = gamma;
+    m_adaptive = false;
+    m_instrumentation = NULL;
     m_sc = new FBStopping(DEFAULT_TOL);
     delete_sc = true;
 }
 
 FBSplitting::FBSplitting(FBProblem & prob, Matrix & x0, double gamma, FBStopping & sc, int maxit) :
-m_cache(FBCache(prob, x0, gamma)), m_maxit(maxit) {
+m_cache(prob, x0, gamma), m_maxit(maxit) {
     m_it = 0;
     m_prob = &prob;
     m_gamma = gamma;
+    m_adaptive = false;
+    m_instrumentation = NULL;
     m_sc = &sc;
     delete_sc = false;
 }
 
 int FBSplitting::iterate() {
+    if (m_adaptive) {
+        int status = backtrack();
+        if (ForBESUtils::is_status_error(status)) return status;
+    }
     m_cache.set_point(*m_cache.get_forward_backward_step(m_gamma));
     return 0;
 }
 
+int FBSplitting::backtrack() {
+    double fx = m_cache.get_eval_f();
+    for (size_t k = 0; k < BACKTRACK_MAXIT; k++) {
+        /* z = prox(x - gamma * grad f(x)); the gradient is computed only once */
+        m_cache.get_forward_backward_step(m_gamma);
+        Matrix * fpr = m_cache.get_fpr();
+        Matrix * gradfx = m_cache.get_gradf();
+        double sqnorm_fpr = std::pow(m_cache.get_norm_fpr(), 2);
+        double grad_fpr = 0.0;
+        for (size_t i = 0; i < fpr->length(); i++) {
+            grad_fpr += (*gradfx)[i] * (*fpr)[i];
+        }
+        double qz = fx - grad_fpr + sqnorm_fpr / (2.0 * m_gamma);
+
+        /* f(z) = f(x - R(x)) */
+        double fz;
+        m_cache.set_direction(*fpr);
+        int status = m_cache.extrapolate_f(-1.0, fz);
+        if (ForBESUtils::is_status_error(status)) return status;
+
+        if (fz <= qz + 1e-12 * (1.0 + std::abs(fx))) {
+            return ForBESUtils::STATUS_OK;
+        }
+        m_gamma *= BACKTRACK_FACTOR;
+    }
+    return ForBESUtils::STATUS_NUMERICAL_PROBLEMS;
+}
+
+void FBSplitting::setAdaptiveStepsize(bool adaptive) {
+    m_adaptive = adaptive;
+}
+
+bool FBSplitting::isAdaptiveStepsize() const {
+    return m_adaptive;
+}
+
+double FBSplitting::getGamma() const {
+    return m_gamma;
+}
+
+void FBSplitting::setInstrumentation(FBInstrumentation* instrumentation) {
+    m_instrumentation = instrumentation;
+    m_cache.set_instrumentation(instrumentation);
+}
+
+FBInstrumentation * FBSplitting::getInstrumentation() const {
+    return m_instrumentation;
+}
+
 int FBSplitting::stop() {
+    FBInstrumentation::Scope scope(m_instrumentation, FBInstrumentation::PHASE_STOPPING);
     return m_sc->stop(m_cache);
 }
 
@@ -66,8 +138,12 @@ FBSplitting::~FBSplitting() {
 int FBSplitting::run() {
     int status = ForBESUtils::STATUS_OK;
     while (m_it < m_maxit && !stop() && !ForBESUtils::is_status_error(status)) {
-        status = iterate();
-        m_it++;        
+        {
+            FBInstrumentation::Scope scope(m_instrumentation, FBInstrumentation::PHASE_SOLVER);
+            status = iterate();
+        }
+        m_it++;
+        if (m_instrumentation != NULL) m_instrumentation->endIteration();
     }
     return status;
 }
@@ -76,3 +152,126 @@ size_t FBSplitting::getIt() {
     return m_it;
 }
 
+void FBSplitting::setMaxIt(size_t maxit) {
+    m_maxit = maxit;
+}
+
+size_t FBSplitting::getMaxIt() const {
+    return m_maxit;
+}
+
+void FBSplitting::resetState() {
+}
+
+static bool same_dimensions(const Matrix * a, const Matrix * b) {
+    return a->getNrows() == b->getNrows() && a->getNcols() == b->getNcols();
+}
+
+void FBSplitting::checkWarmStart(Matrix& x0, Matrix* d1, Matrix* d2) {
+    if (!same_dimensions(&x0, m_cache.get_point())) {
+        throw std::invalid_argument("The initial point has wrong dimensions");
+    }
+    /* offsets can only replace existing ones (the workspace of FBCache
+     * depends on whether there are offsets) */
+    if (d1 != NULL && (m_prob->d1() == NULL || !same_dimensions(d1, m_prob->d1()))) {
+        throw std::invalid_argument("d1 has wrong dimensions or the problem has no offset d1");
+    }
+    if (d2 != NULL && (m_prob->d2() == NULL || !same_dimensions(d2, m_prob->d2()))) {
+        throw std::invalid_argument("d2 has wrong dimensions or the problem has no offset d2");
+    }
+}
+
+int FBSplitting::reset(Matrix& x0) {
+    return reset(x0, NULL, NULL, m_maxit);
+}
+
+int FBSplitting::reset(Matrix& x0, Matrix* d1, Matrix* d2, size_t maxit) {
+    checkWarmStart(x0, d1, d2);
+    if (d1 != NULL) m_prob->setD1(d1);
+    if (d2 != NULL) m_prob->setD2(d2);
+    m_maxit = maxit;
+    m_it = 0;
+    /* the residuals are recomputed since the status of the cache is reset */
+    m_cache.set_point(x0);
+    resetState();
+    return ForBESUtils::STATUS_OK;
+}
+
+int FBSplitting::runBatch(
+        std::vector<FBSplitting*>& solvers,
+        std::vector<Matrix*>& x0,
+        std::vector<Matrix*>& d1,
+        std::vector<Matrix*>& d2,
+        std::vector<Matrix*>& solutions,
+        size_t maxit) {
+    const size_t K = x0.size();
+    if (solvers.empty()
+            || solutions.size() != K
+            || (!d1.empty() && d1.size() != K)
+            || (!d2.empty() && d2.size() != K)) {
+        throw std::invalid_argument("Inconsistent number of solvers or instances");
+    }
+    /* validate all instances up front: no exception may leave the parallel region */
+    for (size_t s = 0; s < solvers.size(); s++) {
+        for (size_t k = 0; k < K; k++) {
+            solvers[s]->checkWarmStart(*x0[k], d1.empty() ? NULL : d1[k], d2.empty() ? NULL : d2[k]);
+        }
+    }
+
+    /* the offsets of the solvers are restored when the batch is over */
+    std::vector<Matrix *> d1_orig(solvers.size());
+    std::vector<Matrix *> d2_orig(solvers.size());
+    for (size_t s = 0; s < solvers.size(); s++) {
+        d1_orig[s] = solvers[s]->m_prob->d1();
+        d2_orig[s] = solvers[s]->m_prob->d2();
+    }
+
+    /* exceptions are caught per instance and reported after the loop */
+    std::vector<int> status(K, ForBESUtils::STATUS_OK);
+    std::vector<bool> failed(K, false);
+    std::vector<std::string> errors(K);
+    const long n_instances = static_cast<long> (K);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(static_cast<int> (solvers.size()))
+#endif
+    for (long k = 0; k < n_instances; k++) {
+#ifdef _OPENMP
+        FBSplitting * solver = solvers[omp_get_thread_num()];
+#else
+        FBSplitting * solver = solvers[0];
+#endif
+        try {
+            solver->reset(*x0[k], d1.empty() ? NULL : d1[k], d2.empty() ? NULL : d2[k], maxit);
+            status[k] = solver->run();
+            *solutions[k] = solver->getSolution();
+        } catch (const std::exception& e) {
+            failed[k] = true;
+            errors[k] = e.what();
+        } catch (...) {
+            failed[k] = true;
+            errors[k] = "unknown exception";
+        }
+    }
+
+    for (size_t s = 0; s < solvers.size(); s++) {
+        FBSplitting * solver = solvers[s];
+        if (solver->m_prob->d1() != d1_orig[s] || solver->m_prob->d2() != d2_orig[s]) {
+            solver->m_prob->setD1(d1_orig[s]);
+            solver->m_prob->setD2(d2_orig[s]);
+            solver->m_cache.reset();
+        }
+    }
+
+    for (size_t k = 0; k < K; k++) {
+        if (failed[k]) {
+            std::ostringstream oss;
+            oss << "runBatch: instance " << k << " failed: " << errors[k];
+            throw std::runtime_error(oss.str());
+        }
+    }
+    for (size_t k = 0; k < K; k++) {
+        if (ForBESUtils::is_status_error(status[k])) return status[k];
+    }
+    return ForBESUtils::STATUS_OK;
+}
+
@@ -4,6 +4,9 @@
 #include "FBProblem.h"
 #include "FBCache.h"
 #include "FBStopping.h"
+#include "FBInstrumentation.h"
+
+#include <vector>
 
 /**
  * \class FBSplitting
@@ -15,6 +18,21 @@
  * iterate() method works. In particular, it computes the next
  * iterate as the forward-backward (or proximal gradient) step
  * at the current point.
+ * 
+ * By default, the step-size \f$\gamma\f$ is kept fixed to the value
+ * provided upon construction, which should not exceed \f$1/L_f\f$, where 
+ * \f$L_f\f$ is the Lipschitz constant of \f$\nabla f\f$. When 
+ * #setAdaptiveStepsize is used to enable the adaptive mode, \f$\gamma\f$ 
+ * is instead reduced by backtracking at every iteration until the 
+ * forward-backward step \f$z\f$ at \f$x\f$ satisfies
+ * 
+ * \f[
+ *  f(z) \leq f(x) - \langle \nabla f(x), R_{\gamma}(x) \rangle 
+ *    + \frac{1}{2\gamma}\|R_{\gamma}(x)\|^2,
+ * \f]
+ * 
+ * where \f$R_{\gamma}(x) = x - z\f$ is the fixed-point residual, so that 
+ * a conservative estimate of \f$L_f\f$ is not necessary.
  */
 class FBSplitting  {
 private:
@@ -34,6 +52,22 @@ private:
      */
     bool delete_sc; 
     double m_gamma;
+    /**
+     * Whether the step-size is adapted by backtracking.
+     */
+    bool m_adaptive;
+    /**
+     * Instrumentation observer (or NULL).
+     */
+    FBInstrumentation * m_instrumentation;
+
+    /**
+     * Checks whether a new initial point and new offsets may be used to 
+     * warm-start the solver.
+     * 
+     * @throws std::invalid_argument otherwise
+     */
+    void checkWarmStart(Matrix & x0, Matrix * d1, Matrix * d2);
         
 protected:
 
@@ -41,6 +75,30 @@ protected:
     size_t m_it;
     size_t m_maxit;
 
+    /**
+     * Reduces the step-size #m_gamma until the forward-backward step at the
+     * current point satisfies the sufficient decrease condition of the 
+     * adaptive mode.
+     * 
+     * The value \f$f(z)\f$ is computed with FBCache::extrapolate_f along the 
+     * direction \f$R_{\gamma}(x)\f$, so \f$f_1\f$ is not re-evaluated 
+     * and the product \f$L_1 d\f$ is computed only once per trial step-size;
+     * \f$f(x)\f$ and \f$\nabla f(x)\f$ are computed only once.
+     * 
+     * @return status code; \link ForBESUtils::STATUS_NUMERICAL_PROBLEMS
+     * STATUS_NUMERICAL_PROBLEMS\endlink if no acceptable step-size is found 
+     * after a maximum number of reductions
+     */
+    int backtrack();
+
+    /**
+     * Clears the algorithm-specific state which depends on the previous 
+     * iterates (e.g., extrapolation or quasi-Newton memory). It is called by
+     * #reset and should be overridden by subclasses which keep such state;
+     * workspace should not be reallocated.
+     */
+    virtual void resetState();
+
 public:
 
     virtual int iterate();
@@ -102,6 +160,141 @@ public:
      */
     virtual Matrix& getSolution();
 
+    /**
+     * Enables or disables the adaptive step-size mode, in which 
+     * \f$\gamma\f$ is reduced by backtracking whenever the sufficient 
+     * decrease condition fails. The step-size is never increased, so the
+     * value given upon construction serves as an upper bound.
+     * 
+     * @param adaptive whether the step-size should be adapted
+     */
+    void setAdaptiveStepsize(bool adaptive);
+
+    /**
+     * Whether the adaptive step-size mode is enabled.
+     * 
+     * @return \c true if the step-size is adapted by backtracking
+     */
+    bool isAdaptiveStepsize() const;
+
+    /**
+     * The current value of the step-size \f$\gamma\f$.
+     * 
+     * @return step-size
+     */
+    double getGamma() const;
+
+    /**
+     * Attaches an instrumentation observer to the solver (and its FBCache),
+     * which records the wall time spent in every phase of the algorithm, 
+     * the number of invocations of the linear operators and functions of the
+     * problem and the number of cache hits (see FBInstrumentation). Every 
+     * iteration of #run is recorded by FBInstrumentation::endIteration.
+     * 
+     * @param instrumentation observer, or NULL to disable instrumentation; 
+     * the solver does not take ownership of it
+     */
+    void setInstrumentation(FBInstrumentation * instrumentation);
+
+    /**
+     * The instrumentation observer attached to the solver.
+     * 
+     * @return pointer to the observer or NULL if none is attached
+     */
+    FBInstrumentation * getInstrumentation() const;
+
+    /**
+     * Sets the maximum number of iterations.
+     * 
+     * @param maxit maximum number of iterations
+     */
+    void setMaxIt(size_t maxit);
+
+    /**
+     * The maximum number of iterations.
+     * 
+     * @return maximum number of iterations
+     */
+    size_t getMaxIt() const;
+
+    /**
+     * Warm-starts the solver at a new initial point. The iteration counter 
+     * is set to zero and the state of the algorithm which depends on 
+     * previous iterates is cleared (see #resetState), while all allocated
+     * memory, the current step-size (which, in adaptive mode, is an estimate 
+     * of \f$1/L_f\f$) and any data cached by the functions of the problem
+     * (e.g., factorizations) are kept.
+     * 
+     * @param x0 new initial point; it must have the dimensions of the 
+     * initial point given upon construction, in the storage of which the 
+     * solver iterates and into which x0 is copied
+     * @return status code
+     * 
+     * @throws std::invalid_argument if x0 has wrong dimensions
+     */
+    int reset(Matrix & x0);
+
+    /**
+     * Warm-starts the solver at a new initial point with new offset vectors
+     * \f$d_1\f$, \f$d_2\f$ and a new maximum number of iterations; see 
+     * #reset(Matrix&).
+     * 
+     * The offsets are set to the FBProblem of the solver using 
+     * FBProblem::setD1 and FBProblem::setD2, so they must not be destroyed
+     * while the problem is used. They may only replace offsets of the same
+     * dimensions which were present in the problem upon construction.
+     * 
+     * @param x0 new initial point
+     * @param d1 new offset \f$d_1\f$, or NULL to keep the current one
+     * @param d2 new offset \f$d_2\f$, or NULL to keep the current one
+     * @param maxit maximum number of iterations
+     * @return status code
+     * 
+     * @throws std::invalid_argument if any of the arguments has wrong 
+     * dimensions or if the problem has no offset to replace
+     */
+    int reset(Matrix & x0, Matrix * d1, Matrix * d2, size_t maxit);
+
+    /**
+     * Solves a batch of K instances of the same problem, which differ in 
+     * the initial point and the offset vectors, in parallel.
+     * 
+     * Every thread uses one of the given solvers, which is warm-started 
+     * (see #reset(Matrix&, Matrix*, Matrix*, size_t)) for each of the 
+     * instances assigned to the thread; the number of threads is at most 
+     * the number of solvers. Solvers must not share their FBProblem objects
+     * or initial points (in which they iterate) and they should not share 
+     * Function and LinearOperator objects which are not safe to use 
+     * concurrently (e.g., functions which cache factorizations). Without 
+     * OpenMP, all instances are solved by the first solver. When the batch 
+     * is over, the offsets of the problems of the solvers are restored, so 
+     * the given offsets need not outlive the call.
+     * 
+     * @param solvers solvers of problems with the same structure
+     * @param x0 initial points of the K instances
+     * @param d1 offsets \f$d_1\f$ of the K instances, or an empty vector
+     * to keep the offsets of the solvers
+     * @param d2 offsets \f$d_2\f$ of the K instances, or an empty vector
+     * to keep the offsets of the solvers
+     * @param solutions K matrices where the solutions are stored
+     * @param maxit maximum number of iterations for each instance
+     * @return \link ForBESUtils::STATUS_OK STATUS_OK\endlink or the 
+     * status of the first instance (in the given order) which failed
+     * 
+     * @throws std::invalid_argument if the sizes of the vectors or the 
+     * dimensions of the instances are inconsistent
+     * @throws std::runtime_error if an instance throws an exception; all 
+     * other instances are solved nonetheless and the message of the first
+     * failed instance (in the given order) is reported
+     */
+    static int runBatch(
+            std::vector<FBSplitting*> & solvers,
+            std::vector<Matrix*> & x0,
+            std::vector<Matrix*> & d1,
+            std::vector<Matrix*> & d2,
+            std::vector<Matrix*> & solutions,
+            size_t maxit);
+
     virtual ~FBSplitting();
 
 };
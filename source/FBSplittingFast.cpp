@@ -6,39 +6,46 @@
 
 FBSplittingFast::FBSplittingFast(FBProblem & prob, Matrix & x0, double gamma) :
 FBSplitting(prob, x0, gamma) {
-    m_previous = NULL;
+    allocate_workspace(x0);
 }
 
 FBSplittingFast::FBSplittingFast(FBProblem & prob, Matrix & x0, double gamma, FBStopping & sc) :
 FBSplitting(prob, x0, gamma, sc) {
-    m_previous = NULL;
+    allocate_workspace(x0);
 }
 
 FBSplittingFast::FBSplittingFast(FBProblem & prob, Matrix & x0, double gamma, int maxit) :
 FBSplitting(prob, x0, gamma, maxit) {
-    m_previous = NULL;
+    allocate_workspace(x0);
 }
 
 FBSplittingFast::FBSplittingFast(FBProblem & prob, Matrix & x0, double gamma, FBStopping & sc, int maxit) :
 FBSplitting(prob, x0, gamma, sc, maxit) {
-    m_previous = NULL;
+    allocate_workspace(x0);
+}
+
+void FBSplittingFast::allocate_workspace(Matrix & x0) {
+    m_previous = new Matrix(x0.getNrows(), x0.getNcols());
+    m_temp = new Matrix(x0.getNrows(), x0.getNcols());
+    m_has_previous = false;
 }
 
 int FBSplittingFast::iterate() {
     // store current point temporarily
-    Matrix * temp = new Matrix(*m_cache.get_point());
+    *m_temp = *m_cache.get_point();
     // extrapolate if not first iterate
-    if (m_previous != NULL) {
+    if (m_has_previous) {
         // y = x + k/(k+2) (x - x')
         //   = (2k+2)/(k+2) x - k/(k+2) x'
         Matrix::add(*m_cache.get_point(), -(1.0 * m_it) / (m_it + 2), *m_previous, (2.0 * m_it + 2.0) / (m_it + 2));
         // tell FBCache that the point has changed
         m_cache.reset();
-        // delete previously allocated 'm_previous'
-        delete m_previous;
     }
-    // store m_previous point
-    m_previous = temp;
+    // store m_previous point (swap the buffers; no allocation)
+    Matrix * swap = m_previous;
+    m_previous = m_temp;
+    m_temp = swap;
+    m_has_previous = true;
     // execute FBS iteration
     return FBSplitting::iterate();
 }
@@ -47,10 +54,17 @@ int FBSplittingFast::stop() {
     return FBSplitting::stop();
 }
 
+void FBSplittingFast::resetState() {
+    m_has_previous = false;
+}
 
 FBSplittingFast::~FBSplittingFast() {
     if (m_previous != NULL) {
         delete m_previous;
         m_previous = NULL;
     }
+    if (m_temp != NULL) {
+        delete m_temp;
+        m_temp = NULL;
+    }
 }
@@ -20,10 +20,20 @@
 class FBSplittingFast : public FBSplitting {
 private:
 
-    Matrix * m_previous;
+    Matrix * m_previous; /**< previous iterate */
+    Matrix * m_temp; /**< workspace; swapped with m_previous at every iteration */
+    bool m_has_previous; /**< whether m_previous holds an iterate */
+
+    void allocate_workspace(Matrix & x0);
 
 protected:
 
+    /**
+     * Discards the previous iterate, so that the next iteration is not 
+     * extrapolated.
+     */
+    virtual void resetState();
+
 public:
 
     virtual int iterate();
@@ -27,3 +27,7 @@ FactoredSolver::FactoredSolver(Matrix& matrix) : MatrixSolver(matrix) {
 FactoredSolver::~FactoredSolver() {
 }
 
+int FactoredSolver::refactorize() {
+    return factorize();
+}
+
@@ -87,6 +87,16 @@ public:
      */
     virtual int solve(Matrix& rhs, Matrix& solution) = 0;
 
+    /**
+     * Recomputes the factorization after the values (but not the sparsity
+     * pattern) of matrix \f$A\f$ have changed. Implementations may reuse
+     * the symbolic analysis of a previous call to #factorize; by default,
+     * #factorize is called.
+     * 
+     * @return status code (see #factorize)
+     */
+    virtual int refactorize(void);
+
 private:
 
 
@@ -42,8 +42,11 @@
 #include "CholeskyFactorization.h"  /* Cholesky factorization */
 #include "S_LDLFactorization.h"     /* LDL' factorization of AA'+bI */
 #include "CGSolver.h"               /* Conjugate gradient solver (for linear operators) */
+#include "MultiShiftCGSolver.h"     /* Multi-shift CG for (T + sigma_i I)x = b */
+#include "BlockCGSolver.h"          /* Block CG for multiple right-hand sides */
 #include "MatrixSolver.h"           /* Factorized solver for matrices */
 #include "SVDHelper.h"              /* SVD and nullspace */
+#include "DCTHelper.h"              /* FFT-based DCT-II and DCT-III */
 
 /* 
  * LINEAR OPERATORS
@@ -58,6 +61,7 @@
 #include "OpGradient2D.h"           /* 2D gradient (of matrices) */
 #include "OpLTI.h"                  /* A linear time-invariant system */
 #include "OpLinearCombination.h"    /* Linear combination of linear operators */
+#include "OpPlan.h"                 /* Optimized evaluation of operator expressions */
 #include "OpReverseVector.h"        /* Vector reverse */
 #include "OpSum.h"                  /* Sum of operators */
 
@@ -90,12 +94,14 @@
 /*
  * FORBES SOLVER
  */
+#include "FBInstrumentation.h"       /* Timing and call counters of FB solvers */
 #include "FBCache.h"                 /* Low-level component of the libForBES engine */
 #include "FBStopping.h"              /* Stopping criterion */
 #include "FBStoppingRelative.h"      /* Stopping criterion using relative tolerance */
 #include "FBProblem.h"               /* FB problem specifications */
 #include "FBSplitting.h"             /* FB spliting algorithm */
 #include "FBSplittingFast.h"         /* Accelerated FB splitting algorithm */
+#include "ZeroFPR.h"                 /* Quasi-Newton FB algorithm (ZeroFPR) */
 
 
 #ifdef FORBES_TEST_UTILS             /* Define FORBES_TEST_UTILS in tests */
@@ -28,6 +28,9 @@
 #define _FORBES_ERROR_MIN 500
 #define _FORBES_ERROR_MAX 1000
 
+/** printf conversion specification of <code>size_t</code> */
+#define FMT_SIZE_T "%lu"
+
 #include <stdexcept>
 
 /**
@@ -19,8 +19,11 @@
  */
 
 #include "Function.h"
+#include "MatrixParallel.h"
 
-Function::Function() {
+#include <cstring>
+
+Function::Function() : m_curvature_enabled(false), m_curvature_valid(false) {
 }
 
 Function::~Function() {
@@ -107,3 +110,46 @@ Function& Function::operator=(const Function& right) {
         throw logic_error("It is not allowed to copy Function objects; operator= is not supported.");
     }
 }
+
+void Function::setCurvatureCache(bool enabled) {
+    m_curvature_enabled = enabled;
+    m_curvature_valid = false;
+    if (!enabled) {
+        std::vector<double>().swap(m_curvature_x);
+        std::vector<double>().swap(m_curvature);
+    }
+}
+
+bool Function::isCurvatureCacheEnabled() const {
+    return m_curvature_enabled;
+}
+
+double * Function::curvature_cache_prepare(Matrix& x) {
+    m_curvature_valid = false;
+    const size_t n = x.length();
+    if (!m_curvature_enabled || n == 0 || x.getType() != Matrix::MATRIX_DENSE) {
+        return NULL;
+    }
+    m_curvature_x.resize(n);
+    m_curvature.resize(n);
+    std::memcpy(&m_curvature_x[0], x.getData(), n * sizeof (double));
+    m_curvature_valid = true;
+    return &m_curvature[0];
+}
+
+bool Function::curvature_cache_product(Matrix& x, Matrix& z, Matrix& Hz) const {
+    const size_t n = x.length();
+    if (!m_curvature_valid || n != m_curvature_x.size() || x.getType() != Matrix::MATRIX_DENSE
+            || std::memcmp(&m_curvature_x[0], x.getData(), n * sizeof (double)) != 0) {
+        return false;
+    }
+    const double * w = &m_curvature[0];
+    const double * z_data = z.getData();
+    double * Hz_data = Hz.getData();
+    MATRIX_PARALLEL_FOR_SIMD(n)
+    for (size_t i = 0; i < n; i++) {
+        Hz_data[i] = w[i] * z_data[i];
+    }
+    return true;
+}
+
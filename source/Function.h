@@ -28,6 +28,8 @@
 #include "FunctionOntologyRegistry.h"
 #include "LinearOperator.h"
 
+#include <vector>
+
 /**
  * \class Function
  * \brief A ForBES function.
@@ -303,11 +305,70 @@ public:
      */
     Function& operator=(const Function& right);
 
-private:
+    /**
+     * Enables or disables the curvature cache of this function (disabled by
+     * default).
+     * 
+     * Functions whose Hessian is a diagonal matrix with entries which are 
+     * expensive to compute (e.g., LogLogisticLoss) may, when the curvature 
+     * cache is enabled, store the diagonal of \f$\nabla^2 f(x)\f$ whenever
+     * the gradient \f$\nabla f(x)\f$ is computed. Subsequent invocations of
+     * #hessianProduct at the same point \f$x\f$ then reduce to a 
+     * diagonal scaling of \f$z\f$. This is useful when many Hessian-vector
+     * products are computed at the same point, as in truncated Newton methods.
+     * 
+     * The cache stores a copy of \f$x\f$ and, therefore, requires additional
+     * memory of the order of \f$2n\f$. Functions which do not support this
+     * feature ignore it.
+     * 
+     * @param enabled whether the curvature cache should be enabled
+     */
+    void setCurvatureCache(bool enabled);
+
+    /**
+     * Whether the curvature cache of this function is enabled.
+     * 
+     * @return \c true if the curvature cache is enabled
+     * 
+     * \sa #setCurvatureCache
+     */
+    bool isCurvatureCacheEnabled() const;
 
+private:
 
+    bool m_curvature_enabled;           /**< whether the curvature cache is enabled */
+    bool m_curvature_valid;             /**< whether the curvature cache is up to date */
+    std::vector<double> m_curvature_x;  /**< point where the curvature was computed */
+    std::vector<double> m_curvature;    /**< diagonal of the Hessian at m_curvature_x */
 
 protected:
+
+    /**
+     * Prepares the curvature cache to store the diagonal of the Hessian at 
+     * \c x. Implementations should call this method when they compute the 
+     * gradient at \c x and, if a non-NULL pointer is returned, store there the
+     * diagonal of the Hessian at \c x.
+     * 
+     * @param x current point
+     * @return pointer to an array of length \c x.length() where the diagonal
+     * of the Hessian should be stored, or \c NULL if the curvature cache is
+     * disabled
+     */
+    double * curvature_cache_prepare(Matrix& x);
+
+    /**
+     * Computes \f$Hz = \nabla^2 f(x) z\f$ using the curvature cache, if it 
+     * holds the Hessian at \c x.
+     * 
+     * @param x point where the Hessian is computed
+     * @param z vector with which the product is computed
+     * @param Hz the result
+     * @return \c true if the product was computed from the cache; \c false 
+     * if the cache is disabled or does not correspond to \c x (then \c Hz is
+     * not modified)
+     */
+    bool curvature_cache_product(Matrix& x, Matrix& z, Matrix& Hz) const;
+
     /*
      * Constructors are protected.
      * It is not allowed to instantiate objects of this class directly.
@@ -19,6 +19,32 @@
  */
 
 #include "HingeLoss.h"
+#include "MatrixParallel.h"
+#include <algorithm>
+
+/**
+ * Computes the proximal operator of the Hinge loss on arrays of length \c n
+ * and, if \c VALUE is true, returns \f$\sum_i \max(0, 1-b_i p_i)\f$, where
+ * \f$p\f$ is the proximal point. The loop body is branch-free so that it can 
+ * be vectorized.
+ */
+template<bool VALUE>
+static double hinge_prox_kernel(const double * x, const double * b, size_t n,
+        double gm, double * prox) {
+    double f = 0.0;
+    MATRIX_PARALLEL_FOR_SIMD_SUM(n, f)
+    for (size_t i = 0; i < n; i++) {
+        const double xi = x[i];
+        const double bi = b[i];
+        const double bxi = bi * xi;
+        const double pi = bxi < 1.0 ? bi * std::min(1.0, bxi + gm) : xi;
+        if (VALUE) {
+            f += std::max(0.0, 1.0 - bi * pi);
+        }
+        prox[i] = pi;
+    }
+    return f;
+}
 
 HingeLoss::HingeLoss(Matrix& b, double mu) :
 Function(), m_mu(mu) {
@@ -38,14 +64,15 @@ int HingeLoss::call(Matrix& x, double& f) {
     if (!x.isColumnVector()) {
         throw std::invalid_argument("x must be a column-vector");
     }
-    f = 0.0;
-    for (size_t i = 0; i < x.getNrows(); i++) {
-        double si = 1 - m_b->get(i) * x[i];
-        if (si > 0) {
-            f += si;
-        }
+    const size_t n = x.getNrows();
+    const double * x_data = x.getData();
+    const double * b_data = m_b->getData();
+    double sum = 0.0;
+    MATRIX_PARALLEL_FOR_SIMD_SUM(n, sum)
+    for (size_t i = 0; i < n; i++) {
+        sum += std::max(0.0, 1.0 - b_data[i] * x_data[i]);
     }
-    f *= m_mu;
+    f = m_mu * sum;
     return ForBESUtils::STATUS_OK;
 }
 
@@ -53,18 +80,7 @@ int HingeLoss::callProx(Matrix& x, double gamma, Matrix& prox) {
     if (!x.isColumnVector()) {
         throw std::invalid_argument("x must be a column-vector");
     }
-    double gm = gamma*m_mu;
-    for (size_t i = 0; i < x.getNrows(); i++) {
-        double bi;
-        double bxi;
-        bi = m_b->get(i);
-        bxi = bi * x[i];
-        if (bxi < 1) {
-            prox[i] = bi * std::min(1.0, bxi + gm);
-        } else {
-            prox[i] = x[i];
-        }
-    }
+    hinge_prox_kernel<false>(x.getData(), m_b->getData(), x.getNrows(), gamma * m_mu, prox.getData());
     return ForBESUtils::STATUS_OK;
 }
 
@@ -72,27 +88,8 @@ int HingeLoss::callProx(Matrix& x, double gamma, Matrix& prox, double& f_at_prox
     if (!x.isColumnVector()) {
         throw std::invalid_argument("x must be a column-vector");
     }
-    double gm = gamma*m_mu;
-    f_at_prox = 0.0;
-    for (size_t i = 0; i < x.getNrows(); i++) {
-        double si;
-        double pi;
-        double bi;
-        double bxi;
-        bi = m_b->get(i);
-        bxi = bi * x[i];
-        if (bxi < 1) {
-            pi = bi * std::min(1.0, bxi + gm);
-        } else {
-            pi = x[i];
-        }
-        si = 1 - m_b->get(i) * pi;
-        if (si > 0) {
-            f_at_prox += si;
-        }
-        prox[i] = pi;
-    }
-    f_at_prox *= m_mu;
+    f_at_prox = m_mu * hinge_prox_kernel<true>(x.getData(), m_b->getData(), x.getNrows(),
+            gamma * m_mu, prox.getData());
     return ForBESUtils::STATUS_OK;
 }
 
@@ -49,11 +49,14 @@
  * \f[
  *  \mathrm{prox}_{\gamma f}(v)_i = 
  *   \begin{cases}
- *     b_i \min(1, b_i + \gamma \mu), &\text{if } b_i x_i < 1\\
+ *     b_i \min(1, b_i x_i + \gamma \mu), &\text{if } b_i x_i < 1\\
  *     x_i, &\text{otherwise}
  *   \end{cases}
  * \f]
  * 
+ * for \f$b_i\in\{-1, 1\}\f$. The element-wise loops are vectorized and, 
+ * when the library is compiled with OpenMP support, executed in parallel for 
+ * vectors with at least \c MATRIX_PARALLEL_THRESHOLD entries.
  */
 class HingeLoss : public Function {
     
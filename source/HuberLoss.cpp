@@ -19,8 +19,32 @@
  */
 
 #include "HuberLoss.h"
+#include "MatrixParallel.h"
 #include <cmath>
 
+/**
+ * Single-pass evaluation of the Huber loss on an array of length \c n; if
+ * \c GRAD is true, the gradient is stored in \c grad. The loop body is
+ * branch-free so that it can be vectorized.
+ */
+template<bool GRAD>
+static double huber_kernel(const double * x, size_t n, double delta, double * grad) {
+    const double one_over_delta = 1.0 / delta;
+    const double half_delta = 0.5 * delta;
+    double f = 0.0;
+    MATRIX_PARALLEL_FOR_SIMD_SUM(n, f)
+    for (size_t i = 0; i < n; i++) {
+        const double xi = x[i];
+        const double abs_xi = std::fabs(xi);
+        const bool quadratic = abs_xi <= delta;
+        f += quadratic ? 0.5 * one_over_delta * xi * xi : abs_xi - half_delta;
+        if (GRAD) {
+            grad[i] = quadratic ? xi * one_over_delta : (xi < 0.0 ? -1.0 : 1.0);
+        }
+    }
+    return f;
+}
+
 HuberLoss::HuberLoss(double delta) :
 Function(), m_delta(delta) {
 }
@@ -34,16 +58,7 @@ int HuberLoss::call(Matrix& x, double& f) {
         throw std::invalid_argument("x must be a column-vector");
     }
     //LCOV_EXCL_STOP
-    f = 0.0;
-    for (size_t i = 0; i < x.getNrows(); i++) {
-        double xi;
-        xi = x[i];
-        if (std::abs(xi) <= m_delta) {
-            f += std::pow(xi, 2) / (2.0 * m_delta);
-        } else {
-            f += std::abs(xi) - m_delta / 2.0;
-        }
-    }
+    f = huber_kernel<false>(x.getData(), x.getNrows(), m_delta, NULL);
     return ForBESUtils::STATUS_OK;
 }
 
@@ -53,17 +68,25 @@ int HuberLoss::call(Matrix& x, double& f, Matrix& grad) {
         throw std::invalid_argument("x must be a column-vector");
     }
     //LCOV_EXCL_STOP
-    f = 0.0;
-    for (size_t i = 0; i < x.getNrows(); i++) {
-        double xi;
-        xi = x[i];
-        if (std::abs(xi) <= m_delta) {
-            f += std::pow(xi, 2) / (2.0 * m_delta);
-            grad[i] = xi / m_delta;
-        } else {
-            f += std::abs(xi) - m_delta / 2.0;
-            grad[i] = std::signbit(xi) ? -1.0 : 1.0;
-        }
+    f = huber_kernel<true>(x.getData(), x.getNrows(), m_delta, grad.getData());
+    return ForBESUtils::STATUS_OK;
+}
+
+int HuberLoss::hessianProduct(Matrix& x, Matrix& z, Matrix& Hz) {
+    //LCOV_EXCL_START
+    if (!x.isColumnVector()) {
+        throw std::invalid_argument("x must be a column-vector");
+    }
+    //LCOV_EXCL_STOP
+    const size_t n = x.getNrows();
+    const double * x_data = x.getData();
+    const double * z_data = z.getData();
+    double * Hz_data = Hz.getData();
+    const double delta = m_delta;
+    const double one_over_delta = 1.0 / delta;
+    MATRIX_PARALLEL_FOR_SIMD(n)
+    for (size_t i = 0; i < n; i++) {
+        Hz_data[i] = std::fabs(x_data[i]) <= delta ? one_over_delta * z_data[i] : 0.0;
     }
     return ForBESUtils::STATUS_OK;
 }
@@ -52,12 +52,18 @@
  * 
  * \f[
  *  \nabla f(x)_i = \begin{cases}
- *   \frac{|x_i|}{\delta},&\text{if } |x_i|\leq \delta \\
+ *   \frac{x_i}{\delta},&\text{if } |x_i|\leq \delta \\
  *   \mathrm{sign}(x_i),&\text{otherwise}
  * \end{cases}
  * \f]
  * 
+ * and its (generalized) Hessian is the diagonal matrix with 
+ * \f$(\nabla^2 f(x))_{ii} = 1/\delta\f$ if \f$|x_i|\leq\delta\f$ and 
+ * \f$0\f$ otherwise.
  * 
+ * The element-wise loops are vectorized and, when the library is compiled
+ * with OpenMP support, executed in parallel for vectors with at least
+ * \c MATRIX_PARALLEL_THRESHOLD entries.
  */
 class HuberLoss : public Function {
 public:
@@ -78,6 +84,8 @@ public:
     virtual int call(Matrix& x, double& f);
     
     virtual int call(Matrix& x, double& f, Matrix& grad);
+
+    virtual int hessianProduct(Matrix& x, Matrix& z, Matrix& Hz);
     
     virtual FunctionOntologicalClass category();
 
@@ -27,10 +27,19 @@
 #include <iostream>
 #include <string.h>
 #include <complex>
+#include <cblas.h>
 
 const long LBFGSBuffer::LBFGS_BUFFER_EOB = -1;
 
 LBFGSBuffer::LBFGSBuffer(size_t n, size_t mem) : m_mem(mem) {
+    allocate(n, mem, false);
+}
+
+LBFGSBuffer::LBFGSBuffer(size_t n, size_t mem, bool compact) : m_mem(mem) {
+    allocate(n, mem, compact);
+}
+
+void LBFGSBuffer::allocate(size_t n, size_t mem, bool compact) {
     // initialize the LBFGS buffer
     m_current_mem = 0;
     m_idx = -1;
@@ -39,6 +48,19 @@ LBFGSBuffer::LBFGSBuffer(size_t n, size_t mem) : m_mem(mem) {
     m_Y = new Matrix(n, mem);
     m_Ys = new Matrix(mem, 1);
     m_alphas = new Matrix(mem, 1);
+    m_compact = compact;
+    m_SY = NULL;
+    m_YY = NULL;
+    m_Sq = NULL;
+    m_Yq = NULL;
+    m_coef = NULL;
+    if (compact) {
+        m_SY = new Matrix(mem, mem);
+        m_YY = new Matrix(mem, mem);
+        m_Sq = new Matrix(mem, 1);
+        m_Yq = new Matrix(mem, 1);
+        m_coef = new Matrix(mem, 1);
+    }
 }
 
 LBFGSBuffer::~LBFGSBuffer() {
@@ -54,6 +76,21 @@ LBFGSBuffer::~LBFGSBuffer() {
     if (m_alphas != NULL) {
         delete m_alphas;
     }
+    if (m_SY != NULL) {
+        delete m_SY;
+    }
+    if (m_YY != NULL) {
+        delete m_YY;
+    }
+    if (m_Sq != NULL) {
+        delete m_Sq;
+    }
+    if (m_Yq != NULL) {
+        delete m_Yq;
+    }
+    if (m_coef != NULL) {
+        delete m_coef;
+    }
     m_mem = 0;
     m_current_mem = 0;
     m_idx = 0;
@@ -89,24 +126,38 @@ int LBFGSBuffer::push(Matrix* s, Matrix* y) {
         m_current_mem = m_mem; // buffer is now full
     }
 
-    size_t n = m_Y->getNrows();
+    const size_t n = m_Y->getNrows();
 
-    // copy data into m_Y
-    double * m_Y_data = m_Y->getData();
-    double * y_data = y->getData();
-    m_Y_data += m_idx*n;
-    memcpy(m_Y_data, y_data, n * sizeof (double));
+    // copy data into m_Y and m_S
+    double * y_new = m_Y->getData() + m_idx * n;
+    double * s_new = m_S->getData() + m_idx * n;
+    memcpy(y_new, y->getData(), n * sizeof (double));
+    memcpy(s_new, s->getData(), n * sizeof (double));
 
-    // copy data into m_S
-    double * m_S_data = m_S->getData();
-    double * s_data = s->getData();
-    m_S_data += m_idx*n;
-    memcpy(m_S_data, s_data, n * sizeof (double));
+    (*m_Ys)[m_idx] = cblas_ddot(n, y_new, 1, s_new, 1);
 
-    Matrix s_mat = MatrixFactory::ShallowVector(s_data, n, 0);
-    Matrix y_mat = MatrixFactory::ShallowVector(y_data, n, 0);
-    Matrix ys = y_mat*s_mat;
-    m_Ys->set(m_idx, 0, ys[0]);
+    if (m_compact) {
+        /* 
+         * Update row and column m_idx of m_SY and m_YY; the columns of m_S 
+         * and m_Y which are in use are 0, ..., m_current_mem - 1.
+         */
+        const size_t m = m_current_mem;
+        double * Sy = m_Sq->getData();
+        double * Ys = m_Yq->getData();
+        double * Yy = m_coef->getData();
+        cblas_dgemv(CblasColMajor, CblasTrans, n, m, 1.0, m_S->getData(), n, y_new, 1, 0.0, Sy, 1);
+        cblas_dgemv(CblasColMajor, CblasTrans, n, m, 1.0, m_Y->getData(), n, s_new, 1, 0.0, Ys, 1);
+        cblas_dgemv(CblasColMajor, CblasTrans, n, m, 1.0, m_Y->getData(), n, y_new, 1, 0.0, Yy, 1);
+        double * SY = m_SY->getData();
+        double * YY = m_YY->getData();
+        const size_t c = m_idx;
+        for (size_t l = 0; l < m; l++) {
+            SY[l + c * m_mem] = Sy[l];
+            SY[c + l * m_mem] = Ys[l];
+            YY[l + c * m_mem] = Yy[l];
+            YY[c + l * m_mem] = Yy[l];
+        }
+    }
     return ForBESUtils::STATUS_OK;
 }
 
@@ -123,14 +174,16 @@ size_t LBFGSBuffer::get_current_mem() const {
 double LBFGSBuffer::hessian_estimate() {
     // returns Hk0 = ys_prev / (y_prev'*y_prev)
     // or 1.0 is no ys_prev is cached
-    size_t idx_current = cursor();
-    size_t n = m_Y->getNrows();
     double gamma_k_0 = 1.0;
     if (m_current_mem > 0) {
-        Matrix curr_y = MatrixFactory::ShallowSubVector(*m_Y, idx_current);
-        double sq_norm_y = 0.0;
-        for (size_t l = 0; l < n; l++) {
-            sq_norm_y += std::pow(curr_y[l], 2);
+        size_t idx_current = cursor();
+        size_t n = m_Y->getNrows();
+        double sq_norm_y;
+        if (m_compact) {
+            sq_norm_y = m_YY->get(idx_current, idx_current);
+        } else {
+            const double * curr_y = m_Y->getData() + idx_current * n;
+            sq_norm_y = cblas_ddot(n, curr_y, 1, curr_y, 1);
         }
         gamma_k_0 = (*m_Ys)[idx_current] / sq_norm_y;
     }
@@ -138,49 +191,111 @@ double LBFGSBuffer::hessian_estimate() {
 }
 
 int LBFGSBuffer::update(const Matrix* q, Matrix* r, double& gamma0) {
-    Matrix qq = *q;
+    if (m_compact) {
+        return update_compact(q, r, gamma0);
+    }
+
+    const size_t n = m_S->getNrows();
+    const double * S = m_S->getData();
+    const double * Y = m_Y->getData();
+
+    /* the first loop updates q in place, in r */
+    *r = *q;
+    double * rd = r->getData();
 
     /*
-     * STEP 1:  First loop (compute alpha, update qq)
-     * [TESTED]
+     * STEP 1:  First loop (compute alpha, update q), from the most recent
+     * pair to the oldest one
      */
-    long k_minus_j;
-    long j = 0;
-    while ((k_minus_j = get_k_minus_j(j)) != LBFGSBuffer::LBFGS_BUFFER_EOB) {
-        Matrix sq = MatrixFactory::ShallowSubVector(*m_S, k_minus_j) * qq; // <si, q_i>
-        Matrix yi = MatrixFactory::ShallowSubVector(*m_Y, k_minus_j); // yi
-        double alpha_i = sq[0] / (*m_Ys)[k_minus_j];
-        (*m_alphas)[k_minus_j] = alpha_i;
-        Matrix::add(qq, -alpha_i, yi, 1.0);
-        j++;
+    for (size_t j = 0; j < m_current_mem; j++) {
+        long k = get_k_minus_j(j);
+        double alpha_i = cblas_ddot(n, S + k * n, 1, rd, 1) / (*m_Ys)[k]; // <si, q_i>/<yi, si>
+        (*m_alphas)[k] = alpha_i;
+        cblas_daxpy(n, -alpha_i, Y + k * n, 1, rd, 1);
     }
 
     /* Update r */
-    *r = gamma0 * qq;
+    cblas_dscal(n, gamma0, rd, 1);
 
+    /*
+     * STEP 2:      Second loop, from the oldest pair to the most recent one
+     */
+    for (size_t j = m_current_mem; j-- > 0;) {
+        long k = get_k_minus_j(j);
+        double beta = cblas_ddot(n, Y + k * n, 1, rd, 1) / (*m_Ys)[k];
+        cblas_daxpy(n, (*m_alphas)[k] - beta, S + k * n, 1, rd, 1);
+    }
+
+    return ForBESUtils::STATUS_OK;
+}
 
+int LBFGSBuffer::update_compact(const Matrix* q, Matrix* r, double gamma0) {
+    const size_t n = m_S->getNrows();
+    const size_t m = m_current_mem;
+    *r = *q;
+    double * rd = r->getData();
+    if (m == 0) {
+        cblas_dscal(n, gamma0, rd, 1);
+        return ForBESUtils::STATUS_OK;
+    }
+
+    const double * S = m_S->getData();
+    const double * Y = m_Y->getData();
+    const double * SY = m_SY->getData();
+    const double * YY = m_YY->getData();
+    const double * ys = m_Ys->getData();
+    double * alphas = m_alphas->getData();
+    double * Sq = m_Sq->getData();
+    double * Yq = m_Yq->getData();
+    double * coef = m_coef->getData();
+
+    /* S'*q and Y'*q (r is a copy of q) */
+    cblas_dgemv(CblasColMajor, CblasTrans, n, m, 1.0, S, n, rd, 1, 0.0, Sq, 1);
+    cblas_dgemv(CblasColMajor, CblasTrans, n, m, 1.0, Y, n, rd, 1, 0.0, Yq, 1);
 
     /*
-     * STEP 2:      Second loop
+     * STEP 1:  First loop; <s_k, q_j> = <s_k, q> - sum_l alpha_l <s_k, y_l>
+     * over the more recent pairs l
      */
-    j = m_mem;
+    for (size_t j = 0; j < m; j++) {
+        size_t k = get_k_minus_j(j);
+        double sq = Sq[k];
+        for (size_t i = 0; i < j; i++) {
+            size_t l = get_k_minus_j(i);
+            sq -= alphas[l] * SY[k + l * m_mem];
+        }
+        alphas[k] = sq / ys[k];
+    }
 
-    // skip empty buffer
-    while (j >= 0 &&
-            (k_minus_j = get_k_minus_j(j)) == LBFGSBuffer::LBFGS_BUFFER_EOB) j--;
+    /* r = gamma0 * (q - Y * alpha) */
+    cblas_dgemv(CblasColMajor, CblasNoTrans, n, m, -1.0, Y, n, alphas, 1, 1.0, rd, 1);
+    cblas_dscal(n, gamma0, rd, 1);
 
+    /* <y_k, r> = gamma0 * (<y_k, q> - sum_l alpha_l <y_k, y_l>) (stored in Yq) */
+    for (size_t k = 0; k < m; k++) {
+        double yy_alpha = 0.0;
+        for (size_t l = 0; l < m; l++) {
+            yy_alpha += YY[k + l * m_mem] * alphas[l];
+        }
+        Yq[k] = gamma0 * (Yq[k] - yy_alpha);
+    }
 
-    // iterate backwards
-    while (j >= 0) {
-        k_minus_j = get_k_minus_j(j);
-        Matrix yi = MatrixFactory::ShallowSubVector(*m_Y, k_minus_j);
-        Matrix b = yi * (*r);
-        double beta = b[0] / (*m_Ys)[k_minus_j];
-        Matrix s = MatrixFactory::ShallowSubVector(*m_S, k_minus_j);
-        Matrix::add(*r, (*m_alphas)[k_minus_j] - beta, s, 1.0);
-        j--;
+    /*
+     * STEP 2:  Second loop; <y_k, r_j> = <y_k, r> + sum_l coef_l <s_l, y_k>
+     * over the older pairs l, where coef_l = alpha_l - beta_l
+     */
+    for (size_t j = m; j-- > 0;) {
+        size_t k = get_k_minus_j(j);
+        double yr = Yq[k];
+        for (size_t i = j + 1; i < m; i++) {
+            size_t l = get_k_minus_j(i);
+            yr += coef[l] * SY[l + k * m_mem];
+        }
+        coef[k] = alphas[k] - yr / ys[k];
     }
 
+    /* r += S * coef */
+    cblas_dgemv(CblasColMajor, CblasNoTrans, n, m, 1.0, S, n, coef, 1, 1.0, rd, 1);
+
     return ForBESUtils::STATUS_OK;
 }
-
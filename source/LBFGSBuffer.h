@@ -39,6 +39,19 @@
  * LBFGSBuffer is a finite length buffer for pairs \f$(s_k, y_k)\f$ which 
  * are necessary for the computation of \f$r_k = H_k q_k\f$ in the LBFGS algorithm.
  * 
+ * The pairs are stored in the columns of two \f$n\times m\f$ matrices which
+ * are used as ring buffers. The two-loop recursion (see #update) operates 
+ * directly on these columns with BLAS level-1 kernels and does not allocate 
+ * any memory. 
+ * 
+ * Optionally, a <em>compact</em> buffer can be constructed, which additionally
+ * maintains the \f$m\times m\f$ matrices of inner products 
+ * \f$\langle s_i, y_j\rangle\f$ and \f$\langle y_i, y_j\rangle\f$. Then,
+ * #update computes the same direction with four BLAS level-2 (GEMV) products 
+ * with the buffers, while the dependencies between the steps of the two loops
+ * are resolved with \f$O(m^2)\f$ scalar operations. This is faster for large
+ * \f$n\f$, at the cost of three more GEMV products in #push.
+ * 
  * \todo Implement generalized inner product so that this class supports general
  * matrices and not only vectors.
  */
@@ -61,6 +74,17 @@ public:
      */
     LBFGSBuffer(size_t n, size_t mem);
 
+    /**
+     * Constructs a new instance of LBFGSBuffer for vectors of size \c n 
+     * and using a memory length \c mem.
+     * 
+     * @param n size of x
+     * @param mem memory
+     * @param compact whether the buffer should maintain the inner products of
+     * the buffered vectors so that #update is computed with GEMV products
+     */
+    LBFGSBuffer(size_t n, size_t mem, bool compact);
+
     /**
      * Default destructor.
      */
@@ -162,6 +186,9 @@ public:
      * which is given by \f$H_k^0 = \gamma_0^0 I\f$. A possible choice is computed 
      * by #hessian_estimate.
      * 
+     * \note No memory is allocated provided that \c r has the same dimensions 
+     * as \c q. Matrices \c q and \c r may not be the same object.
+     * 
      * @return Returns \link ForBESUtils::STATUS_OK STATUS_OK\endlink on success
      * 
      * \sa #hessian_estimate
@@ -220,6 +247,25 @@ private:
     Matrix * m_Y; /**< Buffer of past y_k */
     Matrix * m_Ys; /**< Buffer of past values of y_k'*s_k */
     Matrix * m_alphas; /**< The alphas in the two-loop recursion (loop 1) */
+    bool m_compact; /**< whether the inner products m_SY and m_YY are maintained */
+    Matrix * m_SY; /**< m_SY(i,j) = s_i'*y_j (compact buffers only) */
+    Matrix * m_YY; /**< m_YY(i,j) = y_i'*y_j (compact buffers only) */
+    Matrix * m_Sq; /**< workspace: S'*q, then S'*y (compact buffers only) */
+    Matrix * m_Yq; /**< workspace: Y'*q, then Y'*s (compact buffers only) */
+    Matrix * m_coef; /**< workspace: coefficients of the GEMV products (compact buffers only) */
+
+    void allocate(size_t n, size_t mem, bool compact);
+
+    /**
+     * Two-loop recursion using the inner products m_SY and m_YY.
+     */
+    int update_compact(const Matrix * q, Matrix * r, double gamma0);
+
+    /*
+     * LBFGSBuffer objects own their buffers and cannot be copied.
+     */
+    LBFGSBuffer(const LBFGSBuffer& orig);
+    LBFGSBuffer& operator=(const LBFGSBuffer& right);
 
 
 };
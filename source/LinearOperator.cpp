@@ -26,8 +26,26 @@ LinearOperator::LinearOperator() {
 LinearOperator::~LinearOperator() {
 }
 
+std::pair<size_t, size_t> LinearOperator::blockDimensionOut(const Matrix& x) {
+    std::pair<size_t, size_t> dims = dimensionOut();
+    if (dimensionIn().second == 1) {
+        /* operator on vectors: acts on every column of x */
+        dims.second = x.getNcols();
+    }
+    return dims;
+}
+
+std::pair<size_t, size_t> LinearOperator::blockDimensionIn(const Matrix& y) {
+    std::pair<size_t, size_t> dims = dimensionIn();
+    if (dims.second == 1) {
+        dims.second = y.getNcols();
+    }
+    return dims;
+}
+
 Matrix LinearOperator::call(Matrix& x) {
-    Matrix y(dimensionOut().first, dimensionOut().second);
+    std::pair<size_t, size_t> dims = blockDimensionOut(x);
+    Matrix y(dims.first, dims.second);
     const double gamma = 0.0;
     const double alpha = 1.0;
     ForBESUtils::fail_on_error(call(y, alpha, x, gamma));
@@ -35,7 +53,8 @@ Matrix LinearOperator::call(Matrix& x) {
 }
 
 Matrix LinearOperator::callAdjoint(Matrix& x) {
-    Matrix y_star(dimensionIn().first, dimensionIn().second);
+    std::pair<size_t, size_t> dims = blockDimensionIn(x);
+    Matrix y_star(dims.first, dims.second);
     const double gamma = 0.0;
     const double alpha = 1.0;
     ForBESUtils::fail_on_error(callAdjoint(y_star, alpha, x, gamma));
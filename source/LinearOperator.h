@@ -47,6 +47,14 @@
  * Linear operators are assumed to be of the generic form \f$T:X \to Y\f$,
  * where \f$X\f$ and \f$Y\f$ are vector spaces, either \f$\mathbb{R}^n\f$ or
  * \f$\mathbb{R}^{n\times m}\f$.
+ * 
+ * Operators on vectors (i.e., with \f$X=\mathbb{R}^n\f$) may also be 
+ * applied to matrices \f$x = [x_1\ \cdots\ x_k]\f$ with \f$k\f$ columns,
+ * in which case they act column-wise, that is 
+ * \f$T(x) = [T(x_1)\ \cdots\ T(x_k)]\f$; the operators of this library 
+ * compute such block products in a single pass (e.g., a matrix-matrix 
+ * product instead of \f$k\f$ matrix-vector products). The dimensions of 
+ * block products are given by #blockDimensionIn and #blockDimensionOut.
  */
 class LinearOperator {
 public:
@@ -151,6 +159,28 @@ public:
      */
     virtual std::pair<size_t, size_t> dimensionOut() = 0;
 
+    /**
+     * Dimensions of \f$T(x)\f$ for a given \f$x\f$: for operators on 
+     * vectors, this is <code>(n, k)</code>, where <code>n</code> is the
+     * first component of #dimensionOut and <code>k</code> is the number of
+     * columns of <code>x</code>, otherwise it is #dimensionOut.
+     * 
+     * @param x vector or matrix where the operator is to be calculated
+     * @return Dimensions of <code>T(x)</code>
+     */
+    std::pair<size_t, size_t> blockDimensionOut(const Matrix& x);
+
+    /**
+     * Dimensions of \f$T^*(y)\f$ for a given \f$y\f$: for operators on 
+     * vectors, this is <code>(n, k)</code>, where <code>n</code> is the
+     * first component of #dimensionIn and <code>k</code> is the number of
+     * columns of <code>y</code>, otherwise it is #dimensionIn.
+     * 
+     * @param y vector or matrix where the adjoint is to be calculated
+     * @return Dimensions of <code>T*(y)</code>
+     */
+    std::pair<size_t, size_t> blockDimensionIn(const Matrix& y);
+
     /**
      * Destructor for LinearOperator objects.
      */
@@ -19,7 +19,51 @@
  */
 
 #include "LogLogisticLoss.h"
+#include "MatrixParallel.h"
 #include <cmath>
+#include <algorithm>
+
+/**
+ * Single-pass evaluation of the log-logistic loss on an array of length 
+ * \c n. Returns \f$\sum_i -\ln\sigma(x_i)\f$ (if \c VALUE is true) and 
+ * computes \f$\mu(\sigma(x_i)-1)\f$ into \c grad (if \c GRAD is true) 
+ * and \f$\mu\sigma(x_i)(1-\sigma(x_i))z_i\f$ into \c Hz (if \c HESS is true).
+ * If \c DIAG is true, the diagonal of the Hessian, 
+ * \f$\mu\sigma(x_i)(1-\sigma(x_i))\f$, is stored in \c w.
+ * 
+ * All quantities are computed from \f$e_i = e^{-|x_i|}\in(0,1]\f$, so that
+ * neither overflows nor cancellations occur: 
+ * \f$-\ln\sigma(x_i) = \max(-x_i, 0) + \ln(1+e_i)\f$,
+ * \f$1-\sigma(x_i) = e_i/(1+e_i)\f$ if \f$x_i\geq 0\f$ and \f$1/(1+e_i)\f$ 
+ * otherwise, and \f$\sigma(x_i)(1-\sigma(x_i)) = e_i/(1+e_i)^2\f$.
+ */
+template<bool VALUE, bool GRAD, bool HESS, bool DIAG>
+static double log_logistic_kernel(const double * x, size_t n, double mu,
+        double * grad, const double * z, double * Hz, double * w) {
+    double f = 0.0;
+    MATRIX_PARALLEL_FOR_SIMD_SUM(n, f)
+    for (size_t i = 0; i < n; i++) {
+        const double xi = x[i];
+        const double ei = std::exp(-std::fabs(xi));
+        if (VALUE) {
+            f += std::max(-xi, 0.0) + log1p(ei);
+        }
+        if (GRAD || HESS || DIAG) {
+            const double ri = 1.0 / (1.0 + ei);
+            const double wi = mu * ei * ri * ri;
+            if (GRAD) {
+                grad[i] = -mu * (xi >= 0.0 ? ei * ri : ri);
+            }
+            if (HESS) {
+                Hz[i] = wi * z[i];
+            }
+            if (DIAG) {
+                w[i] = wi;
+            }
+        }
+    }
+    return f;
+}
 
 LogLogisticLoss::LogLogisticLoss() {
     m_mu = 1.0;
@@ -38,13 +82,8 @@ int LogLogisticLoss::call(Matrix& x, double& f) {
         throw std::invalid_argument("x must be a column-vector");
     }
     //LCOV_EXCL_STOP
-    f = 0.0;
-    for (size_t i = 0; i < x.getNrows(); i++) {
-        double si = std::exp(x[i]);
-        si /= (1.0 + si);
-        f -= std::log(si);
-    }
-    f *= m_mu;
+    f = m_mu * log_logistic_kernel<true, false, false, false>(x.getData(), x.getNrows(), m_mu,
+            NULL, NULL, NULL, NULL);
     return ForBESUtils::STATUS_OK;
 }
 
@@ -54,22 +93,32 @@ int LogLogisticLoss::call(Matrix& x, double& f, Matrix& grad) {
         throw std::invalid_argument("x must be a column-vector");
     }
     //LCOV_EXCL_STOP
-    f = 0.0;
-    int status = ForBESUtils::STATUS_OK;
-    for (size_t i = 0; i < x.getNrows(); i++) {        
-        double xi = x[i];
-        if (xi < 33) {                      /* because for values higher than 33, 
-                                             * s1 is practically equal to 1. 
-                                             * This saves the computational burden for
-                                             * high values of x_i */
-            double si = std::exp(xi);       /* si = e^xi              */
-            si = si / (1 + si);             /* si = e^xi / (1+e^xi)   */
-            f -= std::log(si);              /* f -= ln(si)            */
-            grad[i] = m_mu * (si - 1);      /* prox_i = mu*(si-1)     */
-        }
+    double * w = curvature_cache_prepare(x);
+    if (w != NULL) {
+        f = m_mu * log_logistic_kernel<true, true, false, true>(x.getData(), x.getNrows(), m_mu,
+                grad.getData(), NULL, NULL, w);
+    } else {
+        f = m_mu * log_logistic_kernel<true, true, false, false>(x.getData(), x.getNrows(), m_mu,
+                grad.getData(), NULL, NULL, NULL);
     }
-    f *= m_mu;
-    return status;
+    return ForBESUtils::STATUS_OK;
+}
+
+int LogLogisticLoss::call(Matrix& x, double& f, Matrix& grad, Matrix& z, Matrix& Hz) {
+    //LCOV_EXCL_START
+    if (!x.isColumnVector()) {
+        throw std::invalid_argument("x must be a column-vector");
+    }
+    //LCOV_EXCL_STOP
+    double * w = curvature_cache_prepare(x);
+    if (w != NULL) {
+        f = m_mu * log_logistic_kernel<true, true, true, true>(x.getData(), x.getNrows(), m_mu,
+                grad.getData(), z.getData(), Hz.getData(), w);
+    } else {
+        f = m_mu * log_logistic_kernel<true, true, true, false>(x.getData(), x.getNrows(), m_mu,
+                grad.getData(), z.getData(), Hz.getData(), NULL);
+    }
+    return ForBESUtils::STATUS_OK;
 }
 
 int LogLogisticLoss::hessianProduct(Matrix& x, Matrix& z, Matrix& Hz) {
@@ -78,19 +127,12 @@ int LogLogisticLoss::hessianProduct(Matrix& x, Matrix& z, Matrix& Hz) {
         throw std::invalid_argument("x must be a column-vector");
     }
     //LCOV_EXCL_STOP
-    int status = ForBESUtils::STATUS_OK;
-    for (size_t i = 0; i < x.getNrows(); i++) {        
-        double xi = x[i];
-        if (xi < 33) {                      /* because for values higher than 33, 
-                                             * s1 is practically equal to 1. 
-                                             * This saves the computational burden for
-                                             * high values of x_i */
-            double si = std::exp(xi);       /* si = e^xi              */
-            si = si / (1 + si);             /* si = e^xi / (1+e^xi)   */
-            Hz[i] = m_mu * z[i] * si * (1 - si);
-        }
+    if (curvature_cache_product(x, z, Hz)) {
+        return ForBESUtils::STATUS_OK;
     }
-    return status;
+    log_logistic_kernel<false, false, true, false>(x.getData(), x.getNrows(), m_mu,
+            NULL, z.getData(), Hz.getData(), NULL);
+    return ForBESUtils::STATUS_OK;
 }
 
 FunctionOntologicalClass LogLogisticLoss::category() {
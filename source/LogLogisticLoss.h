@@ -56,6 +56,18 @@
  * \f[
  *  (\nabla^2 f(x))_{ii} = \frac{\mu e^{x_i}}{(1+e^{x_i})^2}.
  * \f]
+ * 
+ * All of the above are evaluated through the softplus identity
+ * \f$-\ln\sigma(z) = \max(-z, 0) + \ln(1+e^{-|z|})\f$, which involves only 
+ * exponentials of non-positive numbers and is, therefore, accurate for any 
+ * \f$z\in\mathbb{R}\f$. The element-wise loops are vectorized and, when the 
+ * library is compiled with OpenMP support, executed in parallel for vectors 
+ * with at least \c MATRIX_PARALLEL_THRESHOLD entries.
+ * 
+ * This function supports the \link Function::setCurvatureCache curvature 
+ * cache\endlink: when it is enabled, the computation of the gradient stores 
+ * the diagonal of the Hessian, so that #hessianProduct at the same point 
+ * involves no evaluations of exponentials.
  */
 
 class LogLogisticLoss : public Function {
@@ -80,6 +92,20 @@ public:
 
     virtual int call(Matrix& x, double& f);
 
+    /**
+     * Computes the value of the function at \f$x\f$, its gradient and the
+     * product of its Hessian at \f$x\f$ with a given vector \f$z\f$ in a 
+     * single pass over the data (for instance, within Newton-type methods).
+     * 
+     * @param x vector x
+     * @param f value \f$f(x)\f$
+     * @param grad gradient \f$\nabla f(x)\f$
+     * @param z vector z
+     * @param Hz Hessian-vector product \f$\nabla^2 f(x)z\f$
+     * @return status code (<code>STATUS_OK</code>)
+     */
+    int call(Matrix& x, double& f, Matrix& grad, Matrix& z, Matrix& Hz);
+
     virtual int hessianProduct(Matrix& x, Matrix& z, Matrix& Hz);
 
     virtual FunctionOntologicalClass category();
@@ -19,6 +19,7 @@
  */
 
 #include "Matrix.h"
+#include "MatrixParallel.h"
 #include <iostream>
 #include <stdexcept>
 #include <complex>
@@ -29,6 +30,7 @@
 #include <cstring>
 #include <assert.h>
 #include <limits>
+#include <sys/mman.h>
 
 #ifdef USE_LIBS
 #include <cblas.h>
@@ -39,6 +41,23 @@
 
 cholmod_common* Matrix::ms_singleton = NULL;
 
+int Matrix::ms_num_threads = 0;
+
+void Matrix::set_num_threads(int num_threads) {
+    if (num_threads < 0) {
+        throw std::invalid_argument("The number of threads cannot be negative");
+    }
+    ms_num_threads = num_threads;
+}
+
+int Matrix::get_num_threads() {
+#ifdef _OPENMP
+    return ms_num_threads > 0 ? ms_num_threads : omp_get_max_threads();
+#else
+    return 1;
+#endif
+}
+
 cholmod_common* Matrix::cholmod_handle() {
     if (ms_singleton == NULL) {
         ms_singleton = new cholmod_common;
@@ -68,8 +87,13 @@ Matrix::Matrix() {
     m_triplet = NULL;
     m_sparse = NULL;
     m_dense = NULL;
+    m_csc = NULL;
+    m_csr = NULL;
+    m_dual_storage = false;
     m_sparseStorageType = CHOLMOD_TYPE_TRIPLET;
     m_delete_data = true;
+    m_map_addr = NULL;
+    m_map_length = 0;
 }
 
 Matrix::Matrix(std::pair<size_t, size_t> dimensions) {
@@ -107,6 +131,11 @@ Matrix::Matrix(const Matrix& orig) {
     m_triplet = NULL;
     m_sparse = NULL;
     m_dense = NULL;
+    m_csc = NULL;
+    m_csr = NULL;
+    m_dual_storage = orig.m_dual_storage;
+    m_map_addr = NULL;
+    m_map_length = 0;
     m_type = orig.m_type;
     if (orig.m_type != MATRIX_SPARSE) {
         size_t n = orig.m_dataLength;
@@ -135,6 +164,7 @@ Matrix::Matrix(const Matrix& orig) {
 Matrix::~Matrix() {
     m_ncols = 0;
     m_nrows = 0;
+    _releaseMapping();
     if (m_data != NULL && m_delete_data) {
         delete[] m_data;
     }
@@ -153,6 +183,7 @@ Matrix::~Matrix() {
         cholmod_free_dense(&m_dense, Matrix::cholmod_handle());
         m_dense = NULL;
     }
+    _invalidateCsc();
 }
 
 /********* GETTERS/SETTERS ************/
@@ -172,6 +203,10 @@ bool Matrix::isEmpty() const {
     return (m_nrows == 0 || m_ncols == 0);
 }
 
+bool Matrix::isMapped() const {
+    return m_map_addr != NULL;
+}
+
 bool Matrix::isColumnVector() const {
     return this -> m_ncols == 1;
 }
@@ -293,6 +328,9 @@ void Matrix::set(size_t i, size_t j, double v) {
             _createTriplet();
         }
         if (m_triplet->nnz == m_triplet->nzmax) { /* max NNZ exceeded */
+            if (m_map_addr != NULL) {
+                throw std::logic_error("Cannot add nonzero elements to a memory-mapped sparse matrix");
+            }
             cholmod_reallocate_triplet(m_triplet->nzmax + 1, m_triplet, Matrix::cholmod_handle());
         }
 
@@ -315,6 +353,7 @@ void Matrix::set(size_t i, size_t j, double v) {
             (static_cast<double*> (m_triplet->x))[k_found] = v;
         }
         /* Invalidate alternative sparse representations */
+        _invalidateCsc();
         if (m_sparse != NULL) {
             cholmod_free_sparse(&m_sparse, Matrix::cholmod_handle());
         }
@@ -434,19 +473,21 @@ double Matrix::quad(Matrix& x, Matrix & q) const {
 
 void Matrix::plusop() {
     if (m_type != Matrix::MATRIX_SPARSE) {
-        for (size_t i = 0; i < length(); i++) {
-            if (m_data[i] < 0) {
-                m_data[i] = 0.0;
-            }
+        const size_t n = length();
+        double * data = m_data;
+        MATRIX_PARALLEL_FOR_SIMD(n)
+        for (size_t i = 0; i < n; i++) {
+            data[i] = data[i] < 0.0 ? 0.0 : data[i];
         }
     } else {
         if (m_triplet != NULL) {
-            for (size_t k = 0; k < m_triplet->nnz; k++) {
-                double * val = (static_cast<double*> (m_triplet->x)) + k;
-                if (*val < 0) {
-                    *val = 0.0;
-                }
+            const size_t nnz = m_triplet->nnz;
+            double * val = static_cast<double*> (m_triplet->x);
+            MATRIX_PARALLEL_FOR_SIMD(nnz)
+            for (size_t k = 0; k < nnz; k++) {
+                val[k] = val[k] < 0.0 ? 0.0 : val[k];
             }
+            _invalidateCsc();
         } else if (m_sparse != NULL) {
             for (size_t j = 0; j < m_ncols; j++) {
                 int p = (static_cast<int*> (m_sparse->p))[j];
@@ -469,8 +510,12 @@ void Matrix::plusop(Matrix* mat) const {
         if (length() != mat->length()) {
             throw std::invalid_argument("Input matrix allocation/size error");
         }
-        for (size_t i = 0; i < length(); i++) {
-            mat->m_data[i] = m_data[i] < 0.0 ? 0.0 : m_data[i];
+        const size_t n = length();
+        const double * data = m_data;
+        double * out = mat->m_data;
+        MATRIX_PARALLEL_FOR_SIMD(n)
+        for (size_t i = 0; i < n; i++) {
+            out[i] = data[i] < 0.0 ? 0.0 : data[i];
         }
     } else {
         throw std::logic_error("Not implemented yet");
@@ -483,6 +528,20 @@ bool Matrix::operator==(const Matrix & right) const {
     bool result = (m_type == right.m_type) &&
             (m_ncols == right.m_ncols) &&
             (m_nrows == right.m_nrows);
+    if (result && m_type == MATRIX_DENSE && m_transpose == right.m_transpose) {
+        /* same storage layout: compare the data arrays directly */
+        const size_t n = length();
+        const double * left_data = m_data;
+        const double * right_data = right.m_data;
+#ifdef _OPENMP
+#pragma omp parallel for if (n >= MATRIX_PARALLEL_THRESHOLD) \
+        num_threads(Matrix::get_num_threads()) reduction(&&:result)
+#endif
+        for (size_t i = 0; i < n; i++) {
+            result = result && (std::abs(left_data[i] - right_data[i]) < tol);
+        }
+        return result;
+    }
     for (unsigned int i = 0; i < m_nrows; i++) {
         for (size_t j = 0; j < m_ncols; j++) {
             result = result && (std::abs(get(i, j) - right.get(i, j)) < tol);
@@ -550,7 +609,8 @@ inline void Matrix::vectorAdd(size_t len, double* pV1, const double* pV2) {
 #ifdef USE_LIBS 
     cblas_daxpy(len, 1.0, pV2, 1, pV1, 1); // data = data + right.data
 #else
-    for (int i = 0; i < len; i++)
+    MATRIX_PARALLEL_FOR_SIMD(len)
+    for (size_t i = 0; i < len; i++)
         pV1[i] += pV2[i];
 #endif
 }
@@ -653,6 +713,8 @@ Matrix & Matrix::operator=(const Matrix & right) {
         return *this; // Yes, so skip assignment, and just return *this.
     }
 
+    _releaseMapping();
+
     /*
      * Copy basic properties
      */
@@ -660,6 +722,8 @@ Matrix & Matrix::operator=(const Matrix & right) {
     m_ncols = right.m_ncols;
     m_nrows = right.m_nrows;
     m_type = right.m_type;
+    _invalidateCsc();
+    m_dual_storage = right.m_dual_storage;
     m_triplet = NULL;
     m_sparse = NULL;
     m_dense = NULL;
@@ -725,10 +789,10 @@ Matrix & Matrix::operator=(const Matrix & right) {
 /********* PRIVATE METHODS ************/
 void Matrix::domm(const Matrix &right, Matrix & result) const {
     // multiply with LHS being dense
-    double t;
+    MATRIX_PARALLEL_FOR_IF(result.m_type == MATRIX_DENSE && m_nrows * right.m_ncols >= MATRIX_PARALLEL_THRESHOLD)
     for (size_t j = 0; j < right.m_ncols; j++) {
         for (size_t i = 0; i < m_nrows; i++) {
-            t = 0.0;
+            double t = 0.0;
             for (size_t k = 0; k < m_ncols; k++) {
                 if (!(right.getType() == MATRIX_LOWERTR && k < j)) {
                     t += get(i, k) * right.get(k, j);
@@ -741,11 +805,11 @@ void Matrix::domm(const Matrix &right, Matrix & result) const {
 
 void Matrix::domm(Matrix& C, double alpha, Matrix& A, Matrix& B, double gamma) {
     // multiply with A being dense
-    double t;
+    MATRIX_PARALLEL_FOR_IF(C.m_type == MATRIX_DENSE && C.m_nrows * B.m_ncols >= MATRIX_PARALLEL_THRESHOLD)
     for (size_t j = 0; j < B.m_ncols; j++) {
         for (size_t i = 0; i < C.m_nrows; i++) {
-            t = 0.0;
-            for (size_t k = 0; k < C.m_ncols; k++) {
+            double t = 0.0;
+            for (size_t k = 0; k < A.getNcols(); k++) {
                 if (!(B.getType() == MATRIX_LOWERTR && k < j)) {
                     t += A.get(i, k) * B.get(k, j);
                 }
@@ -816,6 +880,7 @@ Matrix Matrix::multiplyLeftSymmetric(const Matrix & right) const {
 Matrix Matrix::multiplyLeftDiagonal(const Matrix & right) const {
     // multiply when the LHS is diagonal
     Matrix result(m_nrows, right.m_ncols, right.m_type);
+    MATRIX_PARALLEL_FOR_IF(m_nrows * right.m_ncols >= MATRIX_PARALLEL_THRESHOLD)
     for (size_t i = 0; i < m_nrows; i++) {
         if (MATRIX_SYMMETRIC == right.m_type) {
             for (size_t j = i; j < right.m_ncols; j++) {
@@ -847,13 +912,19 @@ Matrix Matrix::multiplyLeftSparse(Matrix & right) {
             right._createSparse();
         }
         cholmod_sparse *r;
+        cholmod_sparse *lhs_tr = (isColumnVector() && right.isColumnVector())
+                ? cholmod_transpose(m_sparse, 1, Matrix::cholmod_handle())
+                : NULL;
         r = cholmod_ssmult(
-                (isColumnVector() && right.isColumnVector()) ? cholmod_transpose(m_sparse, 1, Matrix::cholmod_handle()) : m_sparse,
+                lhs_tr != NULL ? lhs_tr : m_sparse,
                 right.m_sparse,
                 0,
                 true,
                 false,
                 Matrix::cholmod_handle());
+        if (lhs_tr != NULL) {
+            cholmod_free_sparse(&lhs_tr, Matrix::cholmod_handle());
+        }
         Matrix result(true);
         if (isColumnVector() && right.isColumnVector()) { /* Sparse-sparse dot product */
             result = Matrix(1, 1, Matrix::MATRIX_SPARSE);
@@ -864,61 +935,10 @@ Matrix Matrix::multiplyLeftSparse(Matrix & right) {
         result._createTriplet();
         return result;
     } else if (right.m_type == MATRIX_DENSE) { /* SPRASE * DENSE */
-        // RHS is dense
-        Matrix result(getNrows(), right.getNcols());
-
-        if (m_triplet != NULL && m_sparse == NULL)
-            _createSparse();
-
-        double alpha[2] = {1.0, 0.0};
-        double beta[2] = {0.0, 0.0};
-
-        if (right.m_dense == NULL) { /* Prepare right.m_dense */
-            right.m_dense = cholmod_allocate_dense(
-                    right.getNrows(),
-                    right.getNcols(),
-                    right.getNrows(),
-                    CHOLMOD_REAL,
-                    Matrix::cholmod_handle());
-
-            if (!right.m_transpose) {
-                right.m_dense->x = right.m_data;
-            } else {
-                /* Store RHS as transpose into right.m_dense */
-                for (size_t i = 0; i < right.getNrows(); i++) { /* SPARSE x DENSE' */
-                    for (size_t j = 0; j < right.getNcols(); j++) {
-                        (static_cast<double*> (right.m_dense->x))[i + j * right.getNrows()] =
-                                right.get(i, j);
-                    }
-                }
-            }
-        }
-
         bool dotProd = isColumnVector() && right.isColumnVector();
-        result.m_dense = cholmod_allocate_dense(
-                dotProd ? 1 : result.getNrows(),
-                dotProd ? 1 : result.getNcols(),
-                dotProd ? 1 : result.getNrows(),
-                CHOLMOD_REAL,
-                Matrix::cholmod_handle());
-        if (m_transpose) {
-            this->transpose();
-        }
-        cholmod_sdmult(
-                m_sparse,
-                dotProd ? true : m_transpose,
-                alpha,
-                beta,
-                right.m_dense,
-                result.m_dense,
-                Matrix::cholmod_handle()
-                );
-        if (m_transpose) {
-            this->transpose();
-        }
-        for (size_t k = 0; k < result.length(); k++) {
-            result.m_data[k] = (static_cast<double*> (result.m_dense->x))[k];
-        }
+        Matrix result(dotProd ? 1 : getNrows(), right.getNcols());
+        /* a sparse column vector times a dense column vector is x'*y */
+        spmv(result, 1.0, *this, dotProd, right, 0.0);
         return result;
     } else if (right.m_type == MATRIX_DIAGONAL) { // SPARSE * DIAGONAL = SPARSE
         Matrix result(*this); // COPY [result := right]
@@ -954,6 +974,11 @@ void Matrix::init(size_t nr, size_t nc, MatrixType mType) {
     this -> m_triplet = NULL;
     this -> m_sparse = NULL;
     this -> m_dense = NULL;
+    this -> m_csc = NULL;
+    this -> m_csr = NULL;
+    this -> m_dual_storage = false;
+    this -> m_map_addr = NULL;
+    this -> m_map_length = 0;
     switch (m_type) {
         case MATRIX_DENSE:
             m_dataLength = nc * nr;
@@ -999,12 +1024,117 @@ void Matrix::_createSparse() {
 }
 
 void Matrix::_createTriplet() {
+    if (m_map_addr != NULL && m_triplet != NULL) {
+        return; /* the mapped triplets are the data of this matrix */
+    }
     _createSparse();
     if (m_sparse != NULL) { /* make triplets from sparse */
+        _invalidateCsc();
         m_triplet = cholmod_sparse_to_triplet(m_sparse, Matrix::cholmod_handle());
     }
 }
 
+/*
+ * The compressed formats are created lazily by logically const operations
+ * (e.g., products), which may run concurrently on the same matrix, e.g., in
+ * FBSplitting::runBatch or SeparableSum. The conversions are serialized and
+ * m_csc/m_csr are set only once they are complete.
+ */
+void Matrix::_createCsc() {
+    if (m_csc != NULL) {
+        return;
+    }
+#ifdef _OPENMP
+#pragma omp critical(forbes_matrix_compressed)
+#endif
+    {
+        if (m_csc == NULL) {
+            if (m_triplet == NULL) {
+                _createTriplet();
+            }
+            cholmod_sparse * csc = cholmod_triplet_to_sparse(m_triplet, m_triplet->nnz, Matrix::cholmod_handle());
+            m_csc = csc;
+        }
+    }
+}
+
+void Matrix::_createCsr() {
+    _createCsc();
+    if (m_csr != NULL) {
+        return;
+    }
+#ifdef _OPENMP
+#pragma omp critical(forbes_matrix_compressed)
+#endif
+    {
+        if (m_csr == NULL) {
+            cholmod_sparse * csr = cholmod_transpose(m_csc, 1, Matrix::cholmod_handle());
+            m_csr = csr;
+        }
+    }
+}
+
+void Matrix::_invalidateCsc() {
+    if (m_csc != NULL) {
+        const char * map_begin = static_cast<const char*> (m_map_addr);
+        const char * p = static_cast<const char*> (m_csc->p);
+        if (map_begin != NULL && p >= map_begin && p < map_begin + m_map_length) {
+            /* the arrays of a memory-mapped m_csc live in the mapping; free the header only */
+            m_csc->p = NULL;
+            m_csc->i = NULL;
+            m_csc->x = NULL;
+        }
+        cholmod_free_sparse(&m_csc, Matrix::cholmod_handle());
+        m_csc = NULL;
+    }
+    if (m_csr != NULL) {
+        cholmod_free_sparse(&m_csr, Matrix::cholmod_handle());
+        m_csr = NULL;
+    }
+}
+
+void Matrix::_checkStructureMutable() const {
+    if (m_type == MATRIX_SPARSE && m_map_addr != NULL) {
+        throw std::logic_error("Cannot update a memory-mapped sparse matrix in place");
+    }
+}
+
+void Matrix::_releaseMapping() {
+    if (m_map_addr == NULL) {
+        return;
+    }
+    if (m_type == MATRIX_SPARSE) {
+        _invalidateCsc();
+        if (m_triplet != NULL) {
+            /* the arrays of m_triplet live in the mapping; free the header only */
+            m_triplet->i = NULL;
+            m_triplet->j = NULL;
+            m_triplet->x = NULL;
+            cholmod_free_triplet(&m_triplet, Matrix::cholmod_handle());
+            m_triplet = NULL;
+        }
+    } else {
+        m_data = NULL;
+        m_dataLength = 0;
+        m_delete_data = false;
+    }
+    munmap(m_map_addr, m_map_length);
+    m_map_addr = NULL;
+    m_map_length = 0;
+}
+
+void Matrix::setDualStorage(bool dual_storage) {
+    m_dual_storage = dual_storage;
+    if (!dual_storage && m_csr != NULL) {
+        cholmod_free_sparse(&m_csr, Matrix::cholmod_handle());
+        m_csr = NULL;
+    }
+}
+
+bool Matrix::isDualStorage() const {
+    return m_dual_storage;
+}
+
 bool Matrix::isSymmetric() const {
     return (m_nrows == m_ncols) && ((Matrix::MATRIX_SYMMETRIC == m_type)
             || (Matrix::MATRIX_SPARSE == m_type && m_triplet != NULL && m_triplet->stype != 0)
@@ -1014,9 +1144,21 @@ bool Matrix::isSymmetric() const {
 Matrix& operator*=(Matrix& obj, double alpha) {
     if (obj.m_type != Matrix::MATRIX_SPARSE) {
         assert(obj.m_data != NULL);
+#ifdef _OPENMP
+        if (obj.m_dataLength >= MATRIX_PARALLEL_THRESHOLD) {
+            const size_t n = obj.m_dataLength;
+            double * data = obj.m_data;
+            MATRIX_PARALLEL_FOR_SIMD(n)
+            for (size_t i = 0; i < n; i++) {
+                data[i] *= alpha;
+            }
+            return obj;
+        }
+#endif
         cblas_dscal(obj.m_dataLength, alpha, obj.m_data, 1);
     } else {
         obj._createTriplet();
+        obj._invalidateCsc();
         obj.m_sparse = NULL;
         obj.m_dense = NULL;
         for (size_t k = 0; k < obj.m_triplet->nnz; k++) {
@@ -1193,7 +1335,12 @@ Matrix::Matrix(bool shallow) {
     m_triplet = NULL;
     m_sparse = NULL;
     m_dense = NULL;
+    m_csc = NULL;
+    m_csr = NULL;
+    m_dual_storage = false;
     m_sparseStorageType = CHOLMOD_TYPE_TRIPLET;
+    m_map_addr = NULL;
+    m_map_length = 0;
 }
 
 int Matrix::add(Matrix& C, double alpha, Matrix& A, double gamma) {
@@ -1201,6 +1348,7 @@ int Matrix::add(Matrix& C, double alpha, Matrix& A, double gamma) {
     if (C.getNcols() != A.getNcols() || C.getNrows() != A.getNrows()) {
         throw std::invalid_argument("LHS and RHS do not have compatible dimensions");
     }
+    C._checkStructureMutable();
     // C := gamma * C + alpha * A
     int status;
     switch (C.getType()) {
@@ -1238,8 +1386,12 @@ int Matrix::generic_add_helper_left_dense(Matrix& C, double alpha, Matrix& A, do
             cblas_daxpy(A.length(), alpha, A.m_data, 1, C.m_data, 1);
             return ForBESUtils::STATUS_OK;
         } else {
-            for (size_t i = 0; i < A.length(); i++) {
-                C.m_data[i] = (gamma * C.m_data[i]) + (alpha * A.m_data[i]);
+            const size_t n = A.length();
+            double * c_data = C.m_data;
+            const double * a_data = A.m_data;
+            MATRIX_PARALLEL_FOR_SIMD(n)
+            for (size_t i = 0; i < n; i++) {
+                c_data[i] = (gamma * c_data[i]) + (alpha * a_data[i]);
             }
         }
     } else if (type_of_A == MATRIX_DIAGONAL) { /* DENSE + DIAGONAL */
@@ -1444,6 +1596,7 @@ int Matrix::generic_add_helper_left_sparse(Matrix& C, double alpha, Matrix& A, d
                 true,
                 Matrix::cholmod_handle()); /* Use cholmod_add to compute the sum C := gamma * C + alpha * A */
 
+        C._invalidateCsc();
         C.m_triplet = cholmod_sparse_to_triplet(
                 C.m_sparse,
                 Matrix::cholmod_handle()); /* Update the triplet of the result (optional) */
@@ -1563,6 +1716,7 @@ int Matrix::mult(Matrix& C, double alpha, Matrix& A, Matrix& B, double gamma) {
                 << B.getNcols();
         throw std::invalid_argument(oss.str().c_str());
     }
+    C._checkStructureMutable();
     // C := gamma * C + alpha * A * B
     int status = ForBESUtils::STATUS_UNDEFINED_FUNCTION;
     switch (A.getType()) {
@@ -1621,18 +1775,41 @@ int Matrix::multiply_helper_left_dense(Matrix& C, double alpha, Matrix& A, Matri
     } else if (MATRIX_SYMMETRIC == B.m_type || MATRIX_LOWERTR == B.m_type) {
         domm(C, alpha, A, B, gamma);
         status = ForBESUtils::STATUS_OK;
-    } else { /* {DENSE} * {SPARSE} =  */
+    } else if (MATRIX_SPARSE == B.m_type && !C.m_transpose) { /* {DENSE} * {SPARSE} = {DENSE} */
         /*
-         * Trick: For D: dense, S: sparse it is
-         * D * S = (S' * D')'
+         * Every stored entry v = S(i,j) of B (B = S or S') contributes 
+         * alpha * v * A(:,k) to C(:,l) where (k,l) = (i,j), or (j,i) if B = S'.
          */
-        //        Matrix tempSparse(right);
-        //        (const_cast<Matrix&> (*this)).transpose(); /*  D'  */
-        //        tempSparse.transpose(); /*  S'  */
-        //        Matrix r = tempSparse * (const_cast<Matrix&> (*this)); /*  r = S' * D'   */
-        //        r.transpose(); /*  r'  */
-        //        (const_cast<Matrix&> (*this)).transpose(); /*  D  */
-        //        return r;
+        B._createCsc();
+        const cholmod_sparse * S = B.m_csc;
+        const int * Sp = static_cast<const int*> (S->p);
+        const int * Si = static_cast<const int*> (S->i);
+        const double * Sx = static_cast<const double*> (S->x);
+        const size_t m = C.m_nrows;
+        const int inc_a = A.m_transpose ? A.m_ncols : 1;
+        const size_t stride_a = A.m_transpose ? 1 : A.m_nrows;
+        const bool upper = S->stype > 0;
+        if (std::abs(gamma) < std::numeric_limits<double>::epsilon()) {
+            for (size_t l = 0; l < m * C.m_ncols; l++) C.m_data[l] = 0.0;
+        } else {
+            cblas_dscal(m * C.m_ncols, gamma, C.m_data, 1);
+        }
+        for (size_t j = 0; j < S->ncol; j++) {
+            for (int p = Sp[j]; p < Sp[j + 1]; p++) {
+                const size_t i = static_cast<size_t> (Si[p]);
+                if (S->stype != 0 && i != j && (i < j) != upper) continue;
+                const size_t k = B.m_transpose ? j : i;
+                const size_t l = B.m_transpose ? i : j;
+                cblas_daxpy(m, alpha * Sx[p], A.m_data + k * stride_a, inc_a, C.m_data + l * m, 1);
+                if (S->stype != 0 && i != j) {
+                    /* symmetric: the mirrored entry S(j,i) */
+                    cblas_daxpy(m, alpha * Sx[p], A.m_data + l * stride_a, inc_a, C.m_data + k * m, 1);
+                }
+            }
+        }
+        status = ForBESUtils::STATUS_OK;
+    } else {
+        status = ForBESUtils::STATUS_UNDEFINED_FUNCTION;
     }
     return status;
 }
@@ -1654,15 +1831,19 @@ int Matrix::multiply_helper_left_sparse(Matrix& C, double alpha, Matrix& A, Matr
             C._createSparse();
         }
         cholmod_sparse *r; // r will store A * B
-        r = cholmod_ssmult(
-                (A.isColumnVector() && B.isColumnVector())
+        cholmod_sparse *A_tr = (A.isColumnVector() && B.isColumnVector())
                 ? cholmod_transpose(A.m_sparse, 1, Matrix::cholmod_handle())
-                : A.m_sparse,
+                : NULL;
+        r = cholmod_ssmult(
+                A_tr != NULL ? A_tr : A.m_sparse,
                 B.m_sparse,
                 0,
                 true,
                 false,
                 Matrix::cholmod_handle()); // r = A*B
+        if (A_tr != NULL) {
+            cholmod_free_sparse(&A_tr, Matrix::cholmod_handle());
+        }
 
         /*
          * SCALE: r *= alpha (unless alpha == 1)
@@ -1683,6 +1864,7 @@ int Matrix::multiply_helper_left_sparse(Matrix& C, double alpha, Matrix& A, Matr
         if (is_gamma_zero) {
             cholmod_triplet * r_to_triplet = cholmod_sparse_to_triplet(r, Matrix::cholmod_handle());
             // C := alpha * A * B = r
+            C._invalidateCsc();
             C.m_sparse = r;
             C.m_triplet = r_to_triplet;
             status = ForBESUtils::STATUS_OK;
@@ -1697,65 +1879,8 @@ int Matrix::multiply_helper_left_sparse(Matrix& C, double alpha, Matrix& A, Matr
             status = ForBESUtils::STATUS_OK;
         }
     } else if (B.m_type == MATRIX_DENSE) { /* C = gamma * C + alpha * SPARSE * DENSE */
-
-
-        // RHS is dense
-        //                Matrix result(A.getNrows(), B..getNcols());
-
-        //        if (A.m_triplet != NULL && A.m_sparse == NULL)
-        //            A._createSparse();
-        //
-        //        double alpha[2] = {1.0, 0.0};
-        //        double beta[2] = {0.0, 0.0};
-        //
-        //        if (B.m_dense == NULL) { /* Prepare right.m_dense */
-        //            B.m_dense = cholmod_allocate_dense(
-        //                    B.getNrows(),
-        //                    B.getNcols(),
-        //                    B.getNrows(),
-        //                    CHOLMOD_REAL,
-        //                    Matrix::cholmod_handle());
-        //
-        //            if (!B.m_transpose) {
-        //                B.m_dense->x = B.m_data;
-        //            } else {
-        //                /* Store RHS as transpose into right.m_dense */
-        //                for (size_t i = 0; i < B.getNrows(); i++) { /* SPARSE x DENSE' */
-        //                    for (size_t j = 0; j < B.getNcols(); j++) {
-        //                        (static_cast<double*> (B.m_dense->x))[i + j * B.getNrows()] = B.get(i, j);
-        //                    }
-        //                }
-        //            }
-        //        }
-        //
-        //        bool dotProd = isColumnVector() && B.isColumnVector();
-        //        C.m_dense = cholmod_allocate_dense(
-        //                dotProd ? 1 : B.getNrows(),
-        //                dotProd ? 1 : B.getNcols(),
-        //                dotProd ? 1 : B.getNrows(),
-        //                CHOLMOD_REAL,
-        //                Matrix::cholmod_handle());
-
-        //        if (m_transpose) {
-        //            this->transpose();
-        //        }
-        //        cholmod_sdmult(
-        //                m_sparse,
-        //                dotProd ? true : m_transpose,
-        //                alpha,
-        //                beta,
-        //                right.m_dense,
-        //                result.m_dense,
-        //                Matrix::cholmod_handle()
-        //                );
-        //        if (m_transpose) {
-        //            this->transpose();
-        //        }
-        //        for (size_t k = 0; k < result.length(); k++) {
-        //            result.m_data[k] = (static_cast<double*> (result.m_dense->x))[k];
-        //        }
-
-
+        spmv(C, alpha, A, false, B, gamma);
+        status = ForBESUtils::STATUS_OK;
     } else if (B.m_type == MATRIX_DIAGONAL) { // += alpha * SPARSE * DIAGONAL
         Matrix A_temp(A); //  Compute A_temp = A * alpha;
         for (size_t k = 0; k < A.m_triplet->nnz; k++) {
@@ -1771,7 +1896,166 @@ int Matrix::multiply_helper_left_sparse(Matrix& C, double alpha, Matrix& A, Matr
     return status;
 }
 
+void Matrix::spmv(Matrix& C, double alpha, Matrix& A, bool trans, Matrix& B, double gamma) {
+    if (C.m_type != MATRIX_DENSE || C.m_transpose || B.m_transpose) {
+        /* Rare case: work on untransposed dense copies */
+        Matrix B_copy(B.getNrows(), B.getNcols());
+        for (size_t i = 0; i < B.getNrows(); i++) {
+            for (size_t j = 0; j < B.getNcols(); j++) {
+                B_copy.set(i, j, B.get(i, j));
+            }
+        }
+        Matrix T(C.getNrows(), C.getNcols());
+        spmv(T, 1.0, A, trans, B_copy, 0.0);
+        add(C, alpha, T, gamma);
+        return;
+    }
+
+    A._createCsc();
+    const cholmod_sparse * S = A.m_csc; /* S: A or A' as stored in m_triplet */
+    const int * Sp = static_cast<const int*> (S->p);
+    const int * Si = static_cast<const int*> (S->i);
+    const double * Sx = static_cast<const double*> (S->x);
+    const size_t ns = S->ncol;
+    const size_t ms = S->nrow;
+
+    /* op(A) = S or S' */
+    const bool use_transpose = (trans != A.m_transpose);
+    const bool is_gamma_zero = (std::abs(gamma) < std::numeric_limits<double>::epsilon());
+    const size_t nrhs = B.getNcols();
+    const size_t ldb = B.getNrows();
+    const size_t ldc = C.getNrows();
+
+    /*
+     * When B has several columns (right-hand sides), the loops over the
+     * right-hand sides are innermost, so that S is read from memory only once
+     * for all of them; every column (or row) of S is then reused from cache.
+     */
+
+    if (S->stype != 0) {
+        /* S is symmetric and only one of its triangles is stored */
+        const bool upper = S->stype > 0;
+        for (size_t l = 0; l < nrhs * ldc; l++) {
+            C.m_data[l] = is_gamma_zero ? 0.0 : gamma * C.m_data[l];
+        }
+        for (size_t j = 0; j < ns; j++) {
+            for (int p = Sp[j]; p < Sp[j + 1]; p++) {
+                const size_t i = static_cast<size_t> (Si[p]);
+                const double v = alpha * Sx[p];
+                if (i == j) {
+                    for (size_t r = 0; r < nrhs; r++) {
+                        C.m_data[i + r * ldc] += v * B.m_data[j + r * ldb];
+                    }
+                } else if ((i < j) == upper) {
+                    for (size_t r = 0; r < nrhs; r++) {
+                        C.m_data[i + r * ldc] += v * B.m_data[j + r * ldb];
+                        C.m_data[j + r * ldc] += v * B.m_data[i + r * ldb];
+                    }
+                }
+            }
+        }
+    } else if (!use_transpose && A.m_dual_storage) {
+        /* C(i,r) = gamma * C(i,r) + alpha * S(i,:) * B(:,r) (rows of S are
+         * the columns of m_csr) */
+        A._createCsr();
+        const cholmod_sparse * R = A.m_csr;
+        const int * Rp = static_cast<const int*> (R->p);
+        const int * Ri = static_cast<const int*> (R->i);
+        const double * Rx = static_cast<const double*> (R->x);
+        const size_t nnz = static_cast<size_t> (Rp[ms]);
+        MATRIX_PARALLEL_FOR_IF(nnz * nrhs >= MATRIX_PARALLEL_THRESHOLD)
+        for (size_t i = 0; i < ms; i++) {
+            for (size_t r = 0; r < nrhs; r++) {
+                const double * b = B.m_data + r * ldb;
+                double t = 0.0;
+                for (int p = Rp[i]; p < Rp[i + 1]; p++) {
+                    t += Rx[p] * b[Ri[p]];
+                }
+                double * c = C.m_data + r * ldc;
+                c[i] = is_gamma_zero ? alpha * t : gamma * c[i] + alpha * t;
+            }
+        }
+    } else if (!use_transpose) {
+        /* C(:,r) = gamma * C(:,r) + alpha * S * B(:,r) (scatter by columns) */
+        for (size_t l = 0; l < nrhs * ldc; l++) {
+            C.m_data[l] = is_gamma_zero ? 0.0 : gamma * C.m_data[l];
+        }
+        for (size_t j = 0; j < ns; j++) {
+            for (size_t r = 0; r < nrhs; r++) {
+                const double bj = alpha * B.m_data[j + r * ldb];
+                if (bj == 0.0) continue;
+                double * c = C.m_data + r * ldc;
+                for (int p = Sp[j]; p < Sp[j + 1]; p++) {
+                    c[Si[p]] += Sx[p] * bj;
+                }
+            }
+        }
+    } else {
+        /* C(j,r) = gamma * C(j,r) + alpha * S(:,j)' * B(:,r) (dot products) */
+        const size_t nnz = static_cast<size_t> (Sp[ns]);
+        MATRIX_PARALLEL_FOR_IF(nnz * nrhs >= MATRIX_PARALLEL_THRESHOLD)
+        for (size_t j = 0; j < ns; j++) {
+            for (size_t r = 0; r < nrhs; r++) {
+                const double * b = B.m_data + r * ldb;
+                double t = 0.0;
+                for (int p = Sp[j]; p < Sp[j + 1]; p++) {
+                    t += Sx[p] * b[Si[p]];
+                }
+                double * c = C.m_data + r * ldc;
+                c[j] = is_gamma_zero ? alpha * t : gamma * c[j] + alpha * t;
+            }
+        }
+    }
+}
+
+int Matrix::multTranspose(Matrix& C, double alpha, Matrix& A, Matrix& B, double gamma) {
+    if (A.getNrows() != B.getNrows()) {
+        std::ostringstream oss;
+        oss << "A' (" << A.getNcols() << "x" << A.getNrows()
+                << ") and B (" << B.getNrows() << "x" << B.getNcols()
+                << ") do not have compatible dimensions";
+        throw std::invalid_argument(oss.str().c_str());
+    }
+    if (C.getNrows() != A.getNcols() || C.getNcols() != B.getNcols()) {
+        std::ostringstream oss;
+        oss << "C is " << C.getNrows() << "x" << C.getNcols()
+                << ", but it should be " << A.getNcols() << "x"
+                << B.getNcols();
+        throw std::invalid_argument(oss.str().c_str());
+    }
+    C._checkStructureMutable();
+    if (A.m_type == MATRIX_SPARSE && B.m_type == MATRIX_DENSE) {
+        spmv(C, alpha, A, true, B, gamma);
+        return ForBESUtils::STATUS_OK;
+    }
+    if (A.m_type == MATRIX_DENSE && B.m_type == MATRIX_DENSE
+            && C.m_type == MATRIX_DENSE && !C.m_transpose) {
+        /* A is not modified, so A may be shared (or be the same as B) */
+        cblas_dgemm(CblasColMajor,
+                A.m_transpose ? CblasNoTrans : CblasTrans,
+                B.m_transpose ? CblasTrans : CblasNoTrans,
+                A.m_ncols,
+                B.m_ncols,
+                A.m_nrows,
+                alpha,
+                A.m_data,
+                A.m_transpose ? A.m_ncols : A.m_nrows,
+                B.m_data,
+                B.m_transpose ? B.m_ncols : B.m_nrows,
+                gamma,
+                C.m_data,
+                C.m_nrows);
+        return ForBESUtils::STATUS_OK;
+    }
+    A.transpose();
+    int status = mult(C, alpha, A, B, gamma);
+    A.transpose();
+    return status;
+}
+
 int Matrix::multiply_helper_left_diagonal(Matrix& C, double alpha, Matrix& A, Matrix& B, double gamma) {
+    /* every row of C is updated independently (unless C is sparse) */
+    MATRIX_PARALLEL_FOR_IF(C.m_type != MATRIX_SPARSE && C.m_nrows * B.m_ncols >= MATRIX_PARALLEL_THRESHOLD)
     for (size_t i = 0; i < C.m_nrows; i++) {
         if (MATRIX_SYMMETRIC == B.m_type) {
             for (size_t j = i; j < B.m_ncols; j++) {
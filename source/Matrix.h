@@ -27,6 +27,17 @@
 #include "ForBESUtils.h"
 #include <utility>
 
+/**
+ * Number of elements above which the element-wise kernels of Matrix (e.g.,
+ * Matrix::plusop, scalar multiplication, addition and comparison of dense
+ * matrices and multiplication by diagonal matrices) are executed in parallel.
+ * This has an effect only if the library is compiled with OpenMP support
+ * (e.g., <code>make DO_OPENMP=1</code>).
+ */
+#ifndef MATRIX_PARALLEL_THRESHOLD
+#define MATRIX_PARALLEL_THRESHOLD 10000
+#endif
+
 /**
  * \class Matrix
  * \version version 0.3
@@ -93,6 +104,26 @@ public:
      */
     static int destroy_handle();
 
+    /**
+     * Sets the number of threads used by the element-wise kernels of this
+     * class on matrices with at least \c MATRIX_PARALLEL_THRESHOLD elements.
+     * 
+     * If the library is compiled without OpenMP support, this setting has no
+     * effect and all operations are serial.
+     *
+     * @param num_threads number of threads; use \c 0 to use the OpenMP default
+     * (see <code>omp_get_max_threads</code>)
+     * @throws std::invalid_argument if num_threads is negative
+     */
+    static void set_num_threads(int num_threads);
+
+    /**
+     * Number of threads used by the element-wise kernels of this class.
+     *
+     * @return number of threads (\c 1 if OpenMP is not enabled)
+     */
+    static int get_num_threads();
+
     /**
      * Types of matrices.
      */
@@ -351,6 +382,18 @@ public:
      */
     bool isEmpty() const;
 
+    /**
+     * Checks whether the data of this matrix live in a memory-mapped file,
+     * i.e., whether this matrix was created using MatrixFactory::MapBinary.
+     * 
+     * The mapping is released when this matrix is destroyed or assigned 
+     * another value. Copies of a memory-mapped matrix (created using the copy 
+     * constructor) own their data and are not memory-mapped.
+     *
+     * @return <code>true</code> if this matrix is memory-mapped.
+     */
+    bool isMapped() const;
+
     /**
      * Length of data of this matrix (e.g., if this is a diagonal matrix, only its
      * diagonal elements are stored, so the data length equals the row-dimension
@@ -435,6 +478,35 @@ public:
      */
     void toggle_diagonal();
 
+    /**
+     * Sets whether this sparse matrix keeps, besides its compressed-column
+     * storage, a compressed-row copy (i.e., a cached transpose) which is used
+     * in products with dense matrices.
+     * 
+     * With dual storage, both \f$Ax\f$ and \f$A^{\top}y\f$ are computed
+     * row by row (each entry of the result is an independent inner product),
+     * so both run in parallel without atomic updates when OpenMP is enabled
+     * (see #set_num_threads). This doubles the memory needed to store the
+     * matrix. Without dual storage, \f$Ax\f$ is computed serially by
+     * scattering the columns of \f$A\f$.
+     * 
+     * This setting has no effect on non-sparse matrices and on sparse 
+     * matrices which are stored as symmetric.
+     * 
+     * @param dual_storage whether to keep both storage layouts
+     */
+    void setDualStorage(bool dual_storage);
+
+    /**
+     * Whether this matrix uses dual (compressed-column and compressed-row)
+     * storage.
+     * 
+     * @return \c true if dual storage is enabled
+     * 
+     * \sa #setDualStorage
+     */
+    bool isDualStorage() const;
+
     /**
      * This idempotent method updates the entries of the current matrix by applying
      * element-wise the function <code>max(x, 0)</code>, i.e., it replaces all negative
@@ -699,6 +771,28 @@ public:
      */
     static int mult(Matrix& C, double alpha, Matrix& A, Matrix& B, double gamma);
 
+    /**
+     * Performs the following operation
+     * \f[
+     * C \leftarrow \gamma C + \alpha A^{\top} B,
+     * \f]
+     * 
+     * When \c A is sparse and \c B is dense, the product is computed directly
+     * from the (cached) compressed-column representation of \c A, so neither
+     * \c A is transposed nor is any memory allocated.
+     * 
+     * @param C reference of matrix to be updated
+     * @param alpha scalar which multiplies the product <code>A'B</code>
+     * @param A matrix A
+     * @param B matrix B
+     * @param gamma scalar which multiplies C
+     * @return status code (see #mult)
+     * 
+     * \exception std::invalid_argument An invalid argument exception is thrown
+     * if the matrices are not conformable.
+     */
+    static int multTranspose(Matrix& C, double alpha, Matrix& A, Matrix& B, double gamma);
+
 
 
 
@@ -737,11 +831,21 @@ private:
     cholmod_triplet *m_triplet; /**< Sparse triplets */
     cholmod_sparse *m_sparse; /**< A sparse matrix */
     cholmod_dense *m_dense; /**< A dense CHOLMOD matrix */
+    cholmod_sparse *m_csc; /**< Compressed-column copy of m_triplet used in sparse-dense products */
+    cholmod_sparse *m_csr; /**< Transpose of m_csc (compressed-row copy of m_triplet) */
+    bool m_dual_storage; /**< Whether m_csr is used in sparse-dense products */
+
+    /* Memory-mapped matrices */
+    void *m_map_addr; /**< Address of the file mapping m_data or the arrays of m_triplet and m_csc point to (or NULL) */
+    size_t m_map_length; /**< Length of the file mapping in bytes */
 
 
     /* SINGLETON CHOLMOD HANDLE */
     static cholmod_common *ms_singleton; /**< Singleton instance of cholmod_common */
 
+    /* NUMBER OF THREADS */
+    static int ms_num_threads; /**< Number of threads (0: OpenMP default) */
+
     /**
      * Instantiates <code>m_sparse</code> from <code>m_triplet</code>
      * using CHOLMOD's <code>cholmod_triplet_to_sparse</code>. Can only be
@@ -755,6 +859,40 @@ private:
      */
     void _createTriplet();
 
+    /**
+     * Creates m_csc from m_triplet, unless it already exists. Since m_triplet
+     * is not affected by #transpose(), neither is m_csc. It is safe to call
+     * this method concurrently from several OpenMP threads.
+     */
+    void _createCsc();
+
+    /**
+     * Creates m_csr (the transpose of m_csc), unless it already exists. It is
+     * safe to call this method concurrently from several OpenMP threads.
+     */
+    void _createCsr();
+
+    /**
+     * Frees m_csc and m_csr; this must be called whenever m_triplet is modified.
+     * The arrays of a memory-mapped m_csc (see MatrixFactory::MapBinary) are
+     * not freed.
+     */
+    void _invalidateCsc();
+
+    /**
+     * Releases the file mapping (if any) this matrix points to: m_data is set
+     * to NULL and a memory-mapped m_triplet is freed without touching its 
+     * arrays. Nothing happens if the matrix is not memory-mapped.
+     */
+    void _releaseMapping();
+
+    /**
+     * Throws a <code>std::logic_error</code> if this is a memory-mapped sparse
+     * matrix: its triplets live in the mapping, so they cannot be replaced by
+     * the result of an operation (e.g., by Matrix::add or Matrix::mult).
+     */
+    void _checkStructureMutable() const;
+
     /**
      * Initialize the current matrix (allocate memory etc) for a given number of
      * rows and columns and a given matrix type.
@@ -881,6 +1019,17 @@ private:
      * C := gamma * C + alpha*A*B, where A is sparse
      */
     static int multiply_helper_left_sparse(Matrix& C, double alpha, Matrix& A, Matrix& B, double gamma);
+    /**
+     * 
+     * C := gamma * C + alpha * op(A) * B, where A is sparse, B is dense and
+     * op(A) is A or its transpose (when trans is true).
+     * 
+     * The product is computed from the cached compressed-column storage of A
+     * (see #_createCsc) and written directly into C; no memory is allocated
+     * when B and C are dense and not stored as transposes. If B has several
+     * columns, A is traversed only once for all of them.
+     */
+    static void spmv(Matrix& C, double alpha, Matrix& A, bool trans, Matrix& B, double gamma);
     /**
      * 
      * C := gamma * C + alpha*A*B, where A is diagonal
@@ -22,6 +22,8 @@
 
 #include "MatrixFactory.h"
 #include "Matrix.h"
+#include "MatrixWriter.h"
+#include "MatrixParallel.h"
 
 #include <vector>       // std::vector
 #include <algorithm>    // std::random_shuffle
@@ -30,6 +32,15 @@
 
 #include <cmath>
 #include <sstream>
+#include <cstring>
+#include <cctype>
+#include <cstdlib>
+#include <climits>
+#include <stdexcept>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 typedef std::pair<size_t, size_t> nice_pair;
 
@@ -119,6 +130,541 @@ Matrix MatrixFactory::ReadSparse(FILE* fp) {
     return mat;
 }
 
+/* symmetry of a Matrix Market file */
+enum MMSymmetry {
+    MM_GENERAL,
+    MM_SYMMETRIC,
+    MM_SKEW_SYMMETRIC
+};
+
+/**
+ * Reads the whole stream into a null-terminated buffer.
+ */
+static void mm_read_stream(FILE* fp, std::vector<char>& buffer) {
+    struct stat st;
+    size_t capacity = 65536;
+    if (fstat(fileno(fp), &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+        capacity = st.st_size + 1;
+    }
+    buffer.resize(capacity);
+    size_t len = 0;
+    while (true) {
+        if (len == buffer.size()) {
+            buffer.resize(2 * buffer.size());
+        }
+        size_t n = fread(&buffer[len], 1, buffer.size() - len, fp);
+        if (n == 0) {
+            break;
+        }
+        len += n;
+    }
+    buffer.resize(len);
+    buffer.push_back('\0');
+}
+
+/**
+ * Returns the end of the line which starts at p, that is, the position of the
+ * next new-line character, or end.
+ */
+static const char* mm_line_end(const char* p, const char* end) {
+    const char * q = static_cast<const char*> (memchr(p, '\n', end - p));
+    return q == NULL ? end : q;
+}
+
+/**
+ * Whether line [p, e) holds data, i.e., it is neither blank nor a comment.
+ */
+static bool mm_is_data_line(const char* p, const char* e) {
+    while (p < e && (*p == ' ' || *p == '\t' || *p == '\r')) {
+        p++;
+    }
+    return p < e && *p != '%';
+}
+
+/**
+ * Number of data lines in [p, e).
+ */
+static size_t mm_count_entries(const char* p, const char* e) {
+    size_t count = 0;
+    while (p < e) {
+        const char * le = mm_line_end(p, e);
+        if (mm_is_data_line(p, le)) {
+            count++;
+        }
+        p = le + 1;
+    }
+    return count;
+}
+
+/**
+ * Parses the entries (i, j, value) in [p, e) of a file in coordinate format;
+ * returns false if an entry is malformed or out of bounds.
+ */
+static bool mm_parse_coordinate(const char* p, const char* e, bool pattern,
+        long nrows, long ncols, int* ii, int* jj, double* xx) {
+    size_t k = 0;
+    char * q;
+    while (p < e) {
+        const char * le = mm_line_end(p, e);
+        if (mm_is_data_line(p, le)) {
+            long i = strtol(p, &q, 10);
+            if (q == p || q > le) {
+                return false;
+            }
+            p = q;
+            long j = strtol(p, &q, 10);
+            if (q == p || q > le) {
+                return false;
+            }
+            p = q;
+            double v = 1.0;
+            if (!pattern) {
+                v = strtod(p, &q);
+                if (q == p || q > le) {
+                    return false;
+                }
+            }
+            if (i < 1 || i > nrows || j < 1 || j > ncols) {
+                return false;
+            }
+            ii[k] = static_cast<int> (i - 1);
+            jj[k] = static_cast<int> (j - 1);
+            xx[k] = v;
+            k++;
+        }
+        p = le + 1;
+    }
+    return true;
+}
+
+/**
+ * Parses the values in [p, e) of a file in array format; returns false if a
+ * value is malformed.
+ */
+static bool mm_parse_array(const char* p, const char* e, double* x) {
+    size_t k = 0;
+    char * q;
+    while (p < e) {
+        const char * le = mm_line_end(p, e);
+        if (mm_is_data_line(p, le)) {
+            x[k] = strtod(p, &q);
+            if (q == p || q > le) {
+                return false;
+            }
+            k++;
+        }
+        p = le + 1;
+    }
+    return true;
+}
+
+static std::string mm_lowercase(std::string token) {
+    for (size_t k = 0; k < token.size(); k++) {
+        token[k] = std::tolower(token[k]);
+    }
+    return token;
+}
+
+Matrix MatrixFactory::ReadMatrixMarket(FILE* fp) {
+    if (fp == NULL) {
+        throw std::invalid_argument("File is NULL");
+    }
+    std::vector<char> buffer;
+    mm_read_stream(fp, buffer);
+    const char * p = &buffer[0];
+    const char * end = p + buffer.size() - 1;
+
+    /* banner: %%MatrixMarket matrix format field symmetry */
+    const char * le = mm_line_end(p, end);
+    std::istringstream banner(std::string(p, le));
+    std::string tag, object, format, field, symmetry;
+    banner >> tag >> object >> format >> field >> symmetry;
+    if (tag != "%%MatrixMarket" || mm_lowercase(object) != "matrix") {
+        throw std::invalid_argument("Not a Matrix Market file");
+    }
+    format = mm_lowercase(format);
+    field = mm_lowercase(field);
+    symmetry = mm_lowercase(symmetry);
+    bool coordinate = (format == "coordinate");
+    if (!coordinate && format != "array") {
+        throw std::invalid_argument("Unknown Matrix Market format");
+    }
+    if (field == "complex") {
+        throw std::invalid_argument("Complex Matrix Market files are not supported");
+    }
+    bool pattern = (field == "pattern");
+    if ((pattern && !coordinate) || (!pattern && field != "real" && field != "integer" && field != "double")) {
+        throw std::invalid_argument("Unknown Matrix Market field");
+    }
+    MMSymmetry sym;
+    if (symmetry == "general") {
+        sym = MM_GENERAL;
+    } else if (symmetry == "symmetric" || symmetry == "hermitian") {
+        sym = MM_SYMMETRIC;
+    } else if (symmetry == "skew-symmetric") {
+        sym = MM_SKEW_SYMMETRIC;
+    } else {
+        throw std::invalid_argument("Unknown Matrix Market symmetry");
+    }
+
+    /* size line (after the comments) */
+    p = le < end ? le + 1 : end;
+    while (p < end) {
+        le = mm_line_end(p, end);
+        if (mm_is_data_line(p, le)) {
+            break;
+        }
+        p = le < end ? le + 1 : end;
+    }
+    if (p >= end) {
+        throw std::invalid_argument("Matrix Market file without a size line");
+    }
+    std::istringstream size_line(std::string(p, le));
+    unsigned long nrows = 0;
+    unsigned long ncols = 0;
+    unsigned long nnz = 0;
+    size_line >> nrows >> ncols;
+    if (coordinate) {
+        size_line >> nnz;
+    }
+    if (!size_line) {
+        throw std::invalid_argument("Invalid size line in Matrix Market file");
+    }
+    if (sym != MM_GENERAL && nrows != ncols) {
+        throw std::invalid_argument("Symmetric Matrix Market matrices must be square");
+    }
+    size_t count;
+    if (coordinate) {
+        count = nnz;
+    } else if (sym == MM_GENERAL) {
+        count = nrows * ncols;
+    } else if (sym == MM_SYMMETRIC) {
+        count = nrows * (nrows + 1) / 2;
+    } else {
+        count = nrows * (nrows - 1) / 2;
+    }
+
+    /* split the body into chunks which start at the beginning of a line */
+    const char * body = le < end ? le + 1 : end;
+    size_t len = end - body;
+    size_t nchunks = len / MATRIX_MARKET_CHUNK_SIZE + 1;
+    std::vector<const char*> bounds(nchunks + 1);
+    bounds[0] = body;
+    bounds[nchunks] = end;
+    for (size_t k = 1; k < nchunks; k++) {
+        const char * b = mm_line_end(body + k * (len / nchunks), end);
+        b = b < end ? b + 1 : end;
+        bounds[k] = std::max(b, bounds[k - 1]);
+    }
+
+    /* count the entries of every chunk to find where they are stored */
+    std::vector<size_t> offset(nchunks + 1, 0);
+    MATRIX_PARALLEL_FOR_IF(nchunks > 1)
+    for (size_t k = 0; k < nchunks; k++) {
+        offset[k + 1] = mm_count_entries(bounds[k], bounds[k + 1]);
+    }
+    for (size_t k = 0; k < nchunks; k++) {
+        offset[k + 1] += offset[k];
+    }
+    if (offset[nchunks] != count) {
+        throw std::invalid_argument("Wrong number of entries in Matrix Market file");
+    }
+
+    std::vector<char> ok(nchunks, 1);
+    if (coordinate) {
+        size_t max_nnz = sym == MM_SKEW_SYMMETRIC ? 2 * nnz : nnz;
+        Matrix mat = MakeSparse(nrows, ncols, max_nnz,
+                sym == MM_SYMMETRIC ? Matrix::SPARSE_SYMMETRIC_L : Matrix::SPARSE_UNSYMMETRIC);
+        int * ii = static_cast<int*> (mat.m_triplet->i);
+        int * jj = static_cast<int*> (mat.m_triplet->j);
+        double * xx = static_cast<double*> (mat.m_triplet->x);
+        MATRIX_PARALLEL_FOR_IF(nchunks > 1)
+        for (size_t k = 0; k < nchunks; k++) {
+            ok[k] = mm_parse_coordinate(bounds[k], bounds[k + 1], pattern, nrows, ncols,
+                    ii + offset[k], jj + offset[k], xx + offset[k]);
+        }
+        if (std::find(ok.begin(), ok.end(), 0) != ok.end()) {
+            throw std::invalid_argument("Invalid entry in Matrix Market file");
+        }
+        size_t total = nnz;
+        if (sym == MM_SKEW_SYMMETRIC) {
+            for (size_t k = 0; k < nnz; k++) {
+                if (ii[k] != jj[k]) {
+                    ii[total] = jj[k];
+                    jj[total] = ii[k];
+                    xx[total] = -xx[k];
+                    total++;
+                }
+            }
+        }
+        mat.m_triplet->nnz = total;
+        return mat;
+    }
+
+    /* 
+     * In array format, the values of general matrices are given in column-major
+     * order and those of symmetric matrices are the columns of their lower 
+     * triangular part; these coincide with the storage of dense and symmetric
+     * matrices respectively.
+     */
+    Matrix mat(nrows, ncols, sym == MM_SYMMETRIC ? Matrix::MATRIX_SYMMETRIC : Matrix::MATRIX_DENSE);
+    std::vector<double> values;
+    double * x = mat.m_data;
+    if (sym == MM_SKEW_SYMMETRIC) {
+        values.resize(count + 1);
+        x = &values[0];
+    }
+    MATRIX_PARALLEL_FOR_IF(nchunks > 1)
+    for (size_t k = 0; k < nchunks; k++) {
+        ok[k] = mm_parse_array(bounds[k], bounds[k + 1], x + offset[k]);
+    }
+    if (std::find(ok.begin(), ok.end(), 0) != ok.end()) {
+        throw std::invalid_argument("Invalid entry in Matrix Market file");
+    }
+    if (sym == MM_SKEW_SYMMETRIC) {
+        size_t s = 0;
+        for (size_t j = 0; j < ncols; j++) {
+            for (size_t i = j + 1; i < nrows; i++) {
+                mat.m_data[i + j * nrows] = values[s];
+                mat.m_data[j + i * nrows] = -values[s];
+                s++;
+            }
+        }
+    }
+    return mat;
+}
+
+/**
+ * Validates the header of a binary matrix file and returns the size of the
+ * data which follow it in bytes.
+ */
+static size_t binary_data_size(const MatrixBinaryHeader& header) {
+    if (memcmp(header.magic, MATRIX_BINARY_MAGIC, sizeof (header.magic)) != 0) {
+        throw std::invalid_argument("Not a binary matrix file");
+    }
+    if (header.byte_order != MATRIX_BINARY_BYTE_ORDER) {
+        throw std::invalid_argument("Binary matrix file written with a different byte order");
+    }
+    if (header.version != MATRIX_BINARY_VERSION) {
+        throw std::invalid_argument("Unsupported binary matrix file version");
+    }
+    const uint64_t max_u64 = static_cast<uint64_t> (-1);
+    const uint64_t max_int = static_cast<uint64_t> (INT_MAX);
+    uint64_t n = header.nrows;
+    uint64_t expected_length;
+    uint64_t data_size;
+    switch (header.type) {
+        case Matrix::MATRIX_DENSE:
+            if (header.ncols != 0 && header.nrows > max_u64 / header.ncols) {
+                throw std::invalid_argument("Matrix dimensions are too large in binary matrix file");
+            }
+            expected_length = header.nrows * header.ncols;
+            break;
+        case Matrix::MATRIX_DIAGONAL:
+            expected_length = n;
+            break;
+        case Matrix::MATRIX_LOWERTR:
+        case Matrix::MATRIX_SYMMETRIC:
+            if (n > max_int) {
+                throw std::invalid_argument("Matrix dimensions are too large in binary matrix file");
+            }
+            expected_length = n * (n + 1) / 2;
+            break;
+        case Matrix::MATRIX_SPARSE:
+            /* CHOLMOD uses int indices, so all sizes below fit in 64 bits */
+            if (header.nrows > max_int || header.ncols > max_int || header.length > max_int) {
+                throw std::invalid_argument("Matrix dimensions are too large in binary matrix file");
+            }
+            if (header.length > header.nrows * header.ncols) {
+                throw std::invalid_argument("Wrong number of nonzeros in binary matrix file");
+            }
+            if (header.stype != 0 && header.nrows != header.ncols) {
+                throw std::invalid_argument("Non-square symmetric matrix in binary matrix file");
+            }
+            data_size = header.length * (sizeof (double) + 2 * sizeof (int))
+                    + ((header.transpose != 0 ? header.nrows : header.ncols) + 1) * sizeof (int);
+            if (data_size > static_cast<uint64_t> (static_cast<size_t> (-1))) {
+                throw std::invalid_argument("Matrix dimensions are too large in binary matrix file");
+            }
+            return static_cast<size_t> (data_size);
+        default:
+            throw std::invalid_argument("Unknown matrix type in binary matrix file");
+    }
+    if (header.type != Matrix::MATRIX_DENSE && header.nrows != header.ncols) {
+        throw std::invalid_argument("Non-square matrix in binary matrix file");
+    }
+    if (header.length != expected_length) {
+        throw std::invalid_argument("Wrong data length in binary matrix file");
+    }
+    if (header.length > static_cast<uint64_t> (static_cast<size_t> (-1)) / sizeof (double)) {
+        throw std::invalid_argument("Matrix dimensions are too large in binary matrix file");
+    }
+    return static_cast<size_t> (header.length * sizeof (double));
+}
+
+/**
+ * Checks that the indices of a sparse binary matrix (see MatrixBinaryHeader)
+ * describe a valid nrow-by-ncol matrix with nnz nonzeros and symmetry type
+ * stype in compressed-column order.
+ */
+static void check_binary_sparse_indices(size_t nrow, size_t ncol, size_t nnz, int stype,
+        const int * ii, const int * jj, const int * pp) {
+    if (pp[0] != 0 || static_cast<size_t> (pp[ncol]) != nnz) {
+        throw std::invalid_argument("Wrong column pointers in binary matrix file");
+    }
+    for (size_t j = 0; j < ncol; j++) {
+        if (pp[j + 1] < pp[j] || static_cast<size_t> (pp[j + 1]) > nnz) {
+            throw std::invalid_argument("Wrong column pointers in binary matrix file");
+        }
+        const int col = static_cast<int> (j);
+        for (int k = pp[j]; k < pp[j + 1]; k++) {
+            if (jj[k] != col) {
+                throw std::invalid_argument("Column indices do not match the column pointers in binary matrix file");
+            }
+            if (ii[k] < 0 || static_cast<size_t> (ii[k]) >= nrow) {
+                throw std::invalid_argument("Row index out of range in binary matrix file");
+            }
+            if (k > pp[j] && ii[k] <= ii[k - 1]) {
+                throw std::invalid_argument("Unsorted or duplicate row indices in binary matrix file");
+            }
+            if ((stype > 0 && ii[k] > col) || (stype < 0 && ii[k] < col)) {
+                throw std::invalid_argument("Nonzero outside the stored triangle in binary matrix file");
+            }
+        }
+    }
+}
+
+Matrix MatrixFactory::MapBinary(const char* filename, bool writable) {
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open binary matrix file");
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<size_t> (st.st_size) < sizeof (MatrixBinaryHeader)) {
+        close(fd);
+        throw std::invalid_argument("Not a binary matrix file");
+    }
+    size_t map_length = st.st_size;
+    int prot = writable ? PROT_READ | PROT_WRITE : PROT_READ;
+    void * addr = mmap(NULL, map_length, prot, MAP_PRIVATE, fd, 0);
+    close(fd); /* the mapping remains valid */
+    if (addr == MAP_FAILED) {
+        throw std::runtime_error("Cannot map binary matrix file");
+    }
+
+    const MatrixBinaryHeader * header = static_cast<const MatrixBinaryHeader*> (addr);
+    size_t data_size;
+    try {
+        data_size = binary_data_size(*header);
+    } catch (...) {
+        munmap(addr, map_length);
+        throw;
+    }
+    if (map_length - sizeof (MatrixBinaryHeader) < data_size) {
+        munmap(addr, map_length);
+        throw std::invalid_argument("Truncated binary matrix file");
+    }
+
+    char * data = static_cast<char*> (addr) + sizeof (MatrixBinaryHeader);
+    Matrix mat(true);
+    mat.m_nrows = header->nrows;
+    mat.m_ncols = header->ncols;
+    mat.m_transpose = (header->transpose != 0);
+    mat.m_type = static_cast<Matrix::MatrixType> (header->type);
+    if (mat.m_type == Matrix::MATRIX_SPARSE) {
+        size_t nnz = header->length;
+        size_t nrow = mat.m_transpose ? mat.m_ncols : mat.m_nrows;
+        size_t ncol = mat.m_transpose ? mat.m_nrows : mat.m_ncols;
+        double * xx = reinterpret_cast<double*> (data);
+        int * ii = reinterpret_cast<int*> (data + nnz * sizeof (double));
+        int * jj = ii + nnz;
+        int * pp = jj + nnz;
+        try {
+            check_binary_sparse_indices(nrow, ncol, nnz, header->stype, ii, jj, pp);
+        } catch (...) {
+            munmap(addr, map_length);
+            throw;
+        }
+        /* 
+         * m_triplet and m_csc share the values and the row indices; CHOLMOD's
+         * (minimal) arrays are replaced by the mapped ones
+         */
+        cholmod_triplet * triplet = cholmod_allocate_triplet(nrow, ncol, 0, header->stype,
+                CHOLMOD_REAL, Matrix::cholmod_handle());
+        cholmod_free(triplet->nzmax, sizeof (int), triplet->i, Matrix::cholmod_handle());
+        cholmod_free(triplet->nzmax, sizeof (int), triplet->j, Matrix::cholmod_handle());
+        cholmod_free(triplet->nzmax, sizeof (double), triplet->x, Matrix::cholmod_handle());
+        triplet->x = xx;
+        triplet->i = ii;
+        triplet->j = jj;
+        triplet->nzmax = nnz;
+        triplet->nnz = nnz;
+        cholmod_sparse * csc = cholmod_allocate_sparse(nrow, ncol, 0, 1, 1, header->stype,
+                CHOLMOD_REAL, Matrix::cholmod_handle());
+        cholmod_free(ncol + 1, sizeof (int), csc->p, Matrix::cholmod_handle());
+        cholmod_free(csc->nzmax, sizeof (int), csc->i, Matrix::cholmod_handle());
+        cholmod_free(csc->nzmax, sizeof (double), csc->x, Matrix::cholmod_handle());
+        csc->p = pp;
+        csc->i = ii;
+        csc->x = xx;
+        csc->nzmax = nnz;
+        mat.m_triplet = triplet;
+        mat.m_csc = csc;
+        mat.m_sparseStorageType = Matrix::CHOLMOD_TYPE_TRIPLET;
+        mat.m_dataLength = 0;
+    } else {
+        mat.m_data = reinterpret_cast<double*> (data);
+        mat.m_dataLength = header->length;
+    }
+    mat.m_delete_data = false;
+    mat.m_map_addr = addr;
+    mat.m_map_length = map_length;
+    return mat;
+}
+
+Matrix MatrixFactory::ReadBinary(FILE* fp) {
+    if (fp == NULL) {
+        throw std::invalid_argument("File is NULL");
+    }
+    MatrixBinaryHeader header;
+    if (fread(&header, sizeof (header), 1, fp) != 1) {
+        throw std::runtime_error("Cannot read the header of the binary matrix");
+    }
+    binary_data_size(header);
+
+    Matrix::MatrixType type = static_cast<Matrix::MatrixType> (header.type);
+    bool transpose = (header.transpose != 0);
+    size_t nrow = transpose ? header.ncols : header.nrows;
+    size_t ncol = transpose ? header.nrows : header.ncols;
+    size_t n = header.length;
+    if (type == Matrix::MATRIX_SPARSE) {
+        Matrix mat = MakeSparse(nrow, ncol, n, static_cast<Matrix::SparseMatrixType> (header.stype));
+        cholmod_triplet * triplet = mat.m_triplet;
+        std::vector<int> colptr(ncol + 1);
+        if (fread(triplet->x, sizeof (double), n, fp) != n
+                || fread(triplet->i, sizeof (int), n, fp) != n
+                || fread(triplet->j, sizeof (int), n, fp) != n
+                || fread(&colptr[0], sizeof (int), ncol + 1, fp) != ncol + 1) {
+            throw std::runtime_error("Cannot read the data of the binary matrix");
+        }
+        check_binary_sparse_indices(nrow, ncol, n, header.stype,
+                static_cast<int*> (triplet->i), static_cast<int*> (triplet->j), &colptr[0]);
+        triplet->nnz = n;
+        mat.m_transpose = transpose;
+        mat.m_nrows = header.nrows;
+        mat.m_ncols = header.ncols;
+        return mat;
+    }
+    Matrix mat(nrow, ncol, type);
+    if (fread(mat.m_data, sizeof (double), n, fp) != n) {
+        throw std::runtime_error("Cannot read the data of the binary matrix");
+    }
+    mat.m_transpose = transpose;
+    mat.m_nrows = header.nrows;
+    mat.m_ncols = header.ncols;
+    return mat;
+}
+
 Matrix MatrixFactory::ShallowMatrix(const Matrix& orig) {
     Matrix mat_shallow = Matrix(true);
     mat_shallow.m_transpose = orig.m_transpose;
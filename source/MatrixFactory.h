@@ -23,6 +23,15 @@
 
 #include "Matrix.h"
 
+/**
+ * Size (in bytes) of the chunks into which the body of a Matrix Market file is
+ * split by MatrixFactory::ReadMatrixMarket; chunks are parsed in parallel if
+ * the library is compiled with OpenMP support.
+ */
+#ifndef MATRIX_MARKET_CHUNK_SIZE
+#define MATRIX_MARKET_CHUNK_SIZE 262144
+#endif
+
 /**
  * \class MatrixFactory
  * \brief Use this class to create instances of %Matrix
@@ -137,6 +146,82 @@ public:
      */
     static Matrix ReadSparse(FILE *fp);
 
+    /**
+     * Reads a matrix in the <a href="http://math.nist.gov/MatrixMarket/formats.html">
+     * Matrix Market</a> exchange format.
+     * 
+     * Files in <em>coordinate</em> format are read into sparse matrices; 
+     * symmetric ones are stored as sparse matrices of type 
+     * Matrix::SPARSE_SYMMETRIC_L with the entries of the lower triangular 
+     * part, whereas skew-symmetric ones are expanded. Files in <em>array</em>
+     * format are read into dense matrices, or into matrices of type 
+     * Matrix::MATRIX_SYMMETRIC if they are symmetric. Fields <code>real</code>,
+     * <code>integer</code> and <code>pattern</code> (where all nonzero entries 
+     * are equal to 1) are supported; <code>complex</code> matrices are not.
+     * 
+     * The whole stream is read into memory; its body is then split into chunks
+     * of #MATRIX_MARKET_CHUNK_SIZE bytes which are parsed in parallel (if 
+     * OpenMP is enabled) and the values are written directly into the CHOLMOD
+     * triplets (or the data) of the returned matrix.
+     * 
+     * @param fp A pointer to a file object
+     * @return matrix read from the stream
+     * @throws std::invalid_argument if the stream is not a valid (and 
+     * supported) Matrix Market file
+     * 
+     * \sa MatrixWriter::MATRIX_MARKET
+     */
+    static Matrix ReadMatrixMarket(FILE *fp);
+
+    /**
+     * Memory-maps a matrix which has been stored in the binary format of 
+     * MatrixWriter (see MatrixWriter::BINARY and MatrixBinaryHeader) and returns
+     * a %Matrix object which points directly at the mapped pages: no data are
+     * copied and pages are loaded by the operating system on first access, so 
+     * even very large matrices are "loaded" instantly.
+     * 
+     * The mapping is read-only by default: an attempt to modify a read-only 
+     * memory-mapped matrix will cause a segmentation fault. If <code>writable</code>
+     * is \c true, the file is mapped privately (copy-on-write): the matrix may 
+     * then be modified, but the changes are not written back to the file.
+     * New nonzero elements can never be added to memory-mapped sparse matrices
+     * and such matrices cannot be used as the output of Matrix::add, 
+     * Matrix::mult or Matrix::multTranspose (a <code>std::logic_error</code>
+     * is thrown); their values may still be scaled in place.
+     * 
+     * The returned matrix owns the mapping, which is released when the matrix 
+     * is destroyed or assigned another value; use the copy constructor to get 
+     * a (heap-allocated) hard copy. For sparse matrices, both the triplets and
+     * the compressed-column representation used in matrix-vector products 
+     * point into the mapping (they share the values and the row indices).
+     * 
+     * The header is validated and, for sparse matrices, so are all indices 
+     * (which requires a pass over the index arrays).
+     * 
+     * @param filename path to the file
+     * @param writable whether the mapping is writable (copy-on-write)
+     * @return memory-mapped matrix
+     * @throws std::runtime_error if the file cannot be opened or mapped
+     * @throws std::invalid_argument if the file is not a valid binary matrix file,
+     * e.g., if its sizes are inconsistent or its indices are out of range
+     * 
+     * \sa Matrix::isMapped
+     */
+    static Matrix MapBinary(const char *filename, bool writable = false);
+
+    /**
+     * Reads a matrix which has been stored in the binary format of MatrixWriter
+     * (see MatrixWriter::BINARY) from a stream. Unlike #MapBinary, this method
+     * works with any stream (e.g., pipes), but copies the data into memory.
+     * 
+     * @param fp A pointer to a file object opened in binary mode
+     * @return matrix read from the stream
+     * @throws std::runtime_error if the data cannot be read
+     * @throws std::invalid_argument if the stream does not contain a valid 
+     * binary matrix
+     */
+    static Matrix ReadBinary(FILE *fp);
+
     /**
      * Creates a shallow matrix given a %Matrix object.
      * 
@@ -41,6 +41,11 @@ MatrixOperator::MatrixOperator(Matrix& A) : m_A(A) {
     }
 }
 
+MatrixOperator::MatrixOperator(Matrix& A, bool dual_storage) : m_A(A) {
+    m_isSelfAdjoint = A.isSymmetric();
+    m_A.setDualStorage(dual_storage);
+}
+
 MatrixOperator::~MatrixOperator() {
 }
 
@@ -52,10 +57,7 @@ int MatrixOperator::callAdjoint(Matrix& y, double alpha, Matrix& x, double gamma
     if (isSelfAdjoint()) {
         return call(y, alpha, x, gamma);
     }
-    m_A.transpose();
-    int status = Matrix::mult(y, alpha, m_A, x, gamma);    
-    m_A.transpose();
-    return status;
+    return Matrix::multTranspose(y, alpha, m_A, x, gamma);
 }
 
 std::pair<size_t, size_t> MatrixOperator::dimensionIn() {
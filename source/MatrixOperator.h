@@ -47,6 +47,18 @@ public:
      */
     explicit MatrixOperator(Matrix& A);
 
+    /**
+     * Constructs a new instance of MatrixOperator and sets whether the
+     * underlying (sparse) matrix should use dual storage so that both
+     * #call and #callAdjoint run in parallel.
+     * 
+     * @param A Matrix
+     * @param dual_storage whether to enable the dual storage of \c A
+     * 
+     * \sa Matrix::setDualStorage
+     */
+    MatrixOperator(Matrix& A, bool dual_storage);
+
     /**
      * Provides access to the underlying matrix.
      * @return this operator as a matrix.
@@ -0,0 +1,58 @@
+/*
+ * File:   MatrixParallel.h
+ *
+ * ForBES is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ForBES is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with ForBES. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MATRIXPARALLEL_H
+#define MATRIXPARALLEL_H
+
+#include "Matrix.h"
+
+/*
+ * OpenMP helper macros for element-wise kernels; they expand to nothing if
+ * the library is compiled without OpenMP support. Loops are executed in
+ * parallel (with Matrix::get_num_threads() threads) only when their length
+ * is at least MATRIX_PARALLEL_THRESHOLD.
+ */
+#ifdef _OPENMP
+#include <omp.h>
+#define MATRIX_OMP_PRAGMA_(x) _Pragma(#x)
+#define MATRIX_OMP_PRAGMA(x) MATRIX_OMP_PRAGMA_(x)
+/* parallel loop over the entries of an array of length n; vectorized with
+ * OpenMP 4.0 and above */
+#if _OPENMP >= 201307
+#define MATRIX_PARALLEL_FOR_SIMD(n) MATRIX_OMP_PRAGMA(omp parallel for simd \
+        if ((n) >= MATRIX_PARALLEL_THRESHOLD) num_threads(Matrix::get_num_threads()))
+#define MATRIX_PARALLEL_FOR_SIMD_SUM(n, sum) MATRIX_OMP_PRAGMA(omp parallel for simd \
+        if ((n) >= MATRIX_PARALLEL_THRESHOLD) num_threads(Matrix::get_num_threads()) \
+        reduction(+:sum))
+#else
+#define MATRIX_PARALLEL_FOR_SIMD(n) MATRIX_OMP_PRAGMA(omp parallel for \
+        if ((n) >= MATRIX_PARALLEL_THRESHOLD) num_threads(Matrix::get_num_threads()))
+#define MATRIX_PARALLEL_FOR_SIMD_SUM(n, sum) MATRIX_OMP_PRAGMA(omp parallel for \
+        if ((n) >= MATRIX_PARALLEL_THRESHOLD) num_threads(Matrix::get_num_threads()) \
+        reduction(+:sum))
+#endif
+/* parallel outer loop; runs in parallel only if cond is true */
+#define MATRIX_PARALLEL_FOR_IF(cond) MATRIX_OMP_PRAGMA(omp parallel for \
+        if (cond) num_threads(Matrix::get_num_threads()))
+#else
+#define MATRIX_PARALLEL_FOR_SIMD(n)
+#define MATRIX_PARALLEL_FOR_SIMD_SUM(n, sum)
+#define MATRIX_PARALLEL_FOR_IF(cond)
+#endif
+
+#endif /* MATRIXPARALLEL_H */
+
@@ -19,6 +19,8 @@
  */
 
 #include "MatrixWriter.h"
+#include <stdexcept>
+#include <algorithm>
 
 MatrixWriter::MatrixWriter(Matrix& matrix) : m_matrix(matrix) {
     m_enforceDenseMode = false;
@@ -94,6 +96,110 @@ void MatrixWriter::printTXT(FILE* fp) {
     }
 }
 
+static void write_array(FILE* fp, const void* data, size_t size, size_t n) {
+    if (n > 0 && fwrite(data, size, n, fp) != n) {
+        throw std::runtime_error("Cannot write the matrix data");
+    }
+}
+
+void MatrixWriter::printBinary(FILE* fp) {
+    bool dense_mode = m_enforceDenseMode && m_matrix.getType() != Matrix::MATRIX_DENSE;
+    MatrixBinaryHeader header;
+    memset(&header, 0, sizeof (header));
+    memcpy(header.magic, MATRIX_BINARY_MAGIC, sizeof (header.magic));
+    header.version = MATRIX_BINARY_VERSION;
+    header.byte_order = MATRIX_BINARY_BYTE_ORDER;
+    header.type = dense_mode ? Matrix::MATRIX_DENSE : m_matrix.getType();
+    header.nrows = m_matrix.getNrows();
+    header.ncols = m_matrix.getNcols();
+    if (dense_mode) {
+        header.length = header.nrows * header.ncols;
+    } else if (m_matrix.getType() == Matrix::MATRIX_SPARSE) {
+        /* sparse matrices are written in compressed-column order */
+        m_matrix._createCsc();
+        header.stype = m_matrix.m_csc->stype;
+        header.transpose = m_matrix.m_transpose;
+        header.length = static_cast<const int*> (m_matrix.m_csc->p)[m_matrix.m_csc->ncol];
+    } else {
+        header.transpose = m_matrix.m_transpose;
+        header.length = m_matrix.length();
+    }
+    write_array(fp, &header, sizeof (header), 1);
+
+    if (dense_mode) {
+        for (size_t j = 0; j < m_matrix.getNcols(); j++) {
+            for (size_t i = 0; i < m_matrix.getNrows(); i++) {
+                double v = m_matrix.get(i, j);
+                write_array(fp, &v, sizeof (double), 1);
+            }
+        }
+    } else if (m_matrix.getType() == Matrix::MATRIX_SPARSE) {
+        const cholmod_sparse * csc = m_matrix.m_csc;
+        const int * p = static_cast<const int*> (csc->p);
+        const size_t ncol = csc->ncol;
+        const size_t nnz = header.length;
+        write_array(fp, csc->x, sizeof (double), nnz);
+        write_array(fp, csc->i, sizeof (int), nnz);
+        for (size_t j = 0; j < ncol; j++) {
+            const int col = static_cast<int> (j);
+            for (int k = p[j]; k < p[j + 1]; k++) {
+                write_array(fp, &col, sizeof (int), 1);
+            }
+        }
+        write_array(fp, p, sizeof (int), ncol + 1);
+    } else {
+        write_array(fp, m_matrix.m_data, sizeof (double), m_matrix.length());
+    }
+}
+
+void MatrixWriter::printMatrixMarket(FILE* fp) {
+    const size_t nrows = m_matrix.getNrows();
+    const size_t ncols = m_matrix.getNcols();
+    Matrix::MatrixType type = m_enforceDenseMode ? Matrix::MATRIX_DENSE : m_matrix.getType();
+    if (type == Matrix::MATRIX_SPARSE) {
+        if (m_matrix.m_triplet == NULL) {
+            m_matrix._createTriplet();
+        }
+        const cholmod_triplet * triplet = m_matrix.m_triplet;
+        const int * ii = static_cast<const int*> (triplet->i);
+        const int * jj = static_cast<const int*> (triplet->j);
+        const double * xx = static_cast<const double*> (triplet->x);
+        bool symmetric = (triplet->stype != 0);
+        fprintf(fp, "%%%%MatrixMarket matrix coordinate real %s\n", symmetric ? "symmetric" : "general");
+        fprintf(fp, FMT_SIZE_T " " FMT_SIZE_T " " FMT_SIZE_T "\n", nrows, ncols, triplet->nnz);
+        for (size_t k = 0; k < triplet->nnz; k++) {
+            int i = m_matrix.m_transpose ? jj[k] : ii[k];
+            int j = m_matrix.m_transpose ? ii[k] : jj[k];
+            if (symmetric && i < j) {
+                std::swap(i, j);
+            }
+            fprintf(fp, "%d %d %.17g\n", i + 1, j + 1, xx[k]);
+        }
+    } else if (type == Matrix::MATRIX_DIAGONAL) {
+        fprintf(fp, "%%%%MatrixMarket matrix coordinate real symmetric\n");
+        fprintf(fp, FMT_SIZE_T " " FMT_SIZE_T " " FMT_SIZE_T "\n", nrows, ncols, nrows);
+        for (size_t i = 0; i < nrows; i++) {
+            fprintf(fp, FMT_SIZE_T " " FMT_SIZE_T " %.17g\n", i + 1, i + 1, m_matrix.get(i, i));
+        }
+    } else if (type == Matrix::MATRIX_SYMMETRIC) {
+        fprintf(fp, "%%%%MatrixMarket matrix array real symmetric\n");
+        fprintf(fp, FMT_SIZE_T " " FMT_SIZE_T "\n", nrows, ncols);
+        for (size_t j = 0; j < ncols; j++) {
+            for (size_t i = j; i < nrows; i++) {
+                fprintf(fp, "%.17g\n", m_matrix.get(i, j));
+            }
+        }
+    } else {
+        fprintf(fp, "%%%%MatrixMarket matrix array real general\n");
+        fprintf(fp, FMT_SIZE_T " " FMT_SIZE_T "\n", nrows, ncols);
+        for (size_t j = 0; j < ncols; j++) {
+            for (size_t i = 0; i < nrows; i++) {
+                fprintf(fp, "%.17g\n", m_matrix.get(i, j));
+            }
+        }
+    }
+}
+
 void MatrixWriter::write(FILE* fp) {
     if (fp == NULL) {
         throw std::invalid_argument("File is NULL");
@@ -103,6 +209,10 @@ void MatrixWriter::write(FILE* fp) {
         printJSON(fp);
     } else if (m_format == PLAIN_TXT) {
         printTXT(fp);
+    } else if (m_format == BINARY) {
+        printBinary(fp);
+    } else if (m_format == MATRIX_MARKET) {
+        printMatrixMarket(fp);
     }
 
 
@@ -23,9 +23,7 @@
 
 #include "Matrix.h"
 #include "string.h"
-
-#define FMT_SIZE_T "%lu"
-
+#include <stdint.h>
 
 #undef MATRIX_NROWS 
 #undef MATRIX_NCOLS
@@ -40,6 +38,48 @@
 #define MATRIX_NZ "nnz"
 #define MATRIX_ENFORCE_DENSE_MODE "enforceDenseMode"
 
+#define MATRIX_BINARY_MAGIC "FBSMATRX"
+#define MATRIX_BINARY_VERSION 2
+#define MATRIX_BINARY_BYTE_ORDER 0x01020304
+
+/**
+ * Header of the binary matrix format (MatrixWriter::BINARY); it is 64 bytes 
+ * long and it is followed by the matrix data:
+ * 
+ * - for non-sparse matrices, the <code>length</code> doubles of the data 
+ *   array in the internal storage of the matrix type (e.g., the columns of the
+ *   lower-triangular part for symmetric matrices),
+ * - for sparse matrices, the <code>length</code> (number of nonzeros) values 
+ *   of the triplets (doubles), followed by their row indices (ints), their 
+ *   column indices (ints) and the <code>n+1</code> column pointers (ints), 
+ *   where <code>n</code> is the number of columns of the stored 
+ *   (non-transposed) matrix. The triplets are sorted by column and then by
+ *   row (without duplicates), so the values, the row indices and the column
+ *   pointers form the compressed-column representation of the matrix, 
+ *   which MatrixFactory::MapBinary maps without copying.
+ * 
+ * All numbers are stored in the native byte order of the machine that wrote 
+ * the file; field <code>byte_order</code> is used to detect files written on 
+ * a machine with a different byte order. Since the header is 64 bytes long, 
+ * all data arrays are properly aligned.
+ * 
+ * \sa MatrixFactory::MapBinary
+ * \sa MatrixFactory::ReadBinary
+ */
+struct MatrixBinaryHeader {
+    char magic[8]; /**< MATRIX_BINARY_MAGIC (not null-terminated) */
+    uint32_t version; /**< format version (MATRIX_BINARY_VERSION) */
+    uint32_t byte_order; /**< MATRIX_BINARY_BYTE_ORDER as written by the writer */
+    uint32_t type; /**< Matrix::MatrixType */
+    int32_t stype; /**< symmetry type of sparse matrices (see CHOLMOD) */
+    uint32_t transpose; /**< whether the matrix is transposed */
+    uint32_t reserved; /**< reserved (zero) */
+    uint64_t nrows; /**< number of rows */
+    uint64_t ncols; /**< number of columns */
+    uint64_t length; /**< data length, or number of nonzeros for sparse matrices */
+    uint64_t padding; /**< padding (zero) */
+};
+
 class MatrixWriter {
 public:
     MatrixWriter(Matrix& matrix);
@@ -48,7 +88,22 @@ public:
 
     enum WriteFormat {
         PLAIN_TXT,
-        JSON
+        JSON,
+        /**
+         * Binary format which can be memory-mapped by MatrixFactory::MapBinary
+         * (see MatrixBinaryHeader); the file must be opened in binary mode.
+         */
+        BINARY,
+        /**
+         * <a href="http://math.nist.gov/MatrixMarket/formats.html">Matrix 
+         * Market</a> exchange format, which can be read by 
+         * MatrixFactory::ReadMatrixMarket. Sparse and diagonal matrices are
+         * written in coordinate format (symmetric sparse matrices by means of
+         * their lower triangular part), symmetric matrices in symmetric array 
+         * format and all other matrices (or all matrices, in dense mode) in 
+         * general array format.
+         */
+        MATRIX_MARKET
     };
 
     void enforceDenseMode(bool t);
@@ -59,6 +114,8 @@ public:
     /**
      * Writes a matrix into a file.
      * @param fp
+     * @throws std::invalid_argument if fp is NULL
+     * @throws std::runtime_error if the matrix cannot be written in BINARY format
      */
     void write(FILE* fp);
 private:
@@ -69,6 +126,8 @@ private:
 
     void printJSON(FILE* fp);
     void printTXT(FILE* fp);
+    void printBinary(FILE* fp);
+    void printMatrixMarket(FILE* fp);
 
 };
 
@@ -0,0 +1,187 @@
+/*
+ * File:   MultiShiftCGSolver.cpp
+ *
+ * ForBES is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ForBES is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with ForBES. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MultiShiftCGSolver.h"
+#include <math.h>
+#include <cstring>
+#include <stdexcept>
+
+MultiShiftCGSolver::MultiShiftCGSolver(LinearOperator& linop, const std::vector<double>& shifts) :
+LinOpSolver(linop), m_shifts(shifts) {
+    init(1e-4, 500);
+}
+
+MultiShiftCGSolver::MultiShiftCGSolver(LinearOperator& linop, const std::vector<double>& shifts,
+        double tolerance, size_t max_iterations) :
+LinOpSolver(linop), m_shifts(shifts) {
+    init(tolerance, max_iterations);
+}
+
+MultiShiftCGSolver::~MultiShiftCGSolver() {
+}
+
+void MultiShiftCGSolver::init(double tolerance, size_t max_iterations) {
+    if (m_shifts.empty()) {
+        throw std::invalid_argument("MultiShiftCGSolver: at least one shift is required");
+    }
+    m_tolerance = tolerance;
+    m_max_iterations = max_iterations;
+    m_iterations_count = 0;
+    m_errors.assign(m_shifts.size(), NAN);
+    m_iterations.assign(m_shifts.size(), 0);
+    m_zeta.resize(m_shifts.size());
+    m_zeta_prev.resize(m_shifts.size());
+}
+
+const std::vector<double>& MultiShiftCGSolver::shifts() const {
+    return m_shifts;
+}
+
+double MultiShiftCGSolver::last_error() const {
+    double err = 0.0;
+    for (size_t i = 0; i < m_errors.size(); i++) {
+        if (!(m_errors[i] <= err)) err = m_errors[i]; /* propagates NaN */
+    }
+    return err;
+}
+
+double MultiShiftCGSolver::last_error(size_t i) const {
+    return m_errors.at(i);
+}
+
+size_t MultiShiftCGSolver::last_num_iter() const {
+    return m_iterations_count;
+}
+
+size_t MultiShiftCGSolver::last_num_iter(size_t i) const {
+    return m_iterations.at(i);
+}
+
+int MultiShiftCGSolver::solve(Matrix& b, Matrix& solution) {
+    if (!b.isColumnVector()) {
+        throw std::invalid_argument("MultiShiftCGSolver: the right-hand side must be a column vector");
+    }
+    const size_t n = b.getNrows();
+    const size_t s = m_shifts.size();
+
+    /* CG is applied to T + sigma_min I; the other shifts are relative to it */
+    double sigma_min = m_shifts[0];
+    for (size_t i = 1; i < s; i++) {
+        if (m_shifts[i] < sigma_min) sigma_min = m_shifts[i];
+    }
+
+    if (m_r.getNrows() != n || m_r.getType() != Matrix::MATRIX_DENSE) {
+        m_r = Matrix(n, 1);
+        m_p = Matrix(n, 1);
+        m_Ap = Matrix(n, 1);
+    }
+    if (m_P.getNrows() != n || m_P.getNcols() != s) {
+        m_P = Matrix(n, s);
+    }
+    if (solution.getNrows() != n || solution.getNcols() != s
+            || solution.getType() != Matrix::MATRIX_DENSE) {
+        solution = Matrix(n, s);
+    }
+    double * x = solution.getData();
+    double * r = m_r.getData();
+    double * p = m_p.getData();
+    double * Ap = m_Ap.getData();
+    double * P = m_P.getData();
+
+    /* x_i = 0, r = b, p = p_i = b */
+    memset(x, 0, n * s * sizeof (double));
+    double rr = 0.0;
+    double err = 0.0;
+    for (size_t k = 0; k < n; k++) {
+        double bk = b.getType() == Matrix::MATRIX_DENSE ? b.getData()[k] : b.get(k, 0);
+        r[k] = bk;
+        p[k] = bk;
+        rr += bk * bk;
+        if (fabs(bk) > err) err = fabs(bk);
+    }
+    for (size_t i = 0; i < s; i++) {
+        memcpy(P + i * n, p, n * sizeof (double));
+        m_zeta[i] = 1.0;
+        m_zeta_prev[i] = 1.0;
+        m_errors[i] = err;
+        m_iterations[i] = 0;
+    }
+
+    m_iterations_count = 0;
+    size_t active = 0;
+    for (size_t i = 0; i < s; i++) {
+        if (m_errors[i] >= m_tolerance) active++;
+    }
+    double alpha_prev = 1.0;
+    double beta_prev = 0.0;
+    while (active > 0 && m_iterations_count < m_max_iterations) {
+        m_linop->call(m_Ap, 1.0, m_p, 0.0); // Ap = (T + sigma_min I) p
+        double pAp = 0.0;
+        for (size_t k = 0; k < n; k++) {
+            Ap[k] += sigma_min * p[k];
+            pAp += p[k] * Ap[k];
+        }
+        if (!(pAp > 0.0)) {
+            return ForBESUtils::STATUS_NUMERICAL_PROBLEMS;
+        }
+        double alpha = rr / pAp;
+        double rr_new = 0.0;
+        double r_norm = 0.0;
+        for (size_t k = 0; k < n; k++) {
+            r[k] -= alpha * Ap[k];
+            rr_new += r[k] * r[k];
+            if (fabs(r[k]) > r_norm) r_norm = fabs(r[k]);
+        }
+        double beta = rr_new / rr;
+        m_iterations_count++;
+
+        for (size_t i = 0; i < s; i++) {
+            if (m_errors[i] < m_tolerance) continue; /* converged */
+            const double delta = m_shifts[i] - sigma_min;
+            const double zeta = m_zeta[i];
+            const double zeta_prev = m_zeta_prev[i];
+            double zeta_new = zeta * zeta_prev * alpha_prev
+                    / (alpha * beta_prev * (zeta_prev - zeta)
+                    + zeta_prev * alpha_prev * (1.0 + delta * alpha));
+            double alpha_i = alpha * zeta_new / zeta;
+            double beta_i = beta * (zeta_new / zeta) * (zeta_new / zeta);
+            double * xi = x + i * n;
+            double * pi = P + i * n;
+            for (size_t k = 0; k < n; k++) {
+                xi[k] += alpha_i * pi[k];
+                pi[k] = zeta_new * r[k] + beta_i * pi[k];
+            }
+            m_zeta_prev[i] = zeta;
+            m_zeta[i] = zeta_new;
+            /* the residual of the i-th system is zeta_i * r */
+            m_errors[i] = fabs(zeta_new) * r_norm;
+            m_iterations[i] = m_iterations_count;
+            if (m_errors[i] < m_tolerance) active--;
+        }
+
+        for (size_t k = 0; k < n; k++) {
+            p[k] = r[k] + beta * p[k];
+        }
+        rr = rr_new;
+        alpha_prev = alpha;
+        beta_prev = beta;
+    }
+    if (active > 0) {
+        return ForBESUtils::STATUS_MAX_ITERATIONS_REACHED;
+    }
+    return ForBESUtils::STATUS_OK;
+}
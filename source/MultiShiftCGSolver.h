@@ -0,0 +1,165 @@
+/*
+ * File:   MultiShiftCGSolver.h
+ *
+ * ForBES is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ForBES is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with ForBES. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MULTISHIFTCGSOLVER_H
+#define MULTISHIFTCGSOLVER_H
+
+#include "LinOpSolver.h"
+#include <vector>
+
+/**
+ * \class MultiShiftCGSolver
+ * \brief Multi-shift conjugate gradient solver
+ * \version 0.1
+ * \ingroup LinSysSolver-group
+ *
+ * Solves the family of shifted linear operator equations
+ *
+ * \f[
+ * (T + \sigma_i I) x_i = b,\quad i=1,\ldots,s,
+ * \f]
+ *
+ * where \f$T\f$ is a self-adjoint linear operator and all 
+ * \f$T + \sigma_i I\f$ are positive definite. Since all shifted systems share
+ * the same Krylov subspace, they are solved simultaneously with one 
+ * application of \f$T\f$ per iteration: CG is applied to the system with the
+ * smallest shift and the iterates of all other systems are obtained by 
+ * short recurrences [B. Jegerlehner, Krylov space solvers for shifted linear
+ * systems, 1996]. The cost of every additional shift is a few vector 
+ * updates.
+ *
+ * The initial guess is \f$x_i = 0\f$ for all systems (this is necessary so that
+ * all residuals are collinear) and no preconditioner can be used. Every 
+ * system stops being updated once its residual satisfies 
+ * \f$\|b - (T+\sigma_i I)x_i\|_\infty < \varepsilon\f$; the convergence of 
+ * each system is reported by #last_error(size_t) const and 
+ * #last_num_iter(size_t) const.
+ *
+ * Example:
+ *
+ * \code{.cpp}
+ * MatrixOperator Aop(A);
+ * std::vector<double> shifts;
+ * shifts.push_back(0.1);
+ * shifts.push_back(1.0);
+ * MultiShiftCGSolver solver(Aop, shifts, 1e-8, 500);
+ * Matrix X; // n-by-2; column i solves (A + shifts[i] I) x = b
+ * int status = solver.solve(b, X);
+ * \endcode
+ */
+class MultiShiftCGSolver : public LinOpSolver {
+public:
+
+    /**
+     * Constructs a new multi-shift CG solver with tolerance \f$10^{-4}\f$ and
+     * at most <code>500</code> iterations.
+     *
+     * @param linop self-adjoint linear operator \f$T\f$
+     * @param shifts shifts \f$\sigma_i\f$ (at least one)
+     *
+     * @throws std::invalid_argument if no shifts are provided
+     */
+    MultiShiftCGSolver(LinearOperator& linop, const std::vector<double>& shifts);
+
+    /**
+     * Constructs a new multi-shift CG solver.
+     *
+     * @param linop self-adjoint linear operator \f$T\f$
+     * @param shifts shifts \f$\sigma_i\f$ (at least one)
+     * @param tolerance tolerance
+     * @param max_iterations maximum number of iterations
+     *
+     * @throws std::invalid_argument if no shifts are provided
+     */
+    MultiShiftCGSolver(LinearOperator& linop, const std::vector<double>& shifts,
+            double tolerance, size_t max_iterations);
+
+    virtual ~MultiShiftCGSolver();
+
+    /**
+     * Solves all shifted systems.
+     *
+     * @param rhs the right-hand side \f$b\f$ (column vector)
+     * @param solution on exit, an n-by-s matrix whose i-th column is the 
+     * solution \f$x_i\f$ of the i-th system
+     * @return status code; \link ForBESUtils::STATUS_MAX_ITERATIONS_REACHED 
+     * STATUS_MAX_ITERATIONS_REACHED\endlink if some system has not converged
+     * and \link ForBESUtils::STATUS_NUMERICAL_PROBLEMS STATUS_NUMERICAL_PROBLEMS\endlink
+     * upon breakdown (e.g., if some \f$T + \sigma_i I\f$ is not positive definite)
+     */
+    virtual int solve(Matrix& rhs, Matrix& solution);
+
+    /**
+     * The shifts \f$\sigma_i\f$.
+     *
+     * @return shifts
+     */
+    const std::vector<double>& shifts() const;
+
+    /**
+     * Largest infinity-norm of the residuals of all systems on the last run.
+     *
+     * @return last error
+     */
+    double last_error() const;
+
+    /**
+     * Infinity-norm of the residual of the i-th system on the last run.
+     *
+     * @param i index of the system
+     * @return last error of the i-th system
+     */
+    double last_error(size_t i) const;
+
+    /**
+     * Number of iterations (applications of \f$T\f$) on the last run.
+     *
+     * @return number of iterations
+     */
+    size_t last_num_iter() const;
+
+    /**
+     * Number of iterations after which the i-th system converged on the last
+     * run (equal to #last_num_iter() if it did not converge).
+     *
+     * @param i index of the system
+     * @return number of iterations of the i-th system
+     */
+    size_t last_num_iter(size_t i) const;
+
+private:
+
+    std::vector<double> m_shifts; /**< shifts */
+    double m_tolerance; /**< tolerance */
+    size_t m_max_iterations; /**< maximum number of iterations */
+    size_t m_iterations_count; /**< iterations on the last run */
+    std::vector<double> m_errors; /**< residual norm of every system */
+    std::vector<size_t> m_iterations; /**< iterations of every system */
+
+    /* work vectors and per-system recurrence coefficients */
+    Matrix m_r; /**< residual of the base system */
+    Matrix m_p; /**< search direction of the base system */
+    Matrix m_Ap; /**< T(p) */
+    Matrix m_P; /**< search directions of all systems (columns) */
+    std::vector<double> m_zeta; /**< residual scaling factors */
+    std::vector<double> m_zeta_prev; /**< previous residual scaling factors */
+
+    void init(double tolerance, size_t max_iterations);
+
+};
+
+#endif /* MULTISHIFTCGSOLVER_H */
@@ -70,9 +70,9 @@ int Norm2::callProx(Matrix& x, double gamma, Matrix& prox) {
     //LCOV_EXCL_STOP
     double norm_x = vecNorm2(x);
     double gm = gamma*m_mu;
-    if (norm_x > gm) {
-        double s = 1 - gm / norm_x;
-        prox = s * x;
+    double s = norm_x > gm ? 1 - gm / norm_x : 0.0;
+    for (size_t i = 0; i < x.getNrows(); i++) {
+        prox[i] = s * x[i];
     }
     return ForBESUtils::STATUS_OK;
 }
@@ -85,15 +85,11 @@ int Norm2::callProx(Matrix& x, double gamma, Matrix& prox, double& f_at_prox) {
     //LCOV_EXCL_STOP
     double norm_x = vecNorm2(x);    
     double gm = gamma*m_mu;
-    if (norm_x > gm) {
-        double s = 1 - gm / norm_x;
-        for (size_t i = 0; i < x.getNrows(); i++) {
-            prox.set(i, 0, s * x[i]); // prox = s * x;
-        }
-        f_at_prox = m_mu * s * norm_x;
-    } else {
-        f_at_prox = 0.0;
+    double s = norm_x > gm ? 1 - gm / norm_x : 0.0;
+    for (size_t i = 0; i < x.getNrows(); i++) {
+        prox.set(i, 0, s * x[i]); // prox = s * x;
     }
+    f_at_prox = m_mu * s * norm_x;
     return ForBESUtils::STATUS_OK;
 }
 
@@ -47,8 +47,6 @@ bool OpAdjoint::isSelfAdjoint() {
     return m_originalOperator.isSelfAdjoint();
 }
 
-
-
-
-
-
+LinearOperator& OpAdjoint::getOperator() const {
+    return m_originalOperator;
+}
@@ -52,6 +52,12 @@ public:
 
     virtual bool isSelfAdjoint();
 
+    /**
+     * The operator whose adjoint this is.
+     * @return the original operator
+     */
+    LinearOperator& getOperator() const;
+
 private:
 
     LinearOperator& m_originalOperator;
@@ -30,8 +30,17 @@ OpComposition::OpComposition(LinearOperator& A, LinearOperator& B) : LinearOpera
 OpComposition::~OpComposition() {
 }
 
+/* (re)allocates a buffer only if its dimensions are not the requested ones */
+static Matrix& composition_buffer(Matrix& buffer, const std::pair<size_t, size_t>& dims) {
+    if (buffer.getNrows() != dims.first || buffer.getNcols() != dims.second
+            || buffer.getType() != Matrix::MATRIX_DENSE) {
+        buffer = Matrix(dims.first, dims.second);
+    }
+    return buffer;
+}
+
 int OpComposition::call(Matrix& y, double alpha, Matrix& x, double gamma) {
-    Matrix t(m_B.dimensionOut().first, m_B.dimensionOut().second);
+    Matrix& t = composition_buffer(m_buffer, m_B.blockDimensionOut(x));
     int status = m_B.call(t, 1.0, x, 0.0); // t = B(x)
     if (ForBESUtils::is_status_error(status)) {
         return status;
@@ -41,8 +50,13 @@ int OpComposition::call(Matrix& y, double alpha, Matrix& x, double gamma) {
 }
 
 int OpComposition::callAdjoint(Matrix& y, double alpha, Matrix& x, double gamma) {
-    Matrix t = m_A.callAdjoint(x);            
-    return m_B.callAdjoint(y, alpha, t, gamma);
+    Matrix& t = composition_buffer(m_buffer_adjoint, m_A.blockDimensionIn(x));
+    int status = m_A.callAdjoint(t, 1.0, x, 0.0); // t = A*(x)
+    if (ForBESUtils::is_status_error(status)) {
+        return status;
+    }
+    status = std::max(status, m_B.callAdjoint(y, alpha, t, gamma));
+    return status;
 }
 
 std::pair<size_t, size_t> OpComposition::dimensionIn() {
@@ -57,4 +71,10 @@ bool OpComposition::isSelfAdjoint() {
     return m_A.isSelfAdjoint() && m_B.isSelfAdjoint();
 }
 
+LinearOperator& OpComposition::getA() const {
+    return m_A;
+}
 
+LinearOperator& OpComposition::getB() const {
+    return m_B;
+}
@@ -78,12 +78,24 @@ public:
 
     virtual bool isSelfAdjoint();
 
-    
+    /**
+     * The outer operator \c A of the composition <code>A(B(x))</code>.
+     * @return operator A
+     */
+    LinearOperator& getA() const;
+
+    /**
+     * The inner operator \c B of the composition <code>A(B(x))</code>.
+     * @return operator B
+     */
+    LinearOperator& getB() const;
 
 private:
 
     LinearOperator& m_A;
     LinearOperator& m_B;
+    Matrix m_buffer; /**< intermediate result B(x) */
+    Matrix m_buffer_adjoint; /**< intermediate result A*(x) */
 };
 
 #endif	/* OPCOMPOSITION_H */
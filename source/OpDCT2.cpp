@@ -23,18 +23,54 @@
 #include <iostream>
 
 
-void update_y_helper_n_even(Matrix& y, double alpha, Matrix& x, double gamma, size_t n);
-void update_y_helper_n_odd(Matrix& y, double alpha, Matrix& x, double gamma, size_t n);
+void update_y_helper_n_even(Matrix& y, double alpha, Matrix& x, size_t n, size_t ncols);
+void update_y_helper_n_odd(Matrix& y, double alpha, Matrix& x, size_t n, size_t ncols);
 double power_of_minus_one(size_t k);
 
-OpDCT2::OpDCT2() : LinearOperator(), m_dimension(_EMPTY_OP_DIM) {
+OpDCT2::OpDCT2() : LinearOperator(), m_dimension(_EMPTY_OP_DIM),
+m_method(DCTHelper::DCT_AUTO), m_fft(NULL), m_basis(NULL) {
 
 }
 
-OpDCT2::OpDCT2(size_t n) : m_dimension(_VECTOR_OP_DIM(n)) {
+OpDCT2::OpDCT2(size_t n) : m_dimension(_VECTOR_OP_DIM(n)),
+m_method(DCTHelper::DCT_AUTO), m_fft(NULL), m_basis(NULL) {
+    allocate(n);
+}
+
+OpDCT2::OpDCT2(size_t n, DCTHelper::DCTMethod method) : m_dimension(_VECTOR_OP_DIM(n)),
+m_method(method), m_fft(NULL), m_basis(NULL) {
+    allocate(n);
 }
 
 OpDCT2::~OpDCT2() {
+    if (m_fft != NULL) {
+        delete m_fft;
+    }
+    if (m_basis != NULL) {
+        delete m_basis;
+    }
+}
+
+void OpDCT2::allocate(size_t n) {
+    if (n == 0) {
+        return;
+    }
+    if (m_method == DCTHelper::DCT_TABLE) {
+        m_basis = new Matrix(n, n);
+        DCTHelper::cosineBasis(n, m_basis->getData());
+    }
+    if (m_method == DCTHelper::DCT_FFT
+            || (m_method == DCTHelper::DCT_AUTO && n >= DCT_FFT_THRESHOLD)) {
+        m_fft = new DCTHelper(n);
+    }
+}
+
+DCTHelper * OpDCT2::fftPlan(size_t n) const {
+    return (m_fft != NULL && m_fft->length() == n) ? m_fft : NULL;
+}
+
+Matrix * OpDCT2::basis(size_t n) const {
+    return (m_basis != NULL && m_basis->getNrows() == n) ? m_basis : NULL;
 }
 
 static const double FOO[4] = {1.0, 0.0, -1.0, 0.0};
@@ -43,75 +79,128 @@ inline double power_of_minus_one(size_t k) {
     return (k % 2 == 0) ? 1.0 : -1.0;
 }
 
-void update_y_helper_n_even(Matrix& y, double alpha, Matrix& x, double gamma, size_t n) {
+/*
+ * The helpers below compute the rows k = 1, ..., n-1 of the transform of all
+ * ncols columns of x at once: every coefficient aik is computed once and
+ * applied to all columns. The rows of y must have been scaled by gamma.
+ */
+void update_y_helper_n_even(Matrix& y, double alpha, Matrix& x, size_t n, size_t ncols) {
     size_t nu = n / 2;
     bool apply_trick = (n >= 8) && (n % 4 == 0);
     for (size_t k = 1; k < n; k++) {
-        double yk = 0.0;
         if (apply_trick && k % 2 == 0) {
+            size_t mu = k / 2;
             for (size_t i = 0; i < nu / 2; i++) {
                 double aik;
-                size_t mu = k / 2;
-                aik = std::cos(M_PI * (static_cast<double> (i) + 0.5) * static_cast<double> (k) / static_cast<double> (n));
-                yk += (
-                        x[i]
-                        + power_of_minus_one(mu) * (x[nu - i - 1] + x[nu + i])
-                        + x[n - i - 1]
-                        ) * aik;
+                aik = alpha * std::cos(M_PI * (static_cast<double> (i) + 0.5) * static_cast<double> (k) / static_cast<double> (n));
+                for (size_t c = 0; c < ncols; c++) {
+                    size_t o = c * n;
+                    y[k + o] += (
+                            x[i + o]
+                            + power_of_minus_one(mu) * (x[nu - i - 1 + o] + x[nu + i + o])
+                            + x[n - i - 1 + o]
+                            ) * aik;
+                }
             }
         } else {
             for (size_t i = 0; i < nu; i++) {
                 double aik;
-                aik = std::cos(M_PI * (static_cast<double> (i) + 0.5) * static_cast<double> (k) / static_cast<double> (n));
-                if (k % 2 == 1) {
-                    yk += (x[i] - x[n - i - 1]) * aik;
-                } else {
-                    yk += (x[i] + x[n - i - 1]) * aik;
+                aik = alpha * std::cos(M_PI * (static_cast<double> (i) + 0.5) * static_cast<double> (k) / static_cast<double> (n));
+                for (size_t c = 0; c < ncols; c++) {
+                    size_t o = c * n;
+                    if (k % 2 == 1) {
+                        y[k + o] += (x[i + o] - x[n - i - 1 + o]) * aik;
+                    } else {
+                        y[k + o] += (x[i + o] + x[n - i - 1 + o]) * aik;
+                    }
                 }
             }
         }
-        y[k] = gamma * y[k] + alpha * yk;
     }
 }
 
-void update_y_helper_n_odd(Matrix& y, double alpha, Matrix& x, double gamma, size_t n) {
+void update_y_helper_n_odd(Matrix& y, double alpha, Matrix& x, size_t n, size_t ncols) {
     for (size_t k = 1; k < n; k++) {
-        double yk = 0.0;
         for (size_t i = 0; i < n / 2; i++) {
             double aik;
-            aik = std::cos(M_PI * (static_cast<double> (i) + 0.5) * static_cast<double> (k) / static_cast<double> (n));
-            yk += (x[i] + power_of_minus_one(k) * x[n - 1 - i]) * aik;
+            aik = alpha * std::cos(M_PI * (static_cast<double> (i) + 0.5) * static_cast<double> (k) / static_cast<double> (n));
+            for (size_t c = 0; c < ncols; c++) {
+                size_t o = c * n;
+                y[k + o] += (x[i + o] + power_of_minus_one(k) * x[n - 1 - i + o]) * aik;
+            }
+        }
+        for (size_t c = 0; c < ncols; c++) {
+            y[k + c * n] += alpha * FOO[k % 4] * x[n / 2 + c * n];
         }
-        yk += FOO[k % 4] * x[n / 2];
-        y[k] = gamma * y[k] + alpha * yk;
     }
 }
 
 int OpDCT2::call(Matrix& y, double alpha, Matrix& x, double gamma) {
     size_t n = x.getNrows();
-    double y0 = gamma * y[0];
-    for (size_t i = 0; i < n; i++) {
-        y0 += alpha * x[i];
+    size_t ncols = x.getNcols();
+    Matrix * C = basis(n);
+    if (C != NULL) {
+        return Matrix::mult(y, alpha, *C, x, gamma);
+    }
+    DCTHelper * fft;
+    if (x.getType() == Matrix::MATRIX_DENSE && y.getType() == Matrix::MATRIX_DENSE
+            && (fft = fftPlan(n)) != NULL) {
+        for (size_t c = 0; c < ncols; c++) {
+            fft->dct2(y.getData() + c * n, alpha, x.getData() + c * n, gamma);
+        }
+        return ForBESUtils::STATUS_OK;
+    }
+    for (size_t c = 0; c < ncols; c++) {
+        size_t o = c * n;
+        double y0 = gamma * y[o];
+        for (size_t i = 0; i < n; i++) {
+            y0 += alpha * x[i + o];
+        }
+        y[o] = y0;
+        for (size_t k = 1; k < n; k++) {
+            y[k + o] *= gamma;
+        }
     }
-    y[0] = y0;
     if (n % 2 == 0) { // if n is even
-        update_y_helper_n_even(y, alpha, x, gamma, n);
+        update_y_helper_n_even(y, alpha, x, n, ncols);
     } else {
-        update_y_helper_n_odd(y, alpha, x, gamma, n);
+        update_y_helper_n_odd(y, alpha, x, n, ncols);
     }
     return ForBESUtils::STATUS_OK;
 }
 
 int OpDCT2::callAdjoint(Matrix& y, double alpha, Matrix& x, double gamma) {
     size_t n = x.getNrows();
+    size_t ncols = x.getNcols();
+    Matrix * C = basis(n);
+    if (C != NULL) {
+        return Matrix::multTranspose(y, alpha, *C, x, gamma);
+    }
+    DCTHelper * fft;
+    if (x.getType() == Matrix::MATRIX_DENSE && y.getType() == Matrix::MATRIX_DENSE
+            && (fft = fftPlan(n)) != NULL) {
+        /* T* = DCT-III with x_0 counted in full (instead of x_0/2) */
+        for (size_t c = 0; c < ncols; c++) {
+            size_t o = c * n;
+            double x0_2 = alpha * x[o] / 2.0;
+            fft->dct3(y.getData() + o, alpha, x.getData() + o, gamma);
+            for (size_t k = 0; k < n; k++) {
+                y[k + o] += x0_2;
+            }
+        }
+        return ForBESUtils::STATUS_OK;
+    }
     for (size_t k = 0; k < n; k++) {
-        double v = 0.0;
+        for (size_t c = 0; c < ncols; c++) {
+            y[k + c * n] *= gamma;
+        }
         for (size_t i = 0; i < n; i++) {
             double aki;
-            aki = std::cos(M_PI * (static_cast<double> (k) + 0.5) * static_cast<double> (i) / static_cast<double> (n));
-            v += x[i] * aki;
+            aki = alpha * std::cos(M_PI * (static_cast<double> (k) + 0.5) * static_cast<double> (i) / static_cast<double> (n));
+            for (size_t c = 0; c < ncols; c++) {
+                y[k + c * n] += x[i + c * n] * aki;
+            }
         }
-        y[k] = gamma * y[k] + alpha * v;
     }
     return ForBESUtils::STATUS_OK;
 }
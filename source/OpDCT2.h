@@ -22,6 +22,7 @@
 #define	OPDCT2_H
 
 #include "LinearOperator.h"
+#include "DCTHelper.h"
 #include <math.h>
 
 #define _USE_MATH_DEFINES
@@ -47,6 +48,13 @@
  * 
  * The discrete cosine transform, and especially this version of it - DCT-II - is popular in signal 
  * and image processing, especially for lossy compression.
+ * 
+ * For large \f$n\f$, the operator and its adjoint are evaluated in \f$O(n\log n)\f$
+ * operations using an FFT (see DCTHelper); the direct \f$O(n^2)\f$ evaluation
+ * of the above sums is used for small \f$n\f$, or when #DCTHelper::DCT_DIRECT
+ * is requested explicitly. For many transforms of small size, #DCTHelper::DCT_TABLE
+ * precomputes the \f$n\times n\f$ basis upon construction and applies the
+ * operator as a dense matrix-vector product.
  */
 class OpDCT2 : public LinearOperator {
 public:
@@ -65,6 +73,15 @@ public:
      */
     explicit OpDCT2(size_t n);
 
+    /**
+     * Constructor for an instance of the DCT-II operator with a given size
+     * which uses a given evaluation method.
+     * 
+     * @param n dimension
+     * @param method evaluation method (direct, FFT-based or automatic)
+     */
+    OpDCT2(size_t n, DCTHelper::DCTMethod method);
+
     virtual ~OpDCT2();
 
     virtual int call(Matrix& y, double alpha, Matrix& x, double gamma);
@@ -79,7 +96,33 @@ public:
 
 private:
 
+    OpDCT2(const OpDCT2& orig);
+    OpDCT2& operator=(const OpDCT2& right);
+
+    /**
+     * Allocates the FFT plan or the basis matrix required by the method of
+     * the operator for vectors of length \c n. It is called only by the
+     * constructors, so that #call and #callAdjoint never modify the operator.
+     */
+    void allocate(size_t n);
+
+    /**
+     * Returns the FFT plan for vectors of length \c n, or \c NULL if the
+     * direct method should be used.
+     */
+    DCTHelper * fftPlan(size_t n) const;
+
+    /**
+     * Returns the precomputed basis matrix of the operator (see
+     * DCTHelper::DCT_TABLE) for vectors of length \c n, or \c NULL if it
+     * has not been computed upon construction.
+     */
+    Matrix * basis(size_t n) const;
+
     std::pair<size_t, size_t> m_dimension;
+    DCTHelper::DCTMethod m_method;
+    DCTHelper * m_fft;
+    Matrix * m_basis;
 
 };
 
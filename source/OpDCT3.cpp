@@ -24,49 +24,145 @@
 
 OpDCT3::OpDCT3(size_t dimension) :
 LinearOperator(),
-m_dimension(_VECTOR_OP_DIM(dimension)) {
+m_dimension(_VECTOR_OP_DIM(dimension)),
+m_method(DCTHelper::DCT_AUTO),
+m_fft(NULL),
+m_basis(NULL) {
+    allocate(dimension);
+}
+
+OpDCT3::OpDCT3(size_t dimension, DCTHelper::DCTMethod method) :
+LinearOperator(),
+m_dimension(_VECTOR_OP_DIM(dimension)),
+m_method(method),
+m_fft(NULL),
+m_basis(NULL) {
+    allocate(dimension);
 }
 
 //LCOV_EXCL_START
-OpDCT3::OpDCT3() : m_dimension(_EMPTY_OP_DIM) {
+OpDCT3::OpDCT3() : m_dimension(_EMPTY_OP_DIM), m_method(DCTHelper::DCT_AUTO), m_fft(NULL), m_basis(NULL) {
 }
 //LCOV_EXCL_STOP
 
 OpDCT3::~OpDCT3() {
+    if (m_fft != NULL) {
+        delete m_fft;
+    }
+    if (m_basis != NULL) {
+        delete m_basis;
+    }
+}
+
+void OpDCT3::allocate(size_t n) {
+    if (n == 0) {
+        return;
+    }
+    if (m_method == DCTHelper::DCT_TABLE) {
+        /* T = C' with its first column halved, where C is the DCT-II basis */
+        Matrix C(n, n);
+        DCTHelper::cosineBasis(n, C.getData());
+        m_basis = new Matrix(n, n);
+        double * T = m_basis->getData();
+        const double * pC = C.getData();
+        for (size_t i = 0; i < n; i++) {
+            for (size_t k = 0; k < n; k++) {
+                T[k + i * n] = pC[i + k * n];
+            }
+        }
+        for (size_t k = 0; k < n; k++) {
+            T[k] /= 2.0;
+        }
+    }
+    if (m_method == DCTHelper::DCT_FFT
+            || (m_method == DCTHelper::DCT_AUTO && n >= DCT_FFT_THRESHOLD)) {
+        m_fft = new DCTHelper(n);
+    }
+}
+
+DCTHelper * OpDCT3::fftPlan(size_t n) const {
+    return (m_fft != NULL && m_fft->length() == n) ? m_fft : NULL;
+}
+
+Matrix * OpDCT3::basis(size_t n) const {
+    return (m_basis != NULL && m_basis->getNrows() == n) ? m_basis : NULL;
 }
 
 int OpDCT3::call(Matrix& y, double alpha, Matrix& x, double gamma) {
-    size_t n = x.length();
+    size_t n = x.getNrows();
+    size_t ncols = x.getNcols();
     if (m_dimension.first != 0 && n != m_dimension.first) {
         throw std::invalid_argument("x-dimension is invalid");
     }
-    double x0_2 = x[0] / 2.0;
+    Matrix * T = basis(n);
+    if (T != NULL) {
+        return Matrix::mult(y, alpha, *T, x, gamma);
+    }
+    DCTHelper * fft;
+    if (x.getType() == Matrix::MATRIX_DENSE && y.getType() == Matrix::MATRIX_DENSE
+            && (fft = fftPlan(n)) != NULL) {
+        for (size_t c = 0; c < ncols; c++) {
+            fft->dct3(y.getData() + c * n, alpha, x.getData() + c * n, gamma);
+        }
+        return ForBESUtils::STATUS_OK;
+    }
+    /* every cosine is computed once for all columns of x */
     for (size_t k = 0; k < n; k++) {
-        double yk = x0_2;
+        for (size_t c = 0; c < ncols; c++) {
+            y[k + c * n] = gamma * y[k + c * n] + alpha * x[c * n] / 2.0;
+        }
         for (size_t i = 1; i < n; i++) {
-            yk += (x[i] * std::cos(i * M_PI * (k + 0.5) / n));
+            double aik = alpha * std::cos(i * M_PI * (k + 0.5) / n);
+            for (size_t c = 0; c < ncols; c++) {
+                y[k + c * n] += x[i + c * n] * aik;
+            }
         }
-        y[k] = gamma * y[k] + alpha * yk;
     }
     return ForBESUtils::STATUS_OK;
 }
 
 int OpDCT3::callAdjoint(Matrix& y, double alpha, Matrix& x, double gamma) {
-    size_t n = x.length();
+    size_t n = x.getNrows();
+    size_t ncols = x.getNcols();
     if (m_dimension.first != 0 && n != m_dimension.first) {
         throw std::invalid_argument("x-dimension is invalid");
     }
-    double tk = 0.0;
-    for (size_t i = 0; i < n; i++) {
-        tk += x[i] / 2.0;
+    Matrix * T = basis(n);
+    if (T != NULL) {
+        return Matrix::multTranspose(y, alpha, *T, x, gamma);
+    }
+    DCTHelper * fft;
+    if (x.getType() == Matrix::MATRIX_DENSE && y.getType() == Matrix::MATRIX_DENSE
+            && (fft = fftPlan(n)) != NULL) {
+        /* T* = DCT-II with the first coefficient halved */
+        for (size_t c = 0; c < ncols; c++) {
+            size_t o = c * n;
+            double sum_x = 0.0;
+            for (size_t i = 0; i < n; i++) {
+                sum_x += x[i + o];
+            }
+            fft->dct2(y.getData() + o, alpha, x.getData() + o, gamma);
+            y[o] -= alpha * sum_x / 2.0;
+        }
+        return ForBESUtils::STATUS_OK;
+    }
+    for (size_t c = 0; c < ncols; c++) {
+        double tk = 0.0;
+        for (size_t i = 0; i < n; i++) {
+            tk += x[i + c * n] / 2.0;
+        }
+        y[c * n] = gamma * y[c * n] + alpha * tk;
     }
-    y[0] = gamma * y[0] + alpha * tk;
     for (size_t k = 1; k < n; k++) {
-        tk = 0.0;
+        for (size_t c = 0; c < ncols; c++) {
+            y[k + c * n] *= gamma;
+        }
         for (size_t i = 0; i < n; i++) {
-            tk += (x[i] * std::cos(k * M_PI * (i + 0.5) / n));
+            double aki = alpha * std::cos(k * M_PI * (i + 0.5) / n);
+            for (size_t c = 0; c < ncols; c++) {
+                y[k + c * n] += x[i + c * n] * aki;
+            }
         }
-        y[k] = gamma * y[k] + alpha * tk;
     }
     return ForBESUtils::STATUS_OK;
 }
@@ -22,6 +22,7 @@
 #define	OPDCT3_H
 
 #include "LinearOperator.h"
+#include "DCTHelper.h"
 
 /**
  * \class OpDCT3
@@ -44,6 +45,11 @@
  * 
  * Because it is the inverse of DCT-II (up to a scale factor), this form is sometimes 
  * simply referred to as "the inverse DCT" ("IDCT").
+ * 
+ * For large \f$n\f$, the operator and its adjoint are evaluated in \f$O(n\log n)\f$
+ * operations using an FFT (see DCTHelper). With #DCTHelper::DCT_TABLE the
+ * \f$n\times n\f$ basis is precomputed and the operator is applied as a dense
+ * matrix-vector product.
  *
  */
 class OpDCT3 : public LinearOperator {
@@ -64,6 +70,15 @@ public:
      */
     explicit OpDCT3(size_t m_dimension);
 
+    /**
+     * Construct a new instance of OpDCT3 with a given input/output dimension
+     * which uses a given evaluation method.
+     * 
+     * @param dimension dimension
+     * @param method evaluation method (direct, FFT-based or automatic)
+     */
+    OpDCT3(size_t dimension, DCTHelper::DCTMethod method);
+
     /**
      * Default destructor
      */
@@ -81,7 +96,33 @@ public:
 
 private:
 
+    OpDCT3(const OpDCT3& orig);
+    OpDCT3& operator=(const OpDCT3& right);
+
+    /**
+     * Allocates the FFT plan or the basis matrix required by the method of
+     * the operator for vectors of length \c n. It is called only by the
+     * constructors, so that #call and #callAdjoint never modify the operator.
+     */
+    void allocate(size_t n);
+
+    /**
+     * Returns the FFT plan for vectors of length \c n, or \c NULL if the
+     * direct method should be used.
+     */
+    DCTHelper * fftPlan(size_t n) const;
+
+    /**
+     * Returns the precomputed basis matrix of the operator (see
+     * DCTHelper::DCT_TABLE) for vectors of length \c n, or \c NULL if it
+     * has not been computed upon construction.
+     */
+    Matrix * basis(size_t n) const;
+
     std::pair<size_t, size_t> m_dimension;
+    DCTHelper::DCTMethod m_method;
+    DCTHelper * m_fft;
+    Matrix * m_basis;
 
 };
 
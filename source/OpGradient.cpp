@@ -21,10 +21,10 @@
 #include "OpGradient.h"
 #include <sstream>
 
-void call_1d(Matrix & Tx, Matrix& x, const size_t n, double alpha);
-void call_1d(Matrix & Tx, Matrix& x, const size_t n, double alpha, double gamma);
-void callAdjoint_1d(Matrix& Tstar_x, Matrix& y, const size_t n, double alpha);
-void callAdjoint_1d(Matrix& Tstar_x, Matrix& y, const size_t n, double alpha, double gammna);
+void call_1d(Matrix & Tx, Matrix& x, const size_t n, const size_t ncols, double alpha);
+void call_1d(Matrix & Tx, Matrix& x, const size_t n, const size_t ncols, double alpha, double gamma);
+void callAdjoint_1d(Matrix& Tstar_x, Matrix& y, const size_t n, const size_t ncols, double alpha);
+void callAdjoint_1d(Matrix& Tstar_x, Matrix& y, const size_t n, const size_t ncols, double alpha, double gammna);
 
 OpGradient::OpGradient() : m_dimension(_EMPTY_OP_DIM) {
 }
@@ -37,37 +37,54 @@ OpGradient::~OpGradient() {
 }
 
 /**
- * Calls OpGradient when the input is 1D
- * @param Tx matrix (vector) to store the result
- * @param x input vector x
- * @param n size of x
+ * Calls OpGradient when the input is 1D (on every column of x)
+ * @param Tx matrix to store the result
+ * @param x input vector or matrix x
+ * @param n number of rows of x
+ * @param ncols number of columns of x
  */
-void call_1d(Matrix & Tx, Matrix& x, const size_t n, double alpha) {
-    for (size_t i = 0; i < n - 1; i++) {
-        Tx[i] = alpha * (x[i + 1] - x[i]);
+void call_1d(Matrix & Tx, Matrix& x, const size_t n, const size_t ncols, double alpha) {
+    for (size_t c = 0; c < ncols; c++) {
+        const size_t ox = c * n;
+        const size_t oy = c * (n - 1);
+        for (size_t i = 0; i < n - 1; i++) {
+            Tx[i + oy] = alpha * (x[i + 1 + ox] - x[i + ox]);
+        }
     }
 }
 
-void call_1d(Matrix & Tx, Matrix& x, const size_t n, double alpha, double gamma) {
-    for (size_t i = 0; i < n - 1; i++) {
-        Tx[i] = gamma * Tx[i] + alpha * (x[i + 1] - x[i]);
+void call_1d(Matrix & Tx, Matrix& x, const size_t n, const size_t ncols, double alpha, double gamma) {
+    for (size_t c = 0; c < ncols; c++) {
+        const size_t ox = c * n;
+        const size_t oy = c * (n - 1);
+        for (size_t i = 0; i < n - 1; i++) {
+            Tx[i + oy] = gamma * Tx[i + oy] + alpha * (x[i + 1 + ox] - x[i + ox]);
+        }
     }
 }
 
-void callAdjoint_1d(Matrix& Tstar_x, Matrix& y, const size_t n, double alpha) {
-    Tstar_x[0] = -alpha * y[0];
-    for (size_t i = 1; i < n - 1; i++) {
-        Tstar_x[i] = alpha * (y[i - 1] - y[i]);
+void callAdjoint_1d(Matrix& Tstar_x, Matrix& y, const size_t n, const size_t ncols, double alpha) {
+    for (size_t c = 0; c < ncols; c++) {
+        const size_t ox = c * n;
+        const size_t oy = c * (n - 1);
+        Tstar_x[ox] = -alpha * y[oy];
+        for (size_t i = 1; i < n - 1; i++) {
+            Tstar_x[i + ox] = alpha * (y[i - 1 + oy] - y[i + oy]);
+        }
+        Tstar_x[n - 1 + ox] = alpha * y[n - 2 + oy];
     }
-    Tstar_x[n - 1] = alpha * y[n - 2];
 }
 
-void callAdjoint_1d(Matrix& Tstar_x, Matrix& y, const size_t n, double alpha, double gamma) {
-    Tstar_x.set(0, 0, gamma * Tstar_x.get(0, 0) - alpha * y.get(0, 0));
-    for (size_t i = 1; i < n - 1; i++) {
-        Tstar_x[i] = gamma * Tstar_x[i] + alpha * (y[i - 1] - y[i]);
+void callAdjoint_1d(Matrix& Tstar_x, Matrix& y, const size_t n, const size_t ncols, double alpha, double gamma) {
+    for (size_t c = 0; c < ncols; c++) {
+        const size_t ox = c * n;
+        const size_t oy = c * (n - 1);
+        Tstar_x[ox] = gamma * Tstar_x[ox] - alpha * y[oy];
+        for (size_t i = 1; i < n - 1; i++) {
+            Tstar_x[i + ox] = gamma * Tstar_x[i + ox] + alpha * (y[i - 1 + oy] - y[i + oy]);
+        }
+        Tstar_x[n - 1 + ox] = gamma * Tstar_x[n - 1 + ox] + alpha * y[n - 2 + oy];
     }
-    Tstar_x[n - 1] = gamma * Tstar_x[n - 1] + alpha * y[n - 2];
 }
 
 int OpGradient::call(Matrix& y, double alpha, Matrix& x, double gamma) {
@@ -82,12 +99,20 @@ int OpGradient::call(Matrix& y, double alpha, Matrix& x, double gamma) {
         y = alpha*x;
         return ForBESUtils::STATUS_NUMERICAL_PROBLEMS;
     }
-    call_1d(y, x, n, alpha);
+    if (gamma == 0.0) {
+        call_1d(y, x, n, x.getNcols(), alpha);
+    } else {
+        call_1d(y, x, n, x.getNcols(), alpha, gamma);
+    }
     return ForBESUtils::STATUS_OK;
 }
 
 int OpGradient::callAdjoint(Matrix& y, double alpha, Matrix& x, double gamma) {
-    callAdjoint_1d(y, x, x.getNrows() + 1, alpha);
+    if (gamma == 0.0) {
+        callAdjoint_1d(y, x, x.getNrows() + 1, x.getNcols(), alpha);
+    } else {
+        callAdjoint_1d(y, x, x.getNrows() + 1, x.getNcols(), alpha, gamma);
+    }
     return ForBESUtils::STATUS_OK;
 }
 
@@ -19,15 +19,13 @@
  */
 
 #include "OpLTI.h"
-#include "MatrixFactory.h"
+#include <cblas.h>
 #include <sstream>
-#include <iostream>
-
 
 OpLTI::OpLTI(Matrix& A, Matrix& B, size_t N_horizon) :
 LinearOperator(),
-m_A(A),
-m_B(B),
+m_n(A.getNrows()),
+m_m(B.getNcols()),
 m_N(N_horizon) {
     if (A.getNrows() != A.getNcols()) {
         throw std::invalid_argument("System matrix A must be square");
@@ -35,53 +33,117 @@ m_N(N_horizon) {
     if (A.getNrows() != B.getNrows()) {
         throw std::invalid_argument("A and B have incompatible dimensions");
     }
-    if (N_horizon == 0) {
-        throw std::invalid_argument("N_horizon cannot be zero");
+    if (N_horizon < 2) {
+        throw std::invalid_argument("N_horizon must be at least 2");
+    }
+    m_AB.resize(m_n * (m_n + m_m));
+    for (size_t j = 0; j < m_n; j++) {
+        for (size_t i = 0; i < m_n; i++) {
+            m_AB[i + j * m_n] = A.get(i, j);
+        }
+    }
+    for (size_t j = 0; j < m_m; j++) {
+        for (size_t i = 0; i < m_n; i++) {
+            m_AB[i + (m_n + j) * m_n] = B.get(i, j);
+        }
     }
+    m_work.resize(m_n * (m_N - 1));
 }
 
 OpLTI::~OpLTI() {
 }
 
 int OpLTI::call(Matrix& y, double alpha, Matrix& u, double gamma) {
-    // y := gamma * y + alpha * T(u)
-    // T(u) = [x1, x2, ..., xN]
-    if (!u.isColumnVector()) {
-        throw std::invalid_argument("u should be a column vector");
-    }
-    if (u.getNrows() != (m_N - 1) * m_B.getNcols()) {
+    // y := gamma * y + alpha * T(u), column-wise
+    // T(u) = [x1, x2, ..., x(N-1)]
+    const size_t K = m_N - 1;
+    const size_t ncols = u.getNcols();
+    if (u.getNrows() != K * m_m) {
         std::ostringstream oss;
         oss << "u: wrong dimension - should be (N-1)*n_u = "
-                << (m_N - 1) << "*" << m_B.getNcols()
-                << "=" << ((m_N - 1) * m_B.getNcols());
+                << K << "*" << m_m << "=" << (K * m_m);
         throw std::invalid_argument(oss.str().c_str());
     }
-    size_t n = m_A.getNrows();
-    size_t m = m_B.getNcols();
-    const size_t zero = 0;
-    Matrix y0 = MatrixFactory::ShallowVector(y, n, zero);
-    Matrix u0 = MatrixFactory::ShallowVector(u, m, zero);
-    int status = Matrix::mult(y0, alpha, m_B, u0, gamma);
-    ForBESUtils::fail_on_error(status);
-    std::cout << std::endl;
-    for (size_t i = 1; i < m_N - 1; i++) {
-        Matrix ui = MatrixFactory::ShallowVector(u, m, i * m);
-        std::cout << "u[" << i << "] = " << ui << std::endl;
-    }
-    return ForBESUtils::STATUS_UNDEFINED_FUNCTION;
+    if (y.getNrows() != K * m_n || y.getNcols() != ncols) {
+        throw std::invalid_argument("y: wrong dimension - should be (N-1)*n_x-by-k");
+    }
+    if (ncols == 0) {
+        return ForBESUtils::STATUS_OK;
+    }
+    /* if gamma = 0, the states are computed in y directly */
+    double * x = gamma == 0.0 ? y.getData() : work(K * m_n * ncols);
+    const double * A = &m_AB[0];
+    const double * B = &m_AB[m_n * m_n];
+    /* [x1 ... x(N-1)] := alpha * B * [u0 ... u(N-2)] for all columns at once */
+    cblas_dgemm(CblasColMajor, CblasNoTrans, CblasNoTrans, m_n, K * ncols, m_m,
+            alpha, B, m_n, u.getData(), m_m, 0.0, x, m_n);
+    /* 
+     * x(k+1) := A * x(k) + x(k+1); the states x(k) of all columns are
+     * n-by-ncols blocks with leading dimension (N-1)*n
+     */
+    const size_t ld = K * m_n;
+    for (size_t k = 1; k < K; k++) {
+        cblas_dgemm(CblasColMajor, CblasNoTrans, CblasNoTrans, m_n, ncols, m_n,
+                1.0, A, m_n, x + (k - 1) * m_n, ld, 1.0, x + k * m_n, ld);
+    }
+    if (gamma != 0.0) {
+        double * y_data = y.getData();
+        for (size_t i = 0; i < K * m_n * ncols; i++) {
+            y_data[i] = gamma * y_data[i] + x[i];
+        }
+    }
+    return ForBESUtils::STATUS_OK;
 }
 
 int OpLTI::callAdjoint(Matrix& y, double alpha, Matrix& x, double gamma) {
-    return ForBESUtils::STATUS_UNDEFINED_FUNCTION;
+    // y := gamma * y + alpha * T'(x), column-wise
+    const size_t K = m_N - 1;
+    const size_t ncols = x.getNcols();
+    if (x.getNrows() != K * m_n) {
+        std::ostringstream oss;
+        oss << "x: wrong dimension - should be (N-1)*n_x = "
+                << K << "*" << m_n << "=" << (K * m_n);
+        throw std::invalid_argument(oss.str().c_str());
+    }
+    if (y.getNrows() != K * m_m || y.getNcols() != ncols) {
+        throw std::invalid_argument("y: wrong dimension - should be (N-1)*n_u-by-k");
+    }
+    if (ncols == 0) {
+        return ForBESUtils::STATUS_OK;
+    }
+    double * lambda = work(K * m_n * ncols);
+    const double * A = &m_AB[0];
+    const double * B = &m_AB[m_n * m_n];
+    const double * w = x.getData();
+    /* lambda(N-1) := w(N-1), lambda(k) := w(k) + A' * lambda(k+1) */
+    for (size_t i = 0; i < K * m_n * ncols; i++) {
+        lambda[i] = w[i];
+    }
+    const size_t ld = K * m_n;
+    for (size_t k = K - 1; k > 0; k--) {
+        cblas_dgemm(CblasColMajor, CblasTrans, CblasNoTrans, m_n, ncols, m_n,
+                1.0, A, m_n, lambda + k * m_n, ld, 1.0, lambda + (k - 1) * m_n, ld);
+    }
+    /* [u0 ... u(N-2)] := alpha * B' * [lambda1 ... lambda(N-1)] + gamma * y */
+    cblas_dgemm(CblasColMajor, CblasTrans, CblasNoTrans, m_m, K * ncols, m_n,
+            alpha, B, m_n, lambda, m_n, gamma, y.getData(), m_m);
+    return ForBESUtils::STATUS_OK;
+}
+
+double * OpLTI::work(size_t size) {
+    if (m_work.size() < size) {
+        m_work.resize(size);
+    }
+    return &m_work[0];
 }
 
 std::pair<size_t, size_t> OpLTI::dimensionIn() {
-    std::pair<size_t, size_t> dims(static_cast<size_t> (0), static_cast<size_t> (1));
+    std::pair<size_t, size_t> dims((m_N - 1) * m_m, static_cast<size_t> (1));
     return dims;
 }
 
 std::pair<size_t, size_t> OpLTI::dimensionOut() {
-    std::pair<size_t, size_t> dims(static_cast<size_t> (0), static_cast<size_t> (1));
+    std::pair<size_t, size_t> dims((m_N - 1) * m_n, static_cast<size_t> (1));
     return dims;
 }
 
@@ -89,4 +151,3 @@ bool OpLTI::isSelfAdjoint() {
     return false;
 }
 
-
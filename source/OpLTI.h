@@ -22,15 +22,50 @@
 #define	OPLTI_H
 
 #include "LinearOperator.h"
+#include <vector>
 
 /**
  * \class OpLTI
  * \brief %OpLTI simulates a LTI system with zero initial condition
- * \version 0.0
+ * \version 0.1
  * \author Pantelis Sopasakis
  * \date Created on September 30, 2015, 6:20 PM
  * 
  * \ingroup LinOp
+ * 
+ * This operator maps a sequence of inputs \f$u = (u_0, \ldots, u_{N-2})\f$
+ * to the corresponding sequence of states \f$x = (x_1, \ldots, x_{N-1})\f$ of 
+ * the linear time-invariant system
+ *
+ * \f[
+ *  x_{k+1} = Ax_k + Bu_k,\quad x_0 = 0,
+ * \f]
+ *
+ * where \f$A\in\mathbb{R}^{n\times n}\f$, \f$B\in\mathbb{R}^{n\times m}\f$ and
+ * \f$N\f$ is the prediction horizon. Inputs and states are stacked in column
+ * vectors of dimensions \f$(N-1)m\f$ and \f$(N-1)n\f$ respectively.
+ *
+ * The adjoint operator is computed by the backward sweep
+ *
+ * \f[
+ *  \lambda_{N-1} = w_{N-1},\quad \lambda_k = w_k + A^\top \lambda_{k+1},\quad 
+ *  u_k = B^\top \lambda_{k+1}.
+ * \f]
+ *
+ * Matrices \f$A\f$ and \f$B\f$ are copied, upon construction, in a contiguous
+ * dense array \f$[A\ B]\f$; subsequent modifications of the matrices which
+ * were passed to the constructor do not affect the operator. The inputs 
+ * \f$Bu_k\f$ (resp. \f$B^\top\lambda_k\f$) of all time instants are computed
+ * by a single matrix-matrix product, so only \f$A\f$ is accessed by the 
+ * sequential part of the simulation.
+ *
+ * The operator and its adjoint can be applied to blocks of \f$k\f$ inputs
+ * (resp. states), i.e., to matrices with \f$(N-1)m\f$ (resp. \f$(N-1)n\f$)
+ * rows and \f$k\f$ columns; the \f$k\f$ trajectories are then simulated
+ * simultaneously and every step of the recursion is a matrix-matrix product
+ * with \f$A\f$. No memory is allocated when the operator or its adjoint are
+ * applied, except when a block has more columns than all previous ones (the
+ * workspace then grows accordingly).
  */
 class OpLTI : public LinearOperator {
 public:
@@ -38,6 +73,16 @@ public:
     using LinearOperator::call;
     using LinearOperator::callAdjoint;
 
+    /**
+     * Creates a new LTI operator.
+     *
+     * @param A system matrix (n-by-n)
+     * @param B input matrix (n-by-m)
+     * @param N_horizon prediction horizon (at least 2)
+     * 
+     * @throws std::invalid_argument if the dimensions of the matrices are 
+     * incompatible or N_horizon is smaller than 2
+     */
     OpLTI(Matrix& A, Matrix& B, size_t N_horizon);
 
     virtual ~OpLTI();
@@ -54,9 +99,20 @@ public:
 
 private:
 
-    Matrix & m_A;
-    Matrix & m_B;
-    size_t m_N;
+    OpLTI(const OpLTI& orig);
+    OpLTI& operator=(const OpLTI& right);
+
+    size_t m_n; /**< number of states */
+    size_t m_m; /**< number of inputs */
+    size_t m_N; /**< prediction horizon */
+    std::vector<double> m_AB; /**< [A B] in column-major order */
+    std::vector<double> m_work; /**< states (or co-states), n-by-(N-1)k */
+
+    /**
+     * Returns the workspace, which is enlarged (if necessary) to hold at least
+     * \c size elements.
+     */
+    double * work(size_t size);
 
 };
 
@@ -26,10 +26,55 @@ LinearOperator(), m_A(A), m_B(B), m_a(a), m_b(b) {
         throw std::invalid_argument("A and B have incompatible input dimensions");
     }
     if (A.dimensionOut() != B.dimensionOut()) {
-        throw std::invalid_argument("A and B have incompatible input dimensions");
+        throw std::invalid_argument("A and B have incompatible output dimensions");
     }
 }
 
 OpLinearCombination::~OpLinearCombination() {
 }
 
+int OpLinearCombination::call(Matrix& y, double alpha, Matrix& x, double gamma) {
+    int status = m_A.call(y, alpha * m_a, x, gamma); // y = gamma y + alpha a A(x)
+    if (ForBESUtils::is_status_error(status)) {
+        return status;
+    }
+    status = std::max(status, m_B.call(y, alpha * m_b, x, 1.0)); // y += alpha b B(x)
+    return status;
+}
+
+int OpLinearCombination::callAdjoint(Matrix& y, double alpha, Matrix& x, double gamma) {
+    int status = m_A.callAdjoint(y, alpha * m_a, x, gamma);
+    if (ForBESUtils::is_status_error(status)) {
+        return status;
+    }
+    status = std::max(status, m_B.callAdjoint(y, alpha * m_b, x, 1.0));
+    return status;
+}
+
+std::pair<size_t, size_t> OpLinearCombination::dimensionIn() {
+    return m_A.dimensionIn();
+}
+
+std::pair<size_t, size_t> OpLinearCombination::dimensionOut() {
+    return m_A.dimensionOut();
+}
+
+bool OpLinearCombination::isSelfAdjoint() {
+    return m_A.isSelfAdjoint() && m_B.isSelfAdjoint();
+}
+
+LinearOperator& OpLinearCombination::getA() const {
+    return m_A;
+}
+
+LinearOperator& OpLinearCombination::getB() const {
+    return m_B;
+}
+
+double OpLinearCombination::getCoefficientA() const {
+    return m_a;
+}
+
+double OpLinearCombination::getCoefficientB() const {
+    return m_b;
+}
@@ -33,14 +33,95 @@
  * \date Created on September 14, 2015, 9:25 PM
  * 
  * \ingroup LinOp
+ * 
+ * The linear combination is computed without any intermediate buffers: 
+ * \f$y\leftarrow \gamma y + \alpha (aA(x) + bB(x))\f$ is evaluated as 
+ * \f$y\leftarrow \gamma y + \alpha a A(x)\f$ followed by 
+ * \f$y\leftarrow y + \alpha b B(x)\f$, so the scaling and the summation are
+ * carried out within the passes of \f$A\f$ and \f$B\f$ over \c y. For this
+ * reason, \c x and \c y must not be the same matrix.
  */
 class OpLinearCombination : public LinearOperator {
     
 public:
-    
+
+    using LinearOperator::call;
+    using LinearOperator::callAdjoint;
+
+    /**
+     * Creates the linear operator <code>T(x) = a*A(x) + b*B(x)</code>.
+     * 
+     * @param A linear operator
+     * @param B linear operator with the same dimensions as \c A
+     * @param a coefficient of \c A
+     * @param b coefficient of \c B
+     * 
+     * @throws std::invalid_argument if \c A and \c B have different dimensions
+     */
     OpLinearCombination(LinearOperator& A, LinearOperator& B, double a, double b);
 
     virtual ~OpLinearCombination();
+
+    /**
+     * This method will update \c y as follows
+     * 
+     * \f[
+     * y \leftarrow \gamma y + \alpha (aA(x) + bB(x)).
+     * \f]
+     * 
+     * @param y
+     * @param alpha
+     * @param x
+     * @param gamma
+     * @return status code
+     */
+    virtual int call(Matrix& y, double alpha, Matrix& x, double gamma);
+
+    /**
+     * This method will update \c y as follows
+     * 
+     * \f[
+     * y \leftarrow \gamma y + \alpha (aA^*(x) + bB^*(x)).
+     * \f]
+     * 
+     * @param y
+     * @param alpha
+     * @param x
+     * @param gamma
+     * @return status code
+     */
+    virtual int callAdjoint(Matrix& y, double alpha, Matrix& x, double gamma);
+
+    virtual std::pair<size_t, size_t> dimensionIn();
+
+    virtual std::pair<size_t, size_t> dimensionOut();
+
+    virtual bool isSelfAdjoint();
+
+    /**
+     * The operator \c A of <code>a*A(x) + b*B(x)</code>.
+     * @return operator A
+     */
+    LinearOperator& getA() const;
+
+    /**
+     * The operator \c B of <code>a*A(x) + b*B(x)</code>.
+     * @return operator B
+     */
+    LinearOperator& getB() const;
+
+    /**
+     * The coefficient \c a of <code>a*A(x) + b*B(x)</code>.
+     * @return coefficient a
+     */
+    double getCoefficientA() const;
+
+    /**
+     * The coefficient \c b of <code>a*A(x) + b*B(x)</code>.
+     * @return coefficient b
+     */
+    double getCoefficientB() const;
+
 private:
     LinearOperator& m_A;
     LinearOperator& m_B;
@@ -0,0 +1,401 @@
+/*
+ * File:   OpPlan.cpp
+ *
+ * ForBES is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ForBES is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with ForBES. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "OpPlan.h"
+#include "OpAdjoint.h"
+#include "OpComposition.h"
+#include "OpLinearCombination.h"
+#include "MatrixOperator.h"
+#include <algorithm>
+#include <stdexcept>
+
+/**
+ * Node of an optimized operator expression.
+ */
+struct OpPlan::Node {
+
+    enum Kind {
+        NODE_OPERATOR, /**< a linear operator (or its adjoint) */
+        NODE_MATRIX, /**< a matrix (or its transpose) */
+        NODE_SUM, /**< linear combination of the children */
+        NODE_CHAIN /**< composition of the children (the last one is applied first) */
+    };
+
+    Kind kind;
+    double coef; /**< coefficient */
+    bool adjoint; /**< whether the adjoint of op (transpose of matrix) is applied */
+    LinearOperator * op;
+    Matrix * matrix;
+    bool owns_matrix; /**< whether matrix is a precomputed product */
+    std::pair<size_t, size_t> dim_in;
+    std::pair<size_t, size_t> dim_out;
+    std::vector<Node *> children;
+    std::vector<Matrix> buffers; /**< intermediate results of a chain */
+
+    Node(Kind k) : kind(k), coef(1.0), adjoint(false), op(NULL), matrix(NULL), owns_matrix(false) {
+    }
+
+    ~Node() {
+        for (size_t i = 0; i < children.size(); i++) {
+            delete children[i];
+        }
+        if (owns_matrix) {
+            delete matrix;
+        }
+    }
+
+    bool isDenseMatrix() const {
+        return kind == NODE_MATRIX && matrix->getType() == Matrix::MATRIX_DENSE;
+    }
+
+    /* the matrix which is applied, i.e., M or M' (always a new matrix) */
+    Matrix effectiveMatrix() const {
+        Matrix M(*matrix);
+        if (adjoint) M.transpose();
+        return M;
+    }
+};
+
+OpPlan::OpPlan(LinearOperator& op) : LinearOperator(), m_op(op), m_adjoint(NULL) {
+    m_forward = build(op, false);
+    m_original_cost = cost(m_forward);
+    m_forward = optimize(m_forward);
+    m_cost = cost(m_forward);
+}
+
+OpPlan::~OpPlan() {
+    delete m_forward;
+    if (m_adjoint != NULL) {
+        delete m_adjoint;
+    }
+}
+
+OpPlan::Node * OpPlan::build(LinearOperator& op, bool adjoint) {
+    OpAdjoint * op_adjoint = dynamic_cast<OpAdjoint*> (&op);
+    if (op_adjoint != NULL) {
+        return build(op_adjoint->getOperator(), !adjoint); /* (A*)* = A */
+    }
+    Node * node;
+    OpComposition * op_composition = dynamic_cast<OpComposition*> (&op);
+    OpLinearCombination * op_lincomb = dynamic_cast<OpLinearCombination*> (&op);
+    MatrixOperator * op_matrix = dynamic_cast<MatrixOperator*> (&op);
+    if (op_composition != NULL) {
+        /* (AB)* = B*A* */
+        node = new Node(Node::NODE_CHAIN);
+        LinearOperator& outer = adjoint ? op_composition->getB() : op_composition->getA();
+        LinearOperator& inner = adjoint ? op_composition->getA() : op_composition->getB();
+        Node * factors[2] = {build(outer, adjoint), build(inner, adjoint)};
+        for (size_t i = 0; i < 2; i++) {
+            node->coef *= factors[i]->coef;
+            factors[i]->coef = 1.0;
+            if (factors[i]->kind == Node::NODE_CHAIN) { /* flatten */
+                node->children.insert(node->children.end(),
+                        factors[i]->children.begin(), factors[i]->children.end());
+                factors[i]->children.clear();
+                delete factors[i];
+            } else {
+                node->children.push_back(factors[i]);
+            }
+        }
+    } else if (op_lincomb != NULL) {
+        node = new Node(Node::NODE_SUM);
+        Node * terms[2] = {build(op_lincomb->getA(), adjoint), build(op_lincomb->getB(), adjoint)};
+        double coefs[2] = {op_lincomb->getCoefficientA(), op_lincomb->getCoefficientB()};
+        for (size_t i = 0; i < 2; i++) {
+            if (terms[i]->kind == Node::NODE_SUM) { /* flatten */
+                for (size_t j = 0; j < terms[i]->children.size(); j++) {
+                    terms[i]->children[j]->coef *= coefs[i] * terms[i]->coef;
+                    node->children.push_back(terms[i]->children[j]);
+                }
+                terms[i]->children.clear();
+                delete terms[i];
+            } else {
+                terms[i]->coef *= coefs[i];
+                node->children.push_back(terms[i]);
+            }
+        }
+    } else if (op_matrix != NULL) {
+        node = new Node(Node::NODE_MATRIX);
+        node->matrix = &op_matrix->getMatrix();
+        node->adjoint = adjoint && !op_matrix->isSelfAdjoint();
+    } else {
+        node = new Node(Node::NODE_OPERATOR);
+        node->op = &op;
+        node->adjoint = adjoint && !op.isSelfAdjoint();
+    }
+    node->dim_in = adjoint ? op.dimensionOut() : op.dimensionIn();
+    node->dim_out = adjoint ? op.dimensionIn() : op.dimensionOut();
+    return node;
+}
+
+OpPlan::Node * OpPlan::optimize(Node * node) {
+    for (size_t i = 0; i < node->children.size(); i++) {
+        node->children[i] = optimize(node->children[i]);
+    }
+    if (node->kind == Node::NODE_SUM) {
+        /* drop vanishing terms and add up all dense matrices */
+        std::vector<Node *> terms;
+        Node * dense = NULL;
+        for (size_t i = 0; i < node->children.size(); i++) {
+            Node * term = node->children[i];
+            if (term->coef == 0.0) {
+                delete term;
+            } else if (term->isDenseMatrix()) {
+                if (dense == NULL) {
+                    dense = term;
+                    terms.push_back(term);
+                } else {
+                    Matrix M = dense->effectiveMatrix();
+                    M *= dense->coef;
+                    Matrix N = term->effectiveMatrix();
+                    int status = Matrix::add(M, term->coef, N, 1.0);
+                    if (ForBESUtils::is_status_error(status)) {
+                        throw std::logic_error("OpPlan: cannot add up the dense matrices of a sum");
+                    }
+                    if (dense->owns_matrix) delete dense->matrix;
+                    dense->matrix = new Matrix(M);
+                    dense->owns_matrix = true;
+                    dense->adjoint = false;
+                    dense->coef = 1.0;
+                    delete term;
+                }
+            } else {
+                terms.push_back(term);
+            }
+        }
+        node->children = terms;
+    } else if (node->kind == Node::NODE_CHAIN) {
+        /* 
+         * Runs of dense matrices M[i]...M[j] are grouped into products; the
+         * grouping which minimizes the cost of an application is determined
+         * by dynamic programming over the dimensions d[0], ..., d[r] of the
+         * run (M[k] maps R^d[k+1] to R^d[k]).
+         */
+        std::vector<Node *> factors;
+        size_t i = 0;
+        const size_t nc = node->children.size();
+        while (i < nc) {
+            if (!node->children[i]->isDenseMatrix()) {
+                factors.push_back(node->children[i++]);
+                continue;
+            }
+            size_t j = i;
+            while (j < nc && node->children[j]->isDenseMatrix()) j++;
+            const size_t r = j - i;
+            std::vector<double> d(r + 1);
+            d[0] = static_cast<double> (node->children[i]->dim_out.first);
+            for (size_t k = 0; k < r; k++) {
+                d[k + 1] = static_cast<double> (node->children[i + k]->dim_in.first);
+            }
+            /* best[k]: cost of the first k factors; split[k]: start of the last group */
+            std::vector<double> best(r + 1, 0.0);
+            std::vector<size_t> split(r + 1, 0);
+            for (size_t k = 1; k <= r; k++) {
+                best[k] = -1.0;
+                for (size_t s = 0; s < k; s++) {
+                    double c = best[s] + d[s] * d[k];
+                    if (best[k] < 0.0 || c < best[k]) {
+                        best[k] = c;
+                        split[k] = s;
+                    }
+                }
+            }
+            std::vector<Node *> groups;
+            for (size_t k = r; k > 0; k = split[k]) {
+                size_t s = split[k];
+                Node * first = node->children[i + s];
+                if (k - s > 1) {
+                    Matrix P = first->effectiveMatrix();
+                    first->dim_in = node->children[i + k - 1]->dim_in;
+                    for (size_t q = s + 1; q < k; q++) {
+                        Node * factor = node->children[i + q];
+                        Matrix M = factor->effectiveMatrix();
+                        P = P * M;
+                        first->coef *= factor->coef;
+                        delete factor;
+                    }
+                    if (first->owns_matrix) delete first->matrix;
+                    first->matrix = new Matrix(P);
+                    first->owns_matrix = true;
+                    first->adjoint = false;
+                }
+                groups.push_back(first);
+            }
+            factors.insert(factors.end(), groups.rbegin(), groups.rend());
+            i = j;
+        }
+        node->children = factors;
+        node->buffers.resize(factors.size() > 0 ? factors.size() - 1 : 0);
+    }
+    if ((node->kind == Node::NODE_SUM || node->kind == Node::NODE_CHAIN)
+            && node->children.size() == 1) {
+        /* a single term or factor */
+        Node * child = node->children[0];
+        child->coef *= node->coef;
+        node->children.clear();
+        delete node;
+        return child;
+    }
+    return node;
+}
+
+double OpPlan::cost(const Node * node) {
+    double c = 0.0;
+    switch (node->kind) {
+        case Node::NODE_MATRIX:
+        {
+            const double rows = static_cast<double> (node->matrix->getNrows());
+            const double cols = static_cast<double> (node->matrix->getNcols());
+            switch (node->matrix->getType()) {
+                case Matrix::MATRIX_DENSE:
+                case Matrix::MATRIX_SYMMETRIC:
+                    c = rows * cols;
+                    break;
+                case Matrix::MATRIX_DIAGONAL:
+                    c = rows;
+                    break;
+                default:
+                    c = rows + cols;
+            }
+            break;
+        }
+        case Node::NODE_OPERATOR:
+            c = static_cast<double> (node->dim_in.first * node->dim_in.second
+                    + node->dim_out.first * node->dim_out.second);
+            break;
+        default:
+            for (size_t i = 0; i < node->children.size(); i++) {
+                c += cost(node->children[i]);
+            }
+    }
+    return c;
+}
+
+size_t OpPlan::leaves(const Node * node) {
+    if (node->kind == Node::NODE_MATRIX || node->kind == Node::NODE_OPERATOR) {
+        return 1;
+    }
+    size_t n = 0;
+    for (size_t i = 0; i < node->children.size(); i++) {
+        n += leaves(node->children[i]);
+    }
+    return n;
+}
+
+/* dimensions of the result of node applied to x; sizes the buffers of chains */
+std::pair<size_t, size_t> OpPlan::prepare(Node * node, const Matrix& x) {
+    switch (node->kind) {
+        case Node::NODE_OPERATOR:
+            return node->adjoint ? node->op->blockDimensionIn(x) : node->op->blockDimensionOut(x);
+        case Node::NODE_MATRIX:
+            return std::make_pair(node->dim_out.first, x.getNcols());
+        case Node::NODE_SUM:
+            if (node->children.empty()) {
+                return std::make_pair(node->dim_out.first,
+                        node->dim_out.second == 1 ? x.getNcols() : node->dim_out.second);
+            }
+            return prepare(node->children[0], x);
+        default: /* NODE_CHAIN */
+        {
+            const Matrix * input = &x;
+            for (size_t i = node->children.size() - 1; i > 0; i--) {
+                std::pair<size_t, size_t> dims = prepare(node->children[i], *input);
+                Matrix& buffer = node->buffers[i - 1];
+                if (buffer.getNrows() != dims.first || buffer.getNcols() != dims.second) {
+                    buffer = Matrix(dims.first, dims.second);
+                }
+                input = &buffer;
+            }
+            return prepare(node->children[0], *input);
+        }
+    }
+}
+
+int OpPlan::evaluate(Node * node, Matrix& y, double alpha, Matrix& x, double gamma) {
+    const double a = alpha * node->coef;
+    int status = ForBESUtils::STATUS_OK;
+    switch (node->kind) {
+        case Node::NODE_OPERATOR:
+            return node->adjoint
+                    ? node->op->callAdjoint(y, a, x, gamma)
+                    : node->op->call(y, a, x, gamma);
+        case Node::NODE_MATRIX:
+            return node->adjoint
+                    ? Matrix::multTranspose(y, a, *node->matrix, x, gamma)
+                    : Matrix::mult(y, a, *node->matrix, x, gamma);
+        case Node::NODE_SUM:
+            if (node->children.empty()) {
+                y *= gamma;
+            }
+            for (size_t i = 0; i < node->children.size(); i++) {
+                int s = evaluate(node->children[i], y, a, x, i == 0 ? gamma : 1.0);
+                if (ForBESUtils::is_status_error(s)) return s;
+                status = std::max(status, s);
+            }
+            return status;
+        default: /* NODE_CHAIN */
+        {
+            Matrix * input = &x;
+            for (size_t i = node->children.size() - 1; i > 0; i--) {
+                Matrix& buffer = node->buffers[i - 1];
+                int s = evaluate(node->children[i], buffer, 1.0, *input, 0.0);
+                if (ForBESUtils::is_status_error(s)) return s;
+                status = std::max(status, s);
+                input = &buffer;
+            }
+            int s = evaluate(node->children[0], y, a, *input, gamma);
+            return std::max(status, s);
+        }
+    }
+}
+
+int OpPlan::call(Matrix& y, double alpha, Matrix& x, double gamma) {
+    prepare(m_forward, x);
+    return evaluate(m_forward, y, alpha, x, gamma);
+}
+
+int OpPlan::callAdjoint(Matrix& y, double alpha, Matrix& x, double gamma) {
+    if (m_adjoint == NULL) {
+        m_adjoint = optimize(build(m_op, true));
+    }
+    prepare(m_adjoint, x);
+    return evaluate(m_adjoint, y, alpha, x, gamma);
+}
+
+std::pair<size_t, size_t> OpPlan::dimensionIn() {
+    return m_op.dimensionIn();
+}
+
+std::pair<size_t, size_t> OpPlan::dimensionOut() {
+    return m_op.dimensionOut();
+}
+
+bool OpPlan::isSelfAdjoint() {
+    return m_op.isSelfAdjoint();
+}
+
+double OpPlan::getCost() const {
+    return m_cost;
+}
+
+double OpPlan::getOriginalCost() const {
+    return m_original_cost;
+}
+
+size_t OpPlan::getNumLeaves() const {
+    return leaves(m_forward);
+}
@@ -0,0 +1,147 @@
+/*
+ * File:   OpPlan.h
+ *
+ * ForBES is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ForBES is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with ForBES. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef OPPLAN_H
+#define OPPLAN_H
+
+#include "LinearOperator.h"
+#include <vector>
+
+/**
+ * \class OpPlan
+ * \brief Optimized evaluator of an expression of linear operators
+ * \version 0.1
+ * \ingroup LinOp
+ *
+ * An %OpPlan is a linear operator which is equivalent to a given operator
+ * expression, i.e., a tree of OpComposition, OpSum, OpLinearCombination and
+ * OpAdjoint nodes whose leaves are MatrixOperator objects or any other 
+ * linear operators. The tree is analysed once, upon construction, and is
+ * rewritten as follows:
+ *
+ * - adjoints are pushed down to the leaves, e.g., \f$(AB)^* = B^*A^*\f$, so 
+ *   that adjoints of adjoints cancel out and the adjoints of self-adjoint 
+ *   operators are dropped,
+ * - nested compositions and linear combinations are flattened and their 
+ *   scalar coefficients are folded (and passed to the leaves as the 
+ *   \f$\alpha\f$ of LinearOperator::call), 
+ * - consecutive dense matrices \f$M_1M_2\cdots M_r\f$ in a composition are 
+ *   grouped into precomputed products so as to minimize the cost of an 
+ *   application, e.g., \f$(AB)x\f$ is used instead of \f$A(Bx)\f$ only if
+ *   \f$AB\f$ is smaller than \f$A\f$ and \f$B\f$ together,
+ * - dense matrices in a linear combination are replaced by their (precomputed)
+ *   linear combination.
+ *
+ * The intermediate results of compositions are stored in buffers which are
+ * reused by subsequent invocations. The original expression is not modified
+ * and must outlive the plan; if the matrices of the expression are modified,
+ * a new plan has to be created. The plan of the adjoint operator is created 
+ * upon the first invocation of #callAdjoint.
+ *
+ * Plans are opt-in: OpComposition, OpSum and the other composite operators
+ * are still evaluated node by node, and an expression is only optimized when
+ * it is explicitly wrapped in an %OpPlan. Building a plan has a cost (dense
+ * products are precomputed) which pays off only if the expression is
+ * applied many times, e.g., within an iterative solver, so this is left to
+ * the user.
+ *
+ * Example:
+ *
+ * \code{.cpp}
+ * MatrixOperator opA(A), opB(B);          // A: 10x500, B: 500x10
+ * OpComposition AB(opA, opB);             // x -> A(B(x))
+ * OpAdjoint ABt(AB);
+ * OpSum T(AB, ABt);                       // x -> ABx + (AB)'x
+ * OpPlan plan(T);                         // x -> (AB + B'A')x, one 10x10 matrix
+ * Matrix y = plan.call(x);
+ * \endcode
+ */
+class OpPlan : public LinearOperator {
+public:
+
+    using LinearOperator::call;
+    using LinearOperator::callAdjoint;
+
+    /**
+     * Analyses a linear operator expression and creates its optimized 
+     * evaluator.
+     *
+     * @param op operator expression
+     */
+    explicit OpPlan(LinearOperator& op);
+
+    virtual ~OpPlan();
+
+    virtual int call(Matrix& y, double alpha, Matrix& x, double gamma);
+
+    virtual int callAdjoint(Matrix& y, double alpha, Matrix& x, double gamma);
+
+    virtual std::pair<size_t, size_t> dimensionIn();
+
+    virtual std::pair<size_t, size_t> dimensionOut();
+
+    virtual bool isSelfAdjoint();
+
+    /**
+     * Estimated number of multiply-add operations of an application of the 
+     * optimized operator to a vector. Matrices are counted by their number of
+     * stored entries, and every other operator by the sizes of its input and
+     * output.
+     *
+     * @return estimated cost
+     */
+    double getCost() const;
+
+    /**
+     * Estimated number of multiply-add operations of an application of the 
+     * original expression to a vector (see #getCost).
+     *
+     * @return estimated cost of the original expression
+     */
+    double getOriginalCost() const;
+
+    /**
+     * Number of operators (matrices or other linear operators) which are 
+     * applied when the optimized operator is applied.
+     *
+     * @return number of leaves of the optimized expression
+     */
+    size_t getNumLeaves() const;
+
+private:
+
+    struct Node;
+
+    OpPlan(const OpPlan& orig);
+    OpPlan& operator=(const OpPlan& right);
+
+    LinearOperator& m_op; /**< original expression */
+    Node * m_forward; /**< optimized expression */
+    Node * m_adjoint; /**< optimized adjoint expression (created on demand) */
+    double m_cost; /**< estimated cost of the optimized expression */
+    double m_original_cost; /**< estimated cost of the original expression */
+
+    static Node * build(LinearOperator& op, bool adjoint);
+    static Node * optimize(Node * node);
+    static double cost(const Node * node);
+    static size_t leaves(const Node * node);
+    static std::pair<size_t, size_t> prepare(Node * node, const Matrix& x);
+    static int evaluate(Node * node, Matrix& y, double alpha, Matrix& x, double gamma);
+
+};
+
+#endif /* OPPLAN_H */
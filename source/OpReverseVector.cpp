@@ -37,27 +37,31 @@ OpReverseVector::OpReverseVector(size_t n) {
 
 int OpReverseVector::call(Matrix& y, double alpha, Matrix& x, double gamma) {
     if (y.getNrows() == 0) {
-        y = Matrix(x.getNrows(), 1);
+        y = Matrix(x.getNrows(), x.getNcols());
     }
     bool is_gamma_zero = (std::abs(gamma) < std::numeric_limits<double>::epsilon());
-    size_t n = x.length();
-    for (size_t i = 0; i < n / 2; ++i) {
-        double temp;
-        temp = x.get(n - i - 1, 0);
-        if (is_gamma_zero) {
-            y[n - i - 1] = alpha * x[i];
-            y[i] = alpha * temp;
-        } else {
-            y[n - i - 1] = gamma * y[n - i - 1] + alpha * x[i];
-            y[i] = gamma * y[i] + alpha * temp;
+    /* every column of x is reversed */
+    size_t n = x.getNrows();
+    for (size_t c = 0; c < x.getNcols(); c++) {
+        const size_t o = c * n;
+        for (size_t i = 0; i < n / 2; ++i) {
+            double temp;
+            temp = x[n - i - 1 + o];
+            if (is_gamma_zero) {
+                y[n - i - 1 + o] = alpha * x[i + o];
+                y[i + o] = alpha * temp;
+            } else {
+                y[n - i - 1 + o] = gamma * y[n - i - 1 + o] + alpha * x[i + o];
+                y[i + o] = gamma * y[i + o] + alpha * temp;
+            }
         }
-    }
-    if (n % 2 == 1) {
-        size_t middle_idx = n / 2;
-        if (is_gamma_zero) {
-            y[middle_idx] = alpha * x[middle_idx];
-        } else {
-            y[middle_idx] = gamma * y[middle_idx] + alpha * x[middle_idx];
+        if (n % 2 == 1) {
+            size_t middle_idx = n / 2 + o;
+            if (is_gamma_zero) {
+                y[middle_idx] = alpha * x[middle_idx];
+            } else {
+                y[middle_idx] = gamma * y[middle_idx] + alpha * x[middle_idx];
+            }
         }
     }
     return ForBESUtils::STATUS_OK;
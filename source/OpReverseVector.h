@@ -31,6 +31,9 @@
  * \author Pantelis Sopasakis
  * \date Created on September 15, 2015, 12:57 PM
  * 
+ * If <code>x</code> is a matrix, the order of the elements of each of its 
+ * columns is reversed.
+ * 
  * \ingroup LinOp
  */
 class OpReverseVector : public LinearOperator {
@@ -20,7 +20,7 @@
 
 #include "OpSum.h"
 
-OpSum::OpSum() {
+OpSum::OpSum(LinearOperator& A, LinearOperator& B) : OpLinearCombination(A, B, 1.0, 1.0) {
 }
 
 OpSum::~OpSum() {
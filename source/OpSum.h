@@ -21,7 +21,7 @@
 #ifndef OPSUM_H
 #define	OPSUM_H
 
-#include "LinearOperator.h"
+#include "OpLinearCombination.h"
 
 
 /**
@@ -32,12 +32,24 @@
  * \date Created on September 14, 2015, 9:25 PM
  * 
  * \ingroup LinOp
+ * 
+ * This is the linear combination (see OpLinearCombination) of \c A and \c B 
+ * with unit coefficients; no intermediate buffers are used.
  */
-class OpSum : public LinearOperator {
+class OpSum : public OpLinearCombination {
 public:
-    OpSum();
+
+    /**
+     * Creates the linear operator <code>T(x) = A(x) + B(x)</code>.
+     * 
+     * @param A linear operator
+     * @param B linear operator with the same dimensions as \c A
+     * 
+     * @throws std::invalid_argument if \c A and \c B have different dimensions
+     */
+    OpSum(LinearOperator& A, LinearOperator& B);
+
     virtual ~OpSum();
-private:
 
 };
 
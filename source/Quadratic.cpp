@@ -21,6 +21,8 @@
 #include "Quadratic.h"
 #include "MatrixFactory.h"
 #include "CGSolver.h"
+#include <lapacke.h>
+#include <stdexcept>
 
 using namespace std;
 
@@ -30,6 +32,7 @@ Quadratic::Quadratic() {
     m_solver = NULL;
     m_Q = NULL;
     m_q = NULL;
+    initProx();
 }
 
 Quadratic::Quadratic(Matrix& QQ) {
@@ -38,6 +41,7 @@ Quadratic::Quadratic(Matrix& QQ) {
     m_is_q_zero = true;
     m_solver = NULL;
     m_q = NULL;
+    initProx();
 }
 
 Quadratic::Quadratic(Matrix& QQ, Matrix& qq) {
@@ -46,18 +50,84 @@ Quadratic::Quadratic(Matrix& QQ, Matrix& qq) {
     m_solver = NULL;
     m_is_Q_eye = false;
     m_is_q_zero = false;
+    initProx();
 }
 
 Quadratic::~Quadratic() {
     if (m_solver != NULL) {
         delete m_solver;
     }
+    clearProxCache();
+}
+
+void Quadratic::initProx() {
+    m_prox_method = PROX_FACTORIZATION;
+    m_prox_cache_capacity = QUADRATIC_PROX_CACHE_CAPACITY;
+    m_prox_clock = 0;
+    m_prox_factorizations = 0;
+    m_eig_vectors = NULL;
+    m_eig_values = NULL;
+    m_symmetry_checked = false;
+    m_is_Q_symmetric = false;
+}
+
+void Quadratic::clearProxCache() {
+    for (size_t k = 0; k < m_prox_cache.size(); k++) {
+        delete m_prox_cache[k].solver;
+    }
+    m_prox_cache.clear();
+    if (m_eig_vectors != NULL) {
+        delete m_eig_vectors;
+        m_eig_vectors = NULL;
+    }
+    if (m_eig_values != NULL) {
+        delete m_eig_values;
+        m_eig_values = NULL;
+    }
+    m_symmetry_checked = false;
 }
 
 void Quadratic::setQ(Matrix& Q) {
     m_is_Q_eye = false;
     this->m_Q = &Q;
-    this->m_solver = NULL;
+    if (m_solver != NULL) {
+        delete m_solver;
+        m_solver = NULL;
+    }
+    clearProxCache();
+}
+
+void Quadratic::setProxMethod(ProxMethod method) {
+    m_prox_method = method;
+    clearProxCache();
+}
+
+Quadratic::ProxMethod Quadratic::getProxMethod() const {
+    return m_prox_method;
+}
+
+void Quadratic::setProxCacheCapacity(size_t capacity) {
+    if (capacity == 0) {
+        throw std::invalid_argument("The capacity of the prox cache must be positive");
+    }
+    m_prox_cache_capacity = capacity;
+    while (m_prox_cache.size() > capacity) {
+        /* drop the least recently used factorizations */
+        size_t lru = 0;
+        for (size_t k = 1; k < m_prox_cache.size(); k++) {
+            if (m_prox_cache[k].last_used < m_prox_cache[lru].last_used) lru = k;
+        }
+        delete m_prox_cache[lru].solver;
+        m_prox_cache.erase(m_prox_cache.begin() + lru);
+    }
+}
+
+size_t Quadratic::getProxCacheCapacity() const {
+    return m_prox_cache_capacity;
+}
+
+size_t Quadratic::getProxFactorizations() const {
+    return m_prox_factorizations;
 }
 
 void Quadratic::setq(Matrix& q) {
@@ -155,40 +225,178 @@ FunctionOntologicalClass Quadratic::category() {
 }
 
 int Quadratic::callProx(Matrix& v, double gamma, Matrix& prox) {
-
     Matrix v_gamma_b = v;
     if (!m_is_q_zero) Matrix::add(v_gamma_b, -gamma, *m_q, 1.0);
 
-
-
     // (I+gamma Q)^{-1}(v-gamma q)
-    int status;
-    if (!m_is_Q_eye) {
-        // If Q is not I, we need to create a CGSolver for (I + gamma Q)
-        Matrix Q_tilde(*m_Q);
-        size_t n = m_Q->getNrows();
-        static Matrix Eye = MatrixFactory::MakeIdentity(n, 1.0);
-        Q_tilde *= gamma;
-        Q_tilde += Eye;
-
-        MatrixOperator Q_tilde_op(Q_tilde);
-        Matrix P(n, n, Matrix::MATRIX_DIAGONAL);
-        for (size_t i = 0; i < n; i++) {
-            P[i] = 1 / Q_tilde.get(i, i);
-        }
-        MatrixOperator P_op(P);
-        CGSolver solver(Q_tilde_op, P_op, 1e-6, 1500);
-        status = solver.solve(v_gamma_b, prox);
-        if (ForBESUtils::is_status_error(status)) return status;
-    } else {
+    if (m_is_Q_eye) {
         // Q = I
         // (v-gamma q)/(1+gamma)
         v_gamma_b *= (1. / (1. + gamma));
         prox = v_gamma_b;
         return ForBESUtils::STATUS_OK;
     }
+    if (Matrix::MATRIX_DIAGONAL == m_Q->getType()) {
+        /* Q is diagonal */
+        prox = v_gamma_b;
+        for (size_t i = 0; i < prox.getNrows(); i++) {
+            prox[i] /= (1.0 + gamma * m_Q->get(i, i));
+        }
+        return ForBESUtils::STATUS_OK;
+    }
+    const bool is_dense = Matrix::MATRIX_DENSE == m_Q->getType()
+            || Matrix::MATRIX_SYMMETRIC == m_Q->getType();
+    if (m_prox_method != PROX_CG && isQSymmetric()) {
+        if (m_prox_method == PROX_EIGEN && is_dense) {
+            return callProxEigen(v_gamma_b, gamma, prox);
+        }
+        return callProxFactorization(v_gamma_b, gamma, prox);
+    }
+    return callProxCG(v_gamma_b, gamma, prox);
+}
+
+bool Quadratic::isQSymmetric() {
+    if (m_Q->isSymmetric()) {
+        return true;
+    }
+    if (Matrix::MATRIX_DENSE != m_Q->getType()) {
+        return false;
+    }
+    if (!m_symmetry_checked) {
+        /* a dense Q is only factorized if it is exactly symmetric */
+        const size_t n = m_Q->getNrows();
+        m_is_Q_symmetric = true;
+        for (size_t j = 0; j < n && m_is_Q_symmetric; j++) {
+            for (size_t i = j + 1; i < n; i++) {
+                if (m_Q->get(i, j) != m_Q->get(j, i)) {
+                    m_is_Q_symmetric = false;
+                    break;
+                }
+            }
+        }
+        m_symmetry_checked = true;
+    }
+    return m_is_Q_symmetric;
+}
+
+int Quadratic::callProxCG(Matrix& v_gamma_b, double gamma, Matrix& prox) {
+    // If Q is not I, we need to create a CGSolver for (I + gamma Q)
+    Matrix Q_tilde(*m_Q);
+    size_t n = m_Q->getNrows();
+    Matrix Eye = MatrixFactory::MakeIdentity(n, 1.0);
+    Q_tilde *= gamma;
+    Q_tilde += Eye;
+
+    MatrixOperator Q_tilde_op(Q_tilde);
+    Matrix P(n, n, Matrix::MATRIX_DIAGONAL);
+    for (size_t i = 0; i < n; i++) {
+        P[i] = 1 / Q_tilde.get(i, i);
+    }
+    MatrixOperator P_op(P);
+    if (prox.getNrows() != n || prox.getNcols() != v_gamma_b.getNcols()) {
+        prox = Matrix(n, v_gamma_b.getNcols());
+    }
+    CGSolver solver(Q_tilde_op, P_op, 1e-6, 1500);
+    int status = solver.solve(v_gamma_b, prox);
+    if (ForBESUtils::is_status_error(status)) return status;
     return ForBESUtils::STATUS_OK;
+}
 
+CholeskyFactorization * Quadratic::proxFactorization(double gamma, int& status) {
+    m_prox_clock++;
+    for (size_t k = 0; k < m_prox_cache.size(); k++) {
+        if (m_prox_cache[k].gamma == gamma) {
+            m_prox_cache[k].last_used = m_prox_clock;
+            status = ForBESUtils::STATUS_OK;
+            return m_prox_cache[k].solver;
+        }
+    }
+    size_t slot;
+    if (m_prox_cache.size() < m_prox_cache_capacity) {
+        ProxCacheEntry entry;
+        entry.solver = new CholeskyFactorization(*m_Q);
+        m_prox_cache.push_back(entry);
+        slot = m_prox_cache.size() - 1;
+    } else {
+        /* recycle the least recently used factorization */
+        slot = 0;
+        for (size_t k = 1; k < m_prox_cache.size(); k++) {
+            if (m_prox_cache[k].last_used < m_prox_cache[slot].last_used) slot = k;
+        }
+    }
+    ProxCacheEntry& entry = m_prox_cache[slot];
+    entry.gamma = gamma;
+    entry.last_used = m_prox_clock;
+    m_prox_factorizations++;
+    /* Q + I/gamma; for sparse matrices, the symbolic analysis is reused */
+    status = entry.solver->refactorize(1.0 / gamma);
+    if (ForBESUtils::STATUS_OK != status) {
+        delete entry.solver;
+        m_prox_cache.erase(m_prox_cache.begin() + slot);
+        status = ForBESUtils::STATUS_NUMERICAL_PROBLEMS;
+        return NULL;
+    }
+    return entry.solver;
+}
+
+int Quadratic::callProxFactorization(Matrix& v_gamma_b, double gamma, Matrix& prox) {
+    int status;
+    CholeskyFactorization * solver = proxFactorization(gamma, status);
+    if (solver == NULL) {
+        return status;
+    }
+    /* (I + gamma Q) x = v - gamma q  <=>  (Q + I/gamma) x = (v - gamma q)/gamma */
+    v_gamma_b *= (1.0 / gamma);
+    return solver->solve(v_gamma_b, prox);
 }
 
+int Quadratic::computeEigen() {
+    const size_t n = m_Q->getNrows();
+    m_eig_vectors = new Matrix(n, n);
+    m_eig_values = new Matrix(n, 1);
+    for (size_t j = 0; j < n; j++) {
+        for (size_t i = j; i < n; i++) {
+            m_eig_vectors->set(i, j, m_Q->get(i, j));
+        }
+    }
+    m_prox_factorizations++;
+    /* on exit, the columns of m_eig_vectors are the eigenvectors of Q */
+    int info = LAPACKE_dsyev(LAPACK_COL_MAJOR, 'V', 'L', n,
+            m_eig_vectors->getData(), n, m_eig_values->getData());
+    if (info != 0) {
+        delete m_eig_vectors;
+        delete m_eig_values;
+        m_eig_vectors = NULL;
+        m_eig_values = NULL;
+        return ForBESUtils::STATUS_NUMERICAL_PROBLEMS;
+    }
+    return ForBESUtils::STATUS_OK;
+}
 
+int Quadratic::callProxEigen(Matrix& v_gamma_b, double gamma, Matrix& prox) {
+    if (m_eig_vectors == NULL) {
+        int status = computeEigen();
+        if (ForBESUtils::STATUS_OK != status) {
+            return status;
+        }
+    }
+    const size_t n = m_Q->getNrows();
+    /* prox = V (I + gamma Lambda)^{-1} V' (v - gamma q) */
+    Matrix t(n, v_gamma_b.getNcols());
+    Matrix::multTranspose(t, 1.0, *m_eig_vectors, v_gamma_b, 0.0);
+    for (size_t j = 0; j < t.getNcols(); j++) {
+        for (size_t i = 0; i < n; i++) {
+            double d = 1.0 + gamma * (*m_eig_values)[i];
+            if (d <= 0.0) {
+                return ForBESUtils::STATUS_NUMERICAL_PROBLEMS;
+            }
+            t.getData()[i + j * n] /= d;
+        }
+    }
+    if (prox.getNrows() != n || prox.getNcols() != t.getNcols()
+            || prox.getType() != Matrix::MATRIX_DENSE) {
+        prox = Matrix(n, t.getNcols());
+    }
+    Matrix::mult(prox, 1.0, *m_eig_vectors, t, 0.0);
+    return ForBESUtils::STATUS_OK;
+}
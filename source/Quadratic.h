@@ -25,6 +25,13 @@
 #include "Matrix.h"
 #include "CholeskyFactorization.h"
 #include <iostream>
+#include <vector>
+
+/**
+ * Default maximum number of factorizations which are cached by
+ * Quadratic::callProx (one per value of \f$\gamma\f$).
+ */
+#define QUADRATIC_PROX_CACHE_CAPACITY 4
 
 /**
  * 
@@ -56,8 +63,31 @@
  * \mathrm{prox}_{\gamma f}(v) = (I+\gamma Q)^{-1}(v-\gamma b),
  * \f]
  * 
- * where the linear system \f$(I+\gamma Q)^{-1}(v-\gamma b)\f$ is solved using the
- * conjugate gradient algorithm implemented in CGSolver.
+ * How the linear system \f$(I+\gamma Q)^{-1}(v-\gamma b)\f$ is solved depends
+ * on the #ProxMethod (see #setProxMethod):
+ * 
+ * - #PROX_FACTORIZATION (default): the Cholesky factorization of 
+ *   \f$Q + \gamma^{-1}I\f$ is computed and cached. Adaptive step-size schemes
+ *   tend to revisit a few values of \f$\gamma\f$, so up to 
+ *   #getProxCacheCapacity factorizations are kept and, when the cache is full,
+ *   the least recently used one is recomputed for the new \f$\gamma\f$ 
+ *   (for sparse matrices, its symbolic analysis is reused).
+ *   Every subsequent call with a cached \f$\gamma\f$ costs two triangular 
+ *   solves. This requires a symmetric <code>Q</code> (only its lower 
+ *   triangle is read): dense matrices are checked for symmetry once, and 
+ *   unsymmetric (dense or sparse) matrices are handled by CG, as in earlier
+ *   versions, where CG was always used.
+ * - #PROX_EIGEN: the eigenvalue decomposition \f$Q=V\Lambda V^{\top}\f$ is 
+ *   computed once (\f$O(n^3)\f$), and then 
+ *   \f$\mathrm{prox}_{\gamma f}(v) = V(I+\gamma \Lambda)^{-1}V^{\top}(v-\gamma q)\f$
+ *   costs two matrix-vector products for <em>any</em> \f$\gamma\f$. This is 
+ *   only available for dense and symmetric matrices (otherwise 
+ *   #PROX_FACTORIZATION is used, or CG if <code>Q</code> is not symmetric).
+ * - #PROX_CG: the system is solved using the conjugate gradient algorithm 
+ *   implemented in CGSolver.
+ * 
+ * The cached factorizations refer to the matrix <code>Q</code> passed to this
+ * object; if <code>Q</code> is modified, #setQ needs to be called again.
  * 
  * 
  * Here is a simple example:
@@ -95,6 +125,15 @@ public:
     using Function::callConj;
     using Function::callProx;
 
+    /**
+     * Methods for the computation of the proximal operator
+     */
+    enum ProxMethod {
+        PROX_CG, /**< conjugate gradient */
+        PROX_FACTORIZATION, /**< cached Cholesky factorizations of Q + I/gamma */
+        PROX_EIGEN /**< eigenvalue decomposition of Q (dense or symmetric Q) */
+    };
+
     /**
      * Create a trivial quadratic function with zero Hessian and
      * zero linear term.
@@ -157,6 +196,47 @@ public:
      */
     void setQ(Matrix& Q);
 
+    /**
+     * Selects the method used by #callProx. Changing the method discards all
+     * cached factorizations.
+     * 
+     * @param method the prox method (default: #PROX_FACTORIZATION)
+     */
+    void setProxMethod(ProxMethod method);
+
+    /**
+     * The method used by #callProx.
+     * 
+     * @return the prox method
+     */
+    ProxMethod getProxMethod() const;
+
+    /**
+     * Sets the maximum number of factorizations cached by #callProx when using
+     * #PROX_FACTORIZATION. Each factorization of a dense <code>Q</code> takes
+     * as much memory as <code>Q</code>.
+     * 
+     * @param capacity maximum number of cached factorizations; must be positive
+     * 
+     * @throws std::invalid_argument if \c capacity is zero
+     */
+    void setProxCacheCapacity(size_t capacity);
+
+    /**
+     * Maximum number of factorizations cached by #callProx.
+     * 
+     * @return cache capacity
+     */
+    size_t getProxCacheCapacity() const;
+
+    /**
+     * Number of factorizations (or eigenvalue decompositions) computed by
+     * #callProx so far.
+     * 
+     * @return number of factorizations
+     */
+    size_t getProxFactorizations() const;
+
     /**
      * Setter method for vector \f$q\f$
      * @param q Vector \c q
@@ -214,6 +294,64 @@ private:
     bool m_is_Q_eye; /**< TRUE if Q is the identity matrix */
     bool m_is_q_zero; /**< TRUE is q is the zero vector */
 
+    /**
+     * A cached factorization of Q + I/gamma.
+     */
+    struct ProxCacheEntry {
+        double gamma; /**< step size */
+        CholeskyFactorization * solver; /**< factorization of Q + I/gamma */
+        size_t last_used; /**< time of last use */
+    };
+
+    ProxMethod m_prox_method; /**< method used by callProx */
+    std::vector<ProxCacheEntry> m_prox_cache; /**< cached factorizations */
+    size_t m_prox_cache_capacity; /**< maximum number of cached factorizations */
+    size_t m_prox_clock; /**< incremented upon every use of the cache */
+    size_t m_prox_factorizations; /**< number of factorizations computed */
+    Matrix * m_eig_vectors; /**< eigenvectors of Q (columns) */
+    Matrix * m_eig_values; /**< eigenvalues of Q */
+    bool m_symmetry_checked; /**< whether m_is_Q_symmetric is up to date */
+    bool m_is_Q_symmetric; /**< whether a dense Q is symmetric */
+
+    /**
+     * Initializes the prox-related fields.
+     */
+    void initProx();
+
+    /**
+     * Frees all cached factorizations and eigenvalue decompositions.
+     */
+    void clearProxCache();
+
+    /**
+     * Whether Q is symmetric; a dense Q is checked entrywise upon the first
+     * call (after every #setQ).
+     */
+    bool isQSymmetric();
+
+    /**
+     * Factorization of Q + I/gamma from the cache; it is computed if necessary
+     * and, if the cache is full, replaces the least recently used one.
+     * 
+     * @param gamma step size
+     * @param status status code of the factorization
+     * @return pointer to the factorization or NULL if it failed
+     */
+    CholeskyFactorization * proxFactorization(double gamma, int& status);
+
+    /**
+     * Computes the eigenvalue decomposition of Q.
+     * 
+     * @return status code
+     */
+    int computeEigen();
+
+    int callProxCG(Matrix& v_gamma_b, double gamma, Matrix& prox);
+
+    int callProxFactorization(Matrix& v_gamma_b, double gamma, Matrix& prox);
+
+    int callProxEigen(Matrix& v_gamma_b, double gamma, Matrix& prox);
+
     /**
      * Computes the gradient of this function at a given vector x. 
      * @param x The vector x where the gradient of f should be computed.
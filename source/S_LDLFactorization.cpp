@@ -42,59 +42,106 @@ Matrix S_LDLFactorization::multiply_AAtr_betaI(Matrix& A, double beta) {
 S_LDLFactorization::S_LDLFactorization(Matrix& matrix, double beta) : FactoredSolver(matrix), m_beta(beta) {
     m_factor = NULL;
     m_delegated_solver = NULL;
+    m_gram = NULL;
+    m_analyzed_nnz = 0;
+}
+
+/* number of stored entries of a packed cholmod_sparse */
+static size_t sparse_nnz(const cholmod_sparse * A) {
+    return static_cast<size_t> (static_cast<const int*> (A->p)[A->ncol]);
+}
+
+void S_LDLFactorization::analyze() {
+    if (m_factor != NULL) {
+        cholmod_free_factor(&m_factor, Matrix::cholmod_handle());
+    }
+    m_matrix->m_sparse->stype = 0;
+    m_factor = cholmod_analyze(m_matrix->m_sparse, Matrix::cholmod_handle());
+    m_analyzed_nnz = sparse_nnz(m_matrix->m_sparse);
 }
 
 int S_LDLFactorization::factorize() {
     if (m_matrix_type == Matrix::MATRIX_SPARSE) {
-        double beta_temp[2];
-        beta_temp[0] = m_beta;
-        beta_temp[1] = 0.0;
-
         if (m_matrix->m_sparse == NULL) {
             m_matrix->_createSparse();
         }
-
-        m_matrix->m_sparse->stype = 0;
-        m_factor = cholmod_analyze(m_matrix->m_sparse, Matrix::cholmod_handle());
-        cholmod_factorize_p(m_matrix->m_sparse, beta_temp, NULL, 0, m_factor, Matrix::cholmod_handle());
-        return (m_factor->minor == m_matrix->m_nrows) ? ForBESUtils::STATUS_OK : ForBESUtils::STATUS_NUMERICAL_PROBLEMS;
+        analyze();
+        return factorize_numeric();
     } else if (m_matrix_type == Matrix::MATRIX_DENSE) {
         /* 
          * We here need to factorize a dense matrix 
          * We distinguish between two cases        
-         * 1. A is short (more columns than rows)
-         * 2. A is tall  (more rows than columns)
+         * 1. A is short (more columns than rows): we factorize AA' + beta*I
+         * 2. A is tall  (more rows than columns): we factorize A'A + beta*I
+         * 
+         * The product AA' or A'A is stored, so that it need not be recomputed
+         * when beta changes.
          */
-        if (m_matrix->getNrows() <= m_matrix->getNcols()) {
-            /* this is a ###SHORT### matrix */
-            /*
-             * Note: here we're creating matrix F on the fly and we're passing
-             * its REFERENCE to LDLFactorization. Eventually, m_delegated_solver will
-             * lose track of the original matrix.
-             */
-            Matrix F = multiply_AAtr_betaI(*m_matrix, m_beta);
-            m_delegated_solver = new LDLFactorization(F);
-            int status = m_delegated_solver->factorize();
-            return status;
-        } else {
-            /* this is a ~~~TALL~~~ matrix */
-            m_matrix->transpose();
-            /*
-             * Note: here we're creating matrix F_tilde on the fly and we're passing
-             * its REFERENCE to LDLFactorization. Eventually, m_delegated_solver will
-             * lose track of the original matrix.
-             */
-            Matrix F_tilde = multiply_AAtr_betaI(*m_matrix, m_beta);
-            m_matrix->transpose();
-            m_delegated_solver = new LDLFactorization(F_tilde);
-            int status = m_delegated_solver->factorize();
-            return status;
+        bool is_tall = m_matrix->getNrows() > m_matrix->getNcols();
+        if (is_tall) m_matrix->transpose();
+        Matrix gram = multiply_AAtr_betaI(*m_matrix, 0.0);
+        if (is_tall) m_matrix->transpose();
+        if (m_gram != NULL) {
+            delete m_gram;
         }
+        m_gram = new Matrix(gram);
+        return factorize_numeric();
     } else {
         throw std::invalid_argument("[uoe] Unsupported operation");
     }
 }
 
+int S_LDLFactorization::refactorize() {
+    if (m_matrix_type == Matrix::MATRIX_SPARSE) {
+        if (m_matrix->m_sparse == NULL) {
+            m_matrix->_createSparse();
+        }
+        if (m_factor == NULL || sparse_nnz(m_matrix->m_sparse) != m_analyzed_nnz) {
+            /* no analysis, or the pattern has changed */
+            analyze();
+        }
+        return factorize_numeric();
+    }
+    /* the values of A have changed: recompute AA' (or A'A) */
+    return factorize();
+}
+
+int S_LDLFactorization::refactorize(double beta) {
+    m_beta = beta;
+    if (m_matrix_type == Matrix::MATRIX_DENSE && m_gram != NULL) {
+        return factorize_numeric();
+    }
+    return refactorize();
+}
+
+double S_LDLFactorization::getBeta() const {
+    return m_beta;
+}
+
+int S_LDLFactorization::factorize_numeric() {
+    if (m_matrix_type == Matrix::MATRIX_SPARSE) {
+        double beta_temp[2];
+        beta_temp[0] = m_beta;
+        beta_temp[1] = 0.0;
+        cholmod_factorize_p(m_matrix->m_sparse, beta_temp, NULL, 0, m_factor, Matrix::cholmod_handle());
+        return (m_factor->minor == m_matrix->m_nrows) ? ForBESUtils::STATUS_OK : ForBESUtils::STATUS_NUMERICAL_PROBLEMS;
+    }
+    /*
+     * Note: here we're creating matrix F on the fly and we're passing
+     * its REFERENCE to LDLFactorization. Eventually, m_delegated_solver will
+     * lose track of the original matrix.
+     */
+    Matrix F(*m_gram);
+    for (size_t i = 0; i < F.getNrows(); i++) {
+        F.set(i, i, F.get(i, i) + m_beta);
+    }
+    if (m_delegated_solver != NULL) {
+        delete m_delegated_solver;
+    }
+    m_delegated_solver = new LDLFactorization(F);
+    return m_delegated_solver->factorize();
+}
+
 int S_LDLFactorization::solve(Matrix& rhs, Matrix& solution) {
     solution = Matrix(rhs.m_nrows, rhs.m_ncols);
     if (m_matrix_type == Matrix::MATRIX_SPARSE) {
@@ -147,5 +194,8 @@ S_LDLFactorization::~S_LDLFactorization() {
     if (m_delegated_solver != NULL) {
         delete m_delegated_solver;
     }
+    if (m_gram != NULL) {
+        delete m_gram;
+    }
 }
 
@@ -181,6 +181,37 @@ public:
      */
     virtual int solve(Matrix& rhs, Matrix& solution);
 
+    /**
+     * Recomputes the factorization of \f$AA^{\top}+\beta I\f$ after the values
+     * (but not the sparsity pattern) of \f$A\f$ have changed.
+     * 
+     * For sparse matrices, the symbolic analysis of the last call to 
+     * #factorize is reused; if the number of nonzeros of \f$A\f$ has changed,
+     * or #factorize has not been called, the matrix is analyzed anew.
+     * 
+     * @return status code (see #factorize)
+     */
+    virtual int refactorize();
+
+    /**
+     * Computes the factorization of \f$AA^{\top}+\beta I\f$ for a new 
+     * \f$\beta\f$ (and the current values of \f$A\f$). For sparse matrices, 
+     * the symbolic analysis of the last call to #factorize is reused 
+     * (see #refactorize()); for dense matrices, the product \f$AA^{\top}\f$ 
+     * (or \f$A^{\top}A\f$) is not recomputed.
+     * 
+     * @param beta new (positive) scalar \f$\beta\f$
+     * @return status code (see #factorize)
+     */
+    int refactorize(double beta);
+
+    /**
+     * The current value of \f$\beta\f$.
+     * 
+     * @return scalar \f$\beta\f$
+     */
+    double getBeta() const;
+
 private:
 
     /**
@@ -197,6 +228,28 @@ private:
      */
     FactoredSolver * m_delegated_solver;
 
+    /**
+     * The product AA' (or A'A if A is tall) without the term beta*I (used 
+     * when m_matrix is dense)
+     */
+    Matrix * m_gram;
+
+    /**
+     * Number of nonzeros of the sparse matrix when it was analyzed
+     */
+    size_t m_analyzed_nnz;
+
+    /**
+     * Symbolic analysis of the sparse matrix (replaces m_factor).
+     */
+    void analyze();
+
+    /**
+     * Numeric factorization of AA'+beta*I; for dense matrices, m_gram must
+     * have been computed.
+     */
+    int factorize_numeric();
+
     /**
      * Performs AA'+beta*I for dense matrices. The result will be a 
      * symmetric matrix (type <code>MATRIX_SYMMETRIC</code>).
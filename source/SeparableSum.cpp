@@ -19,135 +19,217 @@
  */
 
 #include "SeparableSum.h"
-#include <iostream>
+#include "MatrixFactory.h"
+
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+/**
+ * Status of a block whose evaluation threw an exception inside a parallel
+ * region; the block is evaluated again serially so that the exception is
+ * propagated to the caller.
+ */
+static const int BLOCK_EXCEPTION = std::numeric_limits<int>::min();
 
 /**
- * Constructs the sub-vector \c c_x which is defined by a given set of indexes.
+ * Copies the entries of \c x indexed by \c idx[0], ..., \c idx[s-1] 
+ * into \c c_x.
  * 
- * @param c_idx set of indexes
  * @param x original vector x
+ * @param idx pointer to the indices
+ * @param s number of indices
+ * @param contiguous whether the indices form a contiguous range
  * @param c_x sub-vector
  */
-void prepare_cx(std::vector<size_t> * c_idx, const Matrix& x, Matrix * c_x);
+static void gather(Matrix& x, const size_t * idx, size_t s, bool contiguous, Matrix& c_x);
+
+/**
+ * Copies the entries of \c c_v into the entries of \c v indexed by
+ * \c idx[0], ..., \c idx[s-1].
+ * 
+ * @param c_v sub-vector
+ * @param idx pointer to the indices
+ * @param s number of indices
+ * @param contiguous whether the indices form a contiguous range
+ * @param v vector to be updated
+ */
+static void scatter(Matrix& c_v, const size_t * idx, size_t s, bool contiguous, Matrix& v);
 
 SeparableSum::~SeparableSum() {
+    for (size_t j = 0; j < m_functions.size(); j++) {
+        delete m_x_buffer[j];
+        delete m_out_buffer[j];
+    }
 }
 
 SeparableSum::SeparableSum(std::map<Function*, std::vector<size_t>*> fun_idx_map) :
-Function(), m_fun_idx_map(fun_idx_map) {
+Function(), m_dim(0), m_parallel(true) {
+    const size_t nblocks = fun_idx_map.size();
+    m_functions.reserve(nblocks);
+    m_block_ptr.reserve(nblocks + 1);
+    m_contiguous.reserve(nblocks);
+    m_x_buffer.reserve(nblocks);
+    m_out_buffer.reserve(nblocks);
+    m_block_ptr.push_back(0);
+    for (std::map<Function*, std::vector<size_t> * >::iterator map_iterator = fun_idx_map.begin()
+            ; map_iterator != fun_idx_map.end()
+            ; ++map_iterator) {
+        const std::vector<size_t> & c_idx = *(map_iterator->second);
+        const size_t s = c_idx.size();
+        bool contiguous = s > 0;
+        for (size_t k = 0; k < s; k++) {
+            contiguous = contiguous && (c_idx[k] == c_idx[0] + k);
+            if (c_idx[k] + 1 > m_dim) {
+                m_dim = c_idx[k] + 1;
+            }
+        }
+        m_functions.push_back(map_iterator->first);
+        m_idx.insert(m_idx.end(), c_idx.begin(), c_idx.end());
+        m_block_ptr.push_back(m_idx.size());
+        m_contiguous.push_back(contiguous);
+        m_x_buffer.push_back(new Matrix(s, 1));
+        m_out_buffer.push_back(new Matrix(s, 1));
+    }
+    m_fvals.resize(nblocks);
+    m_status.resize(nblocks);
 }
 
-void prepare_cx(std::vector<size_t> * c_idx, const Matrix& x, Matrix * c_x) {
-    size_t k = 0;
-    for (std::vector<size_t>::iterator idx_iterator = c_idx->begin();
-            idx_iterator != c_idx->end();
-            ++idx_iterator) {
-        c_x -> set(k, 0, x.get(*idx_iterator, 0));
-        k++;
+void gather(Matrix& x, const size_t * idx, size_t s, bool contiguous, Matrix& c_x) {
+    double * c_x_data = c_x.getData();
+    if (x.getType() != Matrix::MATRIX_DENSE) {
+        for (size_t k = 0; k < s; k++) {
+            c_x_data[k] = x.get(idx[k], 0);
+        }
+        return;
+    }
+    const double * x_data = x.getData();
+    if (contiguous) {
+        std::memcpy(c_x_data, x_data + idx[0], s * sizeof (double));
+        return;
+    }
+    for (size_t k = 0; k < s; k++) {
+        c_x_data[k] = x_data[idx[k]];
     }
 }
 
-int SeparableSum::call(Matrix& x, double& f) {
-    //LCOV_EXCL_START
-    if (!x.isColumnVector()) throw std::invalid_argument("x must be a column-vector");
-    //LCOV_EXCL_STOP
-
-    /* sub-matrix */
-    Matrix *c_x = NULL;
-
-    /* initialization of result f(x) */
-    f = 0.0;
-
-
-    /* Invoke all functions */
-    for (std::map<Function*, std::vector<size_t> * >::iterator map_iterator = m_fun_idx_map.begin()
-            ; map_iterator != m_fun_idx_map.end()
-            ; ++map_iterator) {
-        /* current vector of indices*/
-        std::vector<size_t> * c_idx = NULL;
-
-        /* temporary value of sub-invocations */
-        double f_temp;
-
-        /* status of sub-invocations   */
-        int status;
-
-        /* Pointer to current function */
-        Function * c_fun = NULL;
-        c_fun = map_iterator->first;
-
-        /* Function indices         */
-        c_idx = map_iterator->second;
+void scatter(Matrix& c_v, const size_t * idx, size_t s, bool contiguous, Matrix& v) {
+    const double * c_v_data = c_v.getData();
+    if (v.getType() != Matrix::MATRIX_DENSE) {
+        for (size_t k = 0; k < s; k++) {
+            v.set(idx[k], 0, c_v_data[k]);
+        }
+        return;
+    }
+    double * v_data = v.getData();
+    if (contiguous) {
+        std::memcpy(v_data + idx[0], c_v_data, s * sizeof (double));
+        return;
+    }
+    for (size_t k = 0; k < s; k++) {
+        v_data[idx[k]] = c_v_data[k];
+    }
+}
 
-        /* initialize new sub-matrix */
-        c_x = new Matrix(c_idx->size(), 1);
+int SeparableSum::evaluate_block(size_t j, EvalMode mode, Matrix& x, double gamma, Matrix* out) {
+    Function * c_fun = m_functions[j];
+    const size_t s = m_block_ptr[j + 1] - m_block_ptr[j];
+    const size_t * c_idx = s > 0 ? &m_idx[m_block_ptr[j]] : NULL;
+    const bool contiguous = m_contiguous[j];
+    double & f_temp = m_fvals[j];
+
+    /*
+     * Shallow vectors are used only as inputs: the assignment operator of Matrix
+     * re-points (rather than overwrites) shallow vectors, so they cannot be
+     * handed to functions as outputs.
+     */
+    if ((mode == EVAL_F || mode == EVAL_CONJ) && contiguous && x.getType() == Matrix::MATRIX_DENSE) {
+        Matrix c_x = MatrixFactory::ShallowVector(x.getData(), s, c_idx[0]);
+        return mode == EVAL_F ? c_fun->call(c_x, f_temp) : c_fun->callConj(c_x, f_temp);
+    }
 
-        /* iterator for the indices of c_fun */
-        prepare_cx(c_idx, x, c_x);
+    Matrix & c_x = *m_x_buffer[j];
+    Matrix & c_out = *m_out_buffer[j];
+    gather(x, c_idx, s, contiguous, c_x);
+
+    int status;
+    switch (mode) {
+        case EVAL_F:
+            return c_fun->call(c_x, f_temp);
+        case EVAL_CONJ:
+            return c_fun->callConj(c_x, f_temp);
+        case EVAL_GRAD:
+            status = c_fun->call(c_x, f_temp, c_out);
+            break;
+        case EVAL_PROX:
+            f_temp = 0.0;
+            status = c_fun->callProx(c_x, gamma, c_out);
+            break;
+        default:
+            status = c_fun->callProx(c_x, gamma, c_out, f_temp);
+            break;
+    }
+    if (!ForBESUtils::is_status_error(status)) {
+        scatter(c_out, c_idx, s, contiguous, *out);
+    }
+    return status;
+}
 
-        /* invoke sub-function on c_x, return f_temp */
-        status = c_fun -> call(*c_x, f_temp);
-        if (ForBESUtils::is_status_error(status)) {
-            delete c_x;
-            c_x = NULL;
-            return status;
+int SeparableSum::evaluate(EvalMode mode, Matrix& x, double gamma, Matrix* out, double& f) {
+    if (x.getNrows() < m_dim) {
+        throw std::invalid_argument("x has incompatible dimensions");
+    }
+    if (out != NULL && out->getNrows() < m_dim) {
+        throw std::invalid_argument("the output vector has incompatible dimensions");
+    }
+    const size_t nblocks = m_functions.size();
+
+#ifdef _OPENMP
+    /* gather/scatter on non-dense matrices go through Matrix::get/set, which are not thread-safe */
+    const bool parallel = m_parallel && nblocks > 1 && m_dim >= MATRIX_PARALLEL_THRESHOLD
+            && x.getType() == Matrix::MATRIX_DENSE
+            && (out == NULL || out->getType() == Matrix::MATRIX_DENSE);
+#pragma omp parallel for schedule(dynamic, 16) if (parallel) num_threads(Matrix::get_num_threads())
+    for (size_t j = 0; j < nblocks; j++) {
+        try {
+            m_status[j] = evaluate_block(j, mode, x, gamma, out);
+        } catch (...) {
+            m_status[j] = BLOCK_EXCEPTION;
         }
-        f += f_temp;
     }
-
-    if (c_x != NULL) {
-        delete c_x;
-        c_x = NULL;
+#else
+    for (size_t j = 0; j < nblocks; j++) {
+        m_status[j] = evaluate_block(j, mode, x, gamma, out);
     }
-    return ForBESUtils::STATUS_OK;
-}
+#endif
 
-int SeparableSum::call(Matrix& x, double& f, Matrix& grad) {
-    Matrix *c_x = NULL;
+    /* the values are summed up in a fixed order, independently of the threads */
+    int status = ForBESUtils::STATUS_OK;
     f = 0.0;
-    Matrix *c_grad = NULL;
-    /* Invoke all functions */
-    for (std::map<Function*, std::vector<size_t> * >::iterator map_iterator = m_fun_idx_map.begin()
-            ; map_iterator != m_fun_idx_map.end()
-            ; ++map_iterator) {
-        std::vector<size_t> * c_idx = NULL;
-        double f_temp;
-        int status;
-        Function * c_fun = NULL;
-        c_fun = map_iterator->first;
-        c_idx = map_iterator->second;
-        c_x = new Matrix(c_idx->size(), 1);
-        prepare_cx(c_idx, x, c_x);
-        c_grad = new Matrix(c_idx->size(), 1);
-        status = c_fun -> call(*c_x, f_temp, *c_grad);
-
-        if (ForBESUtils::is_status_error(status)) {
-            delete c_x;
-            c_x = NULL;
-            delete c_grad;
-            c_grad = NULL;
-            return status;
+    for (size_t j = 0; j < nblocks; j++) {
+        if (m_status[j] == BLOCK_EXCEPTION) {
+            m_status[j] = evaluate_block(j, mode, x, gamma, out);
         }
-
-        size_t k = 0;
-        std::vector<size_t>::iterator idx_iterator;
-        for (idx_iterator = c_idx->begin(); idx_iterator != c_idx->end(); ++idx_iterator) {
-            grad[*idx_iterator] = c_grad->get(k);
-            k++;
+        if (ForBESUtils::is_status_error(m_status[j]) && ForBESUtils::is_status_ok(status)) {
+            status = m_status[j];
         }
-
-        f += f_temp;
+        f += m_fvals[j];
     }
+    return status;
+}
 
-    if (c_x != NULL) {
-        delete c_x;
-        c_x = NULL;
-    }
-    if (c_grad != NULL) {
-        delete c_grad;
-        c_grad = NULL;
-    }
-    return ForBESUtils::STATUS_OK;
+int SeparableSum::call(Matrix& x, double& f) {
+    //LCOV_EXCL_START
+    if (!x.isColumnVector()) throw std::invalid_argument("x must be a column-vector");
+    //LCOV_EXCL_STOP
+    return evaluate(EVAL_F, x, 0.0, NULL, f);
+}
+
+int SeparableSum::call(Matrix& x, double& f, Matrix& grad) {
+    //LCOV_EXCL_START
+    if (!x.isColumnVector()) throw std::invalid_argument("x must be a column-vector");
+    //LCOV_EXCL_STOP
+    return evaluate(EVAL_GRAD, x, 0.0, &grad, f);
 }
 
 int SeparableSum::callProx(Matrix& x, double gamma, Matrix& prox) {
@@ -156,35 +238,8 @@ int SeparableSum::callProx(Matrix& x, double gamma, Matrix& prox) {
         throw std::invalid_argument("x must be a column-vector");
     }
     //LCOV_EXCL_STOP
-
-    Matrix *c_x = NULL;
-    Matrix *c_prox = NULL;
-
-    for (std::map<Function*, std::vector<size_t> * >::iterator map_iterator = m_fun_idx_map.begin()
-            ; map_iterator != m_fun_idx_map.end()
-            ; ++map_iterator) {
-        Function * c_fun = map_iterator->first;
-        std::vector<size_t> * c_idx = map_iterator->second;
-        c_x = new Matrix(c_idx->size(), 1);
-        prepare_cx(c_idx, x, c_x);
-
-        c_prox = new Matrix(c_idx->size(), 1);
-        int status = c_fun -> callProx(*c_x, gamma, *c_prox);
-        if (ForBESUtils::is_status_error(status)) {
-            delete c_x;
-            delete c_prox;
-            return status;
-        }
-        size_t k = 0;
-        std::vector<size_t>::iterator idx_iterator;
-        for (idx_iterator = c_idx->begin(); idx_iterator != c_idx->end(); ++idx_iterator) {
-            prox[*idx_iterator] = c_prox->get(k);
-            k++;
-        }
-    }
-    if (c_x != NULL) delete c_x;
-    if (c_prox != NULL) delete c_prox;
-    return ForBESUtils::STATUS_OK;
+    double f_at_prox;
+    return evaluate(EVAL_PROX, x, gamma, &prox, f_at_prox);
 }
 
 int SeparableSum::callProx(Matrix& x, double gamma, Matrix& prox, double& f_at_prox) {
@@ -193,42 +248,7 @@ int SeparableSum::callProx(Matrix& x, double gamma, Matrix& prox, double& f_at_p
         throw std::invalid_argument("x must be a column-vector");
     }
     //LCOV_EXCL_STOP
-
-    Matrix *c_x = NULL;
-    Matrix *c_prox = NULL;
-
-    f_at_prox = 0.0;
-    double f_at_prox_temp = 0.0;
-    for (std::map<Function*, std::vector<size_t> * >::iterator map_iterator = m_fun_idx_map.begin()
-            ; map_iterator != m_fun_idx_map.end()
-            ; ++map_iterator) {
-        Function * c_fun = map_iterator->first;
-        std::vector<size_t> * c_idx = map_iterator->second;
-        c_x = new Matrix(c_idx->size(), 1);
-        prepare_cx(c_idx, x, c_x);
-
-        c_prox = new Matrix(c_idx->size(), 1);
-        int status = c_fun -> callProx(*c_x, gamma, *c_prox, f_at_prox_temp);
-        f_at_prox += f_at_prox_temp;
-
-        //LCOV_EXCL_START
-        if (ForBESUtils::STATUS_OK != status) {
-            delete c_x;
-            delete c_prox;
-            return status;
-        }
-        //LCOV_EXCL_STOP
-
-        size_t k = 0;
-        std::vector<size_t>::iterator idx_iterator;
-        for (idx_iterator = c_idx->begin(); idx_iterator != c_idx->end(); ++idx_iterator) {
-            prox[*idx_iterator] = c_prox->get(k);
-            k++;
-        }
-    }
-    if (c_x != NULL) delete c_x;
-    if (c_prox != NULL) delete c_prox;
-    return ForBESUtils::STATUS_OK;
+    return evaluate(EVAL_PROX_F, x, gamma, &prox, f_at_prox);
 }
 
 int SeparableSum::callConj(Matrix& x, double& f_star) {
@@ -237,33 +257,19 @@ int SeparableSum::callConj(Matrix& x, double& f_star) {
         throw std::invalid_argument("x must be a column-vector");
     }
     //LCOV_EXCL_STOP
-    f_star = 0.0;
+    return evaluate(EVAL_CONJ, x, 0.0, NULL, f_star);
+}
 
-    std::map<Function*, std::vector<size_t> * >::iterator map_iterator;
-    Function * c_fun = NULL;
-    Matrix *c_x = NULL;
+void SeparableSum::setParallel(bool parallel) {
+    m_parallel = parallel;
+}
 
-    for (map_iterator = m_fun_idx_map.begin(); map_iterator != m_fun_idx_map.end(); ++map_iterator) {
-        std::vector<size_t> * c_idx = NULL;
-        c_fun = map_iterator->first; // current function
-        c_idx = map_iterator->second; // current index set I
-        c_x = new Matrix(c_idx->size(), 1); // prepare current vector
-        prepare_cx(c_idx, x, c_x);
+bool SeparableSum::isParallel() const {
+    return m_parallel;
+}
 
-        double f_star_temp;
-        int status = c_fun -> callConj(*c_x, f_star_temp);
-        if (ForBESUtils::is_status_error(status)) {
-            delete c_x;
-            c_x = NULL;
-            return status;
-        }
-        f_star += f_star_temp;
-    }
-    if (c_x != NULL) {
-        delete c_x;
-        c_x = NULL;
-    }
-    return ForBESUtils::STATUS_UNDEFINED_FUNCTION;
+size_t SeparableSum::num_blocks() const {
+    return m_functions.size();
 }
 
 FunctionOntologicalClass SeparableSum::category() {
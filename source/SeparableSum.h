@@ -90,6 +90,21 @@
  *  // Construct the separable sum
  *  Function * sep_sum = new SeparableSum(fun_idx_map);
  * \endcode   
+ * 
+ * Upon construction, the sets of indices are copied into a gather/scatter plan,
+ * so the vectors in the map are not accessed afterwards. Functions whose indices
+ * form a contiguous range \f$\{i, i+1, \ldots, i+r-1\}\f$ are evaluated on
+ * shallow vectors pointing directly to the data of \f$x\f$ (whenever no output
+ * vector is involved) or by means of block copies; the remaining functions work on 
+ * preallocated buffers, so no memory is allocated when the separable sum
+ * is invoked.
+ * 
+ * When the library is compiled with OpenMP support, the functions \f$f_i\f$ are
+ * invoked in parallel (using Matrix::get_num_threads() threads) provided that the 
+ * dimension of \f$x\f$ is at least \c MATRIX_PARALLEL_THRESHOLD and that \f$x\f$
+ * (and the output of the proximal operator) are dense. The functions
+ * \f$f_i\f$ must then be distinct objects which can be invoked concurrently;
+ * parallel evaluation can be turned off using #setParallel.
  */
 class SeparableSum : public Function {
 public:    
@@ -197,10 +212,66 @@ public:
    
     virtual FunctionOntologicalClass category();
 
+    /**
+     * Enables or disables the parallel evaluation of the functions of this
+     * separable sum (enabled by default). This setting has no effect if the
+     * library is compiled without OpenMP support.
+     * 
+     * @param parallel whether the functions may be invoked in parallel
+     */
+    void setParallel(bool parallel);
+
+    /**
+     * Whether the functions of this separable sum may be invoked in parallel.
+     * 
+     * @return \c true if parallel evaluation is enabled
+     */
+    bool isParallel() const;
+
+    /**
+     * Number of functions in this separable sum.
+     * 
+     * @return number of functions
+     */
+    size_t num_blocks() const;
+
 
 private:
 
-    std::map<Function*, std::vector<size_t> * > m_fun_idx_map;
+    /**
+     * Type of invocation of the functions of the separable sum.
+     */
+    enum EvalMode {
+        EVAL_F,         /**< function value */
+        EVAL_GRAD,      /**< function value and gradient */
+        EVAL_PROX,      /**< proximal operator */
+        EVAL_PROX_F,    /**< proximal operator and value at the proximal point */
+        EVAL_CONJ       /**< conjugate */
+    };
+
+    SeparableSum(const SeparableSum& orig);
+    SeparableSum& operator=(const SeparableSum& right);
+
+    /**
+     * Invokes the j-th function; the value is stored in m_fvals[j].
+     */
+    int evaluate_block(size_t j, EvalMode mode, Matrix& x, double gamma, Matrix * out);
+
+    /**
+     * Invokes all functions (in parallel, if possible) and sums up their values.
+     */
+    int evaluate(EvalMode mode, Matrix& x, double gamma, Matrix * out, double& f);
+
+    std::vector<Function*> m_functions;     /**< functions f_j */
+    std::vector<size_t> m_idx;              /**< concatenated index sets */
+    std::vector<size_t> m_block_ptr;        /**< I_j is m_idx[m_block_ptr[j]], ..., m_idx[m_block_ptr[j+1]-1] */
+    std::vector<bool> m_contiguous;         /**< whether I_j is a contiguous range */
+    std::vector<Matrix*> m_x_buffer;        /**< buffers for x_{I_j} */
+    std::vector<Matrix*> m_out_buffer;      /**< buffers for the output of f_j */
+    std::vector<double> m_fvals;            /**< values returned by the functions */
+    std::vector<int> m_status;              /**< status codes returned by the functions */
+    size_t m_dim;                           /**< minimum dimension of x */
+    bool m_parallel;                        /**< whether parallel evaluation is enabled */
 
 };
 
@@ -0,0 +1,143 @@
+/*
+ * File:   ZeroFPR.cpp
+ *
+ * ForBES is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ForBES is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with ForBES. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ZeroFPR.h"
+
+#include <cmath>
+
+#define DEFAULT_LBFGS_MEM 5
+#define LINESEARCH_SIGMA 1e-4
+#define LINESEARCH_MAXIT 10
+#define CURVATURE_EPS 1e-12
+
+ZeroFPR::ZeroFPR(FBProblem & prob, Matrix & x0, double gamma) :
+FBSplitting(prob, x0, gamma) {
+    allocate_workspace(x0, DEFAULT_LBFGS_MEM);
+}
+
+ZeroFPR::ZeroFPR(FBProblem & prob, Matrix & x0, double gamma, FBStopping & sc) :
+FBSplitting(prob, x0, gamma, sc) {
+    allocate_workspace(x0, DEFAULT_LBFGS_MEM);
+}
+
+ZeroFPR::ZeroFPR(FBProblem & prob, Matrix & x0, double gamma, int maxit) :
+FBSplitting(prob, x0, gamma, maxit) {
+    allocate_workspace(x0, DEFAULT_LBFGS_MEM);
+}
+
+ZeroFPR::ZeroFPR(FBProblem & prob, Matrix & x0, double gamma, FBStopping & sc, int maxit, size_t mem) :
+FBSplitting(prob, x0, gamma, sc, maxit) {
+    allocate_workspace(x0, mem);
+}
+
+void ZeroFPR::allocate_workspace(Matrix & x0, size_t mem) {
+    size_t nrows = x0.getNrows();
+    size_t ncols = x0.getNcols();
+    m_lbfgs = new LBFGSBuffer(nrows * ncols, mem);
+    m_xbar = new Matrix(nrows, ncols);
+    m_rbar = new Matrix(nrows, ncols);
+    m_direction = new Matrix(nrows, ncols);
+    m_s = new Matrix(nrows, ncols);
+    m_y = new Matrix(nrows, ncols);
+    m_has_previous = false;
+}
+
+int ZeroFPR::iterate() {
+    int status;
+    if (isAdaptiveStepsize()) {
+        const double gamma_prev = getGamma();
+        status = backtrack();
+        if (ForBESUtils::is_status_error(status)) return status;
+        if (getGamma() != gamma_prev) {
+            /* the stored pairs and xbar refer to the previous step-size */
+            resetState();
+        }
+    }
+    const double gamma = getGamma();
+
+    /* FBE and fixed-point residual at x */
+    double fbe_x = m_cache.get_eval_FBE(gamma);
+    Matrix * fpr_x = m_cache.get_fpr();
+    double sqnorm_fpr_x = std::pow(m_cache.get_norm_fpr(), 2);
+
+    /* s = x - xbar_prev, y = R(x) - R(xbar_prev) */
+    if (m_has_previous) {
+        *m_s = *m_cache.get_point();
+        Matrix::add(*m_s, -1.0, *m_xbar, 1.0);
+        *m_y = *fpr_x;
+        Matrix::add(*m_y, -1.0, *m_rbar, 1.0);
+        double ys = 0.0;
+        double ss = 0.0;
+        for (size_t i = 0; i < m_s->length(); i++) {
+            ys += (*m_y)[i] * (*m_s)[i];
+            ss += (*m_s)[i] * (*m_s)[i];
+        }
+        if (ys > CURVATURE_EPS * ss) {
+            m_lbfgs->push(m_s, m_y);
+        }
+    }
+
+    /* xbar = T(x) and the fixed-point residual at xbar */
+    *m_xbar = *m_cache.get_forward_backward_step(gamma);
+    m_cache.set_point(*m_xbar);
+    *m_rbar = *m_cache.get_fpr();
+    m_has_previous = true;
+
+    /* d = -H * R(xbar) */
+    double H0 = m_lbfgs->hessian_estimate();
+    status = m_lbfgs->update(m_rbar, m_direction, H0);
+    if (ForBESUtils::is_status_error(status)) return status;
+    *m_direction *= -1.0;
+    m_cache.set_direction(*m_direction);
+
+    /* line search on the FBE along xbar + tau * d */
+    double tau = 1.0;
+    const double fbe_bound = fbe_x - LINESEARCH_SIGMA / gamma * sqnorm_fpr_x;
+    bool accepted = false;
+    for (size_t k = 0; k < LINESEARCH_MAXIT; k++) {
+        double fbe_trial;
+        status = m_cache.extrapolate_fbe(tau, gamma, fbe_trial);
+        if (ForBESUtils::is_status_error(status)) return status;
+        if (fbe_trial <= fbe_bound) {
+            accepted = true;
+            break;
+        }
+        tau *= 0.5;
+    }
+
+    /* x = xbar + tau * d (or x = xbar if the line search has failed) */
+    if (accepted) {
+        *m_s = *m_xbar;
+        Matrix::add(*m_s, tau, *m_direction, 1.0);
+        m_cache.set_point(*m_s);
+    }
+    return ForBESUtils::STATUS_OK;
+}
+
+void ZeroFPR::resetState() {
+    m_lbfgs->reset();
+    m_has_previous = false;
+}
+
+ZeroFPR::~ZeroFPR() {
+    delete m_lbfgs;
+    delete m_xbar;
+    delete m_rbar;
+    delete m_direction;
+    delete m_s;
+    delete m_y;
+}
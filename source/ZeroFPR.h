@@ -0,0 +1,152 @@
+/*
+ * File:   ZeroFPR.h
+ *
+ * ForBES is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ForBES is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with ForBES. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ZEROFPR_H
+#define ZEROFPR_H
+
+#include "FBProblem.h"
+#include "FBCache.h"
+#include "FBSplitting.h"
+#include "FBStopping.h"
+#include "LBFGSBuffer.h"
+
+/**
+ * \class ZeroFPR
+ * \brief Quasi-Newton forward-backward algorithm (ZeroFPR)
+ * \version version 0.1
+ * \ingroup FBSolver-group
+ *
+ * ZeroFPR extends FBSplitting by combining the forward-backward step with
+ * L-BFGS directions for the fixed-point residual 
+ * \f$R_{\gamma}(x) = x - T_{\gamma}(x)\f$, where 
+ * \f$T_{\gamma}(x) = \mathrm{prox}_{\gamma g}(x - \gamma \nabla f(x))\f$.
+ * Every iteration consists of the following steps:
+ *
+ * 1. \f$\bar{x}_k = T_{\gamma}(x_k)\f$,
+ * 2. \f$d_k = -H_k R_{\gamma}(\bar{x}_k)\f$, where \f$H_k\f$ is the L-BFGS 
+ *    operator which is computed by LBFGSBuffer::update,
+ * 3. \f$x_{k+1} = \bar{x}_k + \tau_k d_k\f$, where \f$\tau_k\f$ is the 
+ *    largest among \f$1, 1/2, 1/4, \ldots\f$ such that the forward-backward
+ *    envelope decreases sufficiently, that is
+ *    \f[
+ *     \varphi_{\gamma}(x_{k+1}) \leq \varphi_{\gamma}(x_k) 
+ *       - \frac{\sigma}{\gamma} \|R_{\gamma}(x_k)\|^2,
+ *    \f]
+ *    or \f$\tau_k=0\f$ if no such step is found after a few trials,
+ * 4. the pair \f$s_k = x_{k+1} - \bar{x}_k\f$, 
+ *    \f$y_k = R_{\gamma}(x_{k+1}) - R_{\gamma}(\bar{x}_k)\f$ is pushed into 
+ *    the L-BFGS buffer (provided that \f$\langle s_k, y_k\rangle > 0\f$).
+ *
+ * The trial values \f$\varphi_{\gamma}(\bar{x}_k + \tau d_k)\f$ are computed
+ * with FBCache::extrapolate_fbe, so the products \f$L_1 d_k\f$ and 
+ * \f$L_2 d_k\f$ are computed once per iteration and not once per trial 
+ * step, and \f$f_1\f$ is never re-evaluated. All vectors used by the algorithm are allocated upon 
+ * construction.
+ *
+ * The step-size \f$\gamma\f$ should be smaller than \f$1/L_f\f$, where 
+ * \f$L_f\f$ is the Lipschitz constant of \f$\nabla f\f$; alternatively, the
+ * adaptive step-size mode of FBSplitting (see FBSplitting::setAdaptiveStepsize)
+ * can be used; the L-BFGS memory is then cleared whenever the step-size is
+ * reduced, since the stored pairs refer to the residual of the previous
+ * step-size. The same stopping criteria (FBStopping) as in FBSplitting 
+ * apply.
+ *
+ * For details see A. Themelis, L. Stella and P. Patrinos, <em>Forward-backward
+ * envelope for the sum of two nonconvex functions: Further properties and 
+ * nonmonotone line-search algorithms</em>, arXiv:1606.06256, 2016.
+ */
+class ZeroFPR : public FBSplitting {
+private:
+
+    LBFGSBuffer * m_lbfgs; /**< L-BFGS buffer */
+    Matrix * m_xbar; /**< forward-backward step at the current iterate */
+    Matrix * m_rbar; /**< fixed-point residual at #m_xbar */
+    Matrix * m_direction; /**< L-BFGS direction */
+    Matrix * m_s; /**< workspace for the difference s */
+    Matrix * m_y; /**< workspace for the difference y */
+    bool m_has_previous; /**< whether m_xbar and m_rbar hold a previous iterate */
+
+    void allocate_workspace(Matrix & x0, size_t mem);
+
+    /*
+     * ZeroFPR objects own their workspace and cannot be copied.
+     */
+    ZeroFPR(const ZeroFPR& orig);
+    ZeroFPR& operator=(const ZeroFPR& right);
+
+protected:
+
+    /**
+     * Clears the L-BFGS memory and the previous forward-backward step.
+     */
+    virtual void resetState();
+
+public:
+
+    virtual int iterate();
+
+    /**
+     * Initialize a ZeroFPR object. By default, the maximum number of
+     * iterations is set to \c 1000, the tolerance on the fixed-point
+     * residual is set to \c 1e-6 and the L-BFGS memory is set to \c 5.
+     *
+     * @param prob reference to the FBProblem to solve
+     * @param x0 reference to Matrix, the starting point for the solver
+     * @param gamma the initial stepsize parameter for the operations
+     */
+    ZeroFPR(FBProblem & prob, Matrix & x0, double gamma);
+
+    /**
+     * Initialize a ZeroFPR object. By default, the maximum number of
+     * iterations is set to \c 1000 and the L-BFGS memory is set to \c 5.
+     *
+     * @param prob reference to the FBProblem to solve
+     * @param x0 reference to Matrix, the starting point for the solver
+     * @param gamma the initial stepsize parameter for the operations
+     * @param sc reference to the FBStopping to be used as stopping criterion
+     */
+    ZeroFPR(FBProblem & prob, Matrix & x0, double gamma, FBStopping & sc);
+
+    /**
+     * Initialize a ZeroFPR object. By default, the tolerance on the 
+     * fixed-point residual is set to \c 1e-6 and the L-BFGS memory is set 
+     * to \c 5.
+     *
+     * @param prob reference to the FBProblem to solve
+     * @param x0 reference to Matrix, the starting point for the solver
+     * @param gamma the initial stepsize parameter for the operations
+     * @param maxit maximum number of iterations
+     */
+    ZeroFPR(FBProblem & prob, Matrix & x0, double gamma, int maxit);
+
+    /**
+     * Initialize a ZeroFPR object.
+     *
+     * @param prob reference to the FBProblem to solve
+     * @param x0 reference to Matrix, the starting point for the solver
+     * @param gamma the initial stepsize parameter for the operations
+     * @param sc reference to the FBStopping to be used as stopping criterion
+     * @param maxit maximum number of iterations
+     * @param mem memory of the L-BFGS buffer
+     */
+    ZeroFPR(FBProblem & prob, Matrix & x0, double gamma, FBStopping & sc, int maxit, size_t mem = 5);
+
+    virtual ~ZeroFPR();
+
+};
+
+#endif /* ZEROFPR_H */
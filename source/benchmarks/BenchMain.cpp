@@ -0,0 +1,55 @@
+/*
+ * File:   BenchMain.cpp
+ *
+ * ForBES is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ForBES is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with ForBES. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Runs the benchmarks of libforbes and prints the results in CSV format.
+ *
+ * Usage: bench [filter] [--min-time=<seconds>] [--threads=<num>]
+ *
+ * Only the benchmarks whose name contains `filter` are executed.
+ */
+
+#include "Benchmark.h"
+#include "ForBES.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+int main(int argc, char** argv) {
+    for (int i = 1; i < argc; i++) {
+        if (std::strncmp(argv[i], "--min-time=", 11) == 0) {
+            Benchmark::setMinTime(std::atof(argv[i] + 11));
+        } else if (std::strncmp(argv[i], "--threads=", 10) == 0) {
+            Matrix::set_num_threads(std::atoi(argv[i] + 10));
+        } else if (std::strcmp(argv[i], "--help") == 0) {
+            std::cerr << "Usage: " << argv[0] << " [filter] [--min-time=<seconds>] [--threads=<num>]" << std::endl;
+            return EXIT_SUCCESS;
+        } else {
+            Benchmark::setFilter(argv[i]);
+        }
+    }
+
+    std::srand(static_cast<unsigned long> (1433291l));
+    Benchmark::printHeader();
+    bench_matrix();
+    bench_operators();
+    bench_prox();
+    bench_lbfgs();
+    bench_solvers();
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,149 @@
+/*
+ * File:   BenchMatrix.cpp
+ *
+ * ForBES is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ForBES is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with ForBES. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Benchmark.h"
+#include "ForBES.h"
+
+#include <sstream>
+#include <stdexcept>
+
+#define BENCH_MATRIX_N 200
+#define BENCH_MATRIX_DENSITY 0.05
+
+static const char * type_name(Matrix::MatrixType type) {
+    switch (type) {
+        case Matrix::MATRIX_DENSE: return "dense";
+        case Matrix::MATRIX_SPARSE: return "sparse";
+        case Matrix::MATRIX_DIAGONAL: return "diagonal";
+        case Matrix::MATRIX_LOWERTR: return "lowertr";
+        case Matrix::MATRIX_SYMMETRIC: return "symmetric";
+        default: return "unknown";
+    }
+}
+
+/*
+ * Random n-by-k matrix of the given type; `stored` is the number of stored
+ * entries and `entries` is the number of nonzero entries of the matrix.
+ */
+static Matrix make_matrix(size_t n, size_t k, Matrix::MatrixType type, double& stored, double& entries) {
+    size_t nnz;
+    switch (type) {
+        case Matrix::MATRIX_SPARSE:
+            nnz = static_cast<size_t> (BENCH_MATRIX_DENSITY * n * k);
+            stored = entries = nnz;
+            /* 
+             * the values and the row and column indices are stored as 
+             * doubles and ints respectively
+             */
+            stored *= 2.0;
+            return MatrixFactory::MakeRandomSparse(n, k, nnz, -1.0, 2.0);
+        case Matrix::MATRIX_DIAGONAL:
+            stored = entries = n;
+            break;
+        case Matrix::MATRIX_LOWERTR:
+            stored = entries = n * (n + 1.0) / 2.0;
+            break;
+        case Matrix::MATRIX_SYMMETRIC:
+            stored = n * (n + 1.0) / 2.0;
+            entries = n * n;
+            break;
+        default:
+            stored = entries = n * k;
+            break;
+    }
+    return MatrixFactory::MakeRandomMatrix(n, k, -1.0, 2.0, type);
+}
+
+static void bench_mult(Matrix::MatrixType type_A, Matrix::MatrixType type_B, bool vector) {
+    const size_t n = BENCH_MATRIX_N;
+    const size_t k = vector ? 1 : n;
+    std::ostringstream name;
+    name << "matrix/mult/" << type_name(type_A) << "*" << (vector ? "vector" : type_name(type_B))
+            << "/n=" << n;
+    if (!Benchmark::isEnabled(name.str())) return;
+
+    double stored_A, entries_A, stored_B, entries_B;
+    Matrix A = make_matrix(n, n, type_A, stored_A, entries_A);
+    Matrix B = make_matrix(n, k, type_B, stored_B, entries_B);
+    Matrix C(n, k);
+    try {
+        int status = Matrix::mult(C, 1.0, A, B, 0.0);
+        if (ForBESUtils::is_status_error(status)) {
+            /* e.g., sparse * sparse requires a sparse C */
+            C = A * B;
+            status = Matrix::mult(C, 1.0, A, B, 0.0);
+        }
+        if (ForBESUtils::is_status_error(status)) {
+            Benchmark::skip(name.str(), "unsupported combination");
+            return;
+        }
+    } catch (std::exception& e) {
+        Benchmark::skip(name.str(), e.what());
+        return;
+    }
+
+    /* every nonzero of A meets (on average) entries_B / n nonzeros of B */
+    double flops = 2.0 * entries_A * entries_B / n;
+    double bytes = sizeof (double) * (stored_A + stored_B + 2.0 * n * k);
+    for (Benchmark b(name.str(), flops, bytes); b.keepRunning();) {
+        Matrix::mult(C, 1.0, A, B, 0.0);
+    }
+}
+
+static void bench_add(Matrix::MatrixType type) {
+    const size_t n = BENCH_MATRIX_N;
+    std::ostringstream name;
+    name << "matrix/add/" << type_name(type) << "/n=" << n;
+    if (!Benchmark::isEnabled(name.str())) return;
+
+    double stored, entries;
+    Matrix A = make_matrix(n, n, type, stored, entries);
+    Matrix C = make_matrix(n, n, type, stored, entries);
+    try {
+        int status = Matrix::add(C, 1.0, A, 1.0);
+        if (ForBESUtils::is_status_error(status)) {
+            Benchmark::skip(name.str(), "unsupported type");
+            return;
+        }
+    } catch (std::exception& e) {
+        Benchmark::skip(name.str(), e.what());
+        return;
+    }
+    for (Benchmark b(name.str(), 2.0 * entries, 3.0 * sizeof (double) * stored); b.keepRunning();) {
+        Matrix::add(C, 1.0, A, 1.0);
+    }
+}
+
+void bench_matrix() {
+    const Matrix::MatrixType types[] = {
+        Matrix::MATRIX_DENSE,
+        Matrix::MATRIX_SPARSE,
+        Matrix::MATRIX_DIAGONAL,
+        Matrix::MATRIX_LOWERTR,
+        Matrix::MATRIX_SYMMETRIC
+    };
+    const size_t num_types = sizeof (types) / sizeof (types[0]);
+    for (size_t i = 0; i < num_types; i++) {
+        bench_mult(types[i], Matrix::MATRIX_DENSE, true);
+        for (size_t j = 0; j < num_types; j++) {
+            bench_mult(types[i], types[j], false);
+        }
+    }
+    for (size_t i = 0; i < num_types; i++) {
+        bench_add(types[i]);
+    }
+}
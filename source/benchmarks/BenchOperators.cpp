@@ -0,0 +1,92 @@
+/*
+ * File:   BenchOperators.cpp
+ *
+ * ForBES is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ForBES is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with ForBES. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Benchmark.h"
+#include "ForBES.h"
+
+#include <sstream>
+
+/*
+ * Benchmarks y = A(x) and x = A*(y) for the given operator; flops and bytes
+ * refer to a single application of the operator.
+ */
+static void bench_apply(const std::string& name, LinearOperator& op, double flops, double bytes) {
+    std::pair<size_t, size_t> dim_in = op.dimensionIn();
+    std::pair<size_t, size_t> dim_out = op.dimensionOut();
+    Matrix x = MatrixFactory::MakeRandomMatrix(dim_in.first, dim_in.second, -1.0, 2.0);
+    Matrix y = MatrixFactory::MakeRandomMatrix(dim_out.first, dim_out.second, -1.0, 2.0);
+    for (Benchmark b(name + "/call", flops, bytes); b.keepRunning();) {
+        op.call(y, 1.0, x, 0.0);
+    }
+    for (Benchmark b(name + "/callAdjoint", flops, bytes); b.keepRunning();) {
+        op.callAdjoint(x, 1.0, y, 0.0);
+    }
+}
+
+void bench_operators() {
+    {
+        const size_t n = 1000;
+        std::ostringstream name;
+        name << "operators/MatrixOperator/dense/n=" << n;
+        if (Benchmark::isEnabled(name.str())) {
+            Matrix A = MatrixFactory::MakeRandomMatrix(n, n, -1.0, 2.0);
+            MatrixOperator op(A);
+            bench_apply(name.str(), op, 2.0 * n * n, sizeof (double) * (n * n + 2.0 * n));
+        }
+    }
+    {
+        const size_t n = 2000;
+        const size_t nnz = 10 * n;
+        std::ostringstream name;
+        name << "operators/MatrixOperator/sparse/n=" << n << ",nnz=" << nnz;
+        if (Benchmark::isEnabled(name.str())) {
+            Matrix A = MatrixFactory::MakeRandomSparse(n, n, nnz, -1.0, 2.0);
+            MatrixOperator op(A);
+            /* values (double), row indices (int) and the column pointers */
+            double bytes = sizeof (double) * (nnz + 2.0 * n) + sizeof (int) * (nnz + n + 1.0);
+            bench_apply(name.str(), op, 2.0 * nnz, bytes);
+        }
+    }
+    {
+        const size_t n = 1024;
+        std::ostringstream name;
+        name << "operators/OpDCT2/fft/n=" << n;
+        if (Benchmark::isEnabled(name.str())) {
+            OpDCT2 op(n, DCTHelper::DCT_FFT);
+            /* a complex FFT of length n costs about 5 n log2(n) flops */
+            bench_apply(name.str(), op, 5.0 * n * 10.0, 2.0 * sizeof (double) * n);
+        }
+    }
+    {
+        const size_t n = 1024;
+        std::ostringstream name;
+        name << "operators/OpDCT2/direct/n=" << n;
+        if (Benchmark::isEnabled(name.str())) {
+            OpDCT2 op(n, DCTHelper::DCT_DIRECT);
+            bench_apply(name.str(), op, 2.0 * n * n, 2.0 * sizeof (double) * n);
+        }
+    }
+    {
+        const size_t n = 1000000;
+        std::ostringstream name;
+        name << "operators/OpGradient/n=" << n;
+        if (Benchmark::isEnabled(name.str())) {
+            OpGradient op(n);
+            bench_apply(name.str(), op, 2.0 * n, 2.0 * sizeof (double) * n);
+        }
+    }
+}
@@ -0,0 +1,112 @@
+/*
+ * File:   BenchProx.cpp
+ *
+ * ForBES is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ForBES is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with ForBES. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Benchmark.h"
+#include "ForBES.h"
+#include "IndProbSimplex.h"
+
+#include <map>
+#include <sstream>
+#include <vector>
+
+#define BENCH_PROX_N 100000
+#define BENCH_PROX_GAMMA 0.5
+
+/*
+ * Benchmarks prox = prox_{gamma f}(x); every iteration reads x and writes prox.
+ */
+static void bench_prox(const std::string& function, Function& f, size_t n) {
+    std::ostringstream name;
+    name << "prox/" << function << "/n=" << n;
+    Matrix x = MatrixFactory::MakeRandomMatrix(n, 1, -1.0, 2.0);
+    Matrix prox(n, 1);
+    int status = f.callProx(x, BENCH_PROX_GAMMA, prox);
+    if (ForBESUtils::is_status_error(status)) {
+        Benchmark::skip(name.str(), "callProx failed");
+        return;
+    }
+    for (Benchmark b(name.str(), -1.0, 2.0 * sizeof (double) * n); b.keepRunning();) {
+        f.callProx(x, BENCH_PROX_GAMMA, prox);
+    }
+}
+
+void bench_prox() {
+    const size_t n = BENCH_PROX_N;
+
+    double lb = -0.5;
+    double ub = 0.5;
+    IndBox ind_box(lb, ub);
+    bench_prox("IndBox", ind_box, n);
+
+    IndPos ind_pos;
+    bench_prox("IndPos", ind_pos, n);
+
+    IndSOC ind_soc(n);
+    bench_prox("IndSOC", ind_soc, n);
+
+    IndProbSimplex ind_simplex;
+    bench_prox("IndProbSimplex", ind_simplex, n);
+
+    IndBall2 ind_ball2(1.0);
+    bench_prox("IndBall2", ind_ball2, n);
+
+    Norm1 norm1(0.1);
+    bench_prox("Norm1", norm1, n);
+
+    Norm2 norm2(0.1);
+    bench_prox("Norm2", norm2, n);
+
+    SumOfNorm2 sum_of_norm2(0.1, 10);
+    bench_prox("SumOfNorm2", sum_of_norm2, n);
+
+    ElasticNet elastic_net(0.1, 0.1);
+    bench_prox("ElasticNet", elastic_net, n);
+
+    Matrix b = MatrixFactory::MakeRandomMatrix(n, 1, -1.0, 2.0);
+    HingeLoss hinge(b, 1.0);
+    bench_prox("HingeLoss", hinge, n);
+
+    ConjugateFunction conj_norm1(norm1);
+    bench_prox("ConjugateFunction(Norm1)", conj_norm1, n);
+
+    /* Norm1 on the first half of x and IndBox on the second half */
+    std::vector<size_t> idx_first;
+    std::vector<size_t> idx_second;
+    for (size_t i = 0; i < n / 2; i++) {
+        idx_first.push_back(i);
+        idx_second.push_back(n / 2 + i);
+    }
+    std::map<Function*, std::vector<size_t>*> fun_idx_map;
+    fun_idx_map[&norm1] = &idx_first;
+    fun_idx_map[&ind_box] = &idx_second;
+    SeparableSum separable_sum(fun_idx_map);
+    bench_prox("SeparableSum(Norm1,IndBox)", separable_sum, n);
+
+    /* the proximal operator of a quadratic requires a (cached) factorization */
+    const size_t n_quad = 500;
+    Matrix Q = MatrixFactory::MakeRandomMatrix(n_quad, n_quad, -1.0, 2.0);
+    for (size_t i = 0; i < n_quad; i++) {
+        /* symmetric and diagonally dominant */
+        for (size_t j = 0; j < i; j++) {
+            Q.set(i, j, Q.get(j, i));
+        }
+        Q.set(i, i, Q.get(i, i) + n_quad);
+    }
+    Matrix q = MatrixFactory::MakeRandomMatrix(n_quad, 1, -1.0, 2.0);
+    Quadratic quadratic(Q, q);
+    bench_prox("Quadratic/dense", quadratic, n_quad);
+}
@@ -0,0 +1,131 @@
+/*
+ * File:   BenchSolvers.cpp
+ *
+ * ForBES is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ForBES is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with ForBES. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Benchmark.h"
+#include "ForBES.h"
+
+#include <cmath>
+#include <sstream>
+
+void bench_lbfgs() {
+    const size_t n = 1000000;
+    const size_t mem = 10;
+    const bool compact[] = {false, true};
+    for (size_t c = 0; c < 2; c++) {
+        std::ostringstream name;
+        name << "lbfgs/update/" << (compact[c] ? "compact" : "two-loop")
+                << "/n=" << n << ",mem=" << mem;
+        if (!Benchmark::isEnabled(name.str())) continue;
+        LBFGSBuffer buffer(n, mem, compact[c]);
+        Matrix s = MatrixFactory::MakeRandomMatrix(n, 1, -1.0, 2.0);
+        Matrix y(n, 1);
+        for (size_t k = 0; k < mem; k++) {
+            /* pairs with positive curvature */
+            y = s;
+            y *= 1.0 + k;
+            buffer.push(&s, &y);
+        }
+        Matrix q = MatrixFactory::MakeRandomMatrix(n, 1, -1.0, 2.0);
+        Matrix r(n, 1);
+        double H0 = buffer.hessian_estimate();
+        /* four passes over mem vectors of length n (2 flops per entry each) */
+        double flops = 8.0 * mem * n;
+        double bytes = sizeof (double) * (4.0 * mem * n + 2.0 * n);
+        for (Benchmark b(name.str(), flops, bytes); b.keepRunning();) {
+            buffer.update(&q, &r, H0);
+        }
+    }
+}
+
+/*
+ * Solves a lasso problem (n variables, m observations) and reports the time 
+ * per solve and the number of iterations (to the standard error).
+ */
+template<typename Solver>
+static void bench_lasso(const std::string& solver_name, size_t m, size_t n) {
+    std::ostringstream name;
+    name << "solvers/" << solver_name << "/lasso/m=" << m << ",n=" << n;
+    if (!Benchmark::isEnabled(name.str())) return;
+
+    std::srand(static_cast<unsigned long> (1234567l));
+    Matrix A = MatrixFactory::MakeRandomMatrix(m, n, -1.0, 2.0);
+    Matrix minusb = MatrixFactory::MakeRandomMatrix(m, 1, -1.0, 2.0);
+    QuadraticLoss f;
+    MatrixOperator OpA(A);
+    Norm1 g(1.0);
+    FBProblem prob(f, OpA, minusb, g);
+    FBStoppingRelative sc(1e-6);
+    /* 1/L with L = ||A||^2 <= ||A||_F^2 */
+    double gamma = 1.0 / std::pow(A.norm_fro(), 2);
+    const int maxit = 5000;
+
+    size_t it = 0;
+    for (Benchmark b(name.str(), -1.0, 0.0); b.keepRunning();) {
+        Matrix x0(n, 1);
+        Solver solver(prob, x0, gamma, sc, maxit);
+        solver.run();
+        it = solver.getIt();
+    }
+    std::cerr << name.str() << ": " << it << " iterations" << std::endl;
+}
+
+/*
+ * Solves a box-constrained QP with n variables.
+ */
+template<typename Solver>
+static void bench_box_qp(const std::string& solver_name, size_t n) {
+    std::ostringstream name;
+    name << "solvers/" << solver_name << "/boxqp/n=" << n;
+    if (!Benchmark::isEnabled(name.str())) return;
+
+    std::srand(static_cast<unsigned long> (7654321l));
+    Matrix Q = MatrixFactory::MakeRandomMatrix(n, n, -1.0, 2.0);
+    for (size_t i = 0; i < n; i++) {
+        /* symmetric and diagonally dominant */
+        for (size_t j = 0; j < i; j++) {
+            Q.set(i, j, Q.get(j, i));
+        }
+        Q.set(i, i, Q.get(i, i) + n);
+    }
+    Matrix q = MatrixFactory::MakeRandomMatrix(n, 1, -1.0 * n, 2.0 * n);
+    Quadratic f(Q, q);
+    double lb = -1.0;
+    double ub = 1.0;
+    IndBox g(lb, ub);
+    FBProblem prob(f, g);
+    FBStoppingRelative sc(1e-6);
+    double gamma = 0.5 / n;
+    const int maxit = 5000;
+
+    size_t it = 0;
+    for (Benchmark b(name.str(), -1.0, 0.0); b.keepRunning();) {
+        Matrix x0(n, 1);
+        Solver solver(prob, x0, gamma, sc, maxit);
+        solver.run();
+        it = solver.getIt();
+    }
+    std::cerr << name.str() << ": " << it << " iterations" << std::endl;
+}
+
+void bench_solvers() {
+    bench_lasso<FBSplitting>("FBSplitting", 100, 500);
+    bench_lasso<FBSplittingFast>("FBSplittingFast", 100, 500);
+    bench_lasso<ZeroFPR>("ZeroFPR", 100, 500);
+    bench_box_qp<FBSplitting>("FBSplitting", 200);
+    bench_box_qp<FBSplittingFast>("FBSplittingFast", 200);
+    bench_box_qp<ZeroFPR>("ZeroFPR", 200);
+}
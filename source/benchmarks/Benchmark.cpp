@@ -0,0 +1,93 @@
+/*
+ * File:   Benchmark.cpp
+ *
+ * ForBES is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ForBES is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with ForBES. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Benchmark.h"
+
+#include <iostream>
+#include <sys/time.h>
+
+double Benchmark::ms_min_time = 0.2;
+std::string Benchmark::ms_filter = "";
+
+Benchmark::Benchmark(const std::string& name, double flops_per_op, double bytes_per_op) :
+m_name(name), m_flops_per_op(flops_per_op), m_bytes_per_op(bytes_per_op) {
+    m_enabled = isEnabled(name);
+    m_iterations = 0;
+    m_next_check = 1;
+    m_start = wallTime();
+}
+
+Benchmark::~Benchmark() {
+}
+
+bool Benchmark::keepRunning() {
+    if (!m_enabled) return false;
+    if (m_iterations < m_next_check) {
+        m_iterations++;
+        return true;
+    }
+    /* the clock is read after 1, 2, 4, 8, ... iterations */
+    double elapsed = wallTime() - m_start;
+    if (elapsed < ms_min_time) {
+        m_next_check *= 2;
+        m_iterations++;
+        return true;
+    }
+    report(elapsed);
+    m_enabled = false;
+    return false;
+}
+
+void Benchmark::report(double elapsed) {
+    double ns_per_op = 1e9 * elapsed / m_iterations;
+    std::cout << m_name << "," << m_iterations << "," << ns_per_op << ",";
+    if (m_flops_per_op >= 0.0) {
+        std::cout << m_flops_per_op / ns_per_op;
+    }
+    std::cout << "," << m_bytes_per_op << std::endl;
+}
+
+bool Benchmark::isEnabled(const std::string& name) {
+    /* the filter may also be more specific than name (e.g., a group of benchmarks) */
+    return ms_filter.empty()
+            || name.find(ms_filter) != std::string::npos
+            || ms_filter.compare(0, name.size(), name) == 0;
+}
+
+void Benchmark::skip(const std::string& name, const std::string& reason) {
+    if (isEnabled(name)) {
+        std::cerr << "skipped " << name << ": " << reason << std::endl;
+    }
+}
+
+void Benchmark::setMinTime(double seconds) {
+    ms_min_time = seconds;
+}
+
+void Benchmark::setFilter(const std::string& filter) {
+    ms_filter = filter;
+}
+
+void Benchmark::printHeader() {
+    std::cout << "benchmark,iterations,ns_per_op,gflops,bytes_per_op" << std::endl;
+}
+
+double Benchmark::wallTime() {
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return static_cast<double> (tv.tv_sec) + 1e-6 * static_cast<double> (tv.tv_usec);
+}
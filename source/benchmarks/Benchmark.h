@@ -0,0 +1,149 @@
+/*
+ * File:   Benchmark.h
+ *
+ * ForBES is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ForBES is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with ForBES. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <string>
+#include <cstddef>
+
+/**
+ * \class Benchmark
+ * \brief Timing loop of a single benchmark
+ * \version version 0.1
+ *
+ * A Benchmark object times the body of a loop of the form
+ *
+ * \code{.cpp}
+ * for (Benchmark b("matrix/mult/dense*dense/n=200", flops, bytes); b.keepRunning();) {
+ *     Matrix::mult(C, 1.0, A, B, 0.0);
+ * }
+ * \endcode
+ *
+ * The body is repeated (in batches of geometrically increasing size) until 
+ * it has run for at least #setMinTime seconds. When the loop terminates, one
+ * CSV line is written to the standard output with the columns
+ *
+ * <code>benchmark,iterations,ns_per_op,gflops,bytes_per_op</code>
+ *
+ * where <code>gflops</code> is computed from the number of floating-point 
+ * operations per iteration given upon construction (the column is left empty 
+ * if this is not known) and <code>bytes_per_op</code> is the (estimated) 
+ * number of bytes that are read and written in each iteration.
+ *
+ * Benchmarks whose name does not contain the filter set with #setFilter are 
+ * not executed; #isEnabled can be used to skip the preparation of the data of
+ * a group of benchmarks as well.
+ */
+class Benchmark {
+public:
+
+    /**
+     * Starts a new benchmark.
+     * 
+     * @param name name of the benchmark; by convention, this is of the form
+     * <code>category/operation/variant</code>
+     * @param flops_per_op number of floating-point operations per iteration, or
+     * a negative number if not known
+     * @param bytes_per_op number of bytes read and written per iteration
+     */
+    Benchmark(const std::string& name, double flops_per_op, double bytes_per_op);
+
+    virtual ~Benchmark();
+
+    /**
+     * Whether the body of the timing loop should be executed once more. Once 
+     * this returns \c false, the results have been reported.
+     * 
+     * @return \c true to continue iterating
+     */
+    bool keepRunning();
+
+    /**
+     * Whether a benchmark with the given name will be executed.
+     * 
+     * @param name name of the benchmark, or a prefix of the names of a group
+     * of benchmarks
+     * @return \c true if the name contains the filter or the filter starts 
+     * with the name
+     */
+    static bool isEnabled(const std::string& name);
+
+    /**
+     * Reports (to the standard error) that a benchmark has been skipped, e.g., 
+     * because the operation is not supported.
+     * 
+     * @param name name of the benchmark
+     * @param reason reason
+     */
+    static void skip(const std::string& name, const std::string& reason);
+
+    /**
+     * Sets the minimum running time of every benchmark.
+     * 
+     * @param seconds minimum running time in seconds (default: 0.2)
+     */
+    static void setMinTime(double seconds);
+
+    /**
+     * Only the benchmarks whose name contains \c filter will be executed.
+     * 
+     * @param filter filter (default: empty)
+     */
+    static void setFilter(const std::string& filter);
+
+    /**
+     * Prints the CSV header to the standard output.
+     */
+    static void printHeader();
+
+    /**
+     * Current wall-clock time.
+     * 
+     * @return time in seconds
+     */
+    static double wallTime();
+
+private:
+
+    Benchmark(const Benchmark& orig);
+    Benchmark& operator=(const Benchmark& right);
+
+    void report(double elapsed);
+
+    std::string m_name;
+    double m_flops_per_op;
+    double m_bytes_per_op;
+    bool m_enabled;
+    size_t m_iterations; /**< iterations executed so far */
+    size_t m_next_check; /**< iteration at which the clock is read next */
+    double m_start; /**< start time */
+
+    static double ms_min_time;
+    static std::string ms_filter;
+};
+
+/*
+ * Benchmark suites; each is defined in a separate file.
+ */
+void bench_matrix();
+void bench_operators();
+void bench_prox();
+void bench_lbfgs();
+void bench_solvers();
+
+#endif /* BENCHMARK_H */
@@ -0,0 +1,167 @@
+/*
+ * File:   TestBlockCGSolver.cpp
+ *
+ * ForBES is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *  
+ * ForBES is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with ForBES. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "TestBlockCGSolver.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TestBlockCGSolver);
+
+TestBlockCGSolver::TestBlockCGSolver() {
+}
+
+TestBlockCGSolver::~TestBlockCGSolver() {
+}
+
+void TestBlockCGSolver::setUp() {
+}
+
+void TestBlockCGSolver::tearDown() {
+}
+
+/* symmetric positive definite n-by-n matrix */
+static Matrix spd_matrix(size_t n) {
+    Matrix A = MatrixFactory::MakeRandomMatrix(n, n, 0.0, 1.0, Matrix::MATRIX_SYMMETRIC);
+    Matrix Y = MatrixFactory::MakeIdentity(n, 0.5 * n);
+    A += Y;
+    return A;
+}
+
+/* checks that AX = B column-wise */
+static void check_block_solution(Matrix& A, Matrix& X, Matrix& B, double tol) {
+    Matrix AX = A * X;
+    for (size_t j = 0; j < B.getNcols(); j++) {
+        for (size_t i = 0; i < B.getNrows(); i++) {
+            _ASSERT_NUM_EQ(B.get(i, j), AX.get(i, j), tol);
+        }
+    }
+}
+
+void TestBlockCGSolver::testSolve() {
+    const size_t n = 120;
+    const size_t s = 6;
+    Matrix A = spd_matrix(n);
+    MatrixOperator Aop(A);
+    Matrix B = MatrixFactory::MakeRandomMatrix(n, s, -1.0, 2.0);
+    BlockCGSolver solver(Aop);
+    Matrix X;
+    _ASSERT_EQ(ForBESUtils::STATUS_OK, solver.solve(B, X));
+    _ASSERT_EQ(n, X.getNrows());
+    _ASSERT_EQ(s, X.getNcols());
+    _ASSERT(solver.last_error() < 1e-4);
+    check_block_solution(A, X, B, 1e-4);
+    for (size_t j = 0; j < s; j++) {
+        _ASSERT(solver.last_error(j) < 1e-4);
+        _ASSERT(solver.last_num_iter(j) > 0);
+        _ASSERT(solver.last_num_iter(j) <= solver.last_num_iter());
+    }
+
+    /* never more iterations than CG on the hardest column */
+    size_t max_cg_iter = 0;
+    for (size_t j = 0; j < s; j++) {
+        Matrix b(n, 1);
+        for (size_t i = 0; i < n; i++) b[i] = B.get(i, j);
+        CGSolver cg(Aop);
+        Matrix x(n, 1);
+        _ASSERT_EQ(ForBESUtils::STATUS_OK, cg.solve(b, x));
+        if (cg.last_num_iter() > max_cg_iter) max_cg_iter = cg.last_num_iter();
+    }
+    _ASSERT(solver.last_num_iter() <= max_cg_iter + 1);
+}
+
+void TestBlockCGSolver::testSolvePreconditioned() {
+    const size_t n = 150;
+    const size_t s = 4;
+    const double tolerance = 1e-10;
+    Matrix A = spd_matrix(n);
+    Matrix ID(n, n, Matrix::MATRIX_DIAGONAL);
+    for (size_t j = 0; j < n; ++j) {
+        ID.set(j, j, 1 / A.get(j, j));
+    }
+    MatrixOperator Aop(A);
+    MatrixOperator M(ID);
+    Matrix B = MatrixFactory::MakeRandomMatrix(n, s, -1.0, 2.0);
+    BlockCGSolver solver(Aop, M, tolerance, n);
+    Matrix X;
+    _ASSERT_EQ(ForBESUtils::STATUS_OK, solver.solve(B, X));
+    _ASSERT(solver.last_error() < tolerance);
+    check_block_solution(A, X, B, 1e-8);
+}
+
+void TestBlockCGSolver::testWarmStart() {
+    const size_t n = 60;
+    const size_t s = 3;
+    const double tolerance = 1e-9;
+    Matrix A = spd_matrix(n);
+    Matrix Eye = MatrixFactory::MakeIdentity(n, 1.0);
+    MatrixOperator Aop(A);
+    MatrixOperator M(Eye);
+    Matrix B = MatrixFactory::MakeRandomMatrix(n, s, -1.0, 2.0);
+    BlockCGSolver solver(Aop, M, tolerance, n);
+    Matrix X;
+    _ASSERT_EQ(ForBESUtils::STATUS_OK, solver.solve(B, X));
+    /* the solution is a fixed point */
+    _ASSERT_EQ(ForBESUtils::STATUS_OK, solver.solve(B, X));
+    _ASSERT_EQ(static_cast<size_t> (0), solver.last_num_iter());
+
+    /* one column is already solved; the others start from zero */
+    for (size_t i = 0; i < n; i++) {
+        X.set(i, 0, 0.0);
+        X.set(i, 2, 0.0);
+    }
+    _ASSERT_EQ(ForBESUtils::STATUS_OK, solver.solve(B, X));
+    _ASSERT_EQ(static_cast<size_t> (0), solver.last_num_iter(1));
+    _ASSERT(solver.last_num_iter(0) > 0);
+    check_block_solution(A, X, B, 1e-7);
+}
+
+void TestBlockCGSolver::testMaxIterations() {
+    const size_t n = 100;
+    const size_t s = 3;
+    Matrix A = spd_matrix(n);
+    Matrix Eye = MatrixFactory::MakeIdentity(n, 1.0);
+    MatrixOperator Aop(A);
+    MatrixOperator M(Eye);
+    Matrix B = MatrixFactory::MakeRandomMatrix(n, s, -1.0, 2.0);
+    BlockCGSolver solver(Aop, M, 1e-14, 2);
+    Matrix X;
+    _ASSERT_EQ(ForBESUtils::STATUS_MAX_ITERATIONS_REACHED, solver.solve(B, X));
+    _ASSERT_EQ(static_cast<size_t> (2), solver.last_num_iter());
+}
+
+void TestBlockCGSolver::testRepeatedSolves() {
+    /* the work matrices are reused by solves with fewer or more columns */
+    const size_t n = 80;
+    const size_t sizes[4] = {5, 2, 5, 1};
+    const double tolerance = 1e-10;
+    Matrix A = spd_matrix(n);
+    Matrix ID(n, n, Matrix::MATRIX_DIAGONAL);
+    for (size_t j = 0; j < n; ++j) {
+        ID.set(j, j, 1 / A.get(j, j));
+    }
+    MatrixOperator Aop(A);
+    MatrixOperator M(ID);
+    BlockCGSolver solver(Aop, M, tolerance, n);
+    for (size_t t = 0; t < 4; t++) {
+        Matrix B = MatrixFactory::MakeRandomMatrix(n, sizes[t], -1.0, 2.0);
+        /* a converged column is deflated right away */
+        for (size_t i = 0; i < n; i++) B.set(i, 0, 0.0);
+        Matrix X;
+        _ASSERT_EQ(ForBESUtils::STATUS_OK, solver.solve(B, X));
+        _ASSERT_EQ(sizes[t], X.getNcols());
+        _ASSERT(solver.last_error() < tolerance);
+        check_block_solution(A, X, B, 1e-8);
+    }
+}
@@ -89,3 +89,117 @@ void TestCGSolver::testSolveNoPredcond() {
     _ASSERT(solver.last_error() < default_tolerance);
 }
 
+/* symmetric positive definite n-by-n matrix */
+static Matrix cg_test_matrix(size_t n) {
+    Matrix A = MatrixFactory::MakeRandomMatrix(n, n, 0.0, 1.0, Matrix::MATRIX_SYMMETRIC);
+    Matrix Y = MatrixFactory::MakeIdentity(n, 0.5 * n);
+    A += Y;
+    return A;
+}
+
+void TestCGSolver::testSolveWarmStart() {
+    size_t n = 200;
+    const double tolerance = 1e-8;
+    Matrix A = cg_test_matrix(n);
+    MatrixOperator Aop(A);
+    Matrix b = MatrixFactory::MakeRandomMatrix(n, 1, 0.0, 1.0);
+    Matrix b2 = MatrixFactory::MakeRandomMatrix(n, 1, 0.0, 1.0);
+
+    CGSolver solver(Aop);
+    Matrix sol(n, 1);
+    _ASSERT_EQ(ForBESUtils::STATUS_OK, solver.solve(b, sol, tolerance, sol));
+    size_t iter_cold = solver.last_num_iter();
+    _ASSERT(iter_cold > 0);
+
+    /* the solution is a fixed point */
+    _ASSERT_EQ(ForBESUtils::STATUS_OK, solver.solve(b, sol, tolerance, sol));
+    _ASSERT_EQ(static_cast<size_t> (0), solver.last_num_iter());
+
+    /* a different right-hand side, starting from the previous solution */
+    _ASSERT_EQ(ForBESUtils::STATUS_OK, solver.solve(b2, sol, tolerance, sol));
+    Matrix Asol = Aop.call(sol);
+    for (size_t i = 0; i < n; i++) {
+        _ASSERT_NUM_EQ(b2[i], Asol[i], 1e-7);
+    }
+
+    /* a good guess saves iterations */
+    Matrix guess(sol);
+    for (size_t i = 0; i < n; i++) {
+        guess[i] += 1e-4;
+    }
+    _ASSERT_EQ(ForBESUtils::STATUS_OK, solver.solve(b2, sol, tolerance, guess));
+    _ASSERT(solver.last_num_iter() < iter_cold);
+    _ASSERT(solver.last_error() < tolerance);
+}
+
+void TestCGSolver::testSolveReusedBuffer() {
+    size_t n = 150;
+    const double tolerance = 1e-8;
+    Matrix A = cg_test_matrix(n);
+    MatrixOperator Aop(A);
+    Matrix b = MatrixFactory::MakeRandomMatrix(n, 1, 0.0, 1.0);
+    Matrix I = MatrixFactory::MakeIdentity(n, 1.0);
+    MatrixOperator Iop(I);
+    CGSolver solver(Aop, Iop, tolerance, 500);
+    _ASSERT_NOT(solver.isWarmStart());
+
+    Matrix sol(n, 1);
+    _ASSERT_EQ(ForBESUtils::STATUS_OK, solver.solve(b, sol));
+    size_t iter_cold = solver.last_num_iter();
+    Matrix sol_cold(sol);
+
+    /* the contents of the output buffer are ignored by default... */
+    for (size_t i = 0; i < n; i++) {
+        sol[i] = 100.0;
+    }
+    _ASSERT_EQ(ForBESUtils::STATUS_OK, solver.solve(b, sol));
+    _ASSERT_EQ(iter_cold, solver.last_num_iter());
+    _ASSERT_EQ(sol_cold, sol);
+
+    /* ...unless warm starting is enabled */
+    solver.setWarmStart(true);
+    _ASSERT(solver.isWarmStart());
+    _ASSERT_EQ(ForBESUtils::STATUS_OK, solver.solve(b, sol));
+    _ASSERT_EQ(static_cast<size_t> (0), solver.last_num_iter());
+}
+
+void TestCGSolver::testSolvePipelined() {
+    size_t n = 300;
+    const double tolerance = 1e-8;
+    Matrix A = cg_test_matrix(n);
+    Matrix ID(n, n, Matrix::MATRIX_DIAGONAL);
+    for (size_t j = 0; j < n; ++j) {
+        ID.set(j, j, 1 / A.get(j, j));
+    }
+    MatrixOperator Aop(A);
+    MatrixOperator M(ID);
+    Matrix b = MatrixFactory::MakeRandomMatrix(n, 1, 0.0, 1.0);
+
+    CGSolver solver_precond(Aop, M, tolerance, n);
+    CGSolver solver_precond_pipelined(Aop, M, tolerance, n);
+    CGSolver solver_plain(Aop);
+    CGSolver solver_plain_pipelined(Aop);
+    CGSolver * solvers[2] = {&solver_precond, &solver_plain};
+    CGSolver * solvers_pipelined[2] = {&solver_precond_pipelined, &solver_plain_pipelined};
+    for (size_t k = 0; k < 2; k++) {
+        CGSolver& solver = *solvers[k];
+        CGSolver& solver_pipelined = *solvers_pipelined[k];
+        solver_pipelined.setPipelined(true);
+        _ASSERT(solver_pipelined.isPipelined());
+        _ASSERT_NOT(solver.isPipelined());
+
+        Matrix sol(n, 1);
+        Matrix sol_pipelined(n, 1);
+        _ASSERT_EQ(ForBESUtils::STATUS_OK, solver.solve(b, sol, tolerance, sol));
+        _ASSERT_EQ(ForBESUtils::STATUS_OK, solver_pipelined.solve(b, sol_pipelined, tolerance, sol_pipelined));
+        _ASSERT(solver_pipelined.last_error() < tolerance);
+        _ASSERT(solver_pipelined.last_num_iter() > 0);
+        _ASSERT(solver_pipelined.last_num_iter() <= solver.last_num_iter() + 2);
+
+        Matrix Asol = Aop.call(sol_pipelined);
+        for (size_t i = 0; i < n; i++) {
+            _ASSERT_NUM_EQ(b[i], Asol[i], 1e-6);
+            _ASSERT_NUM_EQ(sol[i], sol_pipelined[i], 1e-7);
+        }
+    }
+}
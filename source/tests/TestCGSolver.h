@@ -20,6 +20,9 @@ class TestCGSolver : public CPPUNIT_NS::TestFixture {
     CPPUNIT_TEST(testSolve);
     CPPUNIT_TEST(testSolve2);
     CPPUNIT_TEST(testSolveNoPredcond);
+    CPPUNIT_TEST(testSolveWarmStart);
+    CPPUNIT_TEST(testSolveReusedBuffer);
+    CPPUNIT_TEST(testSolvePipelined);
 
     CPPUNIT_TEST_SUITE_END();
 
@@ -33,6 +36,9 @@ private:
     void testSolve();
     void testSolve2();
     void testSolveNoPredcond();
+    void testSolveWarmStart();
+    void testSolveReusedBuffer();
+    void testSolvePipelined();
 
 };
 
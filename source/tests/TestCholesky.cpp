@@ -168,5 +168,65 @@ void TestCholesky::testCholeskySymmetric() {
     delete cholFactorization;
 }
 
+/* checks that x solves (A + beta I) x = b */
+static void checkShiftedSolution(Matrix& A, double beta, Matrix& x, Matrix& b, double tol) {
+    Matrix r = A * x;
+    Matrix::add(r, beta, x, 1.0);
+    for (size_t i = 0; i < b.getNrows(); i++) {
+        _ASSERT_NUM_EQ(b[i], r[i], tol);
+    }
+}
 
+void TestCholesky::testRefactorize() {
+    const double tol = 1e-8;
+    const size_t n = 25;
+    const double betas[4] = {0.5, 3.0, 0.0, 10.0};
 
+    Matrix sparse = MatrixFactory::MakeSparseSymmetric(n, 2 * n - 1);
+    Matrix dense(n, n);
+    Matrix symmetric(n, n, Matrix::MATRIX_SYMMETRIC);
+    for (size_t i = 0; i < n; i++) {
+        sparse.set(i, i, n + 2.5);
+        dense.set(i, i, n + 2.5);
+        symmetric.set(i, i, n + 2.5);
+    }
+    for (size_t i = 1; i < n; i++) { /* sparse: set the LT part only */
+        sparse.set(i, i - 1, 0.5);
+        dense.set(i, i - 1, 0.5);
+        dense.set(i - 1, i, 0.5);
+        symmetric.set(i, i - 1, 0.5);
+    }
+    Matrix b = MatrixFactory::MakeRandomMatrix(n, 1, -1.0, 2.0);
+
+    Matrix * matrices[3] = {&sparse, &dense, &symmetric};
+    for (size_t q = 0; q < 3; q++) {
+        Matrix& A = *matrices[q];
+        Matrix A_full = (q == 0) ? dense : A;
+        CholeskyFactorization solver(A);
+        Matrix x;
+        _ASSERT_EQ(ForBESUtils::STATUS_OK, solver.factorize());
+        _ASSERT_EQ(0.0, solver.getShift());
+        for (size_t k = 0; k < 4; k++) {
+            _ASSERT_EQ(ForBESUtils::STATUS_OK, solver.refactorize(betas[k]));
+            _ASSERT_EQ(betas[k], solver.getShift());
+            _ASSERT_EQ(ForBESUtils::STATUS_OK, solver.solve(b, x));
+            checkShiftedSolution(A_full, betas[k], x, b, tol);
+        }
+
+        /* new values, same pattern; the shift is kept */
+        for (size_t i = 0; i < n; i++) {
+            A.set(i, i, 2.0 * n);
+            A_full.set(i, i, 2.0 * n);
+        }
+        _ASSERT_EQ(ForBESUtils::STATUS_OK, solver.refactorize());
+        _ASSERT_EQ(betas[3], solver.getShift());
+        _ASSERT_EQ(ForBESUtils::STATUS_OK, solver.solve(b, x));
+        checkShiftedSolution(A_full, betas[3], x, b, tol);
+
+        /* a full factorization resets the shift */
+        _ASSERT_EQ(ForBESUtils::STATUS_OK, solver.factorize());
+        _ASSERT_EQ(0.0, solver.getShift());
+        _ASSERT_EQ(ForBESUtils::STATUS_OK, solver.solve(b, x));
+        checkShiftedSolution(A_full, 0.0, x, b, tol);
+    }
+}
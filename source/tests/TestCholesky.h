@@ -35,6 +35,7 @@ class TestCholesky : public CPPUNIT_NS::TestFixture {
     CPPUNIT_TEST(testCholeskySymmetric);
     CPPUNIT_TEST(testCholeskySymmetric2);
     CPPUNIT_TEST(testCholeskySparse);
+    CPPUNIT_TEST(testRefactorize);
     
 
     CPPUNIT_TEST_SUITE_END();
@@ -50,6 +51,7 @@ private:
     void testCholeskySymmetric();
     void testCholeskySymmetric2();
     void testCholeskySparse();
+    void testRefactorize();
     
 };
 
@@ -0,0 +1,85 @@
+/*
+ * File:   TestDCTHelper.cpp
+ *
+ */
+
+#include "TestDCTHelper.h"
+#include <cmath>
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TestDCTHelper);
+
+TestDCTHelper::TestDCTHelper() {
+}
+
+TestDCTHelper::~TestDCTHelper() {
+}
+
+void TestDCTHelper::setUp() {
+}
+
+void TestDCTHelper::tearDown() {
+}
+
+void TestDCTHelper::testDCT2() {
+    const double tol = 1e-10;
+    for (size_t n = 1; n < 40; n++) {
+        DCTHelper dct(n);
+        _ASSERT_EQ(n, dct.length());
+        Matrix x = MatrixFactory::MakeRandomMatrix(n, 1, -1.0, 2.0);
+        Matrix y(n, 1);
+        dct.dct2(y.getData(), 1.0, x.getData(), 0.0);
+        for (size_t k = 0; k < n; k++) {
+            double yk = 0.0;
+            for (size_t i = 0; i < n; i++) {
+                yk += x[i] * std::cos(M_PI * (i + 0.5) * k / n);
+            }
+            _ASSERT_NUM_EQ(yk, y[k], tol);
+        }
+    }
+}
+
+void TestDCTHelper::testDCT3() {
+    const double tol = 1e-10;
+    for (size_t n = 1; n < 40; n++) {
+        DCTHelper dct(n);
+        Matrix x = MatrixFactory::MakeRandomMatrix(n, 1, -1.0, 2.0);
+        Matrix y = MatrixFactory::MakeRandomMatrix(n, 1, -1.0, 2.0);
+        Matrix y_correct(y);
+        dct.dct3(y.getData(), -2.0, x.getData(), 3.0);
+        for (size_t k = 0; k < n; k++) {
+            double yk = x[0] / 2.0;
+            for (size_t i = 1; i < n; i++) {
+                yk += x[i] * std::cos(M_PI * i * (k + 0.5) / n);
+            }
+            _ASSERT_NUM_EQ(3.0 * y_correct[k] - 2.0 * yk, y[k], tol);
+        }
+    }
+}
+
+void TestDCTHelper::testInverse() {
+    /* DCT-II(DCT-III(x)) = (n/2) x */
+    const size_t dims[4] = {1000, 1024, 4099, 65536};
+    for (size_t q = 0; q < 4; q++) {
+        size_t n = dims[q];
+        DCTHelper dct(n);
+        Matrix x = MatrixFactory::MakeRandomMatrix(n, 1, -1.0, 2.0);
+        Matrix z(n, 1);
+        Matrix y(n, 1);
+        dct.dct3(z.getData(), 1.0, x.getData(), 0.0);
+        dct.dct2(y.getData(), 2.0 / n, z.getData(), 0.0);
+        for (size_t k = 0; k < n; k++) {
+            _ASSERT_NUM_EQ(x[k], y[k], 1e-9);
+        }
+    }
+}
+
+void TestDCTHelper::testCosineBasis() {
+    const size_t n = 37;
+    Matrix C(n, n);
+    DCTHelper::cosineBasis(n, C.getData());
+    for (size_t k = 0; k < n; k++) {
+        for (size_t i = 0; i < n; i++) {
+            _ASSERT_NUM_EQ(std::cos(M_PI * (i + 0.5) * k / n), C.get(k, i), 1e-12);
+        }
+    }
+}
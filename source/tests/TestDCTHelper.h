@@ -0,0 +1,52 @@
+/*
+ * File:   TestDCTHelper.h
+ *
+ * ForBES is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *  
+ * ForBES is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with ForBES. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TESTDCTHELPER_H
+#define TESTDCTHELPER_H
+#define FORBES_TEST_UTILS
+
+#include "ForBES.h"
+#include "DCTHelper.h"
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class TestDCTHelper : public CPPUNIT_NS::TestFixture {
+    CPPUNIT_TEST_SUITE(TestDCTHelper);
+
+    CPPUNIT_TEST(testDCT2);
+    CPPUNIT_TEST(testDCT3);
+    CPPUNIT_TEST(testInverse);
+    CPPUNIT_TEST(testCosineBasis);
+
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    TestDCTHelper();
+    virtual ~TestDCTHelper();
+    void setUp();
+    void tearDown();
+
+private:
+    void testDCT2();
+    void testDCT3();
+    void testInverse();
+    void testCosineBasis();
+
+};
+
+#endif /* TESTDCTHELPER_H */
+
@@ -407,6 +407,43 @@ void TestFBCache::testLogLossPlusL1_small() {
     delete g;
 }
 
+void TestFBCache::testCurvatureCache() {
+    const size_t n = 5;
+    const double gamma = 0.1;
+    double data_x[] = {1, -2, 3, -4, 5};
+    double ref_gradFBEx[] = {0.716685094584284, -1.861049915114549, 0.948270715102844, -1.978513017309498, 0.992646792853859};
+    double data_x2[] = {-1, 0.5, 2, 4, -3};
+
+    Function * f = new LogLogisticLoss(1.0);
+    Function * g = new Norm1(1.0);
+    FBProblem * prob = new FBProblem(*f, *g);
+    Matrix x(n, 1, data_x);
+    Matrix x2(n, 1, data_x2);
+
+    FBCache * cache = new FBCache(*prob, x, 1.0);
+    _ASSERT_NOT(f->isCurvatureCacheEnabled());
+    cache->set_curvature_cache(true);
+    _ASSERT(f->isCurvatureCacheEnabled());
+
+    Matrix * gradFBEx = cache->get_grad_FBE(gamma);
+    for (size_t i = 0; i < n; i++) {
+        _ASSERT_NUM_EQ(ref_gradFBEx[i], gradFBEx->get(i), 1e-12);
+    }
+
+    /* the cache must not be reused at a different point */
+    cache->set_point(x2);
+    Matrix gradFBEx2(*cache->get_grad_FBE(gamma));
+    cache->set_curvature_cache(false);
+    _ASSERT_NOT(f->isCurvatureCacheEnabled());
+    cache->reset();
+    _ASSERT_EQ(gradFBEx2, *cache->get_grad_FBE(gamma));
+
+    delete cache;
+    delete prob;
+    delete f;
+    delete g;
+}
+
 void TestFBCache::testNormFPR() {
     const size_t n = 4;
     double data_Q[] = {
@@ -1208,3 +1245,61 @@ void TestFBCache::testLeanCache() {
     delete g;
     delete prob;
 }
+
+void TestFBCache::testWorkspace() {
+    size_t n = 8;
+    Function * f = new Quadratic();
+    Function * g = new Norm1();
+    FBProblem * prob = new FBProblem(*f, *g);
+    Matrix d1(n, 1);
+    for (size_t i = 0; i < n; i++) d1[i] = 2.0;
+    prob->setD1(&d1);
+
+    Matrix x(n, 1);
+    for (size_t i = 0; i < n; i++) x[i] = i + 1.0;
+    double gamma = 0.2;
+    FBCache * cache = new FBCache(*prob, x, gamma);
+
+    /* f(x) = 0.5 * ||x + d1||^2, grad f(x) = x + d1 */
+    double fx_expected = 0.0;
+    for (size_t i = 0; i < n; i++) fx_expected += 0.5 * std::pow(x[i] + d1[i], 2);
+    _ASSERT_NUM_EQ(fx_expected, cache->get_eval_f(), 1e-10);
+
+    Matrix * y = cache->get_forward_step(gamma);
+    Matrix * gradf = cache->get_gradf();
+    Matrix * z = cache->get_forward_backward_step(gamma);
+    Matrix * gradFBE = cache->get_grad_FBE(gamma);
+    for (size_t i = 0; i < n; i++) {
+        _ASSERT_NUM_EQ(x[i] + d1[i], gradf->get(i, 0), 1e-10);
+    }
+
+    /* the workspace is reused when the point or the direction changes */
+    Matrix x_new(n, 1);
+    Matrix dir(n, 1);
+    for (size_t i = 0; i < n; i++) {
+        x_new[i] = -0.5 * i;
+        dir[i] = 1.0;
+    }
+    cache->set_point(x_new);
+    cache->set_direction(dir);
+    _ASSERT_EQ(y, cache->get_forward_step(gamma));
+    _ASSERT_EQ(gradf, cache->get_gradf());
+    _ASSERT_EQ(z, cache->get_forward_backward_step(gamma));
+    _ASSERT_EQ(gradFBE, cache->get_grad_FBE(gamma));
+    for (size_t i = 0; i < n; i++) {
+        _ASSERT_NUM_EQ(x_new[i] + d1[i], gradf->get(i, 0), 1e-10);
+    }
+
+    double fbe_xtd;
+    double tau = 0.4;
+    _ASSERT_EQ(ForBESUtils::STATUS_OK, cache->extrapolate_fbe(tau, gamma, fbe_xtd));
+    Matrix xtd(n, 1);
+    _ASSERT_EQ(ForBESUtils::STATUS_OK, cache->xtd(tau, xtd));
+    cache->set_point(xtd);
+    _ASSERT_NUM_EQ(cache->get_eval_FBE(gamma), fbe_xtd, 1e-10);
+
+    delete cache;
+    delete f;
+    delete g;
+    delete prob;
+}
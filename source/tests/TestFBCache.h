@@ -25,6 +25,8 @@ class TestFBCache : public CPPUNIT_NS::TestFixture {
     CPPUNIT_TEST(testSparseLeastSquares_small);
     CPPUNIT_TEST(testSparseLogReg_small);
     CPPUNIT_TEST(testLogLossPlusL1_small);
+    CPPUNIT_TEST(testCurvatureCache);
+    CPPUNIT_TEST(testWorkspace);
     
     CPPUNIT_TEST_SUITE_END();
 
@@ -49,6 +51,8 @@ private:
     void testSparseLeastSquares_small();
     void testSparseLogReg_small();
     void testLogLossPlusL1_small();
+    void testCurvatureCache();
+    void testWorkspace();
 };
 
 #endif	/* TESTFBCACHE_H */
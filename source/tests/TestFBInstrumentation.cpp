@@ -0,0 +1,213 @@
+/*
+ * File:   TestFBInstrumentation.cpp
+ *
+ * ForBES is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *  
+ * ForBES is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with ForBES. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "TestFBInstrumentation.h"
+
+#include <cstdio>
+#include <string>
+
+#define MAXIT 1000
+#define TOLERANCE 1e-14
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TestFBInstrumentation);
+
+TestFBInstrumentation::TestFBInstrumentation() {
+}
+
+TestFBInstrumentation::~TestFBInstrumentation() {
+}
+
+void TestFBInstrumentation::setUp() {
+}
+
+void TestFBInstrumentation::tearDown() {
+}
+
+static double busy(size_t n) {
+    double s = 0.0;
+    for (size_t i = 0; i < n; i++) {
+        s += std::sqrt(static_cast<double> (i));
+    }
+    return s;
+}
+
+void TestFBInstrumentation::testPhases() {
+    FBInstrumentation instr;
+    double s = 0.0;
+    instr.beginPhase(FBInstrumentation::PHASE_SOLVER);
+    s += busy(100000);
+    instr.beginPhase(FBInstrumentation::PHASE_PROX);
+    s += busy(100000);
+    {
+        FBInstrumentation::Scope scope(&instr, FBInstrumentation::PHASE_OPERATOR);
+        s += busy(100000);
+    }
+    instr.endPhase();
+    instr.endPhase();
+    instr.endIteration();
+    _ASSERT(s > 0.0);
+
+    _ASSERT_EQ(static_cast<size_t> (1), instr.getIterations());
+    _ASSERT(instr.getTime(FBInstrumentation::PHASE_SOLVER) > 0.0);
+    _ASSERT(instr.getTime(FBInstrumentation::PHASE_PROX) > 0.0);
+    _ASSERT(instr.getTime(FBInstrumentation::PHASE_OPERATOR) > 0.0);
+    _ASSERT_EQ(0.0, instr.getTime(FBInstrumentation::PHASE_FUNCTION));
+    double total = 0.0;
+    for (int p = 0; p < FBInstrumentation::NUM_PHASES; p++) {
+        total += instr.getTime(static_cast<FBInstrumentation::Phase> (p));
+    }
+    _ASSERT_NUM_EQ(total, instr.getTotalTime(), 1e-12);
+
+    /* unbalanced calls to endPhase are ignored */
+    instr.endPhase();
+
+    instr.count(FBInstrumentation::COUNT_PROX_CALL);
+    instr.count(FBInstrumentation::COUNT_PROX_CALL);
+    _ASSERT_EQ(static_cast<size_t> (2), instr.getCount(FBInstrumentation::COUNT_PROX_CALL));
+
+    instr.reset();
+    _ASSERT_EQ(static_cast<size_t> (0), instr.getIterations());
+    _ASSERT_EQ(static_cast<size_t> (0), instr.getCount(FBInstrumentation::COUNT_PROX_CALL));
+    _ASSERT_EQ(0.0, instr.getTotalTime());
+
+    /* a NULL instrumentation is a no-op */
+    FBInstrumentation::Scope scope(NULL, FBInstrumentation::PHASE_PROX);
+}
+
+void TestFBInstrumentation::testSolver() {
+    /* LASSO: 0.5 * ||Ax - b||^2 + 5 * ||x||_1 */
+    size_t n = 5;
+    size_t m = 4;
+    double data_A[] = {
+        1, 2, -1, -1,
+        -2, -1, 0, -1,
+        3, 0, 4, -1,
+        -4, -1, -3, 1,
+        5, 3, 2, 3
+    };
+    double data_minusb[] = {-1, -2, -3, -4};
+    double gamma = 0.01;
+
+    Matrix A(m, n, data_A);
+    Matrix minusb(m, 1, data_minusb);
+    QuadraticLoss f;
+    MatrixOperator OpA(A);
+    Norm1 g(5.0);
+    FBProblem prob(f, OpA, minusb, g);
+    FBStoppingRelative sc(1e-8);
+
+    Matrix x1(n, 1);
+    FBSplitting solver1(prob, x1, gamma, sc, MAXIT);
+    solver1.run();
+    Matrix xstar1 = solver1.getSolution();
+
+    Matrix x2(n, 1);
+    FBInstrumentation instr;
+    FBSplitting solver2(prob, x2, gamma, sc, MAXIT);
+    _ASSERT(solver2.getInstrumentation() == NULL);
+    solver2.setInstrumentation(&instr);
+    _ASSERT(solver2.getInstrumentation() == &instr);
+    solver2.run();
+    Matrix xstar2 = solver2.getSolution();
+
+    /* instrumentation does not affect the results */
+    _ASSERT_EQ(solver1.getIt(), solver2.getIt());
+    _ASSERT_EQ(xstar1, xstar2);
+
+    size_t it = solver2.getIt();
+    _ASSERT(it > 0);
+    _ASSERT_EQ(it, instr.getIterations());
+    /* one forward-backward step per iteration (and one for the stopping test) */
+    _ASSERT(instr.getCount(FBInstrumentation::COUNT_PROX_CALL) >= it);
+    _ASSERT(instr.getCount(FBInstrumentation::COUNT_OPERATOR_CALL) >= it);
+    _ASSERT(instr.getCount(FBInstrumentation::COUNT_OPERATOR_ADJOINT) >= it);
+    _ASSERT(instr.getCount(FBInstrumentation::COUNT_FUNCTION_CALL) >= it);
+    _ASSERT(instr.getTime(FBInstrumentation::PHASE_PROX) > 0.0);
+    _ASSERT(instr.getTime(FBInstrumentation::PHASE_STOPPING) > 0.0);
+    _ASSERT(instr.getTotalTime() > 0.0);
+}
+
+void TestFBInstrumentation::testCacheHits() {
+    size_t n = 4;
+    Matrix Q = MatrixFactory::MakeIdentity(n, 2.0);
+    Matrix q(n, 1);
+    Quadratic f(Q, q);
+    double lb = -1.0;
+    double ub = 1.0;
+    IndBox g(lb, ub);
+    FBProblem prob(f, g);
+    Matrix x(n, 1);
+    for (size_t i = 0; i < n; i++) {
+        x[i] = 0.5 * i;
+    }
+    FBCache cache(prob, x, 0.1);
+    FBInstrumentation instr;
+    cache.set_instrumentation(&instr);
+    _ASSERT(cache.get_instrumentation() == &instr);
+
+    cache.get_forward_backward_step(0.1);
+    _ASSERT_EQ(static_cast<size_t> (0), instr.getCount(FBInstrumentation::COUNT_CACHE_HIT));
+    _ASSERT_EQ(static_cast<size_t> (1), instr.getCount(FBInstrumentation::COUNT_FUNCTION_CALL));
+    _ASSERT_EQ(static_cast<size_t> (1), instr.getCount(FBInstrumentation::COUNT_PROX_CALL));
+
+    /* the forward-backward step is cached */
+    cache.get_forward_backward_step(0.1);
+    _ASSERT_EQ(static_cast<size_t> (1), instr.getCount(FBInstrumentation::COUNT_CACHE_HIT));
+    _ASSERT_EQ(static_cast<size_t> (1), instr.getCount(FBInstrumentation::COUNT_PROX_CALL));
+
+    /* operators are not used */
+    _ASSERT_EQ(static_cast<size_t> (0), instr.getCount(FBInstrumentation::COUNT_OPERATOR_CALL));
+    _ASSERT_EQ(static_cast<size_t> (0), instr.getCount(FBInstrumentation::COUNT_OPERATOR_ADJOINT));
+
+    /* detached */
+    cache.set_instrumentation(NULL);
+    cache.get_forward_backward_step(0.1);
+    _ASSERT_EQ(static_cast<size_t> (1), instr.getCount(FBInstrumentation::COUNT_CACHE_HIT));
+}
+
+void TestFBInstrumentation::testJSON() {
+    FBInstrumentation instr;
+    instr.setTrace(true);
+    _ASSERT(instr.isTrace());
+    for (size_t k = 0; k < 3; k++) {
+        FBInstrumentation::Scope scope(&instr, FBInstrumentation::PHASE_FUNCTION);
+        instr.count(FBInstrumentation::COUNT_FUNCTION_CALL);
+        instr.endIteration();
+    }
+
+    FILE * fp = tmpfile();
+    instr.printJSON(fp);
+    long size = ftell(fp);
+    rewind(fp);
+    std::string json(size, ' ');
+    _ASSERT_EQ(static_cast<size_t> (size), fread(&json[0], 1, size, fp));
+    fclose(fp);
+
+    _ASSERT(json.find("\"iterations\":3") != std::string::npos);
+    _ASSERT(json.find("\"function_calls\":3") != std::string::npos);
+    _ASSERT(json.find("\"trace\":[") != std::string::npos);
+    _ASSERT(json.find("{\"iteration\":3") != std::string::npos);
+    /* per-iteration counts */
+    size_t pos = json.find("\"trace\":[");
+    _ASSERT(json.find("\"function_calls\":1", pos) != std::string::npos);
+    _ASSERT(json.find("\"function_calls\":3", pos) == std::string::npos);
+
+    fp = tmpfile();
+    instr.printSummary(fp);
+    _ASSERT(ftell(fp) > 0);
+    fclose(fp);
+}
@@ -0,0 +1,51 @@
+/*
+ * File:   TestFBInstrumentation.h
+ *
+ * ForBES is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *  
+ * ForBES is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with ForBES. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TESTFBINSTRUMENTATION_H
+#define TESTFBINSTRUMENTATION_H
+#define FORBES_TEST_UTILS
+
+#include "ForBES.h"
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class TestFBInstrumentation : public CPPUNIT_NS::TestFixture {
+    CPPUNIT_TEST_SUITE(TestFBInstrumentation);
+
+    CPPUNIT_TEST(testPhases);
+    CPPUNIT_TEST(testSolver);
+    CPPUNIT_TEST(testCacheHits);
+    CPPUNIT_TEST(testJSON);
+
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    TestFBInstrumentation();
+    virtual ~TestFBInstrumentation();
+    void setUp();
+    void tearDown();
+
+private:
+    void testPhases();
+    void testSolver();
+    void testCacheHits();
+    void testJSON();
+
+};
+
+#endif /* TESTFBINSTRUMENTATION_H */
+
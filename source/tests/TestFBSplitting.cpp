@@ -5,12 +5,37 @@
 #include "MatrixOperator.h"
 #include "TestFBSplitting.h"
 
+#include <stdexcept>
+
 // #include <iostream>
 
 #define DOUBLES_EQUAL_DELTA 1e-4
 #define MAXIT 1000
 #define TOLERANCE 1e-6
 
+/* quadratic loss which throws at points with a huge first entry */
+class FragileQuadraticLoss : public QuadraticLoss {
+public:
+
+    virtual int call(Matrix& x, double& f) {
+        check(x);
+        return QuadraticLoss::call(x, f);
+    }
+
+    virtual int call(Matrix& x, double& f, Matrix& grad) {
+        check(x);
+        return QuadraticLoss::call(x, f, grad);
+    }
+
+private:
+
+    static void check(Matrix& x) {
+        if (x[0] > 1e6 || x[0] < -1e6) {
+            throw std::domain_error("point out of the domain");
+        }
+    }
+};
+
 CPPUNIT_TEST_SUITE_REGISTRATION(TestFBSplitting);
 
 TestFBSplitting::TestFBSplitting() {
@@ -197,3 +222,337 @@ void TestFBSplitting::testSparseLogReg_small() {
 	delete g;
 }
 
+void TestFBSplitting::testBoxQP_adaptive() {
+	size_t n = 4;
+	// problem data
+	double data_Q[] = {
+		7, 2, -2, -1,
+		2, 3, 0, -1,
+		-2, 0, 3, -1,
+		-1, -1, -1, 1
+	};
+	double data_q[] = {
+		1, 2, 3, 4
+	};
+	// too large for a fixed step-size (the largest eigenvalue of Q is ~8.9)
+	double gamma = 5.0;
+	double lb = -1;
+	double ub = +1;
+	// starting point
+	double data_x1[] = {+0.5, +1.2, -0.7, -1.1};
+	// reference results
+	double ref_xstar[] = {-0.352941176470588, -0.764705882352941, -1.000000000000000, -1.000000000000000};
+
+	Matrix * Q = new Matrix(n, n, data_Q);
+	Matrix * q = new Matrix(n, 1, data_q);
+	Matrix * x0 = new Matrix(n, 1, data_x1);
+	Matrix xstar;
+	Function * f = new Quadratic(*Q, *q);
+	Function * g = new IndBox(lb, ub);
+	FBProblem prob(*f, *g);
+	FBStoppingRelative sc(TOLERANCE);
+
+	FBSplitting * solver = new FBSplitting(prob, *x0, gamma, sc, MAXIT);
+	_ASSERT_NOT(solver->isAdaptiveStepsize());
+	solver->setAdaptiveStepsize(true);
+	_ASSERT(solver->isAdaptiveStepsize());
+	_ASSERT_EQ(ForBESUtils::STATUS_OK, solver->run());
+	xstar = solver->getSolution();
+	_ASSERT(solver->getIt() < MAXIT);
+	_ASSERT(solver->getGamma() < gamma);
+	_ASSERT(solver->getGamma() > 0.0);
+	for (int i=0; i < n; i++) {
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(ref_xstar[i], xstar.get(i, 0), DOUBLES_EQUAL_DELTA);
+	}
+
+	delete solver;
+	delete x0;
+	delete Q;
+	delete q;
+	delete f;
+	delete g;
+}
+
+void TestFBSplitting::testLasso_adaptive() {
+	size_t n = 5;
+	size_t m = 4;
+	// problem data
+	double data_A[] = {
+		1, 2, -1, -1,
+		-2, -1, 0, -1,
+		3, 0, 4, -1,
+		-4, -1, -3, 1,
+		5, 3, 2, 3
+	};
+	double data_minusb[] = {-1, -2, -3, -4};
+	// far larger than 1/L, where L = ||A||^2
+	double gamma = 1.0;
+	// starting point
+	double data_x1[] = {0, 0, 0, 0, 0};
+	// reference results
+	double ref_xstar[] = {-0.010238907849511, 0, 0, 0, 0.511945392491421};
+
+	Matrix * A = new Matrix(m, n, data_A);
+	Matrix * minusb = new Matrix(m, 1, data_minusb);
+	Matrix * x0 = new Matrix(n, 1, data_x1);
+	Matrix xstar;
+	Function * f = new QuadraticLoss();
+	LinearOperator * OpA = new MatrixOperator(*A);
+	Function * g = new Norm1(5.0);
+	FBProblem prob(*f, *OpA, *minusb, *g);
+	FBStoppingRelative sc(TOLERANCE);
+
+	FBSplitting * solver = new FBSplitting(prob, *x0, gamma, sc, MAXIT);
+	solver->setAdaptiveStepsize(true);
+	_ASSERT_EQ(ForBESUtils::STATUS_OK, solver->run());
+	xstar = solver->getSolution();
+	_ASSERT(solver->getIt() < MAXIT);
+	_ASSERT(solver->getGamma() < gamma);
+	for (int i=0; i < n; i++) {
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(ref_xstar[i], xstar.get(i, 0), DOUBLES_EQUAL_DELTA);
+	}
+
+	delete solver;
+	delete x0;
+	delete A;
+	delete minusb;
+	delete OpA;
+	delete f;
+	delete g;
+}
+
+void TestFBSplitting::testLasso_warmStart() {
+	size_t n = 5;
+	size_t m = 4;
+	// problem data
+	double data_A[] = {
+		1, 2, -1, -1,
+		-2, -1, 0, -1,
+		3, 0, 4, -1,
+		-4, -1, -3, 1,
+		5, 3, 2, 3
+	};
+	double data_minusb[] = {-1, -2, -3, -4};
+	double data_minusb2[] = {2, -1, 0, -3};
+	double gamma = 0.01;
+	// starting points
+	double data_x1[] = {0, 0, 0, 0, 0};
+	double data_x2[] = {1, -1, 1, -1, 1};
+	// reference results
+	double ref_xstar[] = {-0.010238907849511, 0, 0, 0, 0.511945392491421};
+
+	Matrix A(m, n, data_A);
+	Matrix minusb(m, 1, data_minusb);
+	Matrix minusb2(m, 1, data_minusb2);
+	Matrix x1(n, 1, data_x1);
+	Matrix x2(n, 1, data_x2);
+	QuadraticLoss f;
+	MatrixOperator OpA(A);
+	Norm1 g(5.0);
+	FBProblem prob(f, OpA, minusb, g);
+	FBStoppingRelative sc(TOLERANCE);
+
+	// the solver iterates in the storage of x
+	Matrix x(x1);
+	FBSplitting solver(prob, x, gamma, sc, MAXIT);
+	_ASSERT_EQ(ForBESUtils::STATUS_OK, solver.run());
+	size_t iters = solver.getIt();
+
+	// same problem from another point
+	_ASSERT_EQ(ForBESUtils::STATUS_OK, solver.reset(x2));
+	_ASSERT_EQ(static_cast<size_t> (0), solver.getIt());
+	_ASSERT_EQ(ForBESUtils::STATUS_OK, solver.run());
+	_ASSERT(solver.getIt() < MAXIT);
+	Matrix xstar = solver.getSolution();
+	for (size_t i = 0; i < n; i++) {
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(ref_xstar[i], xstar.get(i, 0), DOUBLES_EQUAL_DELTA);
+	}
+
+	// new offset: compare with a solver constructed from scratch
+	Matrix minusb_copy(minusb);
+	FBProblem prob2(f, OpA, minusb2, g);
+	Matrix x_fresh(x1);
+	FBSplitting fresh(prob2, x_fresh, gamma, sc, MAXIT);
+	_ASSERT_EQ(ForBESUtils::STATUS_OK, fresh.run());
+	Matrix xstar2 = fresh.getSolution();
+
+	_ASSERT_EQ(ForBESUtils::STATUS_OK, solver.reset(x1, &minusb2, NULL, MAXIT));
+	_ASSERT(prob.d1() == &minusb2);
+	_ASSERT_EQ(ForBESUtils::STATUS_OK, solver.run());
+	_ASSERT_EQ(fresh.getIt(), solver.getIt());
+	xstar = solver.getSolution();
+	for (size_t i = 0; i < n; i++) {
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(xstar2.get(i, 0), xstar.get(i, 0), 1e-12);
+	}
+
+	// back to the original offset with fewer iterations
+	_ASSERT_EQ(ForBESUtils::STATUS_OK, solver.reset(x1, &minusb, NULL, 3));
+	_ASSERT_EQ(static_cast<size_t> (3), solver.getMaxIt());
+	solver.run();
+	_ASSERT_EQ(static_cast<size_t> (3), solver.getIt());
+	solver.setMaxIt(MAXIT);
+	solver.reset(x1);
+	_ASSERT_EQ(ForBESUtils::STATUS_OK, solver.run());
+	_ASSERT_EQ(iters, solver.getIt());
+	_ASSERT_EQ(minusb_copy, minusb);
+
+	// wrong dimensions, or no offset d2 to replace
+	Matrix x_wrong(n + 1, 1);
+	Matrix d_wrong(m + 1, 1);
+	_ASSERT_EXCEPTION(solver.reset(x_wrong), std::invalid_argument);
+	_ASSERT_EXCEPTION(solver.reset(x1, &d_wrong, NULL, MAXIT), std::invalid_argument);
+	_ASSERT_EXCEPTION(solver.reset(x1, NULL, &minusb2, MAXIT), std::invalid_argument);
+}
+
+void TestFBSplitting::testLasso_batch() {
+	size_t n = 5;
+	size_t m = 4;
+	const size_t K = 7;
+	const size_t n_solvers = 3;
+	// problem data
+	double data_A[] = {
+		1, 2, -1, -1,
+		-2, -1, 0, -1,
+		3, 0, 4, -1,
+		-4, -1, -3, 1,
+		5, 3, 2, 3
+	};
+	double gamma = 0.01;
+
+	Matrix A(m, n, data_A);
+	QuadraticLoss f;
+	MatrixOperator OpA(A);
+	Norm1 g(5.0);
+	FBStoppingRelative sc(TOLERANCE);
+
+	// one problem and one solver (with its own iterate) per thread
+	std::vector<Matrix*> iterates;
+	std::vector<Matrix*> offsets;
+	std::vector<FBProblem*> problems;
+	std::vector<FBSplitting*> solvers;
+	for (size_t s = 0; s < n_solvers; s++) {
+		iterates.push_back(new Matrix(n, 1));
+		offsets.push_back(new Matrix(m, 1));
+		problems.push_back(new FBProblem(f, OpA, *offsets[s], g));
+		solvers.push_back(new FBSplitting(*problems[s], *iterates[s], gamma, sc, MAXIT));
+	}
+
+	std::vector<Matrix*> x0s;
+	std::vector<Matrix*> d1s;
+	std::vector<Matrix*> d2s;
+	std::vector<Matrix*> solutions;
+	for (size_t k = 0; k < K; k++) {
+		x0s.push_back(new Matrix(MatrixFactory::MakeRandomMatrix(n, 1, -1.0, 2.0)));
+		d1s.push_back(new Matrix(MatrixFactory::MakeRandomMatrix(m, 1, -5.0, 10.0)));
+		solutions.push_back(new Matrix(n, 1));
+	}
+
+	_ASSERT_EQ(ForBESUtils::STATUS_OK, FBSplitting::runBatch(solvers, x0s, d1s, d2s, solutions, MAXIT));
+	// the offsets of the solvers are restored
+	for (size_t s = 0; s < n_solvers; s++) {
+		_ASSERT(problems[s]->d1() == offsets[s]);
+	}
+
+	for (size_t k = 0; k < K; k++) {
+		FBProblem prob(f, OpA, *d1s[k], g);
+		Matrix x0(*x0s[k]);
+		FBSplitting solver(prob, x0, gamma, sc, MAXIT);
+		solver.run();
+		Matrix xstar = solver.getSolution();
+		for (size_t i = 0; i < n; i++) {
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(xstar.get(i, 0), solutions[k]->get(i, 0), 1e-12);
+		}
+	}
+
+	// inconsistent sizes
+	std::vector<Matrix*> too_few(solutions.begin(), solutions.end() - 1);
+	_ASSERT_EXCEPTION(FBSplitting::runBatch(solvers, x0s, d1s, d2s, too_few, MAXIT), std::invalid_argument);
+
+	for (size_t k = 0; k < K; k++) {
+		delete x0s[k];
+		delete d1s[k];
+		delete solutions[k];
+	}
+	for (size_t s = 0; s < n_solvers; s++) {
+		delete solvers[s];
+		delete problems[s];
+		delete offsets[s];
+		delete iterates[s];
+	}
+}
+
+void TestFBSplitting::testLasso_batchFailure() {
+	size_t n = 5;
+	size_t m = 4;
+	const size_t K = 6;
+	const size_t n_solvers = 2;
+	const size_t k_fail = 3;
+	// problem data
+	double data_A[] = {
+		1, 2, -1, -1,
+		-2, -1, 0, -1,
+		3, 0, 4, -1,
+		-4, -1, -3, 1,
+		5, 3, 2, 3
+	};
+	double gamma = 0.01;
+
+	Matrix A(m, n, data_A);
+	FragileQuadraticLoss f;
+	MatrixOperator OpA(A);
+	Norm1 g(5.0);
+	FBStoppingRelative sc(TOLERANCE);
+
+	std::vector<Matrix*> iterates;
+	std::vector<Matrix*> offsets;
+	std::vector<FBProblem*> problems;
+	std::vector<FBSplitting*> solvers;
+	for (size_t s = 0; s < n_solvers; s++) {
+		iterates.push_back(new Matrix(n, 1));
+		offsets.push_back(new Matrix(m, 1));
+		problems.push_back(new FBProblem(f, OpA, *offsets[s], g));
+		solvers.push_back(new FBSplitting(*problems[s], *iterates[s], gamma, sc, MAXIT));
+	}
+
+	std::vector<Matrix*> x0s;
+	std::vector<Matrix*> d1s;
+	std::vector<Matrix*> d2s;
+	std::vector<Matrix*> solutions;
+	for (size_t k = 0; k < K; k++) {
+		x0s.push_back(new Matrix(MatrixFactory::MakeRandomMatrix(n, 1, -1.0, 2.0)));
+		d1s.push_back(new Matrix(MatrixFactory::MakeRandomMatrix(m, 1, -5.0, 10.0)));
+		solutions.push_back(new Matrix(n, 1));
+	}
+	// f throws for this instance
+	(*d1s[k_fail])[0] = 1e9;
+
+	_ASSERT_EXCEPTION(FBSplitting::runBatch(solvers, x0s, d1s, d2s, solutions, MAXIT), std::runtime_error);
+
+	// the offsets of the solvers are restored and all other instances are solved
+	for (size_t s = 0; s < n_solvers; s++) {
+		_ASSERT(problems[s]->d1() == offsets[s]);
+	}
+	for (size_t k = 0; k < K; k++) {
+		if (k == k_fail) continue;
+		FBProblem prob(f, OpA, *d1s[k], g);
+		Matrix x0(*x0s[k]);
+		FBSplitting solver(prob, x0, gamma, sc, MAXIT);
+		solver.run();
+		Matrix xstar = solver.getSolution();
+		for (size_t i = 0; i < n; i++) {
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(xstar.get(i, 0), solutions[k]->get(i, 0), 1e-12);
+		}
+	}
+
+	for (size_t k = 0; k < K; k++) {
+		delete x0s[k];
+		delete d1s[k];
+		delete solutions[k];
+	}
+	for (size_t s = 0; s < n_solvers; s++) {
+		delete solvers[s];
+		delete problems[s];
+		delete offsets[s];
+		delete iterates[s];
+	}
+}
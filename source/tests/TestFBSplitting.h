@@ -14,6 +14,11 @@ class TestFBSplitting : public CPPUNIT_NS::TestFixture {
     CPPUNIT_TEST(testBoxQP_small);
     CPPUNIT_TEST(testLasso_small);
     CPPUNIT_TEST(testSparseLogReg_small);
+    CPPUNIT_TEST(testBoxQP_adaptive);
+    CPPUNIT_TEST(testLasso_adaptive);
+    CPPUNIT_TEST(testLasso_warmStart);
+    CPPUNIT_TEST(testLasso_batch);
+    CPPUNIT_TEST(testLasso_batchFailure);
     
     CPPUNIT_TEST_SUITE_END();
 
@@ -27,6 +32,11 @@ private:
     void testBoxQP_small();
     void testLasso_small();
     void testSparseLogReg_small();
+    void testBoxQP_adaptive();
+    void testLasso_adaptive();
+    void testLasso_warmStart();
+    void testLasso_batch();
+    void testLasso_batchFailure();
 };
 
 #endif	/* TESTFBSPLITTING_H */
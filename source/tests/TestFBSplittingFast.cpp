@@ -203,3 +203,102 @@ void TestFBSplittingFast::testSparseLogReg_small() {
 	delete f;
 	delete g;
 }
+
+void TestFBSplittingFast::testBoxQP_adaptive() {
+	size_t n = 4;
+	// problem data
+	double data_Q[] = {
+		7, 2, -2, -1,
+		2, 3, 0, -1,
+		-2, 0, 3, -1,
+		-1, -1, -1, 1
+	};
+	double data_q[] = {
+		1, 2, 3, 4
+	};
+	// too large for a fixed step-size (the largest eigenvalue of Q is ~8.9)
+	double gamma = 5.0;
+	double lb = -1;
+	double ub = +1;
+	// starting point
+	double data_x1[] = {+0.5, +1.2, -0.7, -1.1};
+	// reference results
+	double ref_xstar[] = {-0.352941176470588, -0.764705882352941, -1.000000000000000, -1.000000000000000};
+
+	Matrix * Q = new Matrix(n, n, data_Q);
+	Matrix * q = new Matrix(n, 1, data_q);
+	Matrix * x0 = new Matrix(n, 1, data_x1);
+	Matrix xstar;
+	Function * f = new Quadratic(*Q, *q);
+	Function * g = new IndBox(lb, ub);
+	FBProblem prob(*f, *g);
+	FBStoppingRelative sc(TOLERANCE);
+
+	FBSplittingFast * solver = new FBSplittingFast(prob, *x0, gamma, sc, MAXIT);
+	_ASSERT_NOT(solver->isAdaptiveStepsize());
+	solver->setAdaptiveStepsize(true);
+	_ASSERT(solver->isAdaptiveStepsize());
+	_ASSERT_EQ(ForBESUtils::STATUS_OK, solver->run());
+	xstar = solver->getSolution();
+	_ASSERT(solver->getIt() < MAXIT);
+	_ASSERT(solver->getGamma() < gamma);
+	_ASSERT(solver->getGamma() > 0.0);
+	for (int i=0; i < n; i++) {
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(ref_xstar[i], xstar.get(i, 0), DOUBLES_EQUAL_DELTA);
+	}
+
+	delete solver;
+	delete x0;
+	delete Q;
+	delete q;
+	delete f;
+	delete g;
+}
+
+void TestFBSplittingFast::testLasso_adaptive() {
+	size_t n = 5;
+	size_t m = 4;
+	// problem data
+	double data_A[] = {
+		1, 2, -1, -1,
+		-2, -1, 0, -1,
+		3, 0, 4, -1,
+		-4, -1, -3, 1,
+		5, 3, 2, 3
+	};
+	double data_minusb[] = {-1, -2, -3, -4};
+	// far larger than 1/L, where L = ||A||^2
+	double gamma = 1.0;
+	// starting point
+	double data_x1[] = {0, 0, 0, 0, 0};
+	// reference results
+	double ref_xstar[] = {-0.010238907849511, 0, 0, 0, 0.511945392491421};
+
+	Matrix * A = new Matrix(m, n, data_A);
+	Matrix * minusb = new Matrix(m, 1, data_minusb);
+	Matrix * x0 = new Matrix(n, 1, data_x1);
+	Matrix xstar;
+	Function * f = new QuadraticLoss();
+	LinearOperator * OpA = new MatrixOperator(*A);
+	Function * g = new Norm1(5.0);
+	FBProblem prob(*f, *OpA, *minusb, *g);
+	FBStoppingRelative sc(TOLERANCE);
+
+	FBSplittingFast * solver = new FBSplittingFast(prob, *x0, gamma, sc, MAXIT);
+	solver->setAdaptiveStepsize(true);
+	_ASSERT_EQ(ForBESUtils::STATUS_OK, solver->run());
+	xstar = solver->getSolution();
+	_ASSERT(solver->getIt() < MAXIT);
+	_ASSERT(solver->getGamma() < gamma);
+	for (int i=0; i < n; i++) {
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(ref_xstar[i], xstar.get(i, 0), DOUBLES_EQUAL_DELTA);
+	}
+
+	delete solver;
+	delete x0;
+	delete A;
+	delete minusb;
+	delete OpA;
+	delete f;
+	delete g;
+}
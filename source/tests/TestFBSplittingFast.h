@@ -14,6 +14,8 @@ class TestFBSplittingFast : public CPPUNIT_NS::TestFixture {
     CPPUNIT_TEST(testBoxQP_small);
     CPPUNIT_TEST(testLasso_small);
     CPPUNIT_TEST(testSparseLogReg_small);
+    CPPUNIT_TEST(testBoxQP_adaptive);
+    CPPUNIT_TEST(testLasso_adaptive);
     
     CPPUNIT_TEST_SUITE_END();
 
@@ -27,6 +29,8 @@ private:
     void testBoxQP_small();
     void testLasso_small();
     void testSparseLogReg_small();
+    void testBoxQP_adaptive();
+    void testLasso_adaptive();
 };
 
 #endif	/* TESTFBSPLITTING_H */
@@ -146,3 +146,36 @@ void TestHingeLoss::testCallProx() {
     delete hinge;
 }
 
+void TestHingeLoss::testLargeVector() {
+    const size_t n = 20000;
+    const double mu = 1.3;
+    const double gamma = 0.4;
+    Matrix b(n, 1);
+    Matrix x = MatrixFactory::MakeRandomMatrix(n, 1, -3.0, 6.0);
+    for (size_t i = 0; i < n; i++) {
+        b[i] = (i % 3 == 0) ? -1.0 : 1.0;
+    }
+    HingeLoss hinge(b, mu);
+
+    double f;
+    double f_at_prox;
+    Matrix prox(n, 1);
+    _ASSERT_EQ(ForBESUtils::STATUS_OK, hinge.call(x, f));
+    _ASSERT_EQ(ForBESUtils::STATUS_OK, hinge.callProx(x, gamma, prox, f_at_prox));
+
+    double f_expected = 0.0;
+    double f_at_prox_expected = 0.0;
+    for (size_t i = 0; i < n; i++) {
+        f_expected += std::max(0.0, 1.0 - b[i] * x[i]);
+        double pi = b[i] * x[i] < 1.0 ? b[i] * std::min(1.0, b[i] * x[i] + gamma * mu) : x[i];
+        _ASSERT_NUM_EQ(pi, prox[i], 1e-12);
+        f_at_prox_expected += std::max(0.0, 1.0 - b[i] * pi);
+    }
+    _ASSERT_NUM_EQ(mu * f_expected, f, 1e-8);
+    _ASSERT_NUM_EQ(mu * f_at_prox_expected, f_at_prox, 1e-8);
+
+    Matrix prox2(n, 1);
+    _ASSERT_EQ(ForBESUtils::STATUS_OK, hinge.callProx(x, gamma, prox2));
+    _ASSERT_EQ(prox, prox2);
+}
+
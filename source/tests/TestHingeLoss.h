@@ -32,6 +32,7 @@ class TestHingeLoss : public CPPUNIT_NS::TestFixture {
     CPPUNIT_TEST(testCall);
     CPPUNIT_TEST(testCall2);
     CPPUNIT_TEST(testCallProx);
+    CPPUNIT_TEST(testLargeVector);
 
     CPPUNIT_TEST_SUITE_END();
 
@@ -45,6 +46,7 @@ private:
     void testCall();
     void testCall2();
     void testCallProx();
+    void testLargeVector();
 
 };
 
@@ -20,6 +20,7 @@
 
 #include "TestHuber.h"
 #include "HuberLoss.h"
+#include <cmath>
 
 
 CPPUNIT_TEST_SUITE_REGISTRATION(TestHuber);
@@ -74,6 +75,10 @@ void TestHuber::testHessian() {
     Matrix z(n, 1, ddata);
     int status = huber->hessianProduct(x, z, Hz);
     _ASSERT(ForBESUtils::is_status_ok(status));
+    for (size_t i = 0; i < n; i++) {
+        double Hz_expected = std::fabs(x[i]) <= delta ? z[i] / delta : 0.0;
+        _ASSERT_NUM_EQ(Hz_expected, Hz[i], 1e-12);
+    }
 
     double fstar;
     _ASSERT(!huber->category().defines_conjugate());
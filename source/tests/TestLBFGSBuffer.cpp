@@ -256,3 +256,46 @@ void TestLBFGSBuffer::testHessianEstimate() {
     delete buffer;
 
 }
+
+void TestLBFGSBuffer::testUpdateCompact() {
+    std::srand(static_cast<unsigned long> (1433291l));
+    size_t n = 50;
+    size_t mem = 4;
+
+    LBFGSBuffer * buffer = new LBFGSBuffer(n, mem);
+    LBFGSBuffer * compact = new LBFGSBuffer(n, mem, true);
+
+    Matrix q = MatrixFactory::MakeRandomMatrix(n, 1, -1.0, 2.0);
+    Matrix r(n, 1);
+    Matrix r_compact(n, 1);
+
+    for (size_t i = 0; i < 11; i++) {
+        if (i == 7) {
+            // the inner products must be rebuilt after a reset
+            _ASSERT_EQ(ForBESUtils::STATUS_OK, buffer->reset());
+            _ASSERT_EQ(ForBESUtils::STATUS_OK, compact->reset());
+        }
+        double H0 = buffer->hessian_estimate();
+        double H0_compact = compact->hessian_estimate();
+        _ASSERT_NUM_EQ(H0, H0_compact, 1e-10);
+
+        _ASSERT_EQ(ForBESUtils::STATUS_OK, buffer->update(&q, &r, H0));
+        _ASSERT_EQ(ForBESUtils::STATUS_OK, compact->update(&q, &r_compact, H0_compact));
+        for (size_t j = 0; j < n; j++) {
+            _ASSERT_NUM_EQ(r[j], r_compact[j], 1e-8);
+        }
+        for (size_t j = 0; j < buffer->get_current_mem(); j++) {
+            _ASSERT_NUM_EQ(buffer->get_alphas()->get(j), compact->get_alphas()->get(j), 1e-8);
+        }
+
+        // pairs with positive curvature, y = s + e
+        Matrix si = MatrixFactory::MakeRandomMatrix(n, 1, -1.0, 2.0);
+        Matrix yi = MatrixFactory::MakeRandomMatrix(n, 1, -0.1, 0.2);
+        yi += si;
+        buffer->push(&si, &yi);
+        compact->push(&si, &yi);
+    }
+
+    delete buffer;
+    delete compact;
+}
@@ -21,6 +21,7 @@ class TestLBFGSBuffer : public CPPUNIT_NS::TestFixture {
     CPPUNIT_TEST(testUpdate);
     CPPUNIT_TEST(testHessianEstimate);
     CPPUNIT_TEST(testTwoLoopQuadratic);
+    CPPUNIT_TEST(testUpdateCompact);
     
     CPPUNIT_TEST_SUITE_END();
 
@@ -36,6 +37,7 @@ private:
     void testUpdate();
     void testHessianEstimate();
     void testTwoLoopQuadratic();
+    void testUpdateCompact();
 
 };
 
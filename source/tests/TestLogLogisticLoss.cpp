@@ -20,6 +20,8 @@
 
 #include "TestLogLogisticLoss.h"
 #include "LogLogisticLoss.h"
+#include "MatrixFactory.h"
+#include <cmath>
 
 const static double DATA_X[] = {
         0.537667139546100,
@@ -137,3 +139,103 @@ void TestLogLogisticLoss::testCall() {
     delete logLogisticLoss;
 
 }
+
+void TestLogLogisticLoss::testFusedCall() {
+    const double mu = 0.8;
+    LogLogisticLoss loss(mu);
+    const size_t n = 25000;
+    Matrix x = MatrixFactory::MakeRandomMatrix(n, 1, -20.0, 40.0);
+    Matrix z = MatrixFactory::MakeRandomMatrix(n, 1, -1.0, 2.0);
+
+    double f, f_fused;
+    Matrix grad(n, 1);
+    Matrix Hz(n, 1);
+    _ASSERT_EQ(ForBESUtils::STATUS_OK, loss.call(x, f, grad));
+    _ASSERT_EQ(ForBESUtils::STATUS_OK, loss.hessianProduct(x, z, Hz));
+
+    Matrix grad_fused(n, 1);
+    Matrix Hz_fused(n, 1);
+    _ASSERT_EQ(ForBESUtils::STATUS_OK, loss.call(x, f_fused, grad_fused, z, Hz_fused));
+    _ASSERT_NUM_EQ(f, f_fused, 1e-9);
+    _ASSERT_EQ(grad, grad_fused);
+    _ASSERT_EQ(Hz, Hz_fused);
+
+    /* compare with the definition for moderate values of x */
+    for (size_t i = 0; i < n; i += 97) {
+        double si = std::exp(x[i]) / (1.0 + std::exp(x[i]));
+        _ASSERT_NUM_EQ(mu * (si - 1.0), grad[i], 1e-12);
+        _ASSERT_NUM_EQ(mu * si * (1.0 - si) * z[i], Hz[i], 1e-12);
+    }
+}
+
+void TestLogLogisticLoss::testExtremeValues() {
+    const double mu = 1.5;
+    LogLogisticLoss loss(mu);
+    const size_t n = 4;
+    const double xdata[n] = {-800.0, -40.0, 40.0, 800.0};
+    Matrix x(n, 1, xdata);
+    Matrix z(n, 1);
+    for (size_t i = 0; i < n; i++) {
+        z[i] = 1.0;
+    }
+
+    double f;
+    Matrix grad(n, 1);
+    Matrix Hz(n, 1);
+    _ASSERT_EQ(ForBESUtils::STATUS_OK, loss.call(x, f, grad, z, Hz));
+
+    /* -ln(sigma(x)) = -x + ln(1 + e^x) for x << 0 and e^-x for x >> 0 */
+    const double f_expected = mu * (800.0 + 40.0 + std::exp(-40.0) + std::exp(-40.0));
+    _ASSERT_NUM_EQ(f_expected, f, 1e-10);
+    _ASSERT_NUM_EQ(-mu, grad[0], 1e-15);
+    _ASSERT_NUM_EQ(-mu, grad[1], 1e-15);
+    _ASSERT_NUM_EQ(-mu * std::exp(-40.0), grad[2], 1e-30);
+    _ASSERT_EQ(0.0, grad[3]);
+    _ASSERT_NUM_EQ(mu * std::exp(-40.0), Hz[1], 1e-30);
+    _ASSERT_NUM_EQ(mu * std::exp(-40.0), Hz[2], 1e-30);
+    _ASSERT_EQ(0.0, Hz[0]);
+    _ASSERT_EQ(0.0, Hz[3]);
+}
+
+void TestLogLogisticLoss::testCurvatureCache() {
+    const double mu = 1.2;
+    const size_t n = 200;
+    LogLogisticLoss loss(mu);
+    LogLogisticLoss loss_ref(mu);
+    _ASSERT_NOT(loss.isCurvatureCacheEnabled());
+    loss.setCurvatureCache(true);
+    _ASSERT(loss.isCurvatureCacheEnabled());
+
+    Matrix x = MatrixFactory::MakeRandomMatrix(n, 1, -5.0, 10.0);
+    Matrix z = MatrixFactory::MakeRandomMatrix(n, 1, -1.0, 2.0);
+    Matrix grad(n, 1);
+    Matrix Hz(n, 1);
+    Matrix Hz_ref(n, 1);
+    double f;
+
+    /* no gradient computed yet */
+    _ASSERT_EQ(ForBESUtils::STATUS_OK, loss.hessianProduct(x, z, Hz));
+    _ASSERT_EQ(ForBESUtils::STATUS_OK, loss_ref.hessianProduct(x, z, Hz_ref));
+    _ASSERT_EQ(Hz_ref, Hz);
+
+    /* products from the cache, for several vectors z */
+    _ASSERT_EQ(ForBESUtils::STATUS_OK, loss.call(x, f, grad));
+    for (size_t rep = 0; rep < 5; rep++) {
+        z = MatrixFactory::MakeRandomMatrix(n, 1, -1.0, 2.0);
+        _ASSERT_EQ(ForBESUtils::STATUS_OK, loss.hessianProduct(x, z, Hz));
+        _ASSERT_EQ(ForBESUtils::STATUS_OK, loss_ref.hessianProduct(x, z, Hz_ref));
+        _ASSERT_EQ(Hz_ref, Hz);
+    }
+
+    /* x is modified in place: the cache must not be used */
+    x[7] += 1.0;
+    _ASSERT_EQ(ForBESUtils::STATUS_OK, loss.hessianProduct(x, z, Hz));
+    _ASSERT_EQ(ForBESUtils::STATUS_OK, loss_ref.hessianProduct(x, z, Hz_ref));
+    _ASSERT_EQ(Hz_ref, Hz);
+
+    loss.setCurvatureCache(false);
+    _ASSERT_EQ(ForBESUtils::STATUS_OK, loss.call(x, f, grad));
+    _ASSERT_EQ(ForBESUtils::STATUS_OK, loss.hessianProduct(x, z, Hz));
+    _ASSERT_EQ(Hz_ref, Hz);
+}
+
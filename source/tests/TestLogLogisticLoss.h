@@ -31,6 +31,9 @@ class TestLogLogisticLoss : public CPPUNIT_NS::TestFixture {
     CPPUNIT_TEST_SUITE(TestLogLogisticLoss);
 
     CPPUNIT_TEST(testCall);
+    CPPUNIT_TEST(testFusedCall);
+    CPPUNIT_TEST(testExtremeValues);
+    CPPUNIT_TEST(testCurvatureCache);
 
     CPPUNIT_TEST_SUITE_END();
 
@@ -42,6 +45,9 @@ public:
 
 private:
     void testCall();    
+    void testFusedCall();
+    void testExtremeValues();
+    void testCurvatureCache();
 
 };
 
@@ -150,6 +150,45 @@ void TestMatrix::testOpplusSparse() {
     }
 }
 
+void TestMatrix::testNumThreads() {
+    _ASSERT_EXCEPTION(Matrix::set_num_threads(-1), std::invalid_argument);
+    _ASSERT(Matrix::get_num_threads() >= 1);
+    Matrix::set_num_threads(2);
+    _ASSERT(Matrix::get_num_threads() >= 1);
+
+    size_t n = 300;
+    size_t m = 200;
+    Matrix X = MatrixFactory::MakeRandomMatrix(n, m, -1.0, 2.0);
+    Matrix Y(X);
+    _ASSERT_EQ(X, Y);
+
+    /* scalar multiplication */
+    Y *= 3.0;
+    _ASSERT_NOT(X == Y);
+    const double tol = 1e-12;
+    for (size_t k = 0; k < X.length(); k++) {
+        _ASSERT_NUM_EQ(3.0 * X[k], Y[k], tol);
+    }
+
+    /* C := 0.5 * C + 2 * X */
+    Matrix::add(Y, 2.0, X, 0.5);
+    for (size_t k = 0; k < X.length(); k++) {
+        _ASSERT_NUM_EQ(3.5 * X[k], Y[k], tol);
+    }
+
+    /* diagonal times dense */
+    Matrix D(n, n, Matrix::MATRIX_DIAGONAL);
+    for (size_t i = 0; i < n; i++) D[i] = i + 1.0;
+    Matrix DX = D * X;
+    for (size_t i = 0; i < n; i++) {
+        for (size_t j = 0; j < m; j++) {
+            _ASSERT_NUM_EQ((i + 1.0) * X.get(i, j), DX.get(i, j), tol);
+        }
+    }
+
+    Matrix::set_num_threads(0);
+}
+
 void TestMatrix::testQuadratic() {
     /* Test quadratic with diagonal matrices */
     Matrix *f;    
@@ -1066,6 +1105,205 @@ void TestMatrix::testSparseGetSet() {
 
 }
 
+void TestMatrix::test_MSD_spmv() {
+    size_t n = 40;
+    size_t m = 25;
+    size_t nrhs = 3;
+    size_t nnz = 120;
+    const double tol = 1e-10;
+    const double alpha = -1.5;
+    const double gamma = 0.7;
+
+    Matrix A = MatrixFactory::MakeRandomSparse(n, m, nnz, -1.0, 2.0);
+    Matrix A_dense(n, m);
+    for (size_t i = 0; i < n; i++) {
+        for (size_t j = 0; j < m; j++) {
+            A_dense.set(i, j, A.get(i, j));
+        }
+    }
+
+    /* C = gamma * C + alpha * A * B */
+    Matrix B = MatrixFactory::MakeRandomMatrix(m, nrhs, -1.0, 2.0);
+    Matrix C = MatrixFactory::MakeRandomMatrix(n, nrhs, -1.0, 2.0);
+    Matrix C_expected(C);
+    _ASSERT_EQ(ForBESUtils::STATUS_OK, Matrix::mult(C, alpha, A, B, gamma));
+    _ASSERT_EQ(ForBESUtils::STATUS_OK, Matrix::mult(C_expected, alpha, A_dense, B, gamma));
+    for (size_t k = 0; k < C.length(); k++) {
+        _ASSERT_NUM_EQ(C_expected[k], C[k], tol);
+    }
+
+    /* D = gamma * D + alpha * A' * E */
+    Matrix E = MatrixFactory::MakeRandomMatrix(n, nrhs, -1.0, 2.0);
+    Matrix D = MatrixFactory::MakeRandomMatrix(m, nrhs, -1.0, 2.0);
+    Matrix D_expected(D);
+    _ASSERT_EQ(ForBESUtils::STATUS_OK, Matrix::multTranspose(D, alpha, A, E, gamma));
+    _ASSERT_EQ(ForBESUtils::STATUS_OK, Matrix::multTranspose(D_expected, alpha, A_dense, E, gamma));
+    for (size_t k = 0; k < D.length(); k++) {
+        _ASSERT_NUM_EQ(D_expected[k], D[k], tol);
+    }
+
+    /* the cached storage is updated when A changes */
+    A.set(3, 4, 10.0);
+    A_dense.set(3, 4, 10.0);
+    _ASSERT_EQ(ForBESUtils::STATUS_OK, Matrix::mult(C, 1.0, A, B, 0.0));
+    _ASSERT_EQ(ForBESUtils::STATUS_OK, Matrix::mult(C_expected, 1.0, A_dense, B, 0.0));
+    for (size_t k = 0; k < C.length(); k++) {
+        _ASSERT_NUM_EQ(C_expected[k], C[k], tol);
+    }
+
+    /* A transposed: (A')' * E and A' * B */
+    A.transpose();
+    A_dense.transpose();
+    _ASSERT_EQ(ForBESUtils::STATUS_OK, Matrix::multTranspose(C, alpha, A, B, gamma));
+    _ASSERT_EQ(ForBESUtils::STATUS_OK, Matrix::multTranspose(C_expected, alpha, A_dense, B, gamma));
+    for (size_t k = 0; k < C.length(); k++) {
+        _ASSERT_NUM_EQ(C_expected[k], C[k], tol);
+    }
+    Matrix AtE = A * E;
+    Matrix AtE_expected = A_dense * E;
+    _ASSERT_EQ(AtE_expected, AtE);
+}
+
+void TestMatrix::test_MSD_spmvSymmetric() {
+    size_t n = 5;
+    Matrix A = MatrixFactory::MakeSparseSymmetric(n, 8);
+    A.set(0, 0, 2.0);
+    A.set(1, 0, -1.0);
+    A.set(3, 1, 4.0);
+    A.set(2, 2, 3.0);
+    A.set(4, 0, 0.5);
+    A.set(4, 4, 1.0);
+
+    Matrix x(n, 1);
+    for (size_t i = 0; i < n; i++) x[i] = i + 1.0;
+    Matrix y(n, 1);
+    for (size_t i = 0; i < n; i++) y[i] = 1.0;
+
+    /* y = 2 * y + A * x, where A(0,1) = A(1,0), A(1,3) = A(3,1), A(0,4) = A(4,0) */
+    double y_expected[] = {
+        2.0 + 2.0 * 1.0 - 1.0 * 2.0 + 0.5 * 5.0,
+        2.0 - 1.0 * 1.0 + 4.0 * 4.0,
+        2.0 + 3.0 * 3.0,
+        2.0 + 4.0 * 2.0,
+        2.0 + 0.5 * 1.0 + 1.0 * 5.0
+    };
+    _ASSERT_EQ(ForBESUtils::STATUS_OK, Matrix::mult(y, 1.0, A, x, 2.0));
+    for (size_t i = 0; i < n; i++) {
+        _ASSERT_NUM_EQ(y_expected[i], y[i], 1e-12);
+    }
+}
+
+void TestMatrix::test_MDS_mult() {
+    const size_t n = 6;
+    const size_t m = 7;
+    const size_t k = 5;
+    const double alpha = 1.5;
+    const double gamma = -0.5;
+
+    for (size_t variant = 0; variant < 4; variant++) {
+        bool transpose_D = (variant & 1) != 0;
+        bool transpose_S = (variant & 2) != 0;
+        Matrix D = transpose_D
+                ? MatrixFactory::MakeRandomMatrix(m, n, -1.0, 2.0)
+                : MatrixFactory::MakeRandomMatrix(n, m, -1.0, 2.0);
+        Matrix S = transpose_S
+                ? MatrixFactory::MakeRandomSparse(k, m, 12, -1.0, 2.0)
+                : MatrixFactory::MakeRandomSparse(m, k, 12, -1.0, 2.0);
+        if (transpose_D) D.transpose();
+        if (transpose_S) S.transpose();
+        Matrix C = MatrixFactory::MakeRandomMatrix(n, k, -1.0, 2.0);
+        Matrix C0 = C;
+
+        /* C = gamma * C + alpha * D * S */
+        _ASSERT_EQ(ForBESUtils::STATUS_OK, Matrix::mult(C, alpha, D, S, gamma));
+        for (size_t i = 0; i < n; i++) {
+            for (size_t j = 0; j < k; j++) {
+                double c = gamma * C0.get(i, j);
+                for (size_t l = 0; l < m; l++) {
+                    c += alpha * D.get(i, l) * S.get(l, j);
+                }
+                _ASSERT_NUM_EQ(c, C.get(i, j), 1e-10);
+            }
+        }
+    }
+
+    /* symmetric sparse matrix (only the lower triangle is stored) */
+    const size_t ns = 4;
+    Matrix S = MatrixFactory::MakeSparseSymmetric(ns, 4);
+    S.set(0, 0, 2.0);
+    S.set(2, 0, -1.0);
+    S.set(3, 1, 4.0);
+    S.set(2, 2, 3.0);
+    double data_S_full[] = {
+        2.0, 0.0, -1.0, 0.0,
+        0.0, 0.0, 0.0, 4.0,
+        -1.0, 0.0, 3.0, 0.0,
+        0.0, 4.0, 0.0, 0.0
+    };
+    Matrix S_full(ns, ns, data_S_full);
+    Matrix D = MatrixFactory::MakeRandomMatrix(n, ns, -1.0, 2.0);
+    Matrix C(n, ns);
+    _ASSERT_EQ(ForBESUtils::STATUS_OK, Matrix::mult(C, 1.0, D, S, 0.0));
+    Matrix C_expected = D * S_full;
+    for (size_t i = 0; i < n * ns; i++) {
+        _ASSERT_NUM_EQ(C_expected[i], C[i], 1e-10);
+    }
+}
+
+void TestMatrix::test_MD_multTranspose() {
+    const size_t n = 7;
+    const size_t m = 4;
+    const size_t k = 3;
+    const double alpha = -1.2;
+    const double gamma = 0.6;
+    const double tol = 1e-10;
+
+    for (size_t variant = 0; variant < 4; variant++) {
+        bool transpose_A = (variant & 1) != 0;
+        bool transpose_B = (variant & 2) != 0;
+        /* A is n-by-m and B is n-by-k, possibly stored transposed */
+        Matrix A = transpose_A
+                ? MatrixFactory::MakeRandomMatrix(m, n, -1.0, 2.0)
+                : MatrixFactory::MakeRandomMatrix(n, m, -1.0, 2.0);
+        Matrix B = transpose_B
+                ? MatrixFactory::MakeRandomMatrix(k, n, -1.0, 2.0)
+                : MatrixFactory::MakeRandomMatrix(n, k, -1.0, 2.0);
+        if (transpose_A) A.transpose();
+        if (transpose_B) B.transpose();
+        Matrix A0(A);
+        Matrix C = MatrixFactory::MakeRandomMatrix(m, k, -1.0, 2.0);
+        Matrix C0(C);
+
+        /* C = gamma * C + alpha * A' * B */
+        _ASSERT_EQ(ForBESUtils::STATUS_OK, Matrix::multTranspose(C, alpha, A, B, gamma));
+        for (size_t i = 0; i < m; i++) {
+            for (size_t j = 0; j < k; j++) {
+                double c = gamma * C0.get(i, j);
+                for (size_t l = 0; l < n; l++) {
+                    c += alpha * A.get(l, i) * B.get(l, j);
+                }
+                _ASSERT_NUM_EQ(c, C.get(i, j), tol);
+            }
+        }
+        /* A is left untouched */
+        _ASSERT_EQ(A0, A);
+    }
+
+    /* A' * A with the same object as both factors */
+    Matrix A = MatrixFactory::MakeRandomMatrix(n, m, -1.0, 2.0);
+    Matrix AtA(m, m);
+    _ASSERT_EQ(ForBESUtils::STATUS_OK, Matrix::multTranspose(AtA, 1.0, A, A, 0.0));
+    for (size_t i = 0; i < m; i++) {
+        for (size_t j = 0; j < m; j++) {
+            double c = 0.0;
+            for (size_t l = 0; l < n; l++) {
+                c += A.get(l, i) * A.get(l, j);
+            }
+            _ASSERT_NUM_EQ(c, AtA.get(i, j), tol);
+        }
+    }
+}
+
 void TestMatrix::test_MSD() {
 
     size_t n = 3;
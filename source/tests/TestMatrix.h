@@ -85,6 +85,7 @@ class TestMatrix : public CPPUNIT_NS::TestFixture {
     CPPUNIT_TEST(testOpplus);
     CPPUNIT_TEST(testOpplus2);
     CPPUNIT_TEST(testOpplusSparse);
+    CPPUNIT_TEST(testNumThreads);
 
 
     CPPUNIT_TEST(test_ADD1);
@@ -146,6 +147,10 @@ class TestMatrix : public CPPUNIT_NS::TestFixture {
     CPPUNIT_TEST(test_MSS);
     CPPUNIT_TEST(test_MSX);
     CPPUNIT_TEST(test_MSD);
+    CPPUNIT_TEST(test_MSD_spmv);
+    CPPUNIT_TEST(test_MSD_spmvSymmetric);
+    CPPUNIT_TEST(test_MDS_mult);
+    CPPUNIT_TEST(test_MD_multTranspose);
     CPPUNIT_TEST(test_MSDT);
     CPPUNIT_TEST(test_MSTDT);
     
@@ -169,6 +174,7 @@ private:
     void testOpplus();
     void testOpplus2();
     void testOpplusSparse();
+    void testNumThreads();
     void testQuadratic();
     void testQuadratic2();
     void testQuadratic3();
@@ -338,6 +344,10 @@ private:
     void test_MDX();
     void test_MSX();
     void test_MSD();
+    void test_MSD_spmv();
+    void test_MSD_spmvSymmetric();
+    void test_MDS_mult();
+    void test_MD_multTranspose();
     void test_MDS();
     void test_MSDT();
     void test_MSTDT();
@@ -20,7 +20,12 @@
 
 #include "TestMatrixFactory.h"
 #include "MatrixFactory.h"
+#include "MatrixWriter.h"
 #include <iostream>
+#include <string>
+#include <cstdio>
+#include <stdlib.h>
+#include <unistd.h>
 
 
 CPPUNIT_TEST_SUITE_REGISTRATION(TestMatrixFactory);
@@ -259,6 +264,415 @@ void TestMatrixFactory::testFailSafe() {
     _ASSERT_EXCEPTION(A = MatrixFactory::MakeRandomSparse(10, 10, 101, 0.0, 1.0), std::invalid_argument);
 }
 
+/* writes a matrix in binary format into a temporary file and returns its path */
+static std::string write_binary(Matrix& A) {
+    char path[] = "/tmp/forbes_matrix_XXXXXX";
+    int fd = mkstemp(path);
+    CPPUNIT_ASSERT_MESSAGE("Cannot create temporary file", fd >= 0);
+    FILE *fp = fdopen(fd, "wb");
+    MatrixWriter writer(A);
+    writer.setWriteFormat(MatrixWriter::BINARY);
+    writer.write(fp);
+    _ASSERT_EQ(0, fclose(fp));
+    return std::string(path);
+}
+
+void TestMatrixFactory::testBinaryDense() {
+    const size_t n = 7;
+    const size_t m = 4;
+    Matrix A[5];
+    A[0] = MatrixFactory::MakeRandomMatrix(n, m, -1.0, 2.0, Matrix::MATRIX_DENSE);
+    A[1] = MatrixFactory::MakeRandomMatrix(n, m, -1.0, 2.0, Matrix::MATRIX_DENSE);
+    A[1].transpose();
+    A[2] = MatrixFactory::MakeRandomMatrix(n, n, -1.0, 2.0, Matrix::MATRIX_DIAGONAL);
+    A[3] = MatrixFactory::MakeRandomMatrix(n, n, -1.0, 2.0, Matrix::MATRIX_SYMMETRIC);
+    A[4] = MatrixFactory::MakeRandomMatrix(n, n, -1.0, 2.0, Matrix::MATRIX_LOWERTR);
+
+    for (size_t k = 0; k < 5; k++) {
+        std::string path = write_binary(A[k]);
+
+        Matrix B = MatrixFactory::MapBinary(path.c_str());
+        _ASSERT(B.isMapped());
+        _ASSERT_NOT(A[k].isMapped());
+        _ASSERT_EQ(A[k].getType(), B.getType());
+        _ASSERT_EQ(A[k].getNrows(), B.getNrows());
+        _ASSERT_EQ(A[k].getNcols(), B.getNcols());
+        _ASSERT_EQ(A[k], B);
+
+        /* hard copies own their data */
+        Matrix C(B);
+        _ASSERT_NOT(C.isMapped());
+        _ASSERT_EQ(A[k], C);
+
+        /* products with mapped matrices */
+        if (A[k].getType() != Matrix::MATRIX_LOWERTR) {
+            Matrix x = MatrixFactory::MakeRandomMatrix(A[k].getNcols(), 1, -1.0, 2.0, Matrix::MATRIX_DENSE);
+            _ASSERT_EQ(A[k] * x, B * x);
+        }
+
+        FILE *fp = fopen(path.c_str(), "rb");
+        Matrix D = MatrixFactory::ReadBinary(fp);
+        _ASSERT_EQ(0, fclose(fp));
+        _ASSERT_NOT(D.isMapped());
+        _ASSERT_EQ(A[k], D);
+
+        /* assignment releases the mapping */
+        B = C;
+        _ASSERT_NOT(B.isMapped());
+        _ASSERT_EQ(A[k], B);
+
+        _ASSERT_EQ(0, unlink(path.c_str()));
+    }
+}
+
+void TestMatrixFactory::testBinarySparse() {
+    const size_t n = 50;
+    const size_t m = 30;
+    const size_t nnz = 120;
+    Matrix A = MatrixFactory::MakeRandomSparse(n, m, nnz, -1.0, 2.0);
+    std::string path = write_binary(A);
+
+    Matrix B = MatrixFactory::MapBinary(path.c_str());
+    _ASSERT(B.isMapped());
+    _ASSERT_EQ(Matrix::MATRIX_SPARSE, B.getType());
+    _ASSERT_EQ(A, B);
+
+    Matrix x = MatrixFactory::MakeRandomMatrix(m, 1, -1.0, 2.0, Matrix::MATRIX_DENSE);
+    _ASSERT_EQ(A * x, B * x);
+
+    /* no new nonzeros can be added to a memory-mapped sparse matrix */
+    _ASSERT_EXCEPTION(B.set(0, 0, 1.0), std::logic_error);
+
+    /* the values of a writable mapped sparse matrix may be modified in place... */
+    Matrix W = MatrixFactory::MapBinary(path.c_str(), true);
+    W *= 2.0;
+    _ASSERT(W.isMapped());
+    Matrix A2(A);
+    A2 *= 2.0;
+    _ASSERT_EQ(A2, W);
+    _ASSERT_EQ(A2 * x, W * x);
+
+    /* ...but its structure cannot be replaced by the result of an operation */
+    Matrix S = MatrixFactory::MakeRandomSparse(n, m, 10, -1.0, 2.0);
+    _ASSERT_EXCEPTION(Matrix::add(W, 1.0, S, 1.0), std::logic_error);
+    _ASSERT_EXCEPTION(W += S, std::logic_error);
+    Matrix I_sparse = MatrixFactory::MakeSparse(m, m, m, Matrix::SPARSE_UNSYMMETRIC);
+    for (size_t i = 0; i < m; i++) {
+        I_sparse.set(i, i, 1.0);
+    }
+    _ASSERT_EXCEPTION(Matrix::mult(W, 1.0, A, I_sparse, 0.0), std::logic_error);
+    Matrix At(A);
+    At.transpose();
+    _ASSERT_EXCEPTION(Matrix::multTranspose(W, 1.0, At, I_sparse, 0.0), std::logic_error);
+    _ASSERT(W.isMapped());
+    _ASSERT_EQ(A2, W);
+    _ASSERT_EQ(n, At.getNcols());
+
+    FILE *fp = fopen(path.c_str(), "rb");
+    Matrix C = MatrixFactory::ReadBinary(fp);
+    _ASSERT_EQ(0, fclose(fp));
+    _ASSERT_EQ(A, C);
+    _ASSERT_EQ(0, unlink(path.c_str()));
+
+    /* transposed sparse matrix */
+    A.transpose();
+    path = write_binary(A);
+    Matrix Bt = MatrixFactory::MapBinary(path.c_str());
+    _ASSERT_EQ(A.getNrows(), Bt.getNrows());
+    _ASSERT_EQ(A.getNcols(), Bt.getNcols());
+    _ASSERT_EQ(A, Bt);
+    Matrix y = MatrixFactory::MakeRandomMatrix(n, 1, -1.0, 2.0, Matrix::MATRIX_DENSE);
+    _ASSERT_EQ(A * y, Bt * y);
+    _ASSERT_EQ(0, unlink(path.c_str()));
+
+    /* symmetric sparse matrix */
+    Matrix Sym = MatrixFactory::MakeSparse(m, m, 2 * m, Matrix::SPARSE_SYMMETRIC_L);
+    for (size_t i = 0; i < m; i++) {
+        Sym.set(i, i, 2.0 + i);
+        if (i + 3 < m) {
+            Sym.set(i, i + 3, -1.0);
+        }
+    }
+    path = write_binary(Sym);
+    Matrix Bs = MatrixFactory::MapBinary(path.c_str());
+    _ASSERT(Bs.isSymmetric());
+    _ASSERT_EQ(Sym, Bs);
+    _ASSERT_EQ(Sym * x, Bs * x);
+    _ASSERT_EQ(0, unlink(path.c_str()));
+}
+
+/* overwrites the header of a binary matrix file */
+static void write_binary_header(const std::string& path, const MatrixBinaryHeader& header) {
+    FILE *fp = fopen(path.c_str(), "r+b");
+    _ASSERT(fp != NULL);
+    _ASSERT_EQ(static_cast<size_t> (1), fwrite(&header, sizeof (header), 1, fp));
+    _ASSERT_EQ(0, fclose(fp));
+}
+
+static MatrixBinaryHeader read_binary_header(const std::string& path) {
+    MatrixBinaryHeader header;
+    FILE *fp = fopen(path.c_str(), "rb");
+    _ASSERT(fp != NULL);
+    _ASSERT_EQ(static_cast<size_t> (1), fread(&header, sizeof (header), 1, fp));
+    _ASSERT_EQ(0, fclose(fp));
+    return header;
+}
+
+void TestMatrixFactory::testBinaryFailSafe() {
+    Matrix A;
+    _ASSERT_EXCEPTION(A = MatrixFactory::MapBinary("matrices/no_such_file"), std::runtime_error);
+    _ASSERT_EXCEPTION(A = MatrixFactory::MapBinary("matrices/sparse1.mx"), std::invalid_argument);
+
+    /* truncated file */
+    Matrix B = MatrixFactory::MakeRandomMatrix(10, 10, -1.0, 2.0, Matrix::MATRIX_DENSE);
+    std::string path = write_binary(B);
+    _ASSERT_EQ(0, truncate(path.c_str(), sizeof (MatrixBinaryHeader) + 99 * sizeof (double)));
+    _ASSERT_EXCEPTION(A = MatrixFactory::MapBinary(path.c_str()), std::invalid_argument);
+    FILE *fp = fopen(path.c_str(), "rb");
+    _ASSERT_EXCEPTION(A = MatrixFactory::ReadBinary(fp), std::runtime_error);
+    _ASSERT_EQ(0, fclose(fp));
+    _ASSERT_EQ(0, unlink(path.c_str()));
+
+    /* dimensions whose product overflows */
+    path = write_binary(B);
+    MatrixBinaryHeader header = read_binary_header(path);
+    header.nrows = static_cast<uint64_t> (1) << 33;
+    header.ncols = static_cast<uint64_t> (1) << 33;
+    write_binary_header(path, header);
+    _ASSERT_EXCEPTION(A = MatrixFactory::MapBinary(path.c_str()), std::invalid_argument);
+    _ASSERT_EQ(0, unlink(path.c_str()));
+
+    /* more nonzeros than entries */
+    const size_t n = 10;
+    const size_t nnz = 20;
+    Matrix S = MatrixFactory::MakeSparse(n, n, nnz, Matrix::SPARSE_UNSYMMETRIC);
+    for (size_t k = 0; k < nnz; k++) {
+        S.set(k % n, (3 * k + k / n) % n, 1.0 + k);
+    }
+    path = write_binary(S);
+    MatrixBinaryHeader sparse_header = read_binary_header(path);
+    header = sparse_header;
+    header.nrows = 1;
+    header.ncols = 1;
+    write_binary_header(path, header);
+    _ASSERT_EXCEPTION(A = MatrixFactory::MapBinary(path.c_str()), std::invalid_argument);
+    write_binary_header(path, sparse_header);
+    A = MatrixFactory::MapBinary(path.c_str());
+    _ASSERT_EQ(S, A);
+    A = B;
+
+    /* row index out of range */
+    fp = fopen(path.c_str(), "r+b");
+    _ASSERT(fp != NULL);
+    _ASSERT_EQ(0, fseek(fp, sizeof (MatrixBinaryHeader) + sparse_header.length * sizeof (double), SEEK_SET));
+    int bad_index = static_cast<int> (n);
+    _ASSERT_EQ(static_cast<size_t> (1), fwrite(&bad_index, sizeof (int), 1, fp));
+    _ASSERT_EQ(0, fclose(fp));
+    _ASSERT_EXCEPTION(A = MatrixFactory::MapBinary(path.c_str()), std::invalid_argument);
+    fp = fopen(path.c_str(), "rb");
+    _ASSERT_EXCEPTION(A = MatrixFactory::ReadBinary(fp), std::invalid_argument);
+    _ASSERT_EQ(0, fclose(fp));
+    _ASSERT_EQ(0, unlink(path.c_str()));
+}
+
+/* reads a matrix from a Matrix Market string */
+static Matrix read_matrix_market(const char* text) {
+    FILE *fp = tmpfile();
+    fputs(text, fp);
+    rewind(fp);
+    Matrix A;
+    try {
+        A = MatrixFactory::ReadMatrixMarket(fp);
+    } catch (...) {
+        fclose(fp);
+        throw;
+    }
+    fclose(fp);
+    return A;
+}
 
+void TestMatrixFactory::testMatrixMarketCoordinate() {
+    Matrix A = read_matrix_market(
+            "%%MatrixMarket matrix coordinate real general\n"
+            "% a comment\n"
+            "%\n"
+            "  6 9 7\n"
+            "1 1 3.8\n"
+            "1 2 2.20\n"
+            "2 3 -1.18\n"
+            "\n"
+            "4 4 5.5\n"
+            "4 6 1.23e0\n"
+            "6 2 0.95\r\n"
+            "6 6 2.68");
+    Matrix A_correct = MatrixFactory::MakeSparse(6, 9, 7, Matrix::SPARSE_UNSYMMETRIC);
+    A_correct.set(0, 0, 3.8);
+    A_correct.set(0, 1, 2.20);
+    A_correct.set(1, 2, -1.18);
+    A_correct.set(3, 3, 5.5);
+    A_correct.set(3, 5, 1.23);
+    A_correct.set(5, 1, 0.95);
+    A_correct.set(5, 5, 2.68);
+    _ASSERT_EQ(Matrix::MATRIX_SPARSE, A.getType());
+    _ASSERT_EQ(A_correct, A);
+
+    /* pattern */
+    Matrix P = read_matrix_market(
+            "%%MatrixMarket matrix coordinate pattern general\n"
+            "3 4 2\n"
+            "1 4\n"
+            "3 2\n");
+    _ASSERT_NUM_EQ(1.0, P.get(0, 3), 1e-12);
+    _ASSERT_NUM_EQ(1.0, P.get(2, 1), 1e-12);
+    _ASSERT_NUM_EQ(0.0, P.get(1, 1), 1e-12);
+
+    /* symmetric: the lower triangular part is given */
+    Matrix S = read_matrix_market(
+            "%%MatrixMarket matrix coordinate real symmetric\n"
+            "3 3 4\n"
+            "1 1 4.0\n"
+            "2 1 -1.0\n"
+            "3 2 2.0\n"
+            "3 3 5.0\n");
+    _ASSERT(S.isSymmetric());
+    Matrix x(3, 1);
+    x[0] = 1.0;
+    x[1] = 2.0;
+    x[2] = 3.0;
+    Matrix Sx = S * x;
+    _ASSERT_NUM_EQ(2.0, Sx[0], 1e-12);
+    _ASSERT_NUM_EQ(5.0, Sx[1], 1e-12);
+    _ASSERT_NUM_EQ(19.0, Sx[2], 1e-12);
+
+    /* skew-symmetric matrices are expanded */
+    Matrix K = read_matrix_market(
+            "%%MatrixMarket matrix coordinate integer skew-symmetric\n"
+            "3 3 2\n"
+            "2 1 3\n"
+            "3 1 -1\n");
+    _ASSERT_NUM_EQ(3.0, K.get(1, 0), 1e-12);
+    _ASSERT_NUM_EQ(-3.0, K.get(0, 1), 1e-12);
+    _ASSERT_NUM_EQ(1.0, K.get(0, 2), 1e-12);
+
+    /* invalid files */
+    _ASSERT_EXCEPTION(read_matrix_market("3 3 1\n1 1 1.0\n"), std::invalid_argument);
+    _ASSERT_EXCEPTION(read_matrix_market(
+            "%%MatrixMarket matrix coordinate complex general\n1 1 1\n1 1 1.0 2.0\n"),
+            std::invalid_argument);
+    _ASSERT_EXCEPTION(read_matrix_market(
+            "%%MatrixMarket matrix coordinate real general\n2 2 2\n1 1 1.0\n"),
+            std::invalid_argument);
+    _ASSERT_EXCEPTION(read_matrix_market(
+            "%%MatrixMarket matrix coordinate real general\n2 2 1\n3 1 1.0\n"),
+            std::invalid_argument);
+    _ASSERT_EXCEPTION(read_matrix_market(
+            "%%MatrixMarket matrix coordinate real general\n2 2 2\n1 1\n2 2 1.0\n"),
+            std::invalid_argument);
+}
 
+void TestMatrixFactory::testMatrixMarketArray() {
+    Matrix A = read_matrix_market(
+            "%%MatrixMarket matrix array real general\n"
+            "% column-major\n"
+            "2 3\n"
+            "1\n2\n3\n4\n5\n6\n");
+    _ASSERT_EQ(Matrix::MATRIX_DENSE, A.getType());
+    _ASSERT_EQ(static_cast<size_t> (2), A.getNrows());
+    _ASSERT_EQ(static_cast<size_t> (3), A.getNcols());
+    for (size_t j = 0; j < 3; j++) {
+        for (size_t i = 0; i < 2; i++) {
+            _ASSERT_NUM_EQ(1.0 + i + 2 * j, A.get(i, j), 1e-12);
+        }
+    }
+
+    Matrix S = read_matrix_market(
+            "%%MatrixMarket matrix array real symmetric\n"
+            "3 3\n"
+            "1\n2\n3\n4\n5\n6\n");
+    _ASSERT_EQ(Matrix::MATRIX_SYMMETRIC, S.getType());
+    _ASSERT_NUM_EQ(2.0, S.get(0, 1), 1e-12);
+    _ASSERT_NUM_EQ(2.0, S.get(1, 0), 1e-12);
+    _ASSERT_NUM_EQ(5.0, S.get(2, 1), 1e-12);
+    _ASSERT_NUM_EQ(6.0, S.get(2, 2), 1e-12);
+
+    Matrix K = read_matrix_market(
+            "%%MatrixMarket matrix array real skew-symmetric\n"
+            "3 3\n"
+            "1\n2\n3\n");
+    _ASSERT_EQ(Matrix::MATRIX_DENSE, K.getType());
+    _ASSERT_NUM_EQ(0.0, K.get(0, 0), 1e-12);
+    _ASSERT_NUM_EQ(1.0, K.get(1, 0), 1e-12);
+    _ASSERT_NUM_EQ(-1.0, K.get(0, 1), 1e-12);
+    _ASSERT_NUM_EQ(3.0, K.get(2, 1), 1e-12);
+    _ASSERT_NUM_EQ(-3.0, K.get(1, 2), 1e-12);
+
+    _ASSERT_EXCEPTION(read_matrix_market(
+            "%%MatrixMarket matrix array real general\n2 2\n1\n2\n3\n"),
+            std::invalid_argument);
+    _ASSERT_EXCEPTION(read_matrix_market(
+            "%%MatrixMarket matrix array real general\n1 2\n1\nabc\n"),
+            std::invalid_argument);
+}
 
+void TestMatrixFactory::testMatrixMarketWriter() {
+    Matrix A[5];
+    A[0] = MatrixFactory::MakeRandomMatrix(7, 4, -1.0, 2.0, Matrix::MATRIX_DENSE);
+    A[1] = MatrixFactory::MakeRandomMatrix(5, 5, -1.0, 2.0, Matrix::MATRIX_SYMMETRIC);
+    A[2] = MatrixFactory::MakeRandomMatrix(5, 5, -1.0, 2.0, Matrix::MATRIX_LOWERTR);
+    A[3] = MatrixFactory::MakeRandomSparse(20, 10, 30, -1.0, 2.0);
+    A[4] = MatrixFactory::MakeRandomMatrix(6, 6, -1.0, 2.0, Matrix::MATRIX_DIAGONAL);
+
+    for (size_t k = 0; k < 5; k++) {
+        FILE *fp = tmpfile();
+        MatrixWriter writer(A[k]);
+        writer.setWriteFormat(MatrixWriter::MATRIX_MARKET);
+        writer.write(fp);
+        rewind(fp);
+        Matrix B = MatrixFactory::ReadMatrixMarket(fp);
+        fclose(fp);
+        _ASSERT_EQ(A[k].getNrows(), B.getNrows());
+        _ASSERT_EQ(A[k].getNcols(), B.getNcols());
+        for (size_t i = 0; i < A[k].getNrows(); i++) {
+            for (size_t j = 0; j < A[k].getNcols(); j++) {
+                if (B.getType() == Matrix::MATRIX_SPARSE && B.isSymmetric() && i < j) {
+                    continue; /* only the lower triangular part is stored */
+                }
+                _ASSERT_EQ(A[k].get(i, j), B.get(i, j));
+            }
+        }
+    }
+    _ASSERT_EQ(Matrix::MATRIX_SPARSE, A[3].getType());
+}
+
+void TestMatrixFactory::testMatrixMarketLarge() {
+    /* large enough to be split into several chunks */
+    const size_t n = 3000;
+    const size_t m = 20;
+    const size_t nnz = n * m;
+    FILE *fp = tmpfile();
+    fprintf(fp, "%%%%MatrixMarket matrix coordinate real general\n");
+    fprintf(fp, "%lu %lu %lu\n", n, m, nnz);
+    Matrix row_sums(n, 1);
+    for (size_t j = 0; j < m; j++) {
+        for (size_t i = 0; i < n; i++) {
+            double v = 0.001 * static_cast<double> (i) - 0.5 * static_cast<double> (j);
+            fprintf(fp, "%lu %lu %.17g\n", i + 1, j + 1, v);
+            row_sums[i] += v;
+        }
+    }
+    _ASSERT(ftell(fp) > 2 * MATRIX_MARKET_CHUNK_SIZE);
+    rewind(fp);
+    Matrix A = MatrixFactory::ReadMatrixMarket(fp);
+    fclose(fp);
+
+    _ASSERT_EQ(n, A.getNrows());
+    _ASSERT_EQ(m, A.getNcols());
+    Matrix ones(m, 1);
+    for (size_t j = 0; j < m; j++) {
+        ones[j] = 1.0;
+    }
+    Matrix Ax = A * ones;
+    for (size_t i = 0; i < n; i++) {
+        _ASSERT_NUM_EQ(row_sums[i], Ax[i], 1e-10);
+    }
+}
@@ -27,6 +27,13 @@ class TestMatrixFactory : public CPPUNIT_NS::TestFixture {
     CPPUNIT_TEST(testShallow3);
     CPPUNIT_TEST(testShallow4);
     CPPUNIT_TEST(testFailSafe);
+    CPPUNIT_TEST(testBinaryDense);
+    CPPUNIT_TEST(testBinarySparse);
+    CPPUNIT_TEST(testBinaryFailSafe);
+    CPPUNIT_TEST(testMatrixMarketCoordinate);
+    CPPUNIT_TEST(testMatrixMarketArray);
+    CPPUNIT_TEST(testMatrixMarketWriter);
+    CPPUNIT_TEST(testMatrixMarketLarge);
     
     CPPUNIT_TEST_SUITE_END();
 
@@ -48,6 +55,13 @@ private:
     void testShallow3();
     void testShallow4();
     void testFailSafe();
+    void testBinaryDense();
+    void testBinarySparse();
+    void testBinaryFailSafe();
+    void testMatrixMarketCoordinate();
+    void testMatrixMarketArray();
+    void testMatrixMarketWriter();
+    void testMatrixMarketLarge();
 
 };
 
@@ -10,6 +10,49 @@
 
 CPPUNIT_TEST_SUITE_REGISTRATION(TestMatrixOperator);
 
+/*
+ * Compares the block products T(X) and T*(W) with the products of T and T*
+ * with the individual columns of X and W.
+ */
+static void checkBlockProducts(LinearOperator& op, size_t n, size_t m, size_t k, double tol) {
+    const double alpha = 0.7;
+    const double gamma = -1.3;
+    Matrix X = MatrixFactory::MakeRandomMatrix(n, k, -1.0, 2.0);
+    Matrix W = MatrixFactory::MakeRandomMatrix(m, k, -1.0, 2.0);
+    Matrix Y0 = MatrixFactory::MakeRandomMatrix(m, k, -1.0, 2.0);
+    Matrix Z0 = MatrixFactory::MakeRandomMatrix(n, k, -1.0, 2.0);
+    Matrix Y(Y0);
+    Matrix Z(Z0);
+    _ASSERT_EQ(ForBESUtils::STATUS_OK, op.call(Y, alpha, X, gamma));
+    _ASSERT_EQ(ForBESUtils::STATUS_OK, op.callAdjoint(Z, alpha, W, gamma));
+    Matrix TX = op.call(X);
+    _ASSERT_EQ(m, TX.getNrows());
+    _ASSERT_EQ(k, TX.getNcols());
+    for (size_t c = 0; c < k; c++) {
+        Matrix x(n, 1);
+        Matrix w(m, 1);
+        Matrix y(m, 1);
+        Matrix z(n, 1);
+        for (size_t i = 0; i < n; i++) {
+            x[i] = X.get(i, c);
+            z[i] = Z0.get(i, c);
+        }
+        for (size_t i = 0; i < m; i++) {
+            w[i] = W.get(i, c);
+            y[i] = Y0.get(i, c);
+        }
+        _ASSERT_EQ(ForBESUtils::STATUS_OK, op.call(y, alpha, x, gamma));
+        _ASSERT_EQ(ForBESUtils::STATUS_OK, op.callAdjoint(z, alpha, w, gamma));
+        for (size_t i = 0; i < m; i++) {
+            _ASSERT_NUM_EQ(y[i], Y.get(i, c), tol);
+            _ASSERT_NUM_EQ((y[i] - gamma * Y0.get(i, c)) / alpha, TX.get(i, c), tol);
+        }
+        for (size_t i = 0; i < n; i++) {
+            _ASSERT_NUM_EQ(z[i], Z.get(i, c), tol);
+        }
+    }
+}
+
 TestMatrixOperator::TestMatrixOperator() {
 }
 
@@ -105,3 +148,63 @@ void TestMatrixOperator::testCallAdjoint() {
     delete T;
 }
 
+void TestMatrixOperator::testSparseDualStorage() {
+    size_t n = 150;
+    size_t m = 120;
+    size_t nnz = 11000;
+    Matrix A = MatrixFactory::MakeRandomSparse(n, m, nnz, -1.0, 2.0);
+    Matrix A_copy(A);
+    _ASSERT_NOT(A_copy.isDualStorage());
+
+    MatrixOperator op(A, true);
+    MatrixOperator op_single(A_copy);
+    _ASSERT(A.isDualStorage());
+
+    Matrix x = MatrixFactory::MakeRandomMatrix(m, 1, -1.0, 2.0);
+    Matrix y = MatrixFactory::MakeRandomMatrix(n, 1, -1.0, 2.0);
+    Matrix y_single(y);
+    Matrix z = MatrixFactory::MakeRandomMatrix(m, 1, -1.0, 2.0);
+    Matrix z_single(z);
+
+    double alpha = -0.8;
+    double gamma = 1.3;
+    Matrix::set_num_threads(2);
+    _ASSERT_EQ(ForBESUtils::STATUS_OK, op.call(y, alpha, x, gamma));
+    _ASSERT_EQ(ForBESUtils::STATUS_OK, op_single.call(y_single, alpha, x, gamma));
+    _ASSERT_EQ(ForBESUtils::STATUS_OK, op.callAdjoint(z, alpha, y, gamma));
+    _ASSERT_EQ(ForBESUtils::STATUS_OK, op_single.callAdjoint(z_single, alpha, y, gamma));
+    Matrix::set_num_threads(0);
+
+    const double tol = 1e-10;
+    for (size_t i = 0; i < n; i++) {
+        _ASSERT_NUM_EQ(y_single[i], y[i], tol);
+    }
+    for (size_t j = 0; j < m; j++) {
+        _ASSERT_NUM_EQ(z_single[j], z[j], tol);
+    }
+}
+
+void TestMatrixOperator::testBlock() {
+    const size_t n = 40;
+    const size_t m = 30;
+    const size_t k = 5;
+    const double tol = 1e-10;
+
+    Matrix A = MatrixFactory::MakeRandomMatrix(m, n, -1.0, 2.0, Matrix::MATRIX_DENSE);
+    MatrixOperator op_dense(A);
+    checkBlockProducts(op_dense, n, m, k, tol);
+
+    Matrix S = MatrixFactory::MakeRandomSparse(m, n, 200, -1.0, 2.0);
+    MatrixOperator op_sparse(S);
+    checkBlockProducts(op_sparse, n, m, k, tol);
+
+    Matrix S_dual(S);
+    MatrixOperator op_dual(S_dual, true);
+    Matrix::set_num_threads(2);
+    checkBlockProducts(op_dual, n, m, k, tol);
+    Matrix::set_num_threads(0);
+
+    Matrix Q = MatrixFactory::MakeRandomMatrix(n, n, -1.0, 2.0, Matrix::MATRIX_SYMMETRIC);
+    MatrixOperator op_symmetric(Q);
+    checkBlockProducts(op_symmetric, n, n, k, tol);
+}
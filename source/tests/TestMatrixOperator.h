@@ -23,6 +23,8 @@ class TestMatrixOperator : public CPPUNIT_NS::TestFixture {
     CPPUNIT_TEST(testCall2);
     CPPUNIT_TEST(testCallId);
     CPPUNIT_TEST(testCallAdjoint);
+    CPPUNIT_TEST(testSparseDualStorage);
+    CPPUNIT_TEST(testBlock);
 
     CPPUNIT_TEST_SUITE_END();
 
@@ -37,6 +39,8 @@ private:
     void testCall2();
     void testCallId();
     void testCallAdjoint();
+    void testSparseDualStorage();
+    void testBlock();
     
 };
 
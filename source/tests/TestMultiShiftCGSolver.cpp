@@ -0,0 +1,143 @@
+/*
+ * File:   TestMultiShiftCGSolver.cpp
+ *
+ * ForBES is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *  
+ * ForBES is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with ForBES. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "TestMultiShiftCGSolver.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TestMultiShiftCGSolver);
+
+TestMultiShiftCGSolver::TestMultiShiftCGSolver() {
+}
+
+TestMultiShiftCGSolver::~TestMultiShiftCGSolver() {
+}
+
+void TestMultiShiftCGSolver::setUp() {
+}
+
+void TestMultiShiftCGSolver::tearDown() {
+}
+
+/* symmetric positive definite n-by-n matrix */
+static Matrix spd_matrix(size_t n) {
+    Matrix A = MatrixFactory::MakeRandomMatrix(n, n, 0.0, 1.0, Matrix::MATRIX_SYMMETRIC);
+    Matrix Y = MatrixFactory::MakeIdentity(n, 0.5 * n);
+    A += Y;
+    return A;
+}
+
+void TestMultiShiftCGSolver::testSolve() {
+    const size_t n = 150;
+    const double tolerance = 1e-9;
+    Matrix A = spd_matrix(n);
+    MatrixOperator Aop(A);
+    Matrix b = MatrixFactory::MakeRandomMatrix(n, 1, -1.0, 2.0);
+
+    std::vector<double> shifts;
+    shifts.push_back(0.5);
+    shifts.push_back(-1.0);
+    shifts.push_back(0.0);
+    shifts.push_back(10.0);
+    shifts.push_back(300.0);
+    MultiShiftCGSolver solver(Aop, shifts, tolerance, n);
+    _ASSERT_EQ(shifts.size(), solver.shifts().size());
+
+    Matrix X;
+    _ASSERT_EQ(ForBESUtils::STATUS_OK, solver.solve(b, X));
+    _ASSERT_EQ(n, X.getNrows());
+    _ASSERT_EQ(shifts.size(), X.getNcols());
+    _ASSERT(solver.last_error() < tolerance);
+    _ASSERT(solver.last_num_iter() > 0);
+
+    for (size_t i = 0; i < shifts.size(); i++) {
+        _ASSERT(solver.last_error(i) < tolerance);
+        _ASSERT(solver.last_num_iter(i) <= solver.last_num_iter());
+        Matrix x(n, 1);
+        for (size_t k = 0; k < n; k++) x[k] = X.get(k, i);
+        Matrix r = A * x;
+        for (size_t k = 0; k < n; k++) {
+            _ASSERT_NUM_EQ(b[k], r[k] + shifts[i] * x[k], 1e-7);
+        }
+    }
+    /* larger shifts give better conditioned systems */
+    _ASSERT(solver.last_num_iter(4) < solver.last_num_iter(1));
+
+    /* the solver can be reused */
+    Matrix b2 = MatrixFactory::MakeRandomMatrix(n, 1, -1.0, 2.0);
+    _ASSERT_EQ(ForBESUtils::STATUS_OK, solver.solve(b2, X));
+    Matrix x0(n, 1);
+    for (size_t k = 0; k < n; k++) x0[k] = X.get(k, 0);
+    Matrix r = A * x0;
+    for (size_t k = 0; k < n; k++) {
+        _ASSERT_NUM_EQ(b2[k], r[k] + shifts[0] * x0[k], 1e-7);
+    }
+}
+
+void TestMultiShiftCGSolver::testMatchesCG() {
+    const size_t n = 80;
+    const double tolerance = 1e-10;
+    Matrix A = spd_matrix(n);
+    MatrixOperator Aop(A);
+    Matrix b = MatrixFactory::MakeRandomMatrix(n, 1, -1.0, 2.0);
+    std::vector<double> shifts;
+    shifts.push_back(2.0);
+    shifts.push_back(0.25);
+    shifts.push_back(40.0);
+    MultiShiftCGSolver solver(Aop, shifts, tolerance, n);
+    Matrix X;
+    _ASSERT_EQ(ForBESUtils::STATUS_OK, solver.solve(b, X));
+
+    for (size_t i = 0; i < shifts.size(); i++) {
+        Matrix A_shifted(A);
+        Matrix Eye = MatrixFactory::MakeIdentity(n, shifts[i]);
+        A_shifted += Eye;
+        MatrixOperator op(A_shifted);
+        CGSolver cg(op);
+        Matrix x(n, 1);
+        _ASSERT_EQ(ForBESUtils::STATUS_OK, cg.solve(b, x, tolerance, x));
+        for (size_t k = 0; k < n; k++) {
+            _ASSERT_NUM_EQ(x[k], X.get(k, i), 1e-8);
+        }
+    }
+}
+
+void TestMultiShiftCGSolver::testMaxIterations() {
+    const size_t n = 100;
+    Matrix A = spd_matrix(n);
+    MatrixOperator Aop(A);
+    Matrix b = MatrixFactory::MakeRandomMatrix(n, 1, -1.0, 2.0);
+    std::vector<double> shifts(2, 0.0);
+    shifts[1] = 1e6;
+    MultiShiftCGSolver solver(Aop, shifts, 1e-12, 2);
+    Matrix X;
+    _ASSERT_EQ(ForBESUtils::STATUS_MAX_ITERATIONS_REACHED, solver.solve(b, X));
+    _ASSERT_EQ(static_cast<size_t> (2), solver.last_num_iter());
+    _ASSERT(solver.last_error(0) > 1e-12);
+    _ASSERT(solver.last_error(1) < solver.last_error(0));
+}
+
+void TestMultiShiftCGSolver::testInvalidShifts() {
+    const size_t n = 5;
+    Matrix A = spd_matrix(n);
+    MatrixOperator Aop(A);
+    std::vector<double> shifts;
+    _ASSERT_EXCEPTION(MultiShiftCGSolver(Aop, shifts), std::invalid_argument);
+    shifts.push_back(1.0);
+    MultiShiftCGSolver solver(Aop, shifts);
+    Matrix B(n, 2);
+    Matrix X;
+    _ASSERT_EXCEPTION(solver.solve(B, X), std::invalid_argument);
+}
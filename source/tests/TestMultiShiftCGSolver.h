@@ -0,0 +1,51 @@
+/*
+ * File:   TestMultiShiftCGSolver.h
+ *
+ * ForBES is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *  
+ * ForBES is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with ForBES. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TESTMULTISHIFTCGSOLVER_H
+#define TESTMULTISHIFTCGSOLVER_H
+#define FORBES_TEST_UTILS
+
+#include "ForBES.h"
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class TestMultiShiftCGSolver : public CPPUNIT_NS::TestFixture {
+    CPPUNIT_TEST_SUITE(TestMultiShiftCGSolver);
+
+    CPPUNIT_TEST(testSolve);
+    CPPUNIT_TEST(testMatchesCG);
+    CPPUNIT_TEST(testMaxIterations);
+    CPPUNIT_TEST(testInvalidShifts);
+
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    TestMultiShiftCGSolver();
+    virtual ~TestMultiShiftCGSolver();
+    void setUp();
+    void tearDown();
+
+private:
+    void testSolve();
+    void testMatchesCG();
+    void testMaxIterations();
+    void testInvalidShifts();
+
+};
+
+#endif /* TESTMULTISHIFTCGSOLVER_H */
+
@@ -23,6 +23,49 @@
 
 CPPUNIT_TEST_SUITE_REGISTRATION(TestOpComposition);
 
+/*
+ * Compares the block products T(X) and T*(W) with the products of T and T*
+ * with the individual columns of X and W.
+ */
+static void checkBlockProducts(LinearOperator& op, size_t n, size_t m, size_t k, double tol) {
+    const double alpha = 0.7;
+    const double gamma = -1.3;
+    Matrix X = MatrixFactory::MakeRandomMatrix(n, k, -1.0, 2.0);
+    Matrix W = MatrixFactory::MakeRandomMatrix(m, k, -1.0, 2.0);
+    Matrix Y0 = MatrixFactory::MakeRandomMatrix(m, k, -1.0, 2.0);
+    Matrix Z0 = MatrixFactory::MakeRandomMatrix(n, k, -1.0, 2.0);
+    Matrix Y(Y0);
+    Matrix Z(Z0);
+    _ASSERT_EQ(ForBESUtils::STATUS_OK, op.call(Y, alpha, X, gamma));
+    _ASSERT_EQ(ForBESUtils::STATUS_OK, op.callAdjoint(Z, alpha, W, gamma));
+    Matrix TX = op.call(X);
+    _ASSERT_EQ(m, TX.getNrows());
+    _ASSERT_EQ(k, TX.getNcols());
+    for (size_t c = 0; c < k; c++) {
+        Matrix x(n, 1);
+        Matrix w(m, 1);
+        Matrix y(m, 1);
+        Matrix z(n, 1);
+        for (size_t i = 0; i < n; i++) {
+            x[i] = X.get(i, c);
+            z[i] = Z0.get(i, c);
+        }
+        for (size_t i = 0; i < m; i++) {
+            w[i] = W.get(i, c);
+            y[i] = Y0.get(i, c);
+        }
+        _ASSERT_EQ(ForBESUtils::STATUS_OK, op.call(y, alpha, x, gamma));
+        _ASSERT_EQ(ForBESUtils::STATUS_OK, op.callAdjoint(z, alpha, w, gamma));
+        for (size_t i = 0; i < m; i++) {
+            _ASSERT_NUM_EQ(y[i], Y.get(i, c), tol);
+            _ASSERT_NUM_EQ((y[i] - gamma * Y0.get(i, c)) / alpha, TX.get(i, c), tol);
+        }
+        for (size_t i = 0; i < n; i++) {
+            _ASSERT_NUM_EQ(z[i], Z.get(i, c), tol);
+        }
+    }
+}
+
 TestOpComposition::TestOpComposition() {
 }
 
@@ -183,5 +226,45 @@ void TestOpComposition::testDimension() {
 
 }
 
+void TestOpComposition::testBlock() {
+    const size_t n = 10;
+    const size_t m = 15;
+    OpReverseVector rev_op(n);
+    Matrix A = MatrixFactory::MakeRandomMatrix(m, n, -1.0, 2.0, Matrix::MATRIX_DENSE);
+    MatrixOperator mat_op(A);
+    OpComposition op(mat_op, rev_op);
+    checkBlockProducts(op, n, m, 4, 1e-10);
+}
 
-
+void TestOpComposition::testRepeatedCalls() {
+    /* the intermediate buffers are reused and resized as needed */
+    const size_t n = 12;
+    const size_t m = 7;
+    const size_t p = 9;
+    const double tol = 1e-10;
+    Matrix A = MatrixFactory::MakeRandomMatrix(p, n, -1.0, 2.0);
+    Matrix B = MatrixFactory::MakeRandomMatrix(n, m, -1.0, 2.0);
+    MatrixOperator opA(A);
+    MatrixOperator opB(B);
+    OpComposition G(opA, opB);
+    Matrix AB = A * B;
+    Matrix ABt(AB);
+    ABt.transpose();
+    const size_t ncols[4] = {1, 3, 3, 1};
+    for (size_t r = 0; r < 4; r++) {
+        Matrix X = MatrixFactory::MakeRandomMatrix(m, ncols[r], -1.0, 2.0);
+        Matrix W = MatrixFactory::MakeRandomMatrix(p, ncols[r], -1.0, 2.0);
+        Matrix Y = G.call(X);
+        Matrix Z = G.callAdjoint(W);
+        Matrix Y_exp = AB * X;
+        Matrix Z_exp = ABt * W;
+        for (size_t j = 0; j < ncols[r]; j++) {
+            for (size_t i = 0; i < p; i++) {
+                _ASSERT_NUM_EQ(Y_exp.get(i, j), Y.get(i, j), tol);
+            }
+            for (size_t i = 0; i < m; i++) {
+                _ASSERT_NUM_EQ(Z_exp.get(i, j), Z.get(i, j), tol);
+            }
+        }
+    }
+}
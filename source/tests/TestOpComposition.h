@@ -33,6 +33,8 @@ class TestOpComposition : public CPPUNIT_NS::TestFixture {
     CPPUNIT_TEST(testCall2);
     CPPUNIT_TEST(testCallAdjoint);
     CPPUNIT_TEST(testDimension);    
+    CPPUNIT_TEST(testBlock);
+    CPPUNIT_TEST(testRepeatedCalls);
 
     CPPUNIT_TEST_SUITE_END();
 
@@ -47,6 +49,8 @@ private:
     void testCall2();
     void testCallAdjoint();
     void testDimension();
+    void testBlock();
+    void testRepeatedCalls();
 
 };
 
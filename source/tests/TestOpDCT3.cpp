@@ -13,6 +13,49 @@ void testOperatorLinearity(LinearOperator*);
 
 CPPUNIT_TEST_SUITE_REGISTRATION(TestOpDCT3);
 
+/*
+ * Compares the block products T(X) and T*(W) with the products of T and T*
+ * with the individual columns of X and W.
+ */
+static void checkBlockProducts(LinearOperator& op, size_t n, size_t m, size_t k, double tol) {
+    const double alpha = 0.7;
+    const double gamma = -1.3;
+    Matrix X = MatrixFactory::MakeRandomMatrix(n, k, -1.0, 2.0);
+    Matrix W = MatrixFactory::MakeRandomMatrix(m, k, -1.0, 2.0);
+    Matrix Y0 = MatrixFactory::MakeRandomMatrix(m, k, -1.0, 2.0);
+    Matrix Z0 = MatrixFactory::MakeRandomMatrix(n, k, -1.0, 2.0);
+    Matrix Y(Y0);
+    Matrix Z(Z0);
+    _ASSERT_EQ(ForBESUtils::STATUS_OK, op.call(Y, alpha, X, gamma));
+    _ASSERT_EQ(ForBESUtils::STATUS_OK, op.callAdjoint(Z, alpha, W, gamma));
+    Matrix TX = op.call(X);
+    _ASSERT_EQ(m, TX.getNrows());
+    _ASSERT_EQ(k, TX.getNcols());
+    for (size_t c = 0; c < k; c++) {
+        Matrix x(n, 1);
+        Matrix w(m, 1);
+        Matrix y(m, 1);
+        Matrix z(n, 1);
+        for (size_t i = 0; i < n; i++) {
+            x[i] = X.get(i, c);
+            z[i] = Z0.get(i, c);
+        }
+        for (size_t i = 0; i < m; i++) {
+            w[i] = W.get(i, c);
+            y[i] = Y0.get(i, c);
+        }
+        _ASSERT_EQ(ForBESUtils::STATUS_OK, op.call(y, alpha, x, gamma));
+        _ASSERT_EQ(ForBESUtils::STATUS_OK, op.callAdjoint(z, alpha, w, gamma));
+        for (size_t i = 0; i < m; i++) {
+            _ASSERT_NUM_EQ(y[i], Y.get(i, c), tol);
+            _ASSERT_NUM_EQ((y[i] - gamma * Y0.get(i, c)) / alpha, TX.get(i, c), tol);
+        }
+        for (size_t i = 0; i < n; i++) {
+            _ASSERT_NUM_EQ(z[i], Z.get(i, c), tol);
+        }
+    }
+}
+
 TestOpDCT3::TestOpDCT3() {
 }
 
@@ -104,3 +147,77 @@ void TestOpDCT3::testAdjointLinearity() {
     delete op;
     delete adj;
 }
+
+void TestOpDCT3::testFFT() {
+    const size_t dims[6] = {1, 3, 16, 65, 128, 300};
+    const double tol = 1e-9;
+    for (size_t q = 0; q < 6; q++) {
+        size_t n = dims[q];
+        OpDCT3 dct_fft(n, DCTHelper::DCT_FFT);
+        OpDCT3 dct_direct(n, DCTHelper::DCT_DIRECT);
+
+        Matrix x = MatrixFactory::MakeRandomMatrix(n, 1, -1.0, 2.0);
+        Matrix y0 = MatrixFactory::MakeRandomMatrix(n, 1, -1.0, 2.0);
+
+        Matrix y_fft(y0);
+        Matrix y_direct(y0);
+        _ASSERT_EQ(ForBESUtils::STATUS_OK, dct_fft.call(y_fft, 1.5, x, 0.5));
+        _ASSERT_EQ(ForBESUtils::STATUS_OK, dct_direct.call(y_direct, 1.5, x, 0.5));
+        for (size_t i = 0; i < n; i++) {
+            _ASSERT_NUM_EQ(y_direct[i], y_fft[i], tol);
+        }
+
+        y_fft = y0;
+        y_direct = y0;
+        _ASSERT_EQ(ForBESUtils::STATUS_OK, dct_fft.callAdjoint(y_fft, 1.5, x, 0.5));
+        _ASSERT_EQ(ForBESUtils::STATUS_OK, dct_direct.callAdjoint(y_direct, 1.5, x, 0.5));
+        for (size_t i = 0; i < n; i++) {
+            _ASSERT_NUM_EQ(y_direct[i], y_fft[i], tol);
+        }
+    }
+}
+
+void TestOpDCT3::testTable() {
+    const size_t dims[6] = {1, 3, 8, 15, 40, 63};
+    const double tol = 1e-10;
+    for (size_t q = 0; q < 6; q++) {
+        size_t n = dims[q];
+        OpDCT3 dct_table(n, DCTHelper::DCT_TABLE);
+        OpDCT3 dct_direct(n, DCTHelper::DCT_DIRECT);
+
+        Matrix x = MatrixFactory::MakeRandomMatrix(n, 1, -1.0, 2.0);
+        Matrix y0 = MatrixFactory::MakeRandomMatrix(n, 1, -1.0, 2.0);
+
+        for (size_t r = 0; r < 3; r++) {
+            Matrix y_table(y0);
+            Matrix y_direct(y0);
+            _ASSERT_EQ(ForBESUtils::STATUS_OK, dct_table.call(y_table, 1.5, x, 0.5));
+            _ASSERT_EQ(ForBESUtils::STATUS_OK, dct_direct.call(y_direct, 1.5, x, 0.5));
+            for (size_t i = 0; i < n; i++) {
+                _ASSERT_NUM_EQ(y_direct[i], y_table[i], tol);
+            }
+
+            y_table = y0;
+            y_direct = y0;
+            _ASSERT_EQ(ForBESUtils::STATUS_OK, dct_table.callAdjoint(y_table, 1.5, x, 0.5));
+            _ASSERT_EQ(ForBESUtils::STATUS_OK, dct_direct.callAdjoint(y_direct, 1.5, x, 0.5));
+            for (size_t i = 0; i < n; i++) {
+                _ASSERT_NUM_EQ(y_direct[i], y_table[i], tol);
+            }
+        }
+    }
+}
+
+void TestOpDCT3::testBlock() {
+    const size_t dims[3] = {7, 100, 257};
+    const double tol = 1e-9;
+    for (size_t q = 0; q < 3; q++) {
+        size_t n = dims[q];
+        OpDCT3 dct_direct(n, DCTHelper::DCT_DIRECT);
+        OpDCT3 dct_fft(n, DCTHelper::DCT_FFT);
+        OpDCT3 dct_table(n, DCTHelper::DCT_TABLE);
+        checkBlockProducts(dct_direct, n, n, 4, tol);
+        checkBlockProducts(dct_fft, n, n, 4, tol);
+        checkBlockProducts(dct_table, n, n, 4, tol);
+    }
+}
@@ -33,6 +33,9 @@ class TestOpDCT3 : public CPPUNIT_NS::TestFixture {
     CPPUNIT_TEST(testCall);
     CPPUNIT_TEST(testLinearity);
     CPPUNIT_TEST(testAdjointLinearity);
+    CPPUNIT_TEST(testFFT);
+    CPPUNIT_TEST(testTable);
+    CPPUNIT_TEST(testBlock);
 
     CPPUNIT_TEST_SUITE_END();
 
@@ -46,6 +49,9 @@ private:
     void testCall();
     void testLinearity();
     void testAdjointLinearity();
+    void testFFT();
+    void testTable();
+    void testBlock();
 
 };
 
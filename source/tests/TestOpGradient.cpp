@@ -13,6 +13,49 @@ void testOperatorLinearity(LinearOperator* op);
 
 CPPUNIT_TEST_SUITE_REGISTRATION(TestOpGradient);
 
+/*
+ * Compares the block products T(X) and T*(W) with the products of T and T*
+ * with the individual columns of X and W.
+ */
+static void checkBlockProducts(LinearOperator& op, size_t n, size_t m, size_t k, double tol) {
+    const double alpha = 0.7;
+    const double gamma = -1.3;
+    Matrix X = MatrixFactory::MakeRandomMatrix(n, k, -1.0, 2.0);
+    Matrix W = MatrixFactory::MakeRandomMatrix(m, k, -1.0, 2.0);
+    Matrix Y0 = MatrixFactory::MakeRandomMatrix(m, k, -1.0, 2.0);
+    Matrix Z0 = MatrixFactory::MakeRandomMatrix(n, k, -1.0, 2.0);
+    Matrix Y(Y0);
+    Matrix Z(Z0);
+    _ASSERT_EQ(ForBESUtils::STATUS_OK, op.call(Y, alpha, X, gamma));
+    _ASSERT_EQ(ForBESUtils::STATUS_OK, op.callAdjoint(Z, alpha, W, gamma));
+    Matrix TX = op.call(X);
+    _ASSERT_EQ(m, TX.getNrows());
+    _ASSERT_EQ(k, TX.getNcols());
+    for (size_t c = 0; c < k; c++) {
+        Matrix x(n, 1);
+        Matrix w(m, 1);
+        Matrix y(m, 1);
+        Matrix z(n, 1);
+        for (size_t i = 0; i < n; i++) {
+            x[i] = X.get(i, c);
+            z[i] = Z0.get(i, c);
+        }
+        for (size_t i = 0; i < m; i++) {
+            w[i] = W.get(i, c);
+            y[i] = Y0.get(i, c);
+        }
+        _ASSERT_EQ(ForBESUtils::STATUS_OK, op.call(y, alpha, x, gamma));
+        _ASSERT_EQ(ForBESUtils::STATUS_OK, op.callAdjoint(z, alpha, w, gamma));
+        for (size_t i = 0; i < m; i++) {
+            _ASSERT_NUM_EQ(y[i], Y.get(i, c), tol);
+            _ASSERT_NUM_EQ((y[i] - gamma * Y0.get(i, c)) / alpha, TX.get(i, c), tol);
+        }
+        for (size_t i = 0; i < n; i++) {
+            _ASSERT_NUM_EQ(z[i], Z.get(i, c), tol);
+        }
+    }
+}
+
 TestOpGradient::TestOpGradient() {
 }
 
@@ -98,3 +141,9 @@ void TestOpGradient::testAdjointLinearity() {
     delete op;
     delete adj;
 }
+
+void TestOpGradient::testBlock() {
+    const size_t n = 9;
+    OpGradient op(n);
+    checkBlockProducts(op, n, n - 1, 3, 1e-12);
+}
@@ -33,6 +33,7 @@ class TestOpGradient : public CPPUNIT_NS::TestFixture {
     CPPUNIT_TEST(testCall);
     CPPUNIT_TEST(testLinearity);
     CPPUNIT_TEST(testAdjointLinearity);
+    CPPUNIT_TEST(testBlock);
 
     CPPUNIT_TEST_SUITE_END();
 
@@ -46,6 +47,7 @@ private:
     void testCall();
     void testLinearity();
     void testAdjointLinearity();
+    void testBlock();
 
 };
 
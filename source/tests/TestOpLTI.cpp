@@ -0,0 +1,236 @@
+/*
+ * File:   TestOpLTI.cpp
+ *
+ * ForBES is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *  
+ * ForBES is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with ForBES. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "TestOpLTI.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TestOpLTI);
+
+TestOpLTI::TestOpLTI() {
+}
+
+TestOpLTI::~TestOpLTI() {
+}
+
+void TestOpLTI::setUp() {
+}
+
+void TestOpLTI::tearDown() {
+}
+
+/* states x1, ..., x(N-1) of x(k+1) = A x(k) + B u(k), x0 = 0 */
+static Matrix simulate(Matrix& A, Matrix& B, Matrix& u, size_t N) {
+    const size_t n = A.getNrows();
+    const size_t m = B.getNcols();
+    Matrix states((N - 1) * n, 1);
+    Matrix x(n, 1);
+    for (size_t k = 0; k < N - 1; k++) {
+        Matrix uk = MatrixFactory::ShallowVector(u, m, k * m);
+        Matrix x_next = A * x;
+        Matrix Bu = B * uk;
+        x_next += Bu;
+        x = x_next;
+        for (size_t i = 0; i < n; i++) {
+            states[k * n + i] = x[i];
+        }
+    }
+    return states;
+}
+
+void TestOpLTI::testCall() {
+    const size_t n = 5;
+    const size_t m = 3;
+    const size_t N = 12;
+    const double alpha = 0.8;
+    const double gamma = -1.5;
+    const double tol = 1e-10;
+    Matrix A = MatrixFactory::MakeRandomMatrix(n, n, -0.5, 1.0);
+    Matrix B = MatrixFactory::MakeRandomMatrix(n, m, -1.0, 2.0);
+    OpLTI op(A, B, N);
+    Matrix u = MatrixFactory::MakeRandomMatrix((N - 1) * m, 1, -1.0, 2.0);
+    Matrix x_expected = simulate(A, B, u, N);
+
+    Matrix x = op.call(u);
+    _ASSERT_EQ(x_expected.getNrows(), x.getNrows());
+    for (size_t i = 0; i < (N - 1) * n; i++) {
+        _ASSERT_NUM_EQ(x_expected[i], x[i], tol);
+    }
+
+    Matrix y0 = MatrixFactory::MakeRandomMatrix((N - 1) * n, 1, -1.0, 2.0);
+    Matrix y(y0);
+    for (size_t repeat = 0; repeat < 2; repeat++) {
+        y = y0;
+        _ASSERT_EQ(ForBESUtils::STATUS_OK, op.call(y, alpha, u, gamma));
+        for (size_t i = 0; i < (N - 1) * n; i++) {
+            _ASSERT_NUM_EQ(gamma * y0[i] + alpha * x_expected[i], y[i], tol);
+        }
+    }
+}
+
+void TestOpLTI::testCallAdjoint() {
+    const size_t n = 6;
+    const size_t m = 2;
+    const size_t N = 9;
+    const double alpha = -0.7;
+    const double gamma = 2.1;
+    const double tol = 1e-10;
+    Matrix A = MatrixFactory::MakeRandomMatrix(n, n, -0.5, 1.0);
+    Matrix B = MatrixFactory::MakeRandomMatrix(n, m, -1.0, 2.0);
+    OpLTI op(A, B, N);
+    Matrix u = MatrixFactory::MakeRandomMatrix((N - 1) * m, 1, -1.0, 2.0);
+    Matrix w = MatrixFactory::MakeRandomMatrix((N - 1) * n, 1, -1.0, 2.0);
+
+    /* <T(u), w> = <u, T*(w)> */
+    Matrix Tu = op.call(u);
+    Matrix Tw = op.callAdjoint(w);
+    _ASSERT_EQ((N - 1) * m, Tw.getNrows());
+    double lhs = 0.0;
+    double rhs = 0.0;
+    for (size_t i = 0; i < (N - 1) * n; i++) {
+        lhs += Tu[i] * w[i];
+    }
+    for (size_t i = 0; i < (N - 1) * m; i++) {
+        rhs += u[i] * Tw[i];
+    }
+    _ASSERT_NUM_EQ(lhs, rhs, tol);
+
+    /* the adjoint of the last block: B' w(N-1) */
+    Matrix wN = MatrixFactory::ShallowVector(w, n, (N - 2) * n);
+    Matrix Bt(B);
+    Bt.transpose();
+    Matrix BtwN = Bt * wN;
+    for (size_t i = 0; i < m; i++) {
+        _ASSERT_NUM_EQ(BtwN[i], Tw[(N - 2) * m + i], tol);
+    }
+
+    Matrix z0 = MatrixFactory::MakeRandomMatrix((N - 1) * m, 1, -1.0, 2.0);
+    Matrix z(z0);
+    _ASSERT_EQ(ForBESUtils::STATUS_OK, op.callAdjoint(z, alpha, w, gamma));
+    for (size_t i = 0; i < (N - 1) * m; i++) {
+        _ASSERT_NUM_EQ(gamma * z0[i] + alpha * Tw[i], z[i], tol);
+    }
+}
+
+void TestOpLTI::testSparseSystem() {
+    const size_t n = 4;
+    const size_t m = 2;
+    const size_t N = 7;
+    const double tol = 1e-10;
+    /* A is diagonal, B is sparse */
+    Matrix A(n, n, Matrix::MATRIX_DIAGONAL);
+    for (size_t i = 0; i < n; i++) {
+        A.set(i, i, 0.5 + 0.1 * i);
+    }
+    Matrix B = MatrixFactory::MakeSparse(n, m, 3, Matrix::SPARSE_UNSYMMETRIC);
+    B.set(0, 0, 1.0);
+    B.set(2, 1, -2.0);
+    B.set(3, 0, 0.5);
+    OpLTI op(A, B, N);
+    Matrix Ad = MatrixFactory::MakeRandomMatrix(n, n, 0.0, 1.0);
+    Matrix Bd = MatrixFactory::MakeRandomMatrix(n, m, 0.0, 1.0);
+    for (size_t i = 0; i < n; i++) {
+        for (size_t j = 0; j < n; j++) {
+            Ad.set(i, j, A.get(i, j));
+        }
+        for (size_t j = 0; j < m; j++) {
+            Bd.set(i, j, B.get(i, j));
+        }
+    }
+    Matrix u = MatrixFactory::MakeRandomMatrix((N - 1) * m, 1, -1.0, 2.0);
+    Matrix x_expected = simulate(Ad, Bd, u, N);
+    Matrix x = op.call(u);
+    for (size_t i = 0; i < (N - 1) * n; i++) {
+        _ASSERT_NUM_EQ(x_expected[i], x[i], tol);
+    }
+}
+
+void TestOpLTI::testDimensions() {
+    Matrix A = MatrixFactory::MakeRandomMatrix(4, 4, -1.0, 2.0);
+    Matrix B = MatrixFactory::MakeRandomMatrix(4, 3, -1.0, 2.0);
+    OpLTI op(A, B, 10);
+    _ASSERT_EQ(static_cast<size_t> (27), op.dimensionIn().first);
+    _ASSERT_EQ(static_cast<size_t> (1), op.dimensionIn().second);
+    _ASSERT_EQ(static_cast<size_t> (36), op.dimensionOut().first);
+    _ASSERT_EQ(static_cast<size_t> (1), op.dimensionOut().second);
+    _ASSERT_NOT(op.isSelfAdjoint());
+}
+
+void TestOpLTI::testInvalidArguments() {
+    Matrix A = MatrixFactory::MakeRandomMatrix(4, 4, -1.0, 2.0);
+    Matrix A_rect = MatrixFactory::MakeRandomMatrix(4, 3, -1.0, 2.0);
+    Matrix B = MatrixFactory::MakeRandomMatrix(4, 2, -1.0, 2.0);
+    Matrix B_wrong = MatrixFactory::MakeRandomMatrix(5, 2, -1.0, 2.0);
+    _ASSERT_EXCEPTION(OpLTI(A_rect, B, 5), std::invalid_argument);
+    _ASSERT_EXCEPTION(OpLTI(A, B_wrong, 5), std::invalid_argument);
+    _ASSERT_EXCEPTION(OpLTI(A, B, 1), std::invalid_argument);
+
+    OpLTI op(A, B, 5);
+    Matrix u_wrong(7, 1);
+    Matrix y(16, 1);
+    _ASSERT_EXCEPTION(op.call(y, 1.0, u_wrong, 0.0), std::invalid_argument);
+    Matrix w_wrong(15, 1);
+    Matrix z(8, 1);
+    _ASSERT_EXCEPTION(op.callAdjoint(z, 1.0, w_wrong, 0.0), std::invalid_argument);
+}
+
+void TestOpLTI::testBlock() {
+    const size_t n = 4;
+    const size_t m = 3;
+    const size_t N = 7;
+    const size_t k = 3;
+    const size_t nx = (N - 1) * n;
+    const size_t nu = (N - 1) * m;
+    const double alpha = 1.3;
+    const double tol = 1e-10;
+    Matrix A = MatrixFactory::MakeRandomMatrix(n, n, -0.5, 1.0);
+    Matrix B = MatrixFactory::MakeRandomMatrix(n, m, -1.0, 2.0);
+    OpLTI op(A, B, N);
+    Matrix U = MatrixFactory::MakeRandomMatrix(nu, k, -1.0, 2.0);
+    Matrix W = MatrixFactory::MakeRandomMatrix(nx, k, -1.0, 2.0);
+    Matrix X0 = MatrixFactory::MakeRandomMatrix(nx, k, -1.0, 2.0);
+    Matrix Z0 = MatrixFactory::MakeRandomMatrix(nu, k, -1.0, 2.0);
+
+    /* the block is processed with gamma = 0 (in place) and gamma != 0 */
+    for (size_t g = 0; g < 2; g++) {
+        const double gamma = g == 0 ? 0.0 : -0.6;
+        Matrix X(X0);
+        Matrix Z(Z0);
+        _ASSERT_EQ(ForBESUtils::STATUS_OK, op.call(X, alpha, U, gamma));
+        _ASSERT_EQ(ForBESUtils::STATUS_OK, op.callAdjoint(Z, alpha, W, gamma));
+        for (size_t c = 0; c < k; c++) {
+            Matrix u = MatrixFactory::ShallowVector(U.getData(), nu, c * nu);
+            Matrix w = MatrixFactory::ShallowVector(W.getData(), nx, c * nx);
+            Matrix x = MatrixFactory::ShallowVector(X0.getData(), nx, c * nx);
+            Matrix z = MatrixFactory::ShallowVector(Z0.getData(), nu, c * nu);
+            Matrix x_col(x);
+            Matrix z_col(z);
+            _ASSERT_EQ(ForBESUtils::STATUS_OK, op.call(x_col, alpha, u, gamma));
+            _ASSERT_EQ(ForBESUtils::STATUS_OK, op.callAdjoint(z_col, alpha, w, gamma));
+            for (size_t i = 0; i < nx; i++) {
+                _ASSERT_NUM_EQ(x_col[i], X.get(i, c), tol);
+            }
+            for (size_t i = 0; i < nu; i++) {
+                _ASSERT_NUM_EQ(z_col[i], Z.get(i, c), tol);
+            }
+        }
+    }
+
+    /* blocks with a different number of columns are rejected */
+    Matrix X_wrong(nx, k - 1);
+    _ASSERT_EXCEPTION(op.call(X_wrong, 1.0, U, 0.0), std::invalid_argument);
+    Matrix Z_wrong(nu, k + 1);
+    _ASSERT_EXCEPTION(op.callAdjoint(Z_wrong, 1.0, W, 0.0), std::invalid_argument);
+}
@@ -0,0 +1,54 @@
+/*
+ * File:   TestOpLTI.h
+ *
+ * ForBES is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *  
+ * ForBES is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with ForBES. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TESTOPLTI_H
+#define TESTOPLTI_H
+#define FORBES_TEST_UTILS
+
+#include "ForBES.h"
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class TestOpLTI : public CPPUNIT_NS::TestFixture {
+    CPPUNIT_TEST_SUITE(TestOpLTI);
+
+    CPPUNIT_TEST(testCall);
+    CPPUNIT_TEST(testCallAdjoint);
+    CPPUNIT_TEST(testSparseSystem);
+    CPPUNIT_TEST(testDimensions);
+    CPPUNIT_TEST(testInvalidArguments);
+    CPPUNIT_TEST(testBlock);
+
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    TestOpLTI();
+    virtual ~TestOpLTI();
+    void setUp();
+    void tearDown();
+
+private:
+    void testCall();
+    void testCallAdjoint();
+    void testSparseSystem();
+    void testDimensions();
+    void testInvalidArguments();
+    void testBlock();
+
+};
+
+#endif /* TESTOPLTI_H */
@@ -0,0 +1,146 @@
+/*
+ * File:   TestOpLinearCombination.cpp
+ *
+ * ForBES is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *  
+ * ForBES is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with ForBES. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "TestOpLinearCombination.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TestOpLinearCombination);
+
+TestOpLinearCombination::TestOpLinearCombination() {
+}
+
+TestOpLinearCombination::~TestOpLinearCombination() {
+}
+
+void TestOpLinearCombination::setUp() {
+}
+
+void TestOpLinearCombination::tearDown() {
+}
+
+void TestOpLinearCombination::testCall() {
+    const size_t n = 20;
+    const size_t m = 14;
+    const double a = 0.8;
+    const double b = -2.5;
+    const double alpha = 1.7;
+    const double gamma = -0.4;
+    const double tol = 1e-10;
+    Matrix A = MatrixFactory::MakeRandomMatrix(m, n, -1.0, 2.0);
+    Matrix B = MatrixFactory::MakeRandomMatrix(m, n, -1.0, 2.0);
+    MatrixOperator opA(A);
+    MatrixOperator opB(B);
+    OpLinearCombination T(opA, opB, a, b);
+    _ASSERT_EQ(n, T.dimensionIn().first);
+    _ASSERT_EQ(m, T.dimensionOut().first);
+
+    Matrix x = MatrixFactory::MakeRandomMatrix(n, 1, -1.0, 2.0);
+    Matrix y0 = MatrixFactory::MakeRandomMatrix(m, 1, -1.0, 2.0);
+    Matrix y(y0);
+    _ASSERT_EQ(ForBESUtils::STATUS_OK, T.call(y, alpha, x, gamma));
+    Matrix Ax = A * x;
+    Matrix Bx = B * x;
+    for (size_t i = 0; i < m; i++) {
+        _ASSERT_NUM_EQ(gamma * y0[i] + alpha * (a * Ax[i] + b * Bx[i]), y[i], tol);
+    }
+    Matrix Tx = T.call(x);
+    for (size_t i = 0; i < m; i++) {
+        _ASSERT_NUM_EQ(a * Ax[i] + b * Bx[i], Tx[i], tol);
+    }
+}
+
+void TestOpLinearCombination::testCallAdjoint() {
+    const size_t n = 11;
+    const size_t m = 16;
+    const double a = -1.1;
+    const double b = 0.3;
+    const double tol = 1e-10;
+    Matrix A = MatrixFactory::MakeRandomMatrix(m, n, -1.0, 2.0);
+    Matrix B = MatrixFactory::MakeRandomMatrix(m, n, -1.0, 2.0);
+    MatrixOperator opA(A);
+    MatrixOperator opB(B);
+    OpLinearCombination T(opA, opB, a, b);
+
+    /* <T(x), w> = <x, T*(w)> */
+    Matrix x = MatrixFactory::MakeRandomMatrix(n, 1, -1.0, 2.0);
+    Matrix w = MatrixFactory::MakeRandomMatrix(m, 1, -1.0, 2.0);
+    Matrix Tx = T.call(x);
+    Matrix Tstar_w = T.callAdjoint(w);
+    _ASSERT_EQ(n, Tstar_w.getNrows());
+    double lhs = 0.0;
+    double rhs = 0.0;
+    for (size_t i = 0; i < m; i++) lhs += Tx[i] * w[i];
+    for (size_t i = 0; i < n; i++) rhs += x[i] * Tstar_w[i];
+    _ASSERT_NUM_EQ(lhs, rhs, tol);
+    _ASSERT_NOT(T.isSelfAdjoint());
+}
+
+void TestOpLinearCombination::testSum() {
+    const size_t n = 25;
+    const double tol = 1e-10;
+    Matrix A = MatrixFactory::MakeRandomMatrix(n, n, -1.0, 2.0);
+    MatrixOperator opA(A);
+    OpReverseVector rev(n);
+    OpSum T(opA, rev); // T(x) = A*x + reverse(x)
+
+    Matrix x = MatrixFactory::MakeRandomMatrix(n, 1, -1.0, 2.0);
+    Matrix Tx = T.call(x);
+    Matrix Ax = A * x;
+    for (size_t i = 0; i < n; i++) {
+        _ASSERT_NUM_EQ(Ax[i] + x[n - 1 - i], Tx[i], tol);
+    }
+    OpSum S(rev, rev);
+    _ASSERT(S.isSelfAdjoint());
+    Matrix Sx = S.call(x);
+    for (size_t i = 0; i < n; i++) {
+        _ASSERT_NUM_EQ(2.0 * x[n - 1 - i], Sx[i], tol);
+    }
+}
+
+void TestOpLinearCombination::testBlock() {
+    const size_t n = 10;
+    const size_t m = 6;
+    const size_t k = 4;
+    const double tol = 1e-10;
+    Matrix A = MatrixFactory::MakeRandomMatrix(m, n, -1.0, 2.0);
+    Matrix B = MatrixFactory::MakeRandomMatrix(m, n, -1.0, 2.0);
+    MatrixOperator opA(A);
+    MatrixOperator opB(B);
+    OpLinearCombination T(opA, opB, 2.0, -0.5);
+    Matrix X = MatrixFactory::MakeRandomMatrix(n, k, -1.0, 2.0);
+    Matrix TX = T.call(X);
+    _ASSERT_EQ(m, TX.getNrows());
+    _ASSERT_EQ(k, TX.getNcols());
+    Matrix AX = A * X;
+    Matrix BX = B * X;
+    for (size_t j = 0; j < k; j++) {
+        for (size_t i = 0; i < m; i++) {
+            _ASSERT_NUM_EQ(2.0 * AX.get(i, j) - 0.5 * BX.get(i, j), TX.get(i, j), tol);
+        }
+    }
+}
+
+void TestOpLinearCombination::testDimensions() {
+    Matrix A = MatrixFactory::MakeRandomMatrix(5, 4, -1.0, 2.0);
+    Matrix B = MatrixFactory::MakeRandomMatrix(5, 3, -1.0, 2.0);
+    Matrix C = MatrixFactory::MakeRandomMatrix(6, 4, -1.0, 2.0);
+    MatrixOperator opA(A);
+    MatrixOperator opB(B);
+    MatrixOperator opC(C);
+    _ASSERT_EXCEPTION(OpLinearCombination(opA, opB, 1.0, 1.0), std::invalid_argument);
+    _ASSERT_EXCEPTION(OpLinearCombination(opA, opC, 1.0, 1.0), std::invalid_argument);
+    _ASSERT_EXCEPTION(OpSum(opA, opB), std::invalid_argument);
+}
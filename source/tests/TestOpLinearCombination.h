@@ -0,0 +1,53 @@
+/*
+ * File:   TestOpLinearCombination.h
+ *
+ * ForBES is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *  
+ * ForBES is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with ForBES. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TESTOPLINEARCOMBINATION_H
+#define TESTOPLINEARCOMBINATION_H
+#define FORBES_TEST_UTILS
+
+#include "ForBES.h"
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class TestOpLinearCombination : public CPPUNIT_NS::TestFixture {
+    CPPUNIT_TEST_SUITE(TestOpLinearCombination);
+
+    CPPUNIT_TEST(testCall);
+    CPPUNIT_TEST(testCallAdjoint);
+    CPPUNIT_TEST(testSum);
+    CPPUNIT_TEST(testBlock);
+    CPPUNIT_TEST(testDimensions);
+
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    TestOpLinearCombination();
+    virtual ~TestOpLinearCombination();
+    void setUp();
+    void tearDown();
+
+private:
+    void testCall();
+    void testCallAdjoint();
+    void testSum();
+    void testBlock();
+    void testDimensions();
+
+};
+
+#endif /* TESTOPLINEARCOMBINATION_H */
+
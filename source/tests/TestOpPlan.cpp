@@ -0,0 +1,207 @@
+/*
+ * File:   TestOpPlan.cpp
+ *
+ * ForBES is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *  
+ * ForBES is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with ForBES. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "TestOpPlan.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TestOpPlan);
+
+TestOpPlan::TestOpPlan() {
+}
+
+TestOpPlan::~TestOpPlan() {
+}
+
+void TestOpPlan::setUp() {
+}
+
+void TestOpPlan::tearDown() {
+}
+
+/* checks that plan and op yield the same y = alpha*T(x) + gamma*y and its adjoint */
+static void assertSameOperator(OpPlan& plan, LinearOperator& op, size_t k) {
+    const double alpha = -1.3;
+    const double gamma = 0.7;
+    const double tol = 1e-9;
+    const size_t n = op.dimensionIn().first;
+    const size_t m = op.dimensionOut().first;
+    _ASSERT_EQ(n, plan.dimensionIn().first);
+    _ASSERT_EQ(m, plan.dimensionOut().first);
+
+    Matrix x = MatrixFactory::MakeRandomMatrix(n, k, -1.0, 2.0);
+    Matrix y0 = MatrixFactory::MakeRandomMatrix(m, k, -1.0, 2.0);
+    Matrix y_expected(y0);
+    Matrix y(y0);
+    _ASSERT_EQ(ForBESUtils::STATUS_OK, op.call(y_expected, alpha, x, gamma));
+    for (size_t repeat = 0; repeat < 2; repeat++) {
+        y = y0;
+        _ASSERT_EQ(ForBESUtils::STATUS_OK, plan.call(y, alpha, x, gamma));
+        for (size_t i = 0; i < m * k; i++) {
+            _ASSERT_NUM_EQ(y_expected[i], y[i], tol);
+        }
+    }
+
+    Matrix w = MatrixFactory::MakeRandomMatrix(m, k, -1.0, 2.0);
+    Matrix z0 = MatrixFactory::MakeRandomMatrix(n, k, -1.0, 2.0);
+    Matrix z_expected(z0);
+    Matrix z(z0);
+    _ASSERT_EQ(ForBESUtils::STATUS_OK, op.callAdjoint(z_expected, alpha, w, gamma));
+    _ASSERT_EQ(ForBESUtils::STATUS_OK, plan.callAdjoint(z, alpha, w, gamma));
+    for (size_t i = 0; i < n * k; i++) {
+        _ASSERT_NUM_EQ(z_expected[i], z[i], tol);
+    }
+}
+
+void TestOpPlan::testAdjointOfAdjoint() {
+    Matrix A = MatrixFactory::MakeRandomMatrix(12, 7, -1.0, 2.0);
+    MatrixOperator opA(A);
+    OpAdjoint opAt(opA);
+    OpAdjoint opAtt(opAt);
+    OpPlan plan(opAtt);
+    _ASSERT_EQ(static_cast<size_t> (1), plan.getNumLeaves());
+    _ASSERT_NUM_EQ(84.0, plan.getCost(), 1e-12);
+    assertSameOperator(plan, opAtt, 1);
+}
+
+void TestOpPlan::testCoefficients() {
+    const size_t n = 9;
+    const size_t m = 6;
+    Matrix A = MatrixFactory::MakeRandomMatrix(m, n, -1.0, 2.0);
+    Matrix B = MatrixFactory::MakeRandomMatrix(m, n, -1.0, 2.0);
+    Matrix C = MatrixFactory::MakeRandomMatrix(m, n, -1.0, 2.0);
+    MatrixOperator opA(A);
+    MatrixOperator opB(B);
+    MatrixOperator opC(C);
+    OpLinearCombination AB(opA, opB, 2.0, -0.5);
+    OpLinearCombination ABC(AB, opC, 3.0, 1.5);
+    OpLinearCombination zero(ABC, opA, 1.0, 0.0);
+    OpPlan plan(zero);
+    /* 6A - 1.5B + 1.5C is precomputed */
+    _ASSERT_EQ(static_cast<size_t> (1), plan.getNumLeaves());
+    _ASSERT_NUM_EQ(static_cast<double> (m * n), plan.getCost(), 1e-12);
+    _ASSERT(plan.getOriginalCost() > plan.getCost());
+    assertSameOperator(plan, zero, 1);
+}
+
+void TestOpPlan::testMergeProducts() {
+    /* A(B(Cx)) with A: 5x200, B: 200x5, C: 5x3 is replaced by (ABC)x */
+    Matrix A = MatrixFactory::MakeRandomMatrix(5, 200, -1.0, 2.0);
+    Matrix B = MatrixFactory::MakeRandomMatrix(200, 5, -1.0, 2.0);
+    Matrix C = MatrixFactory::MakeRandomMatrix(5, 3, -1.0, 2.0);
+    MatrixOperator opA(A);
+    MatrixOperator opB(B);
+    MatrixOperator opC(C);
+    OpComposition BC(opB, opC);
+    OpComposition ABC(opA, BC);
+    OpPlan plan(ABC);
+    _ASSERT_EQ(static_cast<size_t> (1), plan.getNumLeaves());
+    _ASSERT_NUM_EQ(2015.0, plan.getOriginalCost(), 1e-12);
+    _ASSERT_NUM_EQ(15.0, plan.getCost(), 1e-12);
+    assertSameOperator(plan, ABC, 1);
+
+    /* the coefficients of all merged factors are kept: A(2B + 0C) = 2AB */
+    Matrix B2 = MatrixFactory::MakeRandomMatrix(200, 5, -1.0, 2.0);
+    Matrix C2 = MatrixFactory::MakeRandomMatrix(200, 5, -1.0, 2.0);
+    MatrixOperator opB2(B2);
+    MatrixOperator opC2(C2);
+    OpLinearCombination T2(opB2, opC2, 2.0, 0.0);
+    OpComposition AT2(opA, T2);
+    OpPlan plan2(AT2);
+    _ASSERT_EQ(static_cast<size_t> (1), plan2.getNumLeaves());
+    _ASSERT_NUM_EQ(25.0, plan2.getCost(), 1e-12);
+    assertSameOperator(plan2, AT2, 1);
+}
+
+void TestOpPlan::testNoMerge() {
+    /* A(Bx) with A: 100x2, B: 2x100 is cheaper than (AB)x */
+    Matrix A = MatrixFactory::MakeRandomMatrix(100, 2, -1.0, 2.0);
+    Matrix B = MatrixFactory::MakeRandomMatrix(2, 100, -1.0, 2.0);
+    MatrixOperator opA(A);
+    MatrixOperator opB(B);
+    OpComposition AB(opA, opB);
+    OpPlan plan(AB);
+    _ASSERT_EQ(static_cast<size_t> (2), plan.getNumLeaves());
+    _ASSERT_NUM_EQ(plan.getOriginalCost(), plan.getCost(), 1e-12);
+    assertSameOperator(plan, AB, 1);
+
+    /* ... but (A'(Bx))' = B'(Ax) with A: 100x2, B: 100x2 is grouped as (B'A)x */
+    Matrix C = MatrixFactory::MakeRandomMatrix(100, 2, -1.0, 2.0);
+    MatrixOperator opC(C);
+    OpAdjoint opAt(opA);
+    OpComposition AtC(opAt, opC);
+    OpAdjoint CtA(AtC);
+    OpPlan plan2(CtA);
+    _ASSERT_EQ(static_cast<size_t> (1), plan2.getNumLeaves());
+    _ASSERT_NUM_EQ(4.0, plan2.getCost(), 1e-12);
+    assertSameOperator(plan2, CtA, 1);
+}
+
+void TestOpPlan::testSumWithAdjoint() {
+    /* AB + (AB)' is a single 10x10 matrix */
+    Matrix A = MatrixFactory::MakeRandomMatrix(10, 50, -1.0, 2.0);
+    Matrix B = MatrixFactory::MakeRandomMatrix(50, 10, -1.0, 2.0);
+    MatrixOperator opA(A);
+    MatrixOperator opB(B);
+    OpComposition AB(opA, opB);
+    OpAdjoint ABt(AB);
+    OpSum T(AB, ABt);
+    OpPlan plan(T);
+    _ASSERT_EQ(static_cast<size_t> (1), plan.getNumLeaves());
+    _ASSERT_NUM_EQ(100.0, plan.getCost(), 1e-12);
+    assertSameOperator(plan, T, 1);
+}
+
+void TestOpPlan::testBlock() {
+    Matrix A = MatrixFactory::MakeRandomMatrix(8, 30, -1.0, 2.0);
+    Matrix B = MatrixFactory::MakeRandomMatrix(30, 8, -1.0, 2.0);
+    Matrix D = MatrixFactory::MakeRandomMatrix(8, 8, -1.0, 2.0);
+    MatrixOperator opA(A);
+    MatrixOperator opB(B);
+    MatrixOperator opD(D);
+    OpComposition AB(opA, opB);
+    OpLinearCombination T(AB, opD, 0.5, -2.0);
+    OpPlan plan(T);
+    _ASSERT_EQ(static_cast<size_t> (1), plan.getNumLeaves());
+    assertSameOperator(plan, T, 4);
+}
+
+void TestOpPlan::testOpaqueOperators() {
+    /* A R B C with an opaque operator R: only BC may be merged */
+    const size_t n = 20;
+    Matrix A = MatrixFactory::MakeRandomMatrix(6, n, -1.0, 2.0);
+    Matrix B = MatrixFactory::MakeRandomMatrix(n, 40, -1.0, 2.0);
+    Matrix C = MatrixFactory::MakeRandomMatrix(40, 3, -1.0, 2.0);
+    MatrixOperator opA(A);
+    MatrixOperator opB(B);
+    MatrixOperator opC(C);
+    OpReverseVector R(n);
+    OpComposition BC(opB, opC);
+    OpComposition RBC(R, BC);
+    OpComposition ARBC(opA, RBC);
+    OpPlan plan(ARBC);
+    _ASSERT_EQ(static_cast<size_t> (3), plan.getNumLeaves());
+    _ASSERT(plan.getCost() < plan.getOriginalCost());
+    assertSameOperator(plan, ARBC, 1);
+    assertSameOperator(plan, ARBC, 2);
+
+    /* the plan of a sum with an opaque term */
+    Matrix E = MatrixFactory::MakeRandomMatrix(n, n, -1.0, 2.0);
+    MatrixOperator opE(E);
+    OpLinearCombination T(R, opE, -1.0, 0.5);
+    OpPlan plan2(T);
+    _ASSERT_EQ(static_cast<size_t> (2), plan2.getNumLeaves());
+    assertSameOperator(plan2, T, 1);
+}
@@ -0,0 +1,56 @@
+/*
+ * File:   TestOpPlan.h
+ *
+ * ForBES is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *  
+ * ForBES is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with ForBES. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TESTOPPLAN_H
+#define TESTOPPLAN_H
+#define FORBES_TEST_UTILS
+
+#include "ForBES.h"
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class TestOpPlan : public CPPUNIT_NS::TestFixture {
+    CPPUNIT_TEST_SUITE(TestOpPlan);
+
+    CPPUNIT_TEST(testAdjointOfAdjoint);
+    CPPUNIT_TEST(testCoefficients);
+    CPPUNIT_TEST(testMergeProducts);
+    CPPUNIT_TEST(testNoMerge);
+    CPPUNIT_TEST(testSumWithAdjoint);
+    CPPUNIT_TEST(testBlock);
+    CPPUNIT_TEST(testOpaqueOperators);
+
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    TestOpPlan();
+    virtual ~TestOpPlan();
+    void setUp();
+    void tearDown();
+
+private:
+    void testAdjointOfAdjoint();
+    void testCoefficients();
+    void testMergeProducts();
+    void testNoMerge();
+    void testSumWithAdjoint();
+    void testBlock();
+    void testOpaqueOperators();
+
+};
+
+#endif /* TESTOPPLAN_H */
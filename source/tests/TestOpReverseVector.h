@@ -21,6 +21,7 @@ class TestOpReverseVector : public CPPUNIT_NS::TestFixture {
     CPPUNIT_TEST(testCall);
     CPPUNIT_TEST(testCallNotFixedSize);
     CPPUNIT_TEST(testCallAdjoint);
+    CPPUNIT_TEST(testBlock);
 
     CPPUNIT_TEST_SUITE_END();
 
@@ -34,6 +35,7 @@ private:
     void testCall();
     void testCallNotFixedSize();
     void testCallAdjoint();
+    void testBlock();
 
 };
 
@@ -544,4 +544,156 @@ void TestQuadratic::testApproximateHessian() {
     }
 }
 
+/* checks that p = prox_{gamma f}(v), i.e., (I + gamma Q) p = v - gamma q */
+static void checkQuadraticProx(Matrix& Q, Matrix& q, Matrix& v, double gamma, Matrix& p, double tol) {
+    Matrix r = Q * p;
+    r *= gamma;
+    r += p;
+    for (size_t i = 0; i < v.getNrows(); i++) {
+        _ASSERT_NUM_EQ(v[i] - gamma * q[i], r[i], tol);
+    }
+}
+
+/* random symmetric positive definite n-by-n matrix */
+static Matrix makeSPD(size_t n) {
+    Matrix A = MatrixFactory::MakeRandomMatrix(n, n, -1.0, 2.0);
+    Matrix At(A);
+    At.transpose();
+    Matrix Q = A * At;
+    for (size_t i = 0; i < n; i++) {
+        Q.set(i, i, Q.get(i, i) + 0.1);
+        for (size_t j = 0; j < i; j++) { /* exactly symmetric */
+            Q.set(j, i, Q.get(i, j));
+        }
+    }
+    return Q;
+}
+
+void TestQuadratic::testProxCache() {
+    const size_t n = 30;
+    const double tol = 1e-9;
+    const double gammas[5] = {0.1, 0.5, 0.1, 0.5, 0.05};
+    Matrix Q = makeSPD(n);
+    Matrix q = MatrixFactory::MakeRandomMatrix(n, 1, -1.0, 2.0);
+    Matrix v = MatrixFactory::MakeRandomMatrix(n, 1, -1.0, 2.0);
+    Quadratic F(Q, q);
+    Matrix prox;
+
+    _ASSERT_EQ(Quadratic::PROX_FACTORIZATION, F.getProxMethod());
+    _ASSERT_EQ(static_cast<size_t> (QUADRATIC_PROX_CACHE_CAPACITY), F.getProxCacheCapacity());
+    F.setProxCacheCapacity(2);
+    for (size_t k = 0; k < 5; k++) {
+        _ASSERT_EQ(ForBESUtils::STATUS_OK, F.callProx(v, gammas[k], prox));
+        checkQuadraticProx(Q, q, v, gammas[k], prox, tol);
+    }
+    /* 0.1 and 0.5 are revisited while cached; 0.05 evicts 0.1 */
+    _ASSERT_EQ(static_cast<size_t> (3), F.getProxFactorizations());
+    _ASSERT_EQ(ForBESUtils::STATUS_OK, F.callProx(v, 0.5, prox));
+    _ASSERT_EQ(static_cast<size_t> (3), F.getProxFactorizations());
+    _ASSERT_EQ(ForBESUtils::STATUS_OK, F.callProx(v, 0.1, prox));
+    _ASSERT_EQ(static_cast<size_t> (4), F.getProxFactorizations());
+    checkQuadraticProx(Q, q, v, 0.1, prox, tol);
+
+    /* the cache is invalidated by setQ */
+    Matrix Q2 = makeSPD(n);
+    F.setQ(Q2);
+    _ASSERT_EQ(ForBESUtils::STATUS_OK, F.callProx(v, 0.1, prox));
+    _ASSERT_EQ(static_cast<size_t> (5), F.getProxFactorizations());
+    checkQuadraticProx(Q2, q, v, 0.1, prox, tol);
+
+    _ASSERT_EXCEPTION(F.setProxCacheCapacity(0), std::invalid_argument);
+}
+
+void TestQuadratic::testProxEigen() {
+    const size_t n = 25;
+    const double tol = 1e-9;
+    Matrix Q = makeSPD(n);
+    Matrix Q_sym(n, n, Matrix::MATRIX_SYMMETRIC);
+    for (size_t j = 0; j < n; j++) {
+        for (size_t i = j; i < n; i++) {
+            Q_sym.set(i, j, Q.get(i, j));
+        }
+    }
+    Matrix q = MatrixFactory::MakeRandomMatrix(n, 1, -1.0, 2.0);
+    Matrix v = MatrixFactory::MakeRandomMatrix(n, 1, -1.0, 2.0);
+    Matrix * matrices[2] = {&Q, &Q_sym};
+    for (size_t s = 0; s < 2; s++) {
+        Quadratic F(*matrices[s], q);
+        F.setProxMethod(Quadratic::PROX_EIGEN);
+        Matrix prox;
+        Matrix prox_cg;
+        for (size_t k = 0; k < 6; k++) {
+            double gamma = 0.01 + 0.3 * k;
+            _ASSERT_EQ(ForBESUtils::STATUS_OK, F.callProx(v, gamma, prox));
+            checkQuadraticProx(Q, q, v, gamma, prox, tol);
+        }
+        /* a single eigenvalue decomposition for all values of gamma */
+        _ASSERT_EQ(static_cast<size_t> (1), F.getProxFactorizations());
+
+        F.setProxMethod(Quadratic::PROX_CG);
+        _ASSERT_EQ(ForBESUtils::STATUS_OK, F.callProx(v, 0.2, prox_cg));
+        F.setProxMethod(Quadratic::PROX_EIGEN);
+        _ASSERT_EQ(ForBESUtils::STATUS_OK, F.callProx(v, 0.2, prox));
+        for (size_t i = 0; i < n; i++) {
+            _ASSERT_NUM_EQ(prox_cg[i], prox[i], 1e-5);
+        }
+    }
+}
+
+void TestQuadratic::testProxSparseSymmetric() {
+    const size_t n = 20;
+    const double tol = 1e-9;
+    Matrix Q = MatrixFactory::MakeSparseSymmetric(n, 2 * n - 1);
+    Matrix Q_dense(n, n);
+    for (size_t i = 0; i < n; i++) {
+        Q.set(i, i, 4.0 + 0.1 * i);
+        Q_dense.set(i, i, 4.0 + 0.1 * i);
+    }
+    for (size_t i = 1; i < n; i++) { /* lower triangular part only */
+        Q.set(i, i - 1, -1.0);
+        Q_dense.set(i, i - 1, -1.0);
+        Q_dense.set(i - 1, i, -1.0);
+    }
+    Matrix q = MatrixFactory::MakeRandomMatrix(n, 1, -1.0, 2.0);
+    Matrix v = MatrixFactory::MakeRandomMatrix(n, 1, -1.0, 2.0);
+    Quadratic F(Q, q);
+    Matrix prox;
+    const double gammas[4] = {0.3, 1.5, 0.3, 7.0};
+    for (size_t k = 0; k < 4; k++) {
+        _ASSERT_EQ(ForBESUtils::STATUS_OK, F.callProx(v, gammas[k], prox));
+        checkQuadraticProx(Q_dense, q, v, gammas[k], prox, tol);
+    }
+    _ASSERT_EQ(static_cast<size_t> (3), F.getProxFactorizations());
+}
 
+void TestQuadratic::testProxUnsymmetric() {
+    const size_t n = 15;
+    const double tol = 1e-5;
+    /* a dense Q which is not symmetric: (I + gamma Q) is still invertible */
+    Matrix Q = makeSPD(n);
+    Q.set(0, n - 1, Q.get(0, n - 1) + 0.5);
+    Q.set(3, 1, Q.get(3, 1) - 0.2);
+    Matrix q = MatrixFactory::MakeRandomMatrix(n, 1, -1.0, 2.0);
+    Matrix v = MatrixFactory::MakeRandomMatrix(n, 1, -1.0, 2.0);
+    Quadratic F(Q, q);
+    Matrix prox;
+    _ASSERT_EQ(Quadratic::PROX_FACTORIZATION, F.getProxMethod());
+    _ASSERT_EQ(ForBESUtils::STATUS_OK, F.callProx(v, 0.4, prox));
+    checkQuadraticProx(Q, q, v, 0.4, prox, tol);
+    /* the prox is computed by CG, so nothing is factorized */
+    _ASSERT_EQ(static_cast<size_t> (0), F.getProxFactorizations());
+
+    F.setProxMethod(Quadratic::PROX_EIGEN);
+    _ASSERT_EQ(ForBESUtils::STATUS_OK, F.callProx(v, 0.4, prox));
+    checkQuadraticProx(Q, q, v, 0.4, prox, tol);
+    _ASSERT_EQ(static_cast<size_t> (0), F.getProxFactorizations());
+
+    /* once Q is symmetrized (and set again), it is factorized */
+    Q.set(0, n - 1, Q.get(n - 1, 0));
+    Q.set(3, 1, Q.get(1, 3));
+    F.setQ(Q);
+    F.setProxMethod(Quadratic::PROX_FACTORIZATION);
+    _ASSERT_EQ(ForBESUtils::STATUS_OK, F.callProx(v, 0.4, prox));
+    checkQuadraticProx(Q, q, v, 0.4, prox, 1e-9);
+    _ASSERT_EQ(static_cast<size_t> (1), F.getProxFactorizations());
+}
@@ -48,6 +48,10 @@ class TestQuadratic : public CPPUNIT_NS::TestFixture {
     CPPUNIT_TEST(testHessian);
     CPPUNIT_TEST(testHessianSparse);
     CPPUNIT_TEST(testApproximateHessian);
+    CPPUNIT_TEST(testProxCache);
+    CPPUNIT_TEST(testProxEigen);
+    CPPUNIT_TEST(testProxSparseSymmetric);
+    CPPUNIT_TEST(testProxUnsymmetric);
 
     CPPUNIT_TEST_SUITE_END();
 
@@ -79,6 +83,10 @@ private:
     void testHessian();
     void testHessianSparse();
     void testApproximateHessian();
+    void testProxCache();
+    void testProxEigen();
+    void testProxSparseSymmetric();
+    void testProxUnsymmetric();
 
 };
 
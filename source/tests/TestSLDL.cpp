@@ -153,3 +153,34 @@ void TestSLDL::testDenseTall() {
 
 }
 
+void TestSLDL::testRefactorize() {
+    const double tol = 1e-8;
+    const double betas[3] = {0.7, 2.5, 0.1};
+    Matrix sparse = MatrixFactory::MakeRandomSparse(6, 4, 12, 0.0, 1.0);
+    Matrix dense_short = MatrixFactory::MakeRandomMatrix(4, 9, 0.0, 1.0);
+    Matrix dense_tall = MatrixFactory::MakeRandomMatrix(9, 4, 0.0, 1.0);
+    Matrix * matrices[3] = {&sparse, &dense_short, &dense_tall};
+
+    for (size_t q = 0; q < 3; q++) {
+        Matrix& A = *matrices[q];
+        Matrix At(A);
+        At.transpose();
+        Matrix AAt = A * At;
+        size_t n = A.getNrows();
+        Matrix b = MatrixFactory::MakeRandomMatrix(n, 1, -1.0, 2.0);
+        S_LDLFactorization solver(A, 1.0);
+        _ASSERT_EQ(ForBESUtils::STATUS_OK, solver.factorize());
+        for (size_t k = 0; k < 3; k++) {
+            Matrix x;
+            _ASSERT_EQ(ForBESUtils::STATUS_OK, solver.refactorize(betas[k]));
+            _ASSERT_EQ(betas[k], solver.getBeta());
+            _ASSERT_EQ(ForBESUtils::STATUS_OK, solver.solve(b, x));
+            /* (AA' + beta I) x = b */
+            Matrix r = AAt * x;
+            Matrix::add(r, betas[k], x, 1.0);
+            for (size_t i = 0; i < n; i++) {
+                _ASSERT_NUM_EQ(b[i], r[i], tol);
+            }
+        }
+    }
+}
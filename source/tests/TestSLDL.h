@@ -31,6 +31,7 @@ class TestSLDL : public CPPUNIT_NS::TestFixture {
     CPPUNIT_TEST(testFactorizeAndSolve);
     CPPUNIT_TEST(testDenseShort);
     CPPUNIT_TEST(testDenseTall);
+    CPPUNIT_TEST(testRefactorize);
 
     CPPUNIT_TEST_SUITE_END();
 
@@ -44,6 +45,7 @@ private:
     void testFactorizeAndSolve();
     void testDenseShort();
     void testDenseTall();
+    void testRefactorize();
 };
 
 #endif	/* TESTSLDL_H */
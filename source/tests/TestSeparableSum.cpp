@@ -347,8 +347,13 @@ void TestSeparableSum::testUndefined() {
     
     
     delete f2;
+    delete sep_sum;
     
     f2 = new LogLogisticLoss();
+    fun_idx_map.clear();
+    fun_idx_map[f1] = &idx1;
+    fun_idx_map[f2] = &idx2;
+    sep_sum = new SeparableSum(fun_idx_map);
     double gamma = 0.5;
     Matrix proxf(5,1);
     status = sep_sum->callProx(x, gamma, proxf);
@@ -359,3 +364,140 @@ void TestSeparableSum::testUndefined() {
     delete f2;
     delete sep_sum;
 }
+
+void TestSeparableSum::testContiguousBlocks() {
+    /* f = norm1(x_2, x_3, x_4) + elastic_net(x_0, x_6) + norm2(x_1, x_5, x_7) */
+    const size_t n = 8;
+    std::vector<size_t> idx1(3);
+    std::vector<size_t> idx2(2);
+    std::vector<size_t> idx3(3);
+    idx1[0] = 2;
+    idx1[1] = 3;
+    idx1[2] = 4; /* contiguous */
+    idx2[0] = 0;
+    idx2[1] = 6;
+    idx3[0] = 1;
+    idx3[1] = 5;
+    idx3[2] = 7;
+
+    Function * f1 = new Norm1(1.5);
+    Function * f2 = new ElasticNet(0.7, 1.1);
+    Function * f3 = new Norm2(0.9);
+
+    std::map<Function*, std::vector<size_t>* > fun_idx_map;
+    fun_idx_map[f1] = &idx1;
+    fun_idx_map[f2] = &idx2;
+    fun_idx_map[f3] = &idx3;
+
+    SeparableSum * sep_sum = new SeparableSum(fun_idx_map);
+    _ASSERT_EQ(static_cast<size_t> (3), sep_sum->num_blocks());
+    _ASSERT(sep_sum->isParallel());
+
+    /* the plan does not depend on the index vectors after construction */
+    idx1[0] = 7;
+
+    const double gamma = 0.65;
+    const double tol = 1e-10;
+    for (size_t rep = 0; rep < 20; rep++) {
+        Matrix x = MatrixFactory::MakeRandomMatrix(n, 1, -2.0, 4.0);
+        Matrix x1(3, 1);
+        Matrix x2(2, 1);
+        Matrix x3(3, 1);
+        x1[0] = x[2];
+        x1[1] = x[3];
+        x1[2] = x[4];
+        x2[0] = x[0];
+        x2[1] = x[6];
+        x3[0] = x[1];
+        x3[1] = x[5];
+        x3[2] = x[7];
+
+        double f1_val, f2_val, f3_val, f_val;
+        _ASSERT_EQ(ForBESUtils::STATUS_OK, f1->call(x1, f1_val));
+        _ASSERT_EQ(ForBESUtils::STATUS_OK, f2->call(x2, f2_val));
+        _ASSERT_EQ(ForBESUtils::STATUS_OK, f3->call(x3, f3_val));
+        _ASSERT_EQ(ForBESUtils::STATUS_OK, sep_sum->call(x, f_val));
+        _ASSERT_NUM_EQ(f1_val + f2_val + f3_val, f_val, tol);
+
+        Matrix prox1(3, 1);
+        Matrix prox2(2, 1);
+        Matrix prox3(3, 1);
+        double f1_prox, f2_prox, f3_prox, f_prox;
+        _ASSERT_EQ(ForBESUtils::STATUS_OK, f1->callProx(x1, gamma, prox1, f1_prox));
+        _ASSERT_EQ(ForBESUtils::STATUS_OK, f2->callProx(x2, gamma, prox2, f2_prox));
+        _ASSERT_EQ(ForBESUtils::STATUS_OK, f3->callProx(x3, gamma, prox3, f3_prox));
+
+        Matrix prox(n, 1);
+        _ASSERT_EQ(ForBESUtils::STATUS_OK, sep_sum->callProx(x, gamma, prox, f_prox));
+        _ASSERT_NUM_EQ(f1_prox + f2_prox + f3_prox, f_prox, tol);
+        _ASSERT_NUM_EQ(prox1[0], prox[2], tol);
+        _ASSERT_NUM_EQ(prox1[1], prox[3], tol);
+        _ASSERT_NUM_EQ(prox1[2], prox[4], tol);
+        _ASSERT_NUM_EQ(prox2[0], prox[0], tol);
+        _ASSERT_NUM_EQ(prox2[1], prox[6], tol);
+        _ASSERT_NUM_EQ(prox3[0], prox[1], tol);
+        _ASSERT_NUM_EQ(prox3[1], prox[5], tol);
+        _ASSERT_NUM_EQ(prox3[2], prox[7], tol);
+
+        Matrix prox_only(n, 1);
+        _ASSERT_EQ(ForBESUtils::STATUS_OK, sep_sum->callProx(x, gamma, prox_only));
+        _ASSERT_EQ(prox, prox_only);
+
+        /* the conjugate of ElasticNet is not defined */
+        double f_star;
+        int status = sep_sum->callConj(x, f_star);
+        _ASSERT(ForBESUtils::is_status_error(status));
+    }
+
+    Matrix x_short(n - 1, 1);
+    double f_val;
+    _ASSERT_EXCEPTION(sep_sum->call(x_short, f_val), std::invalid_argument);
+
+    delete f1;
+    delete f2;
+    delete f3;
+    delete sep_sum;
+}
+
+void TestSeparableSum::testManyBlocks() {
+    /* sum of norm1(x_{I_j}) with contiguous blocks equals norm1(x) */
+    const size_t n_blocks = 2000;
+    const size_t block_size = 7;
+    const size_t n = n_blocks * block_size;
+    const double mu = 0.8;
+    const double gamma = 1.3;
+
+    std::vector<Function*> functions(n_blocks);
+    std::vector< std::vector<size_t> > indices(n_blocks, std::vector<size_t>(block_size));
+    std::map<Function*, std::vector<size_t>* > fun_idx_map;
+    for (size_t j = 0; j < n_blocks; j++) {
+        for (size_t k = 0; k < block_size; k++) {
+            indices[j][k] = j * block_size + k;
+        }
+        functions[j] = new Norm1(mu);
+        fun_idx_map[functions[j]] = &indices[j];
+    }
+
+    SeparableSum sep_sum(fun_idx_map);
+    Norm1 norm1(mu);
+
+    Matrix x = MatrixFactory::MakeRandomMatrix(n, 1, -1.0, 2.0);
+    Matrix prox(n, 1);
+    Matrix prox_expected(n, 1);
+    double f_val, f_expected;
+    for (size_t rep = 0; rep < 2; rep++) {
+        sep_sum.setParallel(rep == 0);
+        _ASSERT_EQ(ForBESUtils::STATUS_OK, sep_sum.call(x, f_val));
+        _ASSERT_EQ(ForBESUtils::STATUS_OK, norm1.call(x, f_expected));
+        _ASSERT_NUM_EQ(f_expected, f_val, 1e-8);
+
+        _ASSERT_EQ(ForBESUtils::STATUS_OK, sep_sum.callProx(x, gamma, prox, f_val));
+        _ASSERT_EQ(ForBESUtils::STATUS_OK, norm1.callProx(x, gamma, prox_expected, f_expected));
+        _ASSERT_NUM_EQ(f_expected, f_val, 1e-8);
+        _ASSERT_EQ(prox_expected, prox);
+    }
+
+    for (size_t j = 0; j < n_blocks; j++) {
+        delete functions[j];
+    }
+}
@@ -36,6 +36,8 @@ class TestSeparableSum : public CPPUNIT_NS::TestFixture {
     CPPUNIT_TEST(testCallProx);
     CPPUNIT_TEST(testCallConj);
     CPPUNIT_TEST(testUndefined);
+    CPPUNIT_TEST(testContiguousBlocks);
+    CPPUNIT_TEST(testManyBlocks);
 
     CPPUNIT_TEST_SUITE_END();
 
@@ -51,6 +53,8 @@ private:
     void testCallProx();
     void testCallConj();
     void testUndefined();
+    void testContiguousBlocks();
+    void testManyBlocks();
     
 };
 
@@ -0,0 +1,471 @@
+#include "ZeroFPR.h"
+#include "FBSplittingFast.h"
+#include "FBProblem.h"
+#include "FBStoppingRelative.h"
+#include "MatrixFactory.h"
+#include "MatrixOperator.h"
+#include "TestZeroFPR.h"
+
+#include <cmath>
+
+// #include <iostream>
+
+#define DOUBLES_EQUAL_DELTA 1e-4
+#define MAXIT 1000
+#define TOLERANCE 1e-6
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TestZeroFPR);
+
+/* ZeroFPR which counts how many times its state (L-BFGS memory) is cleared */
+class CountingZeroFPR : public ZeroFPR {
+public:
+
+    CountingZeroFPR(FBProblem & prob, Matrix & x0, double gamma, FBStopping & sc, int maxit) :
+    ZeroFPR(prob, x0, gamma, sc, maxit), m_resets(0) {
+    }
+
+    size_t getResets() const {
+        return m_resets;
+    }
+
+protected:
+
+    virtual void resetState() {
+        m_resets++;
+        ZeroFPR::resetState();
+    }
+
+private:
+    size_t m_resets;
+};
+
+TestZeroFPR::TestZeroFPR() {
+}
+
+TestZeroFPR::~TestZeroFPR() {
+}
+
+void TestZeroFPR::setUp() {
+}
+
+void TestZeroFPR::tearDown() {
+}
+
+void TestZeroFPR::testBoxQP_small() {
+	size_t n = 4;
+	// problem data
+	double data_Q[] = {
+		7, 2, -2, -1,
+		2, 3, 0, -1,
+		-2, 0, 3, -1,
+		-1, -1, -1, 1
+	};
+	double data_q[] = {
+		1, 2, 3, 4
+	};
+	double gamma = 0.1;
+	double lb = -1;
+	double ub = +1;
+	// starting points
+	double data_x1[] = {+0.5, +1.2, -0.7, -1.1};
+	double data_x2[] = {-1.0, -1.0, -1.0, -1.0};
+	// reference results
+	double ref_xstar[] = {-0.352941176470588, -0.764705882352941, -1.000000000000000, -1.000000000000000};
+
+	Matrix * Q = new Matrix(n, n, data_Q);
+	Matrix * q = new Matrix(n, 1, data_q);
+	Matrix * x0;
+	Matrix xstar;
+	Function * f = new Quadratic(*Q, *q);
+	Function * g = new IndBox(lb, ub);
+	FBProblem prob = FBProblem(*f, *g);
+	FBStoppingRelative sc = FBStoppingRelative(TOLERANCE);
+	FBSplitting * solver;
+	
+	// test FB operations starting from x1
+	size_t repeat = 100;
+	for (size_t r = 0; r < repeat; r++) {
+		x0 = new Matrix(n, 1, data_x1);
+		solver = new ZeroFPR(prob, *x0, gamma, sc, MAXIT);
+		solver->run();
+		xstar = solver->getSolution();
+		//cout << "*** iters (zerofpr) : " << solver->getIt() << endl;
+		_ASSERT(solver->getIt() < MAXIT);
+		for (int i=0; i < n; i++) {
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(ref_xstar[i], xstar.get(i, 0), DOUBLES_EQUAL_DELTA);
+		}
+		delete x0;
+		delete solver;
+	
+		// test FB operations starting from x2
+		x0 = new Matrix(n, 1, data_x2);
+		solver = new ZeroFPR(prob, *x0, gamma, sc, MAXIT);
+		solver->run();
+		xstar = solver->getSolution();
+		//cout << "*** iters (zerofpr) : " << solver->getIt() << endl;
+		_ASSERT(solver->getIt() < MAXIT);
+		for (int i=0; i < n; i++) {
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(ref_xstar[i], xstar.get(i, 0), DOUBLES_EQUAL_DELTA);
+		}
+		delete x0;
+		delete solver;
+	}
+
+	delete Q;
+	delete q;
+	delete f;
+	delete g;
+}
+
+void TestZeroFPR::testLasso_small() {
+	size_t n = 5;
+	size_t m = 4;
+	// problem data
+	double data_A[] = {
+		1, 2, -1, -1,
+		-2, -1, 0, -1,
+		3, 0, 4, -1,
+		-4, -1, -3, 1,
+		5, 3, 2, 3
+	};
+	double data_minusb[] = {
+		-1, -2, -3, -4
+	};
+	/*
+	 * WARNING: data_w is not used anywhere...
+	 */
+	double data_w[] = {
+		1, 1, 1, 1
+	};
+	double gamma = 0.01;
+	// starting points
+	double data_x1[] = {0, 0, 0, 0, 0};
+	// reference results
+	double ref_xstar[] = {-0.010238907849511, 0, 0, 0, 0.511945392491421};
+
+	Matrix * A = new Matrix(m, n, data_A);
+	Matrix * minusb = new Matrix(m, 1, data_minusb);
+	Matrix * x0;
+	Matrix xstar;
+	Function * f = new QuadraticLoss();
+	LinearOperator * OpA = new MatrixOperator(*A);
+	Function * g = new Norm1(5.0);
+	FBProblem prob = FBProblem(*f, *OpA, *minusb, *g);
+	FBStoppingRelative sc = FBStoppingRelative(TOLERANCE);
+	FBSplitting * solver;
+	
+	size_t repeat = 200;
+	for (size_t r = 0; r < repeat; r++) {
+		// test FB operations starting from x1
+		x0 = new Matrix(n, 1, data_x1);
+		solver = new ZeroFPR(prob, *x0, gamma, sc, MAXIT);
+		solver->run();
+		xstar = solver->getSolution();
+		//cout << "*** iters (zerofpr) : " << solver->getIt() << endl;
+		_ASSERT(solver->getIt() < MAXIT);
+		for (int i=0; i < n; i++) {
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(ref_xstar[i], xstar.get(i, 0), DOUBLES_EQUAL_DELTA);
+		}
+		delete x0;
+		delete solver;
+	}
+
+	delete A;
+	delete minusb;
+	delete OpA;
+	delete f;
+	delete g;
+}
+
+void TestZeroFPR::testSparseLogReg_small() {
+	size_t n = 5;
+	size_t m = 4;
+	// problem data
+	double data_A[] = {
+		1, 2, -1, -1,
+		-2, -1, 0, -1,
+		3, 0, 4, -1,
+		-4, -1, -3, 1,
+		5, 3, 2, 3
+	};
+	double data_minusb[] = {
+		-1, 1, -1, 1
+	};
+	double gamma = 0.1;
+	// starting points
+	double data_x1[] = {0, 0, 0, 0, 0};
+	// reference results
+	double ref_xstar[] = {0.0, 0.0, 0.215341883018748, 0.0, 0.675253988559914};
+
+	Matrix * A = new Matrix(m, n, data_A);
+	Matrix * minusb = new Matrix(m, 1, data_minusb);
+
+	Function * f = new LogLogisticLoss();
+	LinearOperator * OpA = new MatrixOperator(*A);
+	Function * g = new Norm1(1.0);
+	FBProblem prob(*f, *OpA, *minusb, *g);
+	FBStoppingRelative sc(TOLERANCE);
+	FBSplitting * solver;
+	
+	size_t repeat = 100;
+	for (size_t r = 0; r < repeat; r++) {
+		// test FB operations starting from x1
+		Matrix * x0 = new Matrix(n, 1, data_x1);
+		solver = new ZeroFPR(prob, *x0, gamma, sc, MAXIT);
+		solver->run();
+		Matrix xstar = solver->getSolution();
+		//cout << "*** iters (zerofpr) : " << solver->getIt() << endl << flush;
+		_ASSERT(solver->getIt() < MAXIT);
+		for (int i=0; i < n; i++) {
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(ref_xstar[i], xstar.get(i, 0), DOUBLES_EQUAL_DELTA);
+		}
+		delete x0;
+		delete solver;
+	}
+
+	delete A;
+	delete minusb;
+	delete OpA;
+	delete f;
+	delete g;
+}
+
+void TestZeroFPR::testBoxQP_adaptive() {
+	size_t n = 4;
+	// problem data
+	double data_Q[] = {
+		7, 2, -2, -1,
+		2, 3, 0, -1,
+		-2, 0, 3, -1,
+		-1, -1, -1, 1
+	};
+	double data_q[] = {
+		1, 2, 3, 4
+	};
+	// too large for a fixed step-size (the largest eigenvalue of Q is ~8.9)
+	double gamma = 5.0;
+	double lb = -1;
+	double ub = +1;
+	// starting point
+	double data_x1[] = {+0.5, +1.2, -0.7, -1.1};
+	// reference results
+	double ref_xstar[] = {-0.352941176470588, -0.764705882352941, -1.000000000000000, -1.000000000000000};
+
+	Matrix * Q = new Matrix(n, n, data_Q);
+	Matrix * q = new Matrix(n, 1, data_q);
+	Matrix * x0 = new Matrix(n, 1, data_x1);
+	Matrix xstar;
+	Function * f = new Quadratic(*Q, *q);
+	Function * g = new IndBox(lb, ub);
+	FBProblem prob(*f, *g);
+	FBStoppingRelative sc(TOLERANCE);
+
+	ZeroFPR * solver = new ZeroFPR(prob, *x0, gamma, sc, MAXIT);
+	_ASSERT_NOT(solver->isAdaptiveStepsize());
+	solver->setAdaptiveStepsize(true);
+	_ASSERT(solver->isAdaptiveStepsize());
+	_ASSERT_EQ(ForBESUtils::STATUS_OK, solver->run());
+	xstar = solver->getSolution();
+	_ASSERT(solver->getIt() < MAXIT);
+	_ASSERT(solver->getGamma() < gamma);
+	_ASSERT(solver->getGamma() > 0.0);
+	for (int i=0; i < n; i++) {
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(ref_xstar[i], xstar.get(i, 0), DOUBLES_EQUAL_DELTA);
+	}
+
+	delete solver;
+	delete x0;
+	delete Q;
+	delete q;
+	delete f;
+	delete g;
+}
+
+void TestZeroFPR::testLasso_adaptive() {
+	size_t n = 5;
+	size_t m = 4;
+	// problem data
+	double data_A[] = {
+		1, 2, -1, -1,
+		-2, -1, 0, -1,
+		3, 0, 4, -1,
+		-4, -1, -3, 1,
+		5, 3, 2, 3
+	};
+	double data_minusb[] = {-1, -2, -3, -4};
+	// far larger than 1/L, where L = ||A||^2
+	double gamma = 1.0;
+	// starting point
+	double data_x1[] = {0, 0, 0, 0, 0};
+	// reference results
+	double ref_xstar[] = {-0.010238907849511, 0, 0, 0, 0.511945392491421};
+
+	Matrix * A = new Matrix(m, n, data_A);
+	Matrix * minusb = new Matrix(m, 1, data_minusb);
+	Matrix * x0 = new Matrix(n, 1, data_x1);
+	Matrix xstar;
+	Function * f = new QuadraticLoss();
+	LinearOperator * OpA = new MatrixOperator(*A);
+	Function * g = new Norm1(5.0);
+	FBProblem prob(*f, *OpA, *minusb, *g);
+	FBStoppingRelative sc(TOLERANCE);
+
+	ZeroFPR * solver = new ZeroFPR(prob, *x0, gamma, sc, MAXIT);
+	solver->setAdaptiveStepsize(true);
+	_ASSERT_EQ(ForBESUtils::STATUS_OK, solver->run());
+	xstar = solver->getSolution();
+	_ASSERT(solver->getIt() < MAXIT);
+	_ASSERT(solver->getGamma() < gamma);
+	for (int i=0; i < n; i++) {
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(ref_xstar[i], xstar.get(i, 0), DOUBLES_EQUAL_DELTA);
+	}
+
+	delete solver;
+	delete x0;
+	delete A;
+	delete minusb;
+	delete OpA;
+	delete f;
+	delete g;
+}
+
+void TestZeroFPR::testBoxQP_illConditioned() {
+	size_t n = 20;
+	double lb = -0.5;
+	double ub = +1;
+	// Q = diag(Q_ii) with condition number 1e3
+	Matrix Q(n, n, Matrix::MATRIX_DIAGONAL);
+	Matrix q(n, 1);
+	Matrix ref_xstar(n, 1);
+	for (size_t i = 0; i < n; i++) {
+		Q[i] = std::pow(10.0, 3.0 * i / (n - 1.0));
+		q[i] = 1.0;
+		ref_xstar[i] = std::max(lb, -q[i] / Q[i]);
+	}
+	double gamma = 0.95 / 1e3;
+	size_t mem = 10;
+
+	Function * f = new Quadratic(Q, q);
+	Function * g = new IndBox(lb, ub);
+	FBProblem prob(*f, *g);
+	FBStoppingRelative sc(TOLERANCE);
+
+	Matrix x0(n, 1);
+	ZeroFPR * solver = new ZeroFPR(prob, x0, gamma, sc, 10 * MAXIT, mem);
+	_ASSERT_EQ(ForBESUtils::STATUS_OK, solver->run());
+	size_t it_zerofpr = solver->getIt();
+	Matrix xstar = solver->getSolution();
+	for (size_t i = 0; i < n; i++) {
+		_ASSERT_NUM_EQ(ref_xstar[i], xstar[i], DOUBLES_EQUAL_DELTA);
+	}
+	delete solver;
+
+	Matrix x0_fast(n, 1);
+	FBSplittingFast * solver_fast = new FBSplittingFast(prob, x0_fast, gamma, sc, 10 * MAXIT);
+	solver_fast->run();
+	size_t it_fast = solver_fast->getIt();
+	delete solver_fast;
+
+	// cout << "*** iters : " << it_zerofpr << " (zerofpr), " << it_fast << " (fast)" << endl;
+	_ASSERT(it_zerofpr < it_fast);
+
+	delete f;
+	delete g;
+}
+
+void TestZeroFPR::testLasso_warmStart() {
+	size_t n = 5;
+	size_t m = 4;
+	// problem data
+	double data_A[] = {
+		1, 2, -1, -1,
+		-2, -1, 0, -1,
+		3, 0, 4, -1,
+		-4, -1, -3, 1,
+		5, 3, 2, 3
+	};
+	double data_minusb[] = {-1, -2, -3, -4};
+	double data_minusb2[] = {2, -1, 0, -3};
+	double gamma = 0.01;
+	// starting point
+	double data_x1[] = {0, 0, 0, 0, 0};
+
+	Matrix A(m, n, data_A);
+	Matrix minusb(m, 1, data_minusb);
+	Matrix minusb2(m, 1, data_minusb2);
+	Matrix x1(n, 1, data_x1);
+	QuadraticLoss f;
+	MatrixOperator OpA(A);
+	Norm1 g(5.0);
+	FBStoppingRelative sc(TOLERANCE);
+
+	// reference: a new solver for the second offset
+	FBProblem prob2(f, OpA, minusb2, g);
+	Matrix x_fresh(x1);
+	ZeroFPR fresh(prob2, x_fresh, gamma, sc, MAXIT);
+	_ASSERT_EQ(ForBESUtils::STATUS_OK, fresh.run());
+	Matrix xstar_fresh = fresh.getSolution();
+
+	// warm start after solving for the first offset; the L-BFGS memory
+	// must not carry over
+	FBProblem prob(f, OpA, minusb, g);
+	Matrix x(x1);
+	ZeroFPR solver(prob, x, gamma, sc, MAXIT);
+	_ASSERT_EQ(ForBESUtils::STATUS_OK, solver.run());
+	_ASSERT_EQ(ForBESUtils::STATUS_OK, solver.reset(x1, &minusb2, NULL, MAXIT));
+	_ASSERT_EQ(ForBESUtils::STATUS_OK, solver.run());
+	_ASSERT_EQ(fresh.getIt(), solver.getIt());
+	Matrix xstar = solver.getSolution();
+	for (size_t i = 0; i < n; i++) {
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(xstar_fresh.get(i, 0), xstar.get(i, 0), 1e-12);
+	}
+}
+
+void TestZeroFPR::testLasso_adaptiveResetsMemory() {
+	size_t n = 5;
+	size_t m = 4;
+	// problem data
+	double data_A[] = {
+		1, 2, -1, -1,
+		-2, -1, 0, -1,
+		3, 0, 4, -1,
+		-4, -1, -3, 1,
+		5, 3, 2, 3
+	};
+	double data_minusb[] = {-1, -2, -3, -4};
+	// too large: the first iteration has to backtrack
+	double gamma = 1.0;
+	double data_x1[] = {0, 0, 0, 0, 0};
+	double ref_xstar[] = {-0.010238907849511, 0, 0, 0, 0.511945392491421};
+
+	Matrix A(m, n, data_A);
+	Matrix minusb(m, 1, data_minusb);
+	Matrix x0(n, 1, data_x1);
+	QuadraticLoss f;
+	MatrixOperator OpA(A);
+	Norm1 g(5.0);
+	FBProblem prob(f, OpA, minusb, g);
+	FBStoppingRelative sc(TOLERANCE);
+
+	CountingZeroFPR solver(prob, x0, gamma, sc, MAXIT);
+	solver.setAdaptiveStepsize(true);
+	size_t reductions = 0;
+	size_t it = 0;
+	while (it < MAXIT && !solver.stop()) {
+		double gamma_prev = solver.getGamma();
+		_ASSERT_EQ(ForBESUtils::STATUS_OK, solver.iterate());
+		if (solver.getGamma() < gamma_prev) {
+			reductions++;
+		}
+		// the memory is cleared exactly when the step-size is reduced
+		_ASSERT_EQ(reductions, solver.getResets());
+		it++;
+	}
+	_ASSERT(it < MAXIT);
+	_ASSERT(reductions > 0);
+	_ASSERT(solver.getGamma() < gamma);
+	Matrix xstar = solver.getSolution();
+	for (size_t i = 0; i < n; i++) {
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(ref_xstar[i], xstar.get(i, 0), DOUBLES_EQUAL_DELTA);
+	}
+}
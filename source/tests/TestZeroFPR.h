@@ -0,0 +1,42 @@
+#ifndef TESTZEROFPR_H
+#define	TESTZEROFPR_H
+
+#define FORBES_TEST_UTILS
+
+#include "ForBES.h"
+#include "ForBESUtils.h"
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class TestZeroFPR : public CPPUNIT_NS::TestFixture {
+    CPPUNIT_TEST_SUITE(TestZeroFPR);
+
+    CPPUNIT_TEST(testBoxQP_small);
+    CPPUNIT_TEST(testLasso_small);
+    CPPUNIT_TEST(testSparseLogReg_small);
+    CPPUNIT_TEST(testBoxQP_adaptive);
+    CPPUNIT_TEST(testLasso_adaptive);
+    CPPUNIT_TEST(testBoxQP_illConditioned);
+    CPPUNIT_TEST(testLasso_warmStart);
+    CPPUNIT_TEST(testLasso_adaptiveResetsMemory);
+    
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    TestZeroFPR();
+    virtual ~TestZeroFPR();
+    void setUp();
+    void tearDown();
+
+private:
+    void testBoxQP_small();
+    void testLasso_small();
+    void testSparseLogReg_small();
+    void testBoxQP_adaptive();
+    void testLasso_adaptive();
+    void testBoxQP_illConditioned();
+    void testLasso_warmStart();
+    void testLasso_adaptiveResetsMemory();
+};
+
+#endif	/* TESTZEROFPR_H */